@@ -0,0 +1,45 @@
+#ifndef MYTINYSTL_ALGO_H_
+#define MYTINYSTL_ALGO_H_
+
+// 这个头文件包含了 mystl 的一系列算法
+
+#include "algobase.h"
+#include "iterator.h"
+
+namespace mystl
+{
+
+/*****************************************************************************************/
+// reverse
+// 将[first, last)区间内的元素反转
+/*****************************************************************************************/
+// reverse_dispatch 的 bidirectional_iterator_tag 版本
+template <class BidirectionalIter>
+void reverse_dispatch(BidirectionalIter first, BidirectionalIter last,
+                      bidirectional_iterator_tag)
+{
+  while (true)
+  {
+    if (first == last || first == --last)
+      return;
+    mystl::iter_swap(first++, last);
+  }
+}
+
+// reverse_dispatch 的 random_access_iterator_tag 版本
+template <class RandomIter>
+void reverse_dispatch(RandomIter first, RandomIter last,
+                      random_access_iterator_tag)
+{
+  while (first < last)
+    mystl::iter_swap(first++, --last);
+}
+
+template <class BidirectionalIter>
+void reverse(BidirectionalIter first, BidirectionalIter last)
+{
+  mystl::reverse_dispatch(first, last, iterator_category(first));
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_ALGO_H_
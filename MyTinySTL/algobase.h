@@ -473,10 +473,10 @@ bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
 }
 
 // 针对 const unsigned char* 的特化版本
-bool lexicographical_compare(const unsigned char* first1,
-                             const unsigned char* last1,
-                             const unsigned char* first2,
-                             const unsigned char* last2)
+inline bool lexicographical_compare(const unsigned char* first1,
+                                    const unsigned char* last1,
+                                    const unsigned char* first2,
+                                    const unsigned char* last2)
 {
   const auto len1 = last1 - first1;
   const auto len2 = last2 - first2;
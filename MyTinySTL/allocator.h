@@ -23,6 +23,13 @@ public:
   typedef size_t       size_type;
   typedef ptrdiff_t    difference_type;
 
+  // 得到其他类型的配置器
+  template <class U>
+  struct rebind
+  {
+    typedef allocator<U> other;
+  };
+
 public:
   static T*   allocate();
   static T*   allocate(size_type n);
@@ -108,6 +115,17 @@ void allocator<T>::destroy(T* first, T* last)
   mystl::destroy(first, last);
 }
 
+// 容器成块申请空间（deque 的缓冲区、节点池的块）时每块的建议字节数
+// 为 0 表示由容器自行决定，huge_page_allocator 将其特化为大页的大小
+template <class Alloc>
+struct allocator_chunk_bytes
+{
+  static constexpr size_t value = 0;
+};
+
+template <class Alloc>
+constexpr size_t allocator_chunk_bytes<Alloc>::value;
+
 } // namespace mystl
 #endif // !MYTINYSTL_ALLOCATOR_H_
 
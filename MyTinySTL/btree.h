@@ -0,0 +1,1251 @@
+#ifndef MYTINYSTL_BTREE_H_
+#define MYTINYSTL_BTREE_H_
+
+// 这个头文件包含一个模板类 btree
+// btree : B+ 树，作为 btree_set / btree_multiset 的底层机制
+// 每个节点按 NodeBytes 字节（默认 256，即 4 条 cache line）存放多个元素，
+// 比起红黑树每个元素一个节点、每个节点三个指针加颜色，内存占用更小，查找时的指针跳转也更少
+
+// notes:
+//
+// 1. 元素只存放在叶子节点中，叶子节点之间以双向链表相连，迭代器为（叶子节点，下标）
+// 2. 内部节点存放分隔键值的副本：children[i] 中的键值都不大于 key(i)，children[i + 1] 中的键值都不小于 key(i)
+// 3. 键值为整数且使用 mystl::less 比较时，节点内查找在 SSE2 下一次比较 4 个 32 位键值，
+//    其他整数类型用无分支的计数循环（可由编译器自动向量化），其余类型用二分查找
+// 4. 在最右的叶子节点尾部追加时，分裂只把新元素放入新节点，有序插入得到的叶子节点都是满的
+// 5. 与 set 不同，任何插入、删除操作都可能使所有迭代器失效
+
+#include <initializer_list>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // btree value traits
+    // 值为 pair 时以 first 为键值，否则值本身即为键值
+    template<class T, bool>
+    struct btree_value_traits_imp {
+        typedef T key_type;
+        typedef T mapped_type;
+        typedef T value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value;
+        }
+    };
+
+    template<class T>
+    struct btree_value_traits_imp<T, true> {
+        typedef typename std::remove_cv<typename T::first_type>::type key_type;
+        typedef typename T::second_type mapped_type;
+        typedef T value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value.first;
+        }
+    };
+
+    template<class T>
+    struct btree_value_traits {
+        static constexpr bool is_map = mystl::is_pair<T>::value;
+
+        typedef btree_value_traits_imp<T, is_map> value_traits_type;
+        typedef typename value_traits_type::key_type key_type;
+        typedef typename value_traits_type::mapped_type mapped_type;
+        typedef typename value_traits_type::value_type value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value_traits_type::get_key(value);
+        }
+    };
+
+    // btree 节点的公共部分
+    struct btree_node_base {
+        btree_node_base *parent;  // 父节点，根节点为空
+        unsigned int position;    // 在父节点 children 中的下标
+        unsigned int count;       // 叶子节点为元素个数，内部节点为键值个数
+        bool leaf;
+    };
+
+    // 叶子节点，元素存放在未初始化的 slots 中，前 count 个已构造
+    template<class T, size_t Slots>
+    struct btree_leaf_node : public btree_node_base {
+        btree_leaf_node *prev;
+        btree_leaf_node *next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[Slots];
+
+        T *values() noexcept { return reinterpret_cast<T *>(slots); }
+
+        const T *values() const noexcept { return reinterpret_cast<const T *>(slots); }
+
+        T &value(size_t i) noexcept { return values()[i]; }
+    };
+
+    // 内部节点，count 个键值和 count + 1 个子节点
+    template<class Key, size_t Slots>
+    struct btree_inner_node : public btree_node_base {
+        typename std::aligned_storage<sizeof(Key), alignof(Key)>::type slots[Slots];
+        btree_node_base *children[Slots + 1];
+
+        Key *keys() noexcept { return reinterpret_cast<Key *>(slots); }
+
+        const Key *keys() const noexcept { return reinterpret_cast<const Key *>(slots); }
+
+        Key &key(size_t i) noexcept { return keys()[i]; }
+    };
+
+    // 节点内查找：有序数组中小于 key（不大于 key）的元素个数
+    // 有序数组中满足条件的元素是一个前缀，遇到第一个不满足的元素即可停止
+    template<class K>
+    size_t btree_count_less(const K *first, size_t n, K key) noexcept {
+        size_t cnt = 0;
+        for (size_t i = 0; i < n; ++i) {
+            cnt += static_cast<size_t>(first[i] < key);
+        }
+        return cnt;
+    }
+
+    template<class K>
+    size_t btree_count_not_greater(const K *first, size_t n, K key) noexcept {
+        size_t cnt = 0;
+        for (size_t i = 0; i < n; ++i) {
+            cnt += static_cast<size_t>(!(key < first[i]));
+        }
+        return cnt;
+    }
+
+#if defined(__SSE2__)
+    // 满足条件的元素是前缀，4 位的 mask 只能是 0、1、3、7、15
+    inline size_t btree_prefix_length(int mask) noexcept {
+        return mask == 0 ? 0 : mask == 1 ? 1 : mask == 3 ? 2 : mask == 7 ? 3 : 4;
+    }
+
+    // 32 位整数一次比较 4 个，无符号数先加偏置转成有符号数比较
+    template<bool Unsigned>
+    size_t btree_simd_count(const void *first, size_t n, unsigned int key, bool or_equal) noexcept {
+        const auto p = static_cast<const unsigned int *>(first);
+        const __m128i bias = _mm_set1_epi32(Unsigned ? static_cast<int>(0x80000000u) : 0);
+        const __m128i k = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(key)), bias);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            const __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i)), bias);
+            const __m128i hit = or_equal ? _mm_andnot_si128(_mm_cmpgt_epi32(v, k), _mm_set1_epi32(-1))
+                                         : _mm_cmplt_epi32(v, k);
+            const int mask = _mm_movemask_ps(_mm_castsi128_ps(hit));
+            if (mask != 0xF) {
+                return i + btree_prefix_length(mask);
+            }
+        }
+        const unsigned int flip = Unsigned ? 0x80000000u : 0;
+        for (; i < n; ++i) {
+            const int a = static_cast<int>(p[i] ^ flip);
+            const int b = static_cast<int>(key ^ flip);
+            if (or_equal ? a > b : a >= b) {
+                break;
+            }
+        }
+        return i;
+    }
+
+    inline size_t btree_count_less(const int *first, size_t n, int key) noexcept {
+        return btree_simd_count<false>(first, n, static_cast<unsigned int>(key), false);
+    }
+
+    inline size_t btree_count_not_greater(const int *first, size_t n, int key) noexcept {
+        return btree_simd_count<false>(first, n, static_cast<unsigned int>(key), true);
+    }
+
+    inline size_t btree_count_less(const unsigned int *first, size_t n, unsigned int key) noexcept {
+        return btree_simd_count<true>(first, n, key, false);
+    }
+
+    inline size_t btree_count_not_greater(const unsigned int *first, size_t n, unsigned int key) noexcept {
+        return btree_simd_count<true>(first, n, key, true);
+    }
+#endif
+
+    // btree 的迭代器，指向叶子节点 node 中下标为 pos 的元素
+    // end() 为（最右叶子节点，元素个数），空树时为（nullptr，0）
+    template<class T, class Ref, class Ptr, class Leaf>
+    struct btree_iterator : public iterator<bidirectional_iterator_tag, T> {
+        typedef btree_iterator<T, T &, T *, Leaf> iterator;
+        typedef btree_iterator<T, const T &, const T *, Leaf> const_iterator;
+        typedef btree_iterator self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        Leaf *node;
+        size_type pos;
+
+        // 构造、复制函数
+        btree_iterator() noexcept: node(nullptr), pos(0) {}
+
+        btree_iterator(Leaf *n, size_type p) noexcept: node(n), pos(p) {}
+
+        btree_iterator(const iterator &rhs) noexcept: node(rhs.node), pos(rhs.pos) {}
+
+        btree_iterator &operator=(const btree_iterator &rhs) = default;
+
+        // 重载操作符
+        reference operator*() const { return node->value(pos); }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self &operator++() {
+            ++pos;
+            if (pos == node->count && node->next != nullptr) {
+                node = node->next;
+                pos = 0;
+            }
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self &operator--() {
+            if (pos == 0) {
+                node = node->prev;
+                pos = node->count;
+            }
+            --pos;
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return node == rhs.node && pos == rhs.pos; }
+
+        bool operator!=(const self &rhs) const { return !(*this == rhs); }
+    };
+
+    // 模板类 btree
+    // 参数一代表元素类型，参数二代表键值比较方式，参数三代表节点的目标字节数
+    template<class T, class Compare, size_t NodeBytes = 256>
+    class btree {
+    public:
+        // btree 的嵌套型别定义
+        typedef btree_value_traits<T> value_traits;
+
+        typedef typename value_traits::key_type key_type;
+        typedef typename value_traits::mapped_type mapped_type;
+        typedef typename value_traits::value_type value_type;
+        typedef Compare key_compare;
+
+        typedef mystl::allocator<T> allocator_type;
+        typedef mystl::allocator<T> data_allocator;
+        typedef mystl::allocator<key_type> key_allocator;
+
+        typedef typename allocator_type::pointer pointer;
+        typedef typename allocator_type::const_pointer const_pointer;
+        typedef typename allocator_type::reference reference;
+        typedef typename allocator_type::const_reference const_reference;
+        typedef typename allocator_type::size_type size_type;
+        typedef typename allocator_type::difference_type difference_type;
+
+        // 每个节点可容纳的元素（键值）个数，由节点的目标字节数决定，至少为 3
+        static constexpr size_type leaf_header = sizeof(btree_node_base) + 2 * sizeof(void *);
+        static constexpr size_type inner_header = sizeof(btree_node_base) + sizeof(void *);
+        static constexpr size_type leaf_slots =
+                NodeBytes > leaf_header + 3 * sizeof(T) ? (NodeBytes - leaf_header) / sizeof(T) : 3;
+        static constexpr size_type inner_slots =
+                NodeBytes > inner_header + 3 * (sizeof(key_type) + sizeof(void *))
+                ? (NodeBytes - inner_header) / (sizeof(key_type) + sizeof(void *)) : 3;
+
+        // 除根节点和最右路径上的节点外，节点至少保留的个数
+        // 内部节点分裂时有一个键值上移，两半共 inner_slots 个键值，因此下限为 (inner_slots - 1) / 2
+        static constexpr size_type min_leaf = leaf_slots / 2;
+        static constexpr size_type min_inner = (inner_slots - 1) / 2;
+
+        typedef btree_leaf_node<T, leaf_slots> leaf_node;
+        typedef btree_inner_node<key_type, inner_slots> inner_node;
+        typedef btree_node_base *base_ptr;
+        typedef leaf_node *leaf_ptr;
+        typedef inner_node *inner_ptr;
+
+        typedef mystl::allocator<leaf_node> leaf_allocator;
+        typedef mystl::allocator<inner_node> inner_allocator;
+
+        typedef btree_iterator<T, T &, T *, leaf_node> iterator;
+        typedef btree_iterator<T, const T &, const T *, leaf_node> const_iterator;
+        typedef mystl::reverse_iterator<iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        allocator_type get_allocator() const { return allocator_type(); }
+
+        key_compare key_comp() const { return key_comp_; }
+
+    private:
+        // 键值为整数且使用 mystl::less 时，节点内查找用 btree_count_less / btree_count_not_greater
+        typedef m_bool_constant<std::is_integral<key_type>::value &&
+                                std::is_same<key_compare, mystl::less<key_type>>::value> inner_simd;
+        typedef m_bool_constant<inner_simd::value && !value_traits::is_map> leaf_simd;
+
+        base_ptr root_;        // 根节点，空树时为空
+        leaf_ptr leftmost_;    // 最左的叶子节点
+        leaf_ptr rightmost_;   // 最右的叶子节点
+        size_type node_count_; // 元素个数
+        key_compare key_comp_; // 键值比较的准则
+
+    public:
+        // 构造、复制、移动、析构函数
+        btree() noexcept: root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0), key_comp_() {}
+
+        btree(const btree &rhs);
+
+        btree(btree &&rhs) noexcept
+                : root_(rhs.root_), leftmost_(rhs.leftmost_), rightmost_(rhs.rightmost_),
+                  node_count_(rhs.node_count_), key_comp_(rhs.key_comp_) {
+            rhs.root_ = nullptr;
+            rhs.leftmost_ = nullptr;
+            rhs.rightmost_ = nullptr;
+            rhs.node_count_ = 0;
+        }
+
+        btree &operator=(const btree &rhs);
+
+        btree &operator=(btree &&rhs) noexcept {
+            btree tmp(mystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        ~btree() { clear(); }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return iterator(leftmost_, 0); }
+
+        const_iterator begin() const noexcept { return const_iterator(leftmost_, 0); }
+
+        iterator end() noexcept { return iterator(rightmost_, rightmost_ == nullptr ? 0 : rightmost_->count); }
+
+        const_iterator end() const noexcept {
+            return const_iterator(rightmost_, rightmost_ == nullptr ? 0 : rightmost_->count);
+        }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return node_count_ == 0; }
+
+        size_type size() const noexcept { return node_count_; }
+
+        size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+        // 插入删除相关操作
+        template<class ...Args>
+        iterator emplace_multi(Args &&...args);
+
+        template<class ...Args>
+        mystl::pair<iterator, bool> emplace_unique(Args &&...args);
+
+        // btree 的查找路径很短，hint 只为与 set 的接口一致，不参与定位
+        template<class ...Args>
+        iterator emplace_multi_use_hint(const_iterator, Args &&...args) {
+            return emplace_multi(mystl::forward<Args>(args)...);
+        }
+
+        template<class ...Args>
+        iterator emplace_unique_use_hint(const_iterator, Args &&...args) {
+            return emplace_unique(mystl::forward<Args>(args)...).first;
+        }
+
+        iterator insert_multi(const value_type &value) { return emplace_multi(value); }
+
+        iterator insert_multi(value_type &&value) { return emplace_multi(mystl::move(value)); }
+
+        iterator insert_multi(const_iterator hint, const value_type &value) {
+            return emplace_multi_use_hint(hint, value);
+        }
+
+        iterator insert_multi(const_iterator hint, value_type &&value) {
+            return emplace_multi_use_hint(hint, mystl::move(value));
+        }
+
+        // 有序输入每次都追加到最右的叶子节点，不需要从根节点查找
+        template<class InputIterator>
+        void insert_multi(InputIterator first, InputIterator last) {
+            for (; first != last; ++first)
+                emplace_multi(*first);
+        }
+
+        mystl::pair<iterator, bool> insert_unique(const value_type &value) { return emplace_unique(value); }
+
+        mystl::pair<iterator, bool> insert_unique(value_type &&value) { return emplace_unique(mystl::move(value)); }
+
+        iterator insert_unique(const_iterator hint, const value_type &value) {
+            return emplace_unique_use_hint(hint, value);
+        }
+
+        iterator insert_unique(const_iterator hint, value_type &&value) {
+            return emplace_unique_use_hint(hint, mystl::move(value));
+        }
+
+        template<class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            for (; first != last; ++first)
+                emplace_unique(*first);
+        }
+
+        // erase 返回被删除元素的下一个位置
+        iterator erase(const_iterator position);
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        size_type erase_multi(const key_type &key);
+
+        size_type erase_unique(const key_type &key);
+
+        void clear();
+
+        // btree 相关操作
+        iterator find(const key_type &key);
+
+        const_iterator find(const key_type &key) const;
+
+        size_type count_multi(const key_type &key) const {
+            auto p = equal_range_multi(key);
+            return static_cast<size_type>(mystl::distance(p.first, p.second));
+        }
+
+        size_type count_unique(const key_type &key) const {
+            return find(key) != end() ? 1 : 0;
+        }
+
+        iterator lower_bound(const key_type &key) { return make_iterator(lower_bound_pos(key)); }
+
+        const_iterator lower_bound(const key_type &key) const { return make_iterator(lower_bound_pos(key)); }
+
+        iterator upper_bound(const key_type &key) { return make_iterator(upper_bound_pos(key)); }
+
+        const_iterator upper_bound(const key_type &key) const { return make_iterator(upper_bound_pos(key)); }
+
+        mystl::pair<iterator, iterator>
+        equal_range_multi(const key_type &key) {
+            return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        mystl::pair<const_iterator, const_iterator>
+        equal_range_multi(const key_type &key) const {
+            return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        mystl::pair<iterator, iterator>
+        equal_range_unique(const key_type &key) {
+            iterator it = find(key);
+            auto next = it;
+            return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+        }
+
+        mystl::pair<const_iterator, const_iterator>
+        equal_range_unique(const key_type &key) const {
+            const_iterator it = find(key);
+            auto next = it;
+            return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+        }
+
+        void swap(btree &rhs) noexcept {
+            mystl::swap(root_, rhs.root_);
+            mystl::swap(leftmost_, rhs.leftmost_);
+            mystl::swap(rightmost_, rhs.rightmost_);
+            mystl::swap(node_count_, rhs.node_count_);
+            mystl::swap(key_comp_, rhs.key_comp_);
+        }
+
+    private:
+        // helper functions
+
+        // 叶子节点中的位置
+        struct leaf_pos {
+            leaf_ptr node;
+            size_type pos;
+        };
+
+        static leaf_ptr as_leaf(base_ptr x) noexcept { return static_cast<leaf_ptr>(x); }
+
+        static inner_ptr as_inner(base_ptr x) noexcept { return static_cast<inner_ptr>(x); }
+
+        // 位于叶子节点尾部的位置转到下一个叶子节点的开头，最右叶子节点的尾部即为 end()
+        static leaf_pos normalize(leaf_ptr node, size_type pos) noexcept {
+            if (node != nullptr && pos == node->count && node->next != nullptr) {
+                return leaf_pos{node->next, 0};
+            }
+            return leaf_pos{node, pos};
+        }
+
+        iterator make_iterator(leaf_pos p) noexcept { return iterator(p.node, p.pos); }
+
+        const_iterator make_iterator(leaf_pos p) const noexcept { return const_iterator(p.node, p.pos); }
+
+        // 节点内查找
+        template<class U, class GetKey>
+        size_type search_lower(const U *first, size_type n, const key_type &key, GetKey get_key, m_false_type) const;
+
+        template<class U, class GetKey>
+        size_type search_upper(const U *first, size_type n, const key_type &key, GetKey get_key, m_false_type) const;
+
+        template<class U, class GetKey>
+        size_type search_lower(const U *first, size_type n, const key_type &key, GetKey, m_true_type) const {
+            return btree_count_less(first, n, key);
+        }
+
+        template<class U, class GetKey>
+        size_type search_upper(const U *first, size_type n, const key_type &key, GetKey, m_true_type) const {
+            return btree_count_not_greater(first, n, key);
+        }
+
+        struct key_of_key {
+            const key_type &operator()(const key_type &key) const { return key; }
+        };
+
+        struct key_of_value {
+            const key_type &operator()(const value_type &value) const { return value_traits::get_key(value); }
+        };
+
+        // 从根节点查找到叶子节点，upper 为 true 时查找第一个大于 key 的位置，否则查找第一个不小于 key 的位置
+        leaf_pos descend(const key_type &key, bool upper) const;
+
+        leaf_pos lower_bound_pos(const key_type &key) const { return normalize_pos(descend(key, false)); }
+
+        leaf_pos upper_bound_pos(const key_type &key) const { return normalize_pos(descend(key, true)); }
+
+        static leaf_pos normalize_pos(leaf_pos p) noexcept { return normalize(p.node, p.pos); }
+
+        // 节点的分配与释放
+        leaf_ptr create_leaf();
+
+        inner_ptr create_inner();
+
+        void destroy_subtree(base_ptr x) noexcept;
+
+        // 在 p 位置放入 value，必要时分裂叶子节点，返回新元素的位置
+        leaf_pos insert_at(leaf_pos p, value_type &&value);
+
+        // 分裂叶子节点前先分配好沿途分裂所需的所有节点，分配失败时树保持不变
+        size_type reserve_split(leaf_ptr x, inner_ptr *spare);
+
+        // 分裂后把分隔键值 key 和新的右兄弟 right 插入 left 的父节点，append 表示沿最右路径追加
+        void insert_into_parent(base_ptr left, const key_type &key, base_ptr right, bool append, inner_ptr *spare);
+
+        void inner_insert(inner_ptr x, size_type i, const key_type &key, base_ptr child);
+
+        void inner_remove(inner_ptr x, size_type i) noexcept;
+
+        void set_child(inner_ptr x, size_type i, base_ptr child) noexcept {
+            x->children[i] = child;
+            child->parent = x;
+            child->position = static_cast<unsigned int>(i);
+        }
+
+        // 删除后节点元素过少时向兄弟节点借或与兄弟节点合并
+        leaf_pos rebalance_leaf(leaf_ptr x, size_type pos);
+
+        void rebalance_inner(inner_ptr x);
+
+        void unlink_leaf(leaf_ptr x) noexcept;
+
+        // 未初始化空间上的元素移动
+        template<class U>
+        static void slot_insert(U *first, size_type n, size_type pos, U &&value);
+
+        template<class U>
+        static void slot_erase(U *first, size_type n, size_type pos) noexcept;
+
+        template<class U>
+        static void slot_move(U *dst, U *src, size_type n) noexcept;
+
+        // 复制 rhs 的所有元素，rhs 有序，逐个追加到最右的叶子节点
+        void copy_from(const btree &rhs);
+
+    public:
+        friend bool operator==(const btree &lhs, const btree &rhs) {
+            return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator<(const btree &lhs, const btree &rhs) {
+            return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+    };
+
+    template<class T, class Compare, size_t NodeBytes>
+    constexpr typename btree<T, Compare, NodeBytes>::size_type btree<T, Compare, NodeBytes>::leaf_header;
+
+    template<class T, class Compare, size_t NodeBytes>
+    constexpr typename btree<T, Compare, NodeBytes>::size_type btree<T, Compare, NodeBytes>::inner_header;
+
+    template<class T, class Compare, size_t NodeBytes>
+    constexpr typename btree<T, Compare, NodeBytes>::size_type btree<T, Compare, NodeBytes>::leaf_slots;
+
+    template<class T, class Compare, size_t NodeBytes>
+    constexpr typename btree<T, Compare, NodeBytes>::size_type btree<T, Compare, NodeBytes>::inner_slots;
+
+    template<class T, class Compare, size_t NodeBytes>
+    constexpr typename btree<T, Compare, NodeBytes>::size_type btree<T, Compare, NodeBytes>::min_leaf;
+
+    template<class T, class Compare, size_t NodeBytes>
+    constexpr typename btree<T, Compare, NodeBytes>::size_type btree<T, Compare, NodeBytes>::min_inner;
+
+/*****************************************************************************************/
+
+// 复制构造函数
+    template<class T, class Compare, size_t NodeBytes>
+    btree<T, Compare, NodeBytes>::
+    btree(const btree &rhs)
+            : root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0), key_comp_(rhs.key_comp_) {
+        try {
+            copy_from(rhs);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+// 复制赋值操作符
+    template<class T, class Compare, size_t NodeBytes>
+    btree<T, Compare, NodeBytes> &
+    btree<T, Compare, NodeBytes>::
+    operator=(const btree &rhs) {
+        if (this != &rhs) {
+            btree tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+// 就地插入元素，键值允许重复，插入到相等元素之后
+    template<class T, class Compare, size_t NodeBytes>
+    template<class ...Args>
+    typename btree<T, Compare, NodeBytes>::iterator
+    btree<T, Compare, NodeBytes>::
+    emplace_multi(Args &&...args) {
+        THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "btree<T, Comp>'s size too big");
+        value_type value(mystl::forward<Args>(args)...);
+        const key_type &key = value_traits::get_key(value);
+        leaf_pos p;
+        if (rightmost_ != nullptr &&
+            !key_comp_(key, value_traits::get_key(rightmost_->value(rightmost_->count - 1)))) {
+            // 不小于最大元素，直接追加
+            p = leaf_pos{rightmost_, rightmost_->count};
+        } else {
+            p = descend(key, true);
+        }
+        return make_iterator(insert_at(p, mystl::move(value)));
+    }
+
+// 就地插入元素，键值不允许重复
+    template<class T, class Compare, size_t NodeBytes>
+    template<class ...Args>
+    mystl::pair<typename btree<T, Compare, NodeBytes>::iterator, bool>
+    btree<T, Compare, NodeBytes>::
+    emplace_unique(Args &&...args) {
+        THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "btree<T, Comp>'s size too big");
+        value_type value(mystl::forward<Args>(args)...);
+        const key_type &key = value_traits::get_key(value);
+        leaf_pos p;
+        if (rightmost_ != nullptr &&
+            key_comp_(value_traits::get_key(rightmost_->value(rightmost_->count - 1)), key)) {
+            // 大于最大元素，直接追加
+            p = leaf_pos{rightmost_, rightmost_->count};
+        } else {
+            p = descend(key, false);
+            auto q = normalize_pos(p);
+            if (q.node != nullptr && q.pos != q.node->count &&
+                !key_comp_(key, value_traits::get_key(q.node->value(q.pos)))) {
+                // 键值重复
+                return mystl::make_pair(make_iterator(q), false);
+            }
+        }
+        return mystl::make_pair(make_iterator(insert_at(p, mystl::move(value))), true);
+    }
+
+// 删除 position 位置的元素
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::iterator
+    btree<T, Compare, NodeBytes>::
+    erase(const_iterator position) {
+        auto x = position.node;
+        const size_type pos = position.pos;
+        slot_erase(x->values(), x->count, pos);
+        --x->count;
+        --node_count_;
+        return make_iterator(rebalance_leaf(x, pos));
+    }
+
+// 删除 [first, last) 区间内的元素
+// 删除会移动元素，last 随之失效，因此先算出个数
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::iterator
+    btree<T, Compare, NodeBytes>::
+    erase(const_iterator first, const_iterator last) {
+        if (first == begin() && last == end()) {
+            clear();
+            return end();
+        }
+        auto n = mystl::distance(first, last);
+        iterator it(first.node, first.pos);
+        for (; n > 0; --n) {
+            it = erase(it);
+        }
+        return it;
+    }
+
+// 删除键值等于 key 的元素，返回删除的个数
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::size_type
+    btree<T, Compare, NodeBytes>::
+    erase_multi(const key_type &key) {
+        auto p = equal_range_multi(key);
+        const size_type n = static_cast<size_type>(mystl::distance(p.first, p.second));
+        erase(p.first, p.second);
+        return n;
+    }
+
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::size_type
+    btree<T, Compare, NodeBytes>::
+    erase_unique(const key_type &key) {
+        auto it = find(key);
+        if (it != end()) {
+            erase(it);
+            return 1;
+        }
+        return 0;
+    }
+
+// 清空 btree
+    template<class T, class Compare, size_t NodeBytes>
+    void btree<T, Compare, NodeBytes>::
+    clear() {
+        if (root_ != nullptr) {
+            destroy_subtree(root_);
+            root_ = nullptr;
+            leftmost_ = nullptr;
+            rightmost_ = nullptr;
+            node_count_ = 0;
+        }
+    }
+
+// 查找键值为 key 的元素，返回指向它的迭代器
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::iterator
+    btree<T, Compare, NodeBytes>::
+    find(const key_type &key) {
+        auto p = lower_bound_pos(key);
+        return (p.node == nullptr || p.pos == p.node->count ||
+                key_comp_(key, value_traits::get_key(p.node->value(p.pos)))) ? end() : make_iterator(p);
+    }
+
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::const_iterator
+    btree<T, Compare, NodeBytes>::
+    find(const key_type &key) const {
+        auto p = lower_bound_pos(key);
+        return (p.node == nullptr || p.pos == p.node->count ||
+                key_comp_(key, value_traits::get_key(p.node->value(p.pos)))) ? end() : make_iterator(p);
+    }
+
+/*****************************************************************************************/
+// helper function
+
+// 二分查找第一个不小于 key 的下标
+    template<class T, class Compare, size_t NodeBytes>
+    template<class U, class GetKey>
+    typename btree<T, Compare, NodeBytes>::size_type
+    btree<T, Compare, NodeBytes>::
+    search_lower(const U *first, size_type n, const key_type &key, GetKey get_key, m_false_type) const {
+        size_type lo = 0, hi = n;
+        while (lo < hi) {
+            const size_type mid = lo + (hi - lo) / 2;
+            if (key_comp_(get_key(first[mid]), key)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+// 二分查找第一个大于 key 的下标
+    template<class T, class Compare, size_t NodeBytes>
+    template<class U, class GetKey>
+    typename btree<T, Compare, NodeBytes>::size_type
+    btree<T, Compare, NodeBytes>::
+    search_upper(const U *first, size_type n, const key_type &key, GetKey get_key, m_false_type) const {
+        size_type lo = 0, hi = n;
+        while (lo < hi) {
+            const size_type mid = lo + (hi - lo) / 2;
+            if (key_comp_(key, get_key(first[mid]))) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lo;
+    }
+
+// 从根节点查找到叶子节点
+// 查找 lower_bound 时进入第一个不小于 key 的分隔键值左边的子树，之前子树中的键值都小于 key；
+// 查找 upper_bound 时进入第一个大于 key 的分隔键值左边的子树，之前子树中的键值都不大于 key
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::leaf_pos
+    btree<T, Compare, NodeBytes>::
+    descend(const key_type &key, bool upper) const {
+        if (root_ == nullptr) {
+            return leaf_pos{nullptr, 0};
+        }
+        auto x = root_;
+        while (!x->leaf) {
+            auto inner = as_inner(x);
+            const size_type i = upper
+                                ? search_upper(inner->keys(), inner->count, key, key_of_key(), inner_simd())
+                                : search_lower(inner->keys(), inner->count, key, key_of_key(), inner_simd());
+            x = inner->children[i];
+        }
+        auto leaf = as_leaf(x);
+        const size_type pos = upper
+                              ? search_upper(leaf->values(), leaf->count, key, key_of_value(), leaf_simd())
+                              : search_lower(leaf->values(), leaf->count, key, key_of_value(), leaf_simd());
+        return leaf_pos{leaf, pos};
+    }
+
+// 分配一个空的叶子节点
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::leaf_ptr
+    btree<T, Compare, NodeBytes>::
+    create_leaf() {
+        auto x = leaf_allocator::allocate(1);
+        x->parent = nullptr;
+        x->position = 0;
+        x->count = 0;
+        x->leaf = true;
+        x->prev = nullptr;
+        x->next = nullptr;
+        return x;
+    }
+
+// 分配一个空的内部节点
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::inner_ptr
+    btree<T, Compare, NodeBytes>::
+    create_inner() {
+        auto x = inner_allocator::allocate(1);
+        x->parent = nullptr;
+        x->position = 0;
+        x->count = 0;
+        x->leaf = false;
+        return x;
+    }
+
+// 析构并释放 x 及其子树
+    template<class T, class Compare, size_t NodeBytes>
+    void btree<T, Compare, NodeBytes>::
+    destroy_subtree(base_ptr x) noexcept {
+        if (x->leaf) {
+            auto leaf = as_leaf(x);
+            data_allocator::destroy(leaf->values(), leaf->values() + leaf->count);
+            leaf_allocator::deallocate(leaf);
+            return;
+        }
+        auto inner = as_inner(x);
+        for (size_type i = 0; i <= inner->count; ++i) {
+            destroy_subtree(inner->children[i]);
+        }
+        key_allocator::destroy(inner->keys(), inner->keys() + inner->count);
+        inner_allocator::deallocate(inner);
+    }
+
+// 在 p 位置放入 value
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::leaf_pos
+    btree<T, Compare, NodeBytes>::
+    insert_at(leaf_pos p, value_type &&value) {
+        auto x = p.node;
+        if (x == nullptr) {
+            // 空树
+            x = create_leaf();
+            root_ = leftmost_ = rightmost_ = x;
+        }
+        if (x->count < leaf_slots) {
+            slot_insert(x->values(), x->count, p.pos, mystl::move(value));
+            ++x->count;
+            ++node_count_;
+            return leaf_pos{x, p.pos};
+        }
+        // 叶子节点已满，分裂出右兄弟；在最右的叶子节点尾部追加时右兄弟只放新元素
+        const bool append = x == rightmost_ && p.pos == x->count;
+        const size_type mid = append ? x->count : x->count / 2;
+        inner_ptr spare[sizeof(size_type) * 8];
+        const size_type nspare = reserve_split(x, spare);
+        leaf_ptr right = nullptr;
+        try {
+            right = create_leaf();
+        } catch (...) {
+            for (size_type i = 0; i < nspare; ++i) {
+                inner_allocator::deallocate(spare[i]);
+            }
+            throw;
+        }
+        slot_move(right->values(), x->values() + mid, x->count - mid);
+        right->count = static_cast<unsigned int>(x->count - mid);
+        x->count = static_cast<unsigned int>(mid);
+        right->prev = x;
+        right->next = x->next;
+        if (x->next != nullptr) {
+            x->next->prev = right;
+        } else {
+            rightmost_ = right;
+        }
+        x->next = right;
+
+        leaf_pos result = p.pos < mid ? leaf_pos{x, p.pos} : leaf_pos{right, p.pos - mid};
+        slot_insert(result.node->values(), result.node->count, result.pos, mystl::move(value));
+        ++result.node->count;
+        ++node_count_;
+        insert_into_parent(x, value_traits::get_key(right->value(0)), right, append, spare);
+        return result;
+    }
+
+// 叶子节点 x 分裂时，已满的祖先节点都要分裂，祖先全满时还需要新的根节点
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::size_type
+    btree<T, Compare, NodeBytes>::
+    reserve_split(leaf_ptr x, inner_ptr *spare) {
+        size_type n = 0;
+        auto p = as_inner(x->parent);
+        while (p != nullptr && p->count == inner_slots) {
+            ++n;
+            p = as_inner(p->parent);
+        }
+        if (p == nullptr) {
+            ++n;
+        }
+        size_type i = 0;
+        try {
+            for (; i < n; ++i) {
+                spare[i] = create_inner();
+            }
+        } catch (...) {
+            while (i > 0) {
+                inner_allocator::deallocate(spare[--i]);
+            }
+            throw;
+        }
+        return n;
+    }
+
+// 把分隔键值 key 和 left 的新右兄弟 right 插入父节点，父节点已满时继续向上分裂
+    template<class T, class Compare, size_t NodeBytes>
+    void btree<T, Compare, NodeBytes>::
+    insert_into_parent(base_ptr left, const key_type &key, base_ptr right, bool append, inner_ptr *spare) {
+        auto parent = as_inner(left->parent);
+        if (parent == nullptr) {
+            // left 为根节点，树长高一层
+            auto root = *spare;
+            key_allocator::construct(root->keys(), key);
+            root->count = 1;
+            set_child(root, 0, left);
+            set_child(root, 1, right);
+            root_ = root;
+            return;
+        }
+        const size_type i = left->position;
+        if (parent->count < inner_slots) {
+            inner_insert(parent, i, key, right);
+            return;
+        }
+        // 父节点已满，以 mid 处的键值为界分裂，该键值上移到祖父节点
+        const size_type n = parent->count;
+        const size_type mid = append ? n - 1 : n / 2;
+        auto sibling = *spare++;
+        slot_move(sibling->keys(), parent->keys() + mid + 1, n - mid - 1);
+        for (size_type j = mid + 1; j <= n; ++j) {
+            set_child(sibling, j - mid - 1, parent->children[j]);
+        }
+        sibling->count = static_cast<unsigned int>(n - mid - 1);
+        key_type up(mystl::move(parent->key(mid)));
+        key_allocator::destroy(parent->keys() + mid);
+        parent->count = static_cast<unsigned int>(mid);
+        if (i <= mid) {
+            inner_insert(parent, i, key, right);
+        } else {
+            inner_insert(sibling, i - mid - 1, key, right);
+        }
+        insert_into_parent(parent, up, sibling, append, spare);
+    }
+
+// 在内部节点 x 的第 i 个键值处插入 key，child 成为第 i + 1 个子节点
+    template<class T, class Compare, size_t NodeBytes>
+    void btree<T, Compare, NodeBytes>::
+    inner_insert(inner_ptr x, size_type i, const key_type &key, base_ptr child) {
+        key_type tmp(key);
+        slot_insert(x->keys(), x->count, i, mystl::move(tmp));
+        for (size_type j = x->count + 1; j > i + 1; --j) {
+            set_child(x, j, x->children[j - 1]);
+        }
+        set_child(x, i + 1, child);
+        ++x->count;
+    }
+
+// 删除内部节点 x 的第 i 个键值和第 i + 1 个子节点
+    template<class T, class Compare, size_t NodeBytes>
+    void btree<T, Compare, NodeBytes>::
+    inner_remove(inner_ptr x, size_type i) noexcept {
+        slot_erase(x->keys(), x->count, i);
+        for (size_type j = i + 1; j < x->count; ++j) {
+            set_child(x, j, x->children[j + 1]);
+        }
+        --x->count;
+    }
+
+// 叶子节点 x 删除了 pos 处的元素后重新平衡，返回原来 pos 处之后那个元素的新位置
+    template<class T, class Compare, size_t NodeBytes>
+    typename btree<T, Compare, NodeBytes>::leaf_pos
+    btree<T, Compare, NodeBytes>::
+    rebalance_leaf(leaf_ptr x, size_type pos) {
+        if (x == root_) {
+            if (x->count == 0) {
+                leaf_allocator::deallocate(x);
+                root_ = leftmost_ = rightmost_ = nullptr;
+                return leaf_pos{nullptr, 0};
+            }
+            return normalize(x, pos);
+        }
+        if (x->count >= min_leaf) {
+            return normalize(x, pos);
+        }
+        auto parent = as_inner(x->parent);
+        const size_type i = x->position;
+        auto left = i > 0 ? as_leaf(parent->children[i - 1]) : nullptr;
+        auto right = i < parent->count ? as_leaf(parent->children[i + 1]) : nullptr;
+        if (left != nullptr && left->count > min_leaf) {
+            // 从左兄弟借最大的元素
+            slot_insert(x->values(), x->count, 0, mystl::move(left->value(left->count - 1)));
+            ++x->count;
+            slot_erase(left->values(), left->count, left->count - 1);
+            --left->count;
+            parent->key(i - 1) = value_traits::get_key(x->value(0));
+            return normalize(x, pos + 1);
+        }
+        if (right != nullptr && right->count > min_leaf) {
+            // 从右兄弟借最小的元素
+            slot_insert(x->values(), x->count, x->count, mystl::move(right->value(0)));
+            ++x->count;
+            slot_erase(right->values(), right->count, 0);
+            --right->count;
+            parent->key(i) = value_traits::get_key(right->value(0));
+            return normalize(x, pos);
+        }
+        if (left != nullptr) {
+            // 并入左兄弟
+            const size_type offset = left->count;
+            slot_move(left->values() + offset, x->values(), x->count);
+            left->count += x->count;
+            unlink_leaf(x);
+            leaf_allocator::deallocate(x);
+            inner_remove(parent, i - 1);
+            rebalance_inner(parent);
+            return normalize(left, offset + pos);
+        }
+        // 右兄弟并入本节点
+        slot_move(x->values() + x->count, right->values(), right->count);
+        x->count += right->count;
+        unlink_leaf(right);
+        leaf_allocator::deallocate(right);
+        inner_remove(parent, i);
+        rebalance_inner(parent);
+        return normalize(x, pos);
+    }
+
+// 内部节点 x 删除了一个键值后重新平衡，必要时逐层向上
+    template<class T, class Compare, size_t NodeBytes>
+    void btree<T, Compare, NodeBytes>::
+    rebalance_inner(inner_ptr x) {
+        while (true) {
+            if (x == root_) {
+                if (x->count == 0) {
+                    // 根节点只剩一个子节点，树降低一层
+                    root_ = x->children[0];
+                    root_->parent = nullptr;
+                    root_->position = 0;
+                    inner_allocator::deallocate(x);
+                }
+                return;
+            }
+            if (x->count >= min_inner) {
+                return;
+            }
+            auto parent = as_inner(x->parent);
+            const size_type i = x->position;
+            auto left = i > 0 ? as_inner(parent->children[i - 1]) : nullptr;
+            auto right = i < parent->count ? as_inner(parent->children[i + 1]) : nullptr;
+            if (left != nullptr && left->count > min_inner) {
+                // 经父节点向右旋转：父节点的键值下移到本节点开头，左兄弟最大的键值上移
+                key_type down(parent->key(i - 1));
+                slot_insert(x->keys(), x->count, 0, mystl::move(down));
+                for (size_type j = x->count + 1; j > 0; --j) {
+                    set_child(x, j, x->children[j - 1]);
+                }
+                set_child(x, 0, left->children[left->count]);
+                ++x->count;
+                parent->key(i - 1) = mystl::move(left->key(left->count - 1));
+                slot_erase(left->keys(), left->count, left->count - 1);
+                --left->count;
+                return;
+            }
+            if (right != nullptr && right->count > min_inner) {
+                // 经父节点向左旋转
+                key_type down(parent->key(i));
+                slot_insert(x->keys(), x->count, x->count, mystl::move(down));
+                set_child(x, x->count + 1, right->children[0]);
+                ++x->count;
+                parent->key(i) = mystl::move(right->key(0));
+                slot_erase(right->keys(), right->count, 0);
+                for (size_type j = 0; j < right->count; ++j) {
+                    set_child(right, j, right->children[j + 1]);
+                }
+                --right->count;
+                return;
+            }
+            // 与兄弟节点合并，父节点的分隔键值下移
+            auto dst = left != nullptr ? left : x;
+            auto src = left != nullptr ? x : right;
+            const size_type sep = left != nullptr ? i - 1 : i;
+            key_type down(parent->key(sep));
+            slot_insert(dst->keys(), dst->count, dst->count, mystl::move(down));
+            ++dst->count;
+            slot_move(dst->keys() + dst->count, src->keys(), src->count);
+            for (size_type j = 0; j <= src->count; ++j) {
+                set_child(dst, dst->count + j, src->children[j]);
+            }
+            dst->count += src->count;
+            inner_allocator::deallocate(src);
+            inner_remove(parent, sep);
+            x = parent;
+        }
+    }
+
+// 从叶子节点链表中摘下 x
+    template<class T, class Compare, size_t NodeBytes>
+    void btree<T, Compare, NodeBytes>::
+    unlink_leaf(leaf_ptr x) noexcept {
+        if (x->prev != nullptr) {
+            x->prev->next = x->next;
+        } else {
+            leftmost_ = x->next;
+        }
+        if (x->next != nullptr) {
+            x->next->prev = x->prev;
+        } else {
+            rightmost_ = x->prev;
+        }
+    }
+
+// 在含 n 个元素的数组的 pos 处插入 value，数组尾部有未初始化的空间
+    template<class T, class Compare, size_t NodeBytes>
+    template<class U>
+    void btree<T, Compare, NodeBytes>::
+    slot_insert(U *first, size_type n, size_type pos, U &&value) {
+        if (pos == n) {
+            mystl::allocator<U>::construct(first + n, mystl::move(value));
+            return;
+        }
+        mystl::allocator<U>::construct(first + n, mystl::move(first[n - 1]));
+        mystl::move_backward(first + pos, first + n - 1, first + n);
+        first[pos] = mystl::move(value);
+    }
+
+// 删除含 n 个元素的数组 pos 处的元素
+    template<class T, class Compare, size_t NodeBytes>
+    template<class U>
+    void btree<T, Compare, NodeBytes>::
+    slot_erase(U *first, size_type n, size_type pos) noexcept {
+        mystl::move(first + pos + 1, first + n, first + pos);
+        mystl::allocator<U>::destroy(first + n - 1);
+    }
+
+// 把 src 的 n 个元素移动到未初始化的 dst，并析构 src
+    template<class T, class Compare, size_t NodeBytes>
+    template<class U>
+    void btree<T, Compare, NodeBytes>::
+    slot_move(U *dst, U *src, size_type n) noexcept {
+        for (size_type i = 0; i < n; ++i) {
+            mystl::allocator<U>::construct(dst + i, mystl::move(src[i]));
+            mystl::allocator<U>::destroy(src + i);
+        }
+    }
+
+// 复制 rhs 的所有元素
+    template<class T, class Compare, size_t NodeBytes>
+    void btree<T, Compare, NodeBytes>::
+    copy_from(const btree &rhs) {
+        for (auto it = rhs.begin(); it != rhs.end(); ++it) {
+            value_type value(*it);
+            insert_at(leaf_pos{rightmost_, rightmost_ == nullptr ? 0 : rightmost_->count}, mystl::move(value));
+        }
+    }
+
+    // 重载比较操作符
+    template<class T, class Compare, size_t NodeBytes>
+    bool operator!=(const btree<T, Compare, NodeBytes> &lhs, const btree<T, Compare, NodeBytes> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, class Compare, size_t NodeBytes>
+    bool operator>(const btree<T, Compare, NodeBytes> &lhs, const btree<T, Compare, NodeBytes> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, class Compare, size_t NodeBytes>
+    bool operator<=(const btree<T, Compare, NodeBytes> &lhs, const btree<T, Compare, NodeBytes> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, class Compare, size_t NodeBytes>
+    bool operator>=(const btree<T, Compare, NodeBytes> &lhs, const btree<T, Compare, NodeBytes> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class T, class Compare, size_t NodeBytes>
+    void swap(btree<T, Compare, NodeBytes> &lhs, btree<T, Compare, NodeBytes> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_BTREE_H_
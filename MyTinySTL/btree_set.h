@@ -0,0 +1,452 @@
+#ifndef MYTINYSTL_BTREE_SET_H_
+#define MYTINYSTL_BTREE_SET_H_
+
+// 这个头文件包含两个模板类 btree_set 和 btree_multiset
+// btree_set      : 以 B+ 树实现的集合，接口与 set 相同，键值不允许重复
+// btree_multiset : 以 B+ 树实现的集合，接口与 multiset 相同，键值允许重复
+
+// notes:
+//
+// 1. 每个节点存放多个元素，节点大小由模板参数 NodeBytes 决定，缺省 256 字节（4 条 cache line），
+//    数据量远大于 cache 时可调大到页的大小；树高和查找时的 cache miss 都远少于 set
+// 2. 与 set 不同，任何插入、删除操作都会使所有迭代器失效
+//
+// 异常保证：
+// mystl::btree_set<Key> / mystl::btree_multiset<Key> 满足基本异常保证，键值的复制、移动不抛出异常时，
+// 对以下等函数做强异常安全保证：
+//   * emplace
+//   * emplace_hint
+//   * insert（单个元素）
+
+#include "btree.h"
+
+namespace mystl {
+    // 模板类 btree_set，键值不允许重复
+    // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，参数三代表节点的目标字节数
+    template<class Key, class Compare = mystl::less<Key>, size_t NodeBytes = 256>
+    class btree_set {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+    private:
+        // 以 mystl::btree 作为底层机制
+        typedef mystl::btree<value_type, key_compare, NodeBytes> base_type;
+        base_type tree_;
+
+    public:
+        // 使用 btree 定义的类型
+        typedef typename base_type::const_pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::const_reference reference;
+        typedef typename base_type::const_reference const_reference;
+        typedef typename base_type::const_iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef typename base_type::const_reverse_iterator reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::allocator_type allocator_type;
+
+    public:
+        // 构造、复制、移动函数
+        btree_set() = default;
+
+        template<class InputIterator>
+        btree_set(InputIterator first, InputIterator last) :tree_() {
+            // 不重复的插入
+            tree_.insert_unique(first, last);
+        }
+
+        btree_set(std::initializer_list<value_type> ilist) : tree_() {
+            // 不重复的插入
+            tree_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        btree_set(const btree_set &rhs) : tree_(rhs.tree_) {}
+
+        btree_set(btree_set &&rhs) noexcept: tree_(mystl::move(rhs.tree_)) {}
+
+        btree_set &operator=(const btree_set &rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        btree_set &operator=(btree_set &&rhs) {
+            tree_ = mystl::move(rhs.tree_);
+            return *this;
+        }
+
+        btree_set &operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            tree_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // 相关接口，通过调用 btree 中的函数实现
+        key_compare key_comp() const { return tree_.key_comp(); }
+
+        value_compare value_comp() const { return tree_.key_comp(); }
+
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+        // 迭代器相关
+        iterator begin() noexcept { return tree_.begin(); }
+
+        const_iterator begin() const noexcept { return tree_.begin(); }
+
+        iterator end() noexcept { return tree_.end(); }
+
+        const_iterator end() const noexcept { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return tree_.empty(); }
+
+        size_type size() const noexcept { return tree_.size(); }
+
+        size_type max_size() const noexcept { return tree_.max_size(); }
+
+
+        // 插入删除操作
+        template<class ...Args>
+        pair<iterator, bool> emplace(Args &&...args) {
+            return tree_.emplace_unique(mystl::forward<Args>(args)...);
+        }
+
+        template<class ...Args>
+        iterator emplace_hint(iterator hint, Args &&...args) {
+            return tree_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...);
+        }
+
+        pair<iterator, bool> insert(const value_type &value) {
+            return tree_.insert_unique(value);
+        }
+
+        pair<iterator, bool> insert(value_type &&value) {
+            return tree_.insert_unique(mystl::move(value));
+        }
+
+        iterator insert(iterator hint, const value_type &value) {
+            return tree_.insert_unique(hint, value);
+        }
+
+        iterator insert(iterator hint, value_type &&value) {
+            return tree_.insert_unique(hint, mystl::move(value));
+        }
+
+        // 有序输入每次都追加到最右的叶子节点
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            tree_.insert_unique(first, last);
+        }
+
+        void erase(iterator position) { tree_.erase(position); }
+
+        size_type erase(const key_type &key) { return tree_.erase_unique(key); }
+
+        void erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+        void clear() { tree_.clear(); }
+
+        // btree_set 相关操作
+
+        iterator find(const key_type &key) { return tree_.find(key); }
+
+        const_iterator find(const key_type &key) const { return tree_.find(key); }
+
+        size_type count(const key_type &key) const { return tree_.count_unique(key); }
+
+        iterator lower_bound(const key_type &key) { return tree_.lower_bound(key); }
+
+        const_iterator lower_bound(const key_type &key) const { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type &key) { return tree_.upper_bound(key); }
+
+        const_iterator upper_bound(const key_type &key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator>
+        equal_range(const key_type &key) { return tree_.equal_range_unique(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const { return tree_.equal_range_unique(key); }
+
+        void swap(btree_set &rhs) noexcept { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const btree_set &lhs, const btree_set &rhs) { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator<(const btree_set &lhs, const btree_set &rhs) { return lhs.tree_ < rhs.tree_; }
+    };
+
+    // 重载比较操作符
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator==(const btree_set<Key, Compare, NodeBytes> &lhs, const btree_set<Key, Compare, NodeBytes> &rhs) {
+        return lhs == rhs;
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator<(const btree_set<Key, Compare, NodeBytes> &lhs, const btree_set<Key, Compare, NodeBytes> &rhs) {
+        return lhs < rhs;
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator!=(const btree_set<Key, Compare, NodeBytes> &lhs, const btree_set<Key, Compare, NodeBytes> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator>(const btree_set<Key, Compare, NodeBytes> &lhs, const btree_set<Key, Compare, NodeBytes> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator<=(const btree_set<Key, Compare, NodeBytes> &lhs, const btree_set<Key, Compare, NodeBytes> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator>=(const btree_set<Key, Compare, NodeBytes> &lhs, const btree_set<Key, Compare, NodeBytes> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class Key, class Compare, size_t NodeBytes>
+    void swap(btree_set<Key, Compare, NodeBytes> &lhs, btree_set<Key, Compare, NodeBytes> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+/*****************************************************************************************/
+
+// 模板类 btree_multiset，键值允许重复
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，参数三代表节点的目标字节数
+    template<class Key, class Compare = mystl::less<Key>, size_t NodeBytes = 256>
+    class btree_multiset {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+
+    private:
+        // 以 mystl::btree 作为底层机制
+        typedef mystl::btree<value_type, key_compare, NodeBytes> base_type;
+        base_type tree_;  // 以 btree 表现 btree_multiset
+
+    public:
+        // 使用 btree 定义的型别
+        typedef typename base_type::const_pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::const_reference reference;
+        typedef typename base_type::const_reference const_reference;
+        typedef typename base_type::const_iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef typename base_type::const_reverse_iterator reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::allocator_type allocator_type;
+
+    public:
+        // 构造、复制、移动函数
+        btree_multiset() = default;
+
+        template<class InputIterator>
+        btree_multiset(InputIterator first, InputIterator last)
+                :tree_() { tree_.insert_multi(first, last); }
+
+        btree_multiset(std::initializer_list<value_type> ilist)
+                : tree_() { tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+        btree_multiset(const btree_multiset &rhs)
+                : tree_(rhs.tree_) {
+        }
+
+        btree_multiset(btree_multiset &&rhs) noexcept
+                : tree_(mystl::move(rhs.tree_)) {
+        }
+
+        btree_multiset &operator=(const btree_multiset &rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        btree_multiset &operator=(btree_multiset &&rhs) {
+            tree_ = mystl::move(rhs.tree_);
+            return *this;
+        }
+
+        btree_multiset &operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            tree_.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // 相关接口
+
+        key_compare key_comp() const { return tree_.key_comp(); }
+
+        value_compare value_comp() const { return tree_.key_comp(); }
+
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+        // 迭代器相关
+
+        iterator begin() noexcept { return tree_.begin(); }
+
+        const_iterator begin() const noexcept { return tree_.begin(); }
+
+        iterator end() noexcept { return tree_.end(); }
+
+        const_iterator end() const noexcept { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return tree_.empty(); }
+
+        size_type size() const noexcept { return tree_.size(); }
+
+        size_type max_size() const noexcept { return tree_.max_size(); }
+
+
+        // 插入删除操作
+
+        template<class ...Args>
+        iterator emplace(Args &&...args) {
+            return tree_.emplace_multi(mystl::forward<Args>(args)...);
+        }
+
+        template<class ...Args>
+        iterator emplace_hint(iterator hint, Args &&...args) {
+            return tree_.emplace_multi_use_hint(hint, mystl::forward<Args>(args)...);
+        }
+
+        iterator insert(const value_type &value) {
+            return tree_.insert_multi(value);
+        }
+
+        iterator insert(value_type &&value) {
+            return tree_.insert_multi(mystl::move(value));
+        }
+
+        iterator insert(iterator hint, const value_type &value) {
+            return tree_.insert_multi(hint, value);
+        }
+
+        iterator insert(iterator hint, value_type &&value) {
+            return tree_.insert_multi(hint, mystl::move(value));
+        }
+
+        // 有序输入每次都追加到最右的叶子节点
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            tree_.insert_multi(first, last);
+        }
+
+        void erase(iterator position) { tree_.erase(position); }
+
+        size_type erase(const key_type &key) { return tree_.erase_multi(key); }
+
+        void erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+        void clear() { tree_.clear(); }
+
+        // btree_multiset 相关操作
+
+        iterator find(const key_type &key) { return tree_.find(key); }
+
+        const_iterator find(const key_type &key) const { return tree_.find(key); }
+
+        size_type count(const key_type &key) const { return tree_.count_multi(key); }
+
+        iterator lower_bound(const key_type &key) { return tree_.lower_bound(key); }
+
+        const_iterator lower_bound(const key_type &key) const { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type &key) { return tree_.upper_bound(key); }
+
+        const_iterator upper_bound(const key_type &key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator>
+        equal_range(const key_type &key) { return tree_.equal_range_multi(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const { return tree_.equal_range_multi(key); }
+
+        void swap(btree_multiset &rhs) noexcept { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const btree_multiset &lhs, const btree_multiset &rhs) { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator<(const btree_multiset &lhs, const btree_multiset &rhs) { return lhs.tree_ < rhs.tree_; }
+    };
+
+    // 重载比较操作符
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator==(const btree_multiset<Key, Compare, NodeBytes> &lhs, const btree_multiset<Key, Compare, NodeBytes> &rhs) {
+        return lhs == rhs;
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator<(const btree_multiset<Key, Compare, NodeBytes> &lhs, const btree_multiset<Key, Compare, NodeBytes> &rhs) {
+        return lhs < rhs;
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator!=(const btree_multiset<Key, Compare, NodeBytes> &lhs, const btree_multiset<Key, Compare, NodeBytes> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator>(const btree_multiset<Key, Compare, NodeBytes> &lhs, const btree_multiset<Key, Compare, NodeBytes> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator<=(const btree_multiset<Key, Compare, NodeBytes> &lhs, const btree_multiset<Key, Compare, NodeBytes> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class Key, class Compare, size_t NodeBytes>
+    bool operator>=(const btree_multiset<Key, Compare, NodeBytes> &lhs, const btree_multiset<Key, Compare, NodeBytes> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class Key, class Compare, size_t NodeBytes>
+    void swap(btree_multiset<Key, Compare, NodeBytes> &lhs, btree_multiset<Key, Compare, NodeBytes> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+} // namespace mystl
+#endif // !MYTINYSTL_BTREE_SET_H_
@@ -0,0 +1,602 @@
+#ifndef MYTINYSTL_CONCURRENT_SET_H_
+#define MYTINYSTL_CONCURRENT_SET_H_
+
+// 这个头文件包含一个模板类 concurrent_set
+// concurrent_set : 支持并发读写的有序集合，以跳表实现，查找接口与 set 相同，键值不允许重复
+
+// notes:
+//
+// 1. 读操作（find、lower_bound、迭代等）与插入都不加锁，也从不等待：读者只在进入时登记 epoch，
+//    之后沿跳表以 acquire 读取指针前进；插入以 CAS 把新节点链入各层；删除（erase、clear）之间用互斥量串行
+// 2. 插入时先填好新节点的后继，以 CAS 链入第 0 层即为插入成功，再自底向上逐层链入上层，
+//    CAS 失败时重新查找前驱后重试；读者看到的总是有序的链表
+// 3. 删除时自顶向下在节点各层的后继指针上打删除标记（指针的最低位），打上第 0 层的标记即为删除成功；
+//    带标记的指针不会再被 CAS 成功，插入与删除查找前驱时顺手摘下带标记的节点。
+//    读者跳过带标记的节点，被摘下的节点仍指向原来的后继，停在其上的读者可以继续前进
+// 4. 节点可能在插入者链入上层的同时被删除，删除者打完标记后等待插入者结束链入，再查找一次摘下节点的所有层，
+//    之后才退休该节点；删除因此可能等待正在插入同一节点的线程，插入与读操作不会等待
+// 5. 删除的节点先退休，等所有可能看到它的读者离开后再释放，见 epoch.h
+// 6. 迭代器持有 epoch 登记，其指向的节点在迭代器销毁前不会被释放；
+//    迭代是弱一致的：不会失效、不会重复，但可能看不到迭代开始后插入或删除的元素。
+//    长期持有迭代器会推迟所有已删除节点的释放
+// 7. 跳表只有后继指针，迭代器为前向迭代器
+// 8. 塔高按 1/P 的概率逐层增加，P 为模板参数，缺省为 4，随机数状态每个线程一份；
+//    节点的各层指针与值放在同一块内存中。单线程的跳表见 skiplist.h
+//
+// 异常保证：
+// insert / emplace 做强异常安全保证
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "functional.h"
+#include "iterator.h"
+#include "construct.h"
+#include "vector.h"
+#include "epoch.h"
+#include "skiplist.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // 跳表节点，长度为 height 的塔（各层后继指针）紧接在节点之后
+    // 后继指针的最低位为删除标记，节点至少按指针对齐，未打标记的指针最低位总是 0
+    template<class T>
+    struct alignas(T) alignas(void *) concurrent_set_node {
+        typedef concurrent_set_node *node_ptr;
+        typedef std::atomic<node_ptr> link_type;
+
+        T value;
+        unsigned int height;
+        std::atomic<bool> linking;   // 插入者仍在链入上层时为 true
+
+        link_type *next() noexcept { return reinterpret_cast<link_type *>(this + 1); }
+
+        static size_t bytes(unsigned int height) noexcept {
+            return sizeof(concurrent_set_node) + height * sizeof(link_type);
+        }
+
+        static bool is_marked(node_ptr p) noexcept {
+            return (reinterpret_cast<uintptr_t>(p) & 1) != 0;
+        }
+
+        static node_ptr marked(node_ptr p) noexcept {
+            return reinterpret_cast<node_ptr>(reinterpret_cast<uintptr_t>(p) | 1);
+        }
+
+        static node_ptr unmarked(node_ptr p) noexcept {
+            return reinterpret_cast<node_ptr>(reinterpret_cast<uintptr_t>(p) & ~static_cast<uintptr_t>(1));
+        }
+
+        // 从 x 开始第 0 层上第一个未删除的节点
+        static node_ptr first_live(node_ptr x) noexcept {
+            x = unmarked(x);
+            while (x != nullptr) {
+                auto succ = x->next()[0].load(std::memory_order_acquire);
+                if (!is_marked(succ)) {
+                    break;
+                }
+                x = unmarked(succ);
+            }
+            return x;
+        }
+
+        // x 之后第一个未删除的节点
+        static node_ptr next_live(node_ptr x) noexcept {
+            return first_live(x->next()[0].load(std::memory_order_acquire));
+        }
+    };
+
+    // concurrent_set 的迭代器，持有 epoch 登记，end() 不持有
+    template<class T>
+    struct concurrent_set_iterator : public iterator<forward_iterator_tag, T> {
+        typedef concurrent_set_node<T> node_type;
+        typedef concurrent_set_iterator<T> self;
+
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+        typedef ptrdiff_t difference_type;
+
+        node_type *node;
+        epoch_guard guard;
+
+        concurrent_set_iterator() noexcept: node(nullptr), guard() {}
+
+        concurrent_set_iterator(node_type *n, epoch_guard g) noexcept: node(n), guard(mystl::move(g)) {}
+
+        reference operator*() const { return node->value; }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self &operator++() {
+            node = node_type::next_live(node);
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return node == rhs.node; }
+
+        bool operator!=(const self &rhs) const { return node != rhs.node; }
+    };
+
+    // 模板类 concurrent_set，键值不允许重复
+    // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，
+    // 参数三为塔高每层继续增高的概率的倒数，缺省为 4
+    template<class Key, class Compare = mystl::less<Key>, unsigned int P = 4>
+    class concurrent_set {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+
+        typedef const Key *pointer;
+        typedef const Key *const_pointer;
+        typedef const Key &reference;
+        typedef const Key &const_reference;
+        typedef concurrent_set_iterator<Key> iterator;
+        typedef concurrent_set_iterator<Key> const_iterator;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        static constexpr unsigned int max_height = 32;
+        static constexpr unsigned int level_probability_inverse = P;
+
+    private:
+        typedef concurrent_set_node<Key> node_type;
+        typedef node_type *node_ptr;
+        typedef std::atomic<node_ptr> link_type;
+
+        // 已摘下、等待释放的节点
+        struct retired_node {
+            node_ptr node;
+            size_t epoch;
+        };
+
+        link_type head_[max_height];            // 头节点的各层指针，不会被打上删除标记
+        std::atomic<unsigned int> height_;      // 当前最高的层数，只增不减
+        std::atomic<size_type> node_count_;     // 元素个数
+        key_compare key_comp_;
+        mutable epoch_domain domain_;
+        std::mutex write_mutex_;                // 删除者之间互斥
+        mystl::vector<retired_node> retired_;   // 由删除者维护
+
+    public:
+        // 构造、析构函数，不可复制、移动
+        concurrent_set() : height_(1), node_count_(0), key_comp_() {
+            for (auto &link : head_) {
+                link.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        template<class InputIterator>
+        concurrent_set(InputIterator first, InputIterator last) : concurrent_set() {
+            insert(first, last);
+        }
+
+        concurrent_set(std::initializer_list<value_type> ilist) : concurrent_set() {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        concurrent_set(const concurrent_set &) = delete;
+
+        concurrent_set &operator=(const concurrent_set &) = delete;
+
+        // 析构时不能再有其他线程访问
+        ~concurrent_set() {
+            auto x = head_[0].load(std::memory_order_relaxed);
+            while (x != nullptr) {
+                auto next = node_type::unmarked(x->next()[0].load(std::memory_order_relaxed));
+                destroy_node(x);
+                x = next;
+            }
+            for (auto &r : retired_) {
+                destroy_node(r.node);
+            }
+        }
+
+        key_compare key_comp() const { return key_comp_; }
+
+        value_compare value_comp() const { return key_comp_; }
+
+        // 迭代器相关
+        const_iterator begin() const {
+            epoch_guard guard(domain_);
+            return make_iterator(node_type::first_live(head_[0].load(std::memory_order_acquire)), guard);
+        }
+
+        const_iterator end() const noexcept { return const_iterator(); }
+
+        const_iterator cbegin() const { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        // 容量相关，并发修改时只是一个近似值
+        bool empty() const noexcept { return size() == 0; }
+
+        size_type size() const noexcept { return node_count_.load(std::memory_order_relaxed); }
+
+        size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+        // 插入删除操作
+        template<class ...Args>
+        pair<iterator, bool> emplace(Args &&...args) {
+            return insert(value_type(mystl::forward<Args>(args)...));
+        }
+
+        pair<iterator, bool> insert(const value_type &value) {
+            return insert_value(value);
+        }
+
+        pair<iterator, bool> insert(value_type &&value) {
+            return insert_value(mystl::move(value));
+        }
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            for (; first != last; ++first)
+                insert_value(*first);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        size_type erase(const key_type &key);
+
+        void erase(const_iterator position) { erase(*position); }
+
+        void clear();
+
+        // concurrent_set 相关操作
+        bool contains(const key_type &key) const {
+            epoch_guard guard(domain_);
+            auto x = lower_bound_node(key);
+            return x != nullptr && !key_comp_(key, x->value);
+        }
+
+        const_iterator find(const key_type &key) const {
+            epoch_guard guard(domain_);
+            auto x = lower_bound_node(key);
+            if (x == nullptr || key_comp_(key, x->value)) {
+                return end();
+            }
+            return const_iterator(x, mystl::move(guard));
+        }
+
+        size_type count(const key_type &key) const { return contains(key) ? 1 : 0; }
+
+        const_iterator lower_bound(const key_type &key) const {
+            epoch_guard guard(domain_);
+            return make_iterator(lower_bound_node(key), guard);
+        }
+
+        const_iterator upper_bound(const key_type &key) const {
+            epoch_guard guard(domain_);
+            auto x = lower_bound_node(key);
+            if (x != nullptr && !key_comp_(key, x->value)) {
+                x = node_type::next_live(x);
+            }
+            return make_iterator(x, guard);
+        }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const {
+            auto first = lower_bound(key);
+            auto last = first;
+            if (last != end() && !key_comp_(key, *last)) {
+                ++last;
+            }
+            return mystl::make_pair(first, last);
+        }
+
+    private:
+        // helper functions
+        static const_iterator make_iterator(node_ptr x, epoch_guard &guard) {
+            return x == nullptr ? const_iterator() : const_iterator(x, mystl::move(guard));
+        }
+
+        // 第一个不小于 key 的未删除节点，调用者需已登记 epoch 或持有写锁
+        node_ptr lower_bound_node(const key_type &key) const;
+
+        // 查找每一层最后一个小于 key 的位置与其后继，写入 preds、succs，返回 succs[0]；
+        // 途中摘下带删除标记的节点
+        node_ptr find_preds(const key_type &key, link_type **preds, node_ptr *succs);
+
+        // 前驱的指针被打上删除标记或已改变时返回 false，需要从头重新查找
+        bool try_find_preds(const key_type &key, link_type **preds, node_ptr *succs);
+
+        template<class V>
+        pair<iterator, bool> insert_value(V &&value);
+
+        // 自底向上把已链入第 0 层的 node 链入上层，node 被删除时放弃
+        void link_upper(node_ptr node, link_type **preds, node_ptr *succs);
+
+        // 在 x 的各层打上删除标记，等待插入者结束后摘下 x，只在持有写锁时调用
+        void unlink_node(node_ptr x);
+
+        static unsigned int random_height() noexcept;
+
+        template<class V>
+        static node_ptr create_node(V &&value, unsigned int height);
+
+        static void destroy_node(node_ptr x) noexcept;
+
+        // 以当前 epoch 退休节点
+        void retire(node_ptr x);
+
+        void reclaim() noexcept;
+    };
+
+    template<class Key, class Compare, unsigned int P>
+    constexpr unsigned int concurrent_set<Key, Compare, P>::max_height;
+
+    template<class Key, class Compare, unsigned int P>
+    constexpr unsigned int concurrent_set<Key, Compare, P>::level_probability_inverse;
+
+/*****************************************************************************************/
+
+// 删除键值等于 key 的元素，返回删除的个数
+    template<class Key, class Compare, unsigned int P>
+    typename concurrent_set<Key, Compare, P>::size_type
+    concurrent_set<Key, Compare, P>::
+    erase(const key_type &key) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        link_type *preds[max_height];
+        node_ptr succs[max_height];
+        auto x = find_preds(key, preds, succs);
+        if (x == nullptr || key_comp_(key, x->value)) {
+            return 0;
+        }
+        unlink_node(x);
+        retire(x);
+        reclaim();
+        return 1;
+    }
+
+// 清空 concurrent_set，逐个删除第 0 层的第一个节点，与并发的插入互不干扰
+    template<class Key, class Compare, unsigned int P>
+    void concurrent_set<Key, Compare, P>::
+    clear() {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        node_ptr x;
+        while ((x = node_type::first_live(head_[0].load(std::memory_order_acquire))) != nullptr) {
+            unlink_node(x);
+            retire(x);
+        }
+        reclaim();
+    }
+
+/*****************************************************************************************/
+// helper function
+
+// 从最高层开始，每层向右走到最后一个小于 key 的节点，再下降一层，跳过带删除标记的节点
+    template<class Key, class Compare, unsigned int P>
+    typename concurrent_set<Key, Compare, P>::node_ptr
+    concurrent_set<Key, Compare, P>::
+    lower_bound_node(const key_type &key) const {
+        const link_type *tower = head_;
+        node_ptr x = nullptr;
+        for (unsigned int i = height_.load(std::memory_order_acquire); i > 0; --i) {
+            x = node_type::unmarked(tower[i - 1].load(std::memory_order_acquire));
+            while (x != nullptr) {
+                auto succ = x->next()[i - 1].load(std::memory_order_acquire);
+                if (node_type::is_marked(succ)) {
+                    x = node_type::unmarked(succ);
+                } else if (key_comp_(x->value, key)) {
+                    tower = x->next();
+                    x = succ;
+                } else {
+                    break;
+                }
+            }
+        }
+        return x;
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    typename concurrent_set<Key, Compare, P>::node_ptr
+    concurrent_set<Key, Compare, P>::
+    find_preds(const key_type &key, link_type **preds, node_ptr *succs) {
+        while (!try_find_preds(key, preds, succs)) {
+        }
+        return succs[0];
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    bool concurrent_set<Key, Compare, P>::
+    try_find_preds(const key_type &key, link_type **preds, node_ptr *succs) {
+        link_type *tower = head_;
+        for (unsigned int i = max_height; i > 0; --i) {
+            auto x = tower[i - 1].load(std::memory_order_acquire);
+            if (node_type::is_marked(x)) {
+                return false;
+            }
+            while (x != nullptr) {
+                auto succ = x->next()[i - 1].load(std::memory_order_acquire);
+                if (node_type::is_marked(succ)) {
+                    // x 已被删除，从前驱处摘下
+                    auto expected = x;
+                    if (!tower[i - 1].compare_exchange_strong(expected, node_type::unmarked(succ))) {
+                        return false;
+                    }
+                    x = node_type::unmarked(succ);
+                } else if (key_comp_(x->value, key)) {
+                    tower = x->next();
+                    x = succ;
+                } else {
+                    break;
+                }
+            }
+            preds[i - 1] = tower;
+            succs[i - 1] = x;
+        }
+        return true;
+    }
+
+// 插入元素，键值已存在时返回已有的元素；以 CAS 链入第 0 层，失败时重新查找
+    template<class Key, class Compare, unsigned int P>
+    template<class V>
+    pair<typename concurrent_set<Key, Compare, P>::iterator, bool>
+    concurrent_set<Key, Compare, P>::
+    insert_value(V &&value) {
+        epoch_guard guard(domain_);
+        link_type *preds[max_height];
+        node_ptr succs[max_height];
+        auto x = find_preds(value, preds, succs);
+        if (x != nullptr && !key_comp_(value, x->value)) {
+            return mystl::make_pair(iterator(x, mystl::move(guard)), false);
+        }
+        THROW_LENGTH_ERROR_IF(size() > max_size() - 1, "concurrent_set<Key, Comp>'s size too big");
+        auto node = create_node(mystl::forward<V>(value), random_height());
+        while (true) {
+            for (unsigned int i = 0; i < node->height; ++i) {
+                node->next()[i].store(succs[i], std::memory_order_relaxed);
+            }
+            auto expected = succs[0];
+            if (preds[0][0].compare_exchange_strong(expected, node)) {
+                break;
+            }
+            x = find_preds(node->value, preds, succs);
+            if (x != nullptr && !key_comp_(node->value, x->value)) {
+                // 新节点尚未发布，可以直接释放
+                destroy_node(node);
+                return mystl::make_pair(iterator(x, mystl::move(guard)), false);
+            }
+        }
+        node_count_.fetch_add(1, std::memory_order_relaxed);
+        auto height = height_.load(std::memory_order_relaxed);
+        while (height < node->height &&
+               !height_.compare_exchange_weak(height, node->height, std::memory_order_release)) {
+        }
+        link_upper(node, preds, succs);
+        node->linking.store(false, std::memory_order_release);
+        return mystl::make_pair(iterator(node, mystl::move(guard)), true);
+    }
+
+// 逐层先把 node 在该层的后继改为 succs[i]，再以 CAS 把它挂到前驱之后；
+// node 的后继带上删除标记说明它已被删除，不再链入
+    template<class Key, class Compare, unsigned int P>
+    void concurrent_set<Key, Compare, P>::
+    link_upper(node_ptr node, link_type **preds, node_ptr *succs) {
+        for (unsigned int i = 1; i < node->height; ++i) {
+            while (true) {
+                auto succ = node->next()[i].load(std::memory_order_acquire);
+                if (node_type::is_marked(succ)) {
+                    return;
+                }
+                if (succ != succs[i] && !node->next()[i].compare_exchange_strong(succ, succs[i])) {
+                    return;
+                }
+                auto expected = succs[i];
+                if (preds[i][i].compare_exchange_strong(expected, node)) {
+                    break;
+                }
+                find_preds(node->value, preds, succs);
+                if (node_type::is_marked(node->next()[0].load(std::memory_order_acquire))) {
+                    return;
+                }
+            }
+        }
+    }
+
+// 自顶向下打删除标记，第 0 层的标记最后打上；之后插入者不会再链入新的层，
+// 等它结束后查找一次，途中摘下 x 在各层的链接
+    template<class Key, class Compare, unsigned int P>
+    void concurrent_set<Key, Compare, P>::
+    unlink_node(node_ptr x) {
+        for (unsigned int i = x->height; i > 0; --i) {
+            auto succ = x->next()[i - 1].load(std::memory_order_acquire);
+            while (!node_type::is_marked(succ) &&
+                   !x->next()[i - 1].compare_exchange_weak(succ, node_type::marked(succ))) {
+            }
+        }
+        node_count_.fetch_sub(1, std::memory_order_relaxed);
+        while (x->linking.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        link_type *preds[max_height];
+        node_ptr succs[max_height];
+        find_preds(x->value, preds, succs);
+    }
+
+// 随机塔高，每个线程使用自己的随机数状态
+    template<class Key, class Compare, unsigned int P>
+    unsigned int concurrent_set<Key, Compare, P>::
+    random_height() noexcept {
+        static thread_local uint64_t seed = 0;
+        if (seed == 0) {
+            seed = 0x9E3779B97F4A7C15ULL ^ static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&seed));
+        }
+        return skiplist_random_height<P>(seed, max_height);
+    }
+
+// 分配节点，各层指针追加在节点之后
+    template<class Key, class Compare, unsigned int P>
+    template<class V>
+    typename concurrent_set<Key, Compare, P>::node_ptr
+    concurrent_set<Key, Compare, P>::
+    create_node(V &&value, unsigned int height) {
+        auto x = static_cast<node_ptr>(::operator new(node_type::bytes(height)));
+        try {
+            mystl::construct(mystl::address_of(x->value), mystl::forward<V>(value));
+        } catch (...) {
+            ::operator delete(x);
+            throw;
+        }
+        x->height = height;
+        ::new(static_cast<void *>(&x->linking)) std::atomic<bool>(true);
+        for (unsigned int i = 0; i < height; ++i) {
+            ::new(static_cast<void *>(x->next() + i)) link_type(nullptr);
+        }
+        return x;
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    void concurrent_set<Key, Compare, P>::
+    destroy_node(node_ptr x) noexcept {
+        mystl::destroy(mystl::address_of(x->value));
+        ::operator delete(x);
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    void concurrent_set<Key, Compare, P>::
+    retire(node_ptr x) {
+        try {
+            retired_.push_back(retired_node{x, domain_.epoch()});
+        } catch (...) {
+            // 无法记录时泄漏该节点，不能在读者可能仍在访问时释放
+        }
+    }
+
+// 推进 epoch，释放已经没有读者能看到的节点；retired_ 按 epoch 非降序排列，只需释放一个前缀
+    template<class Key, class Compare, unsigned int P>
+    void concurrent_set<Key, Compare, P>::
+    reclaim() noexcept {
+        if (retired_.empty()) {
+            return;
+        }
+        domain_.try_advance();
+        size_type n = 0;
+        while (n < retired_.size() && domain_.can_reclaim(retired_[n].epoch)) {
+            destroy_node(retired_[n].node);
+            ++n;
+        }
+        if (n != 0) {
+            retired_.erase(retired_.begin(), retired_.begin() + n);
+        }
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_CONCURRENT_SET_H_
@@ -39,19 +39,30 @@ namespace mystl {
 #define DEQUE_MAP_INIT_SIZE 8
 #endif
 
-    template<class T>
+    template<class T, class Alloc = mystl::allocator<T>>
     struct deque_buf_size {
         // static 静态变量，该变量属于这个类而不是该类的某个对象，即类共享一个变量
         // constexpr表达式是指值不会改变并且在编译过程就能得到计算结果的表达式
-        // 若T的大小小于16，则buf大小取 4096 / sizeof(T)，否则取16
-        static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+        // 若T的大小小于256，则buf大小取 4096 / sizeof(T)，否则取16
+        // 配置器给出了块大小（如 huge_page_allocator 的大页）时，一个buf占满一块
+        static constexpr size_t chunk = allocator_chunk_bytes<Alloc>::value;
+        static constexpr size_t value = chunk != 0
+                                        ? (chunk / sizeof(T) > 16 ? chunk / sizeof(T) : 16)
+                                        : (sizeof(T) < 256 ? 4096 / sizeof(T) : 16);
     };
 
+    template<class T, class Alloc>
+    constexpr size_t deque_buf_size<T, Alloc>::chunk;
+
+    template<class T, class Alloc>
+    constexpr size_t deque_buf_size<T, Alloc>::value;
+
 // deque 的迭代器设计
-    template<class T, class Ref, class Ptr>
+// BufSize 为一个缓冲区中的元素个数，由 deque 根据元素类型和配置器决定
+    template<class T, class Ref, class Ptr, size_t BufSize = deque_buf_size<T>::value>
     struct deque_iterator : public iterator<random_access_iterator_tag, T> {
-        typedef deque_iterator<T, T &, T *> iterator;
-        typedef deque_iterator<T, const T &, const T *> const_iterator;
+        typedef deque_iterator<T, T &, T *, BufSize> iterator;
+        typedef deque_iterator<T, const T &, const T *, BufSize> const_iterator;
         typedef deque_iterator self;
 
         typedef T value_type;
@@ -62,7 +73,7 @@ namespace mystl {
         typedef T *value_pointer;
         typedef T **map_pointer;
 
-        static const size_type buffer_size = deque_buf_size<T>::value;  // deque中一个buffer的大小
+        static const size_type buffer_size = BufSize;  // deque中一个buffer的大小
 
         // 迭代器所含成员数据
         value_pointer cur;    // 指向所在缓冲区的当前元素
@@ -212,13 +223,14 @@ namespace mystl {
 
 // 模板类deque
 // 模板参数代表数据类型
-    template<class T>
+    template<class T, class Alloc = mystl::allocator<T>>
     class deque {
     public:
         // deque 的型别定义
-        typedef mystl::allocator<T> allocator_type;
-        typedef mystl::allocator<T> data_allocator;
-        typedef mystl::allocator<T *> map_allocator;
+        // Alloc 为空间配置器，缓冲区与 map 都由它分配
+        typedef Alloc allocator_type;
+        typedef Alloc data_allocator;
+        typedef typename Alloc::template rebind<T *>::other map_allocator;
 
         typedef typename allocator_type::value_type value_type;
         typedef typename allocator_type::pointer pointer;
@@ -230,15 +242,15 @@ namespace mystl {
         typedef pointer *map_pointer;
         typedef const_pointer *const_map_pointer;
 
-        typedef deque_iterator<T, T &, T *> iterator;
-        typedef deque_iterator<T, const T &, const T *> const_iterator;
+        static const size_type buffer_size = deque_buf_size<T, Alloc>::value;
+
+        typedef deque_iterator<T, T &, T *, buffer_size> iterator;
+        typedef deque_iterator<T, const T &, const T *, buffer_size> const_iterator;
         typedef mystl::reverse_iterator<iterator> reverse_iterator;
         typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
 
         allocator_type get_allocator() { return allocator_type(); }
 
-        static const size_type buffer_size = deque_buf_size<T>::value;
-
     private:
         // 用以下四个数据来表现一个deque
         iterator begin_;  // 指向第一个节点
@@ -341,6 +353,10 @@ namespace mystl {
 
         void resize(size_type new_size, const value_type &value);
 
+        // 在尾部追加 n 个未初始化的元素并返回指向第一个新元素的迭代器，
+        // 由调用者逐个缓冲区直接写入数据（如从文件读入），只用于平凡可复制的类型
+        iterator append_uninitialized(size_type n);
+
         // shrink_to_fit：减少容器的容量以适应其大小并销毁超出容量的所有元素
         void shrink_to_fit() noexcept;
 
@@ -420,7 +436,7 @@ namespace mystl {
 
         // emplace：在双端队列指定位置插入新元素并将双端队列的大小增加一
         template<class ...Args>
-        void emplace(iterator pos, Args &&...args);
+        iterator emplace(iterator pos, Args &&...args);
 
         // push_front / push_back
         // emplace效率比push高，因为不用调用移动构造函数和拷贝构造函数
@@ -525,15 +541,15 @@ namespace mystl {
 
         void reallocate_map_at_front(size_type need);
 
-        void reallocate_map_at_back(size_type need)
+        void reallocate_map_at_back(size_type need);
 
     };
 
 /*****************************************************************************************/
 
 // 复制赋值运算符
-    template<class T>
-    deque<T> &deque<T>::operator=(const deque &rhs) {
+    template<class T, class Alloc>
+    deque<T, Alloc> &deque<T, Alloc>::operator=(const deque &rhs) {
         if (this != &rhs) {
             // 若当前地址不等于rhs的地址
             const auto len = size();  // 记录当前空间大小
@@ -556,8 +572,8 @@ namespace mystl {
 
 // 移动赋值运算符
 // 将rhs移动到当前deque地址下
-    template<class T>
-    deque<T> &deque<T>::operator=(deque<T> &&rhs) {
+    template<class T, class Alloc>
+    deque<T, Alloc> &deque<T, Alloc>::operator=(deque<T, Alloc> &&rhs) {
         clear(); // 清空当前deque
         // 更新各参数
         begin_ = mystl::move(rhs.begin_);
@@ -571,8 +587,8 @@ namespace mystl {
     }
 
 // 重置容器大小
-    template<class T>
-    void deque<T>::resize(size_type new_size, const value_type &value) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::resize(size_type new_size, const value_type &value) {
         const auto len = size();  // 获取当前容量
         if (new_size < len) {
             // 若当前容量大于新容量
@@ -585,9 +601,22 @@ namespace mystl {
         }
     }
 
+// 在尾部追加 n 个未初始化的元素，只分配缓冲区，不初始化元素
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::append_uninitialized(size_type n) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "deque<T>::append_uninitialized() requires trivially copyable T");
+        THROW_LENGTH_ERROR_IF(size() > max_size() - n, "deque<T>'s size too big");
+        require_capacity(n, false);
+        auto p = end_;
+        end_ += n;
+        return p;
+    }
+
 // 减小容器容量
-    template<class T>
-    void deque<T>::shrink_to_fit() noexcept {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::shrink_to_fit() noexcept {
         // 至少会留下头部缓冲区
         // map_：指向一块map，map中的每个元素都是一个指针，指向一个缓冲区
         for (auto cur = map_; cur < begin_.node; ++cur) {
@@ -595,7 +624,7 @@ namespace mystl {
             data_allocator::deallocate(*cur, buffer_size);
             *cur = nullptr;
         }
-        for (auto cur = end_.node; cur < map_ + map_size_; ++cur) {
+        for (auto cur = end_.node + 1; cur < map_ + map_size_; ++cur) {
             // 将 尾结点之后 且 小于map_指向的map的最后一个位置 内的空间清空并置为nullptr
             data_allocator::deallocate(*cur, buffer_size);
             *cur = nullptr;
@@ -603,9 +632,9 @@ namespace mystl {
     }
 
 // 在头部就地构建元素
-    template<class T>
+    template<class T, class Alloc>
     template<class ...Args>
-    void deque<T>::emplace_front(Args &&...args) {
+    void deque<T, Alloc>::emplace_front(Args &&...args) {
         if (begin_.cur != begin_.first) {
             // 若当前节点不等于头节点
             // cur 指向所在缓冲区的当前元素
@@ -631,9 +660,9 @@ namespace mystl {
     }
 
 // 在尾部就地构造元素
-    template<class T>
+    template<class T, class Alloc>
     template<class ...Args>
-    void deque<T>::emplace_back(Args &&args...) {
+    void deque<T, Alloc>::emplace_back(Args &&...args) {
         if (end_.cur != end_.last - 1) {
             // 若当前结尾不等于空间结尾位置，则直接插入
             data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
@@ -648,9 +677,9 @@ namespace mystl {
     }
 
 // 在pos位置就地构建元素
-    template<class T>
+    template<class T, class Alloc>
     template<class ...Args>
-    typename deque<T>::iterator deque<T>::emplace(iterator pos, Args &&args...) {
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::emplace(iterator pos, Args &&...args) {
         if (pos.cur == begin_.cur) {
             // 若插入位置等于起始位置，则在头部就地构建元素
             emplace_front(mystl::forward<Args>(args)...);
@@ -666,8 +695,8 @@ namespace mystl {
 
 // 在头部插入元素
 // 和emplace_front的区别是这里传入的直接是一个value，不用自己构建
-    template<class T>
-    void deque<T>::push_front(const value_type &value) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::push_front(const value_type &value) {
         if (begin_.cur != begin_.first) {
             // 若begin_的当前位置不等于begin_缓冲区的开始位置，则在头部插入并将begin_前移一位
             data_allocator::construct(begin_.cur - 1, value);
@@ -687,8 +716,8 @@ namespace mystl {
     }
 
 // 在尾部插入元素
-    template<class T>
-    void deque<T>::push_back(const value_type &value) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::push_back(const value_type &value) {
         if (end_.cur != end_.last - 1) {
             // 若空间充足，则直接插入
             data_allocator::construct(end_.cur, value);
@@ -702,8 +731,8 @@ namespace mystl {
     }
 
 // 弹出头部元素
-    template<class T>
-    void deque<T>::pop_front() {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::pop_front() {
         MYSTL_DEBUG(!empty());
         if (begin_.cur != begin_.last - 1) {
             // 若begin缓冲区当前位置不等于begin缓冲区的结尾位置
@@ -720,8 +749,8 @@ namespace mystl {
     }
 
 // 弹出尾部元素
-    template<class T>
-    void deque<T>::pop_back() {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::pop_back() {
         MYSTL_DEBUG(!empty());
         if (end_.cur != end_.first) {
             // 若end缓冲区当前位置不等于end缓冲区起始位置
@@ -739,9 +768,9 @@ namespace mystl {
     }
 
 // 在position处插入元素
-    template<class T>
-    typename deque<T>::iterator
-    deque<T>::insert(iterator position, const value_type &value) {
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::insert(iterator position, const value_type &value) {
         if (position.cur == begin_.cur) {
             // 若position的当前位置等于begin缓冲区的当前位置
             // 则直接进行头插法
@@ -760,9 +789,9 @@ namespace mystl {
         }
     }
 
-    template<class T>
-    typename deque<T>::iterator
-    deque<T>::insert(iterator position, value_type &&value) {
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::insert(iterator position, value_type &&value) {
         // 这个和上面有什么区别？为什么要通过就地构建元素完成？
         if (position.cur == begin_.cur) {
             emplace_front(mystl::move(value));
@@ -778,8 +807,8 @@ namespace mystl {
     }
 
 // 在position位置插入n个元素
-    template<class T>
-    void deque<T>::insert(iterator position, size_type n, const value_type &value) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::insert(iterator position, size_type n, const value_type &value) {
         if (position.cur == begin_.cur) {
             // 若插入位置在头部
             // 则在头部申请n个空间
@@ -805,9 +834,9 @@ namespace mystl {
     }
 
 // 删除position处的元素
-    template<class T>
-    typename deque<T>::iterator
-    deque<T>::erase(iterator position) {
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::erase(iterator position) {
         auto next = position;  // 记录position位置
         ++next;  // 移动到position后一位
         const size_type elems_before = position - begin_;  // 记录在position之前有几个元素
@@ -829,9 +858,9 @@ namespace mystl {
     }
 
 // 删除[first, last)上的元素
-    template<class T>
-    typename deque<T>::iterator
-    deque<T>::erase(iterator first, iterator last) {
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::erase(iterator first, iterator last) {
         if (first == begin_ && last == end_) {
             // 若清除的范围刚好是整个空间，则直接clear并返回结束位置
             clear();
@@ -869,8 +898,8 @@ namespace mystl {
     }
 
 // 清空 deque
-    template<class T>
-    void deque<T>::clear() {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::clear() {
         // clear 会保留头部的缓冲区
         for (map_pointer cur = begin_.node + 1; cur < end_.node; ++cur) {
             // 从头部下一个开始销毁到结束缓冲区之前
@@ -885,15 +914,14 @@ namespace mystl {
             // 若头部等于尾部，则一起销毁
             mystl::destroy(begin_.cur, end_.cur);
         }
-        // 减小容器容量
-        shrink_to_fit();
-        // 更新结束位置
+        // 先更新结束位置，再减小容器容量，只保留头部缓冲区
         end_ = begin_;
+        shrink_to_fit();
     }
 
 // 交换两个deque
-    template<class T>
-    void deque<T>::swap(deque<T> &rhs) noexcept {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::swap(deque<T, Alloc> &rhs) noexcept {
         if (this != &rhs) {
             // 交换两个不相等的deuqe的全部信息
             mystl::swap(begin_, rhs.begin_);
@@ -907,9 +935,9 @@ namespace mystl {
 // helper function
 
 // create_map 函数
-    template<class T>
-    typename deque<T>::map_pointer
-    deque<T>::create_map(size_type size) {
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::map_pointer
+    deque<T, Alloc>::create_map(size_type size) {
         map_pointer mp = nullptr;  // 创建一个map指针
         mp = map_allocator::allocate(size);  // mp指向构建为size大小的map
         for (size_type i = 0; i < size; ++i) {
@@ -920,8 +948,8 @@ namespace mystl {
     }
 
 // create_buffer 函数
-    template<class T>
-    void deque<T>::
+    template<class T, class Alloc>
+    void deque<T, Alloc>::
     create_buffer(map_pointer nstart, map_pointer nfinish) {
         map_pointer cur;
         try {
@@ -941,8 +969,8 @@ namespace mystl {
     }
 
 // destroy_buffer 函数
-    template<class T>
-    void deque<T>::
+    template<class T, class Alloc>
+    void deque<T, Alloc>::
     destroy_buffer(map_pointer nstart, map_pointer nfinish) {
         for (map_pointer n = nstart; n <= nfinish; ++n) {
             // 释放当前buffer的内存空间
@@ -953,8 +981,8 @@ namespace mystl {
     }
 
 // map_init 函数
-    template<class T>
-    void deque<T>::
+    template<class T, class Alloc>
+    void deque<T, Alloc>::
     map_init(size_type nElem) {
         const size_type nNode = nElem / buffer_size + 1; // 需要分配的缓冲区个数
         // 设置 map_size_为固定的初始化大小 和 当前要求分配的缓冲区个数+2 中取最大
@@ -991,8 +1019,8 @@ namespace mystl {
 
 // fill_init 函数
 // 初始化并填充n个value
-    template<class T>
-    void deque<T>::
+    template<class T, class Alloc>
+    void deque<T, Alloc>::
     fill_init(size_type n, const value_type &value) {
         map_init(n);  // 初始化n个空间
         if (n != 0) {
@@ -1007,9 +1035,9 @@ namespace mystl {
 
 // copy_init 函数
 // 初始化并复制[first, last)之间的元素
-    template<class T>
+    template<class T, class Alloc>
     template<class IIter>
-    void deque<T>::
+    void deque<T, Alloc>::
     copy_init(IIter first, IIter last, input_iterator_tag) {
         const size_type n = mystl::distance(first, last);  // 计算有多少个元素
         map_init(n);  // 初始化n个空间
@@ -1019,10 +1047,10 @@ namespace mystl {
         }
     }
 
-    template<class T>
+    template<class T, class Alloc>
     template<class FIter>
-    void deque<T>::
-    copy_init(IIter first, IIter last, forward_iterator_tag) {
+    void deque<T, Alloc>::
+    copy_init(FIter first, FIter last, forward_iterator_tag) {
         const size_type n = mystl::distance(first, last);  // 计算距离
         map_init(n);  // 初始化map
         for (auto cur = begin_.node; cur < end_.node; ++cur) {
@@ -1035,8 +1063,8 @@ namespace mystl {
     }
 
 // fill_assign 函数
-    template<class T>
-    void deque<T>::
+    template<class T, class Alloc>
+    void deque<T, Alloc>::
     fill_assign(size_type n, const value_type &value) {
         if (n > size()) {
             // 若n大于当前空间大小
@@ -1053,9 +1081,9 @@ namespace mystl {
     }
 
 // copy_assign 函数
-    template<class T>
+    template<class T, class Alloc>
     template<class IIter>
-    void deque<T>::
+    void deque<T, Alloc>::
     copy_assign(IIter first, IIter last, input_iterator_tag) {
         // 记录下当前空间的begin和end的位置
         auto first1 = begin();
@@ -1073,9 +1101,9 @@ namespace mystl {
         }
     }
 
-    template<class T>
+    template<class T, class Alloc>
     template<class FIter>
-    void deque<T>::
+    void deque<T, Alloc>::
     copy_assign(FIter first, FIter last, forward_iterator_tag) {
         const size_type len1 = size();  // 当前尺寸
         const size_type len2 = mystl::distance(first, last);  // 计算距离
@@ -1094,11 +1122,11 @@ namespace mystl {
     }
 
 // insert_aux 函数
-    template<class T>
+    template<class T, class Alloc>
     template<class... Args>
-    typename deque<T>::iterator
-    deque<T>::
-    insert_aux(iterator position, Args &&args...) {
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::
+    insert_aux(iterator position, Args &&...args) {
         const size_type elems_before = position - begin_;  // 计算插入位置前有几个元素
         value_type value_copy = value_type(mystl::forward<Args>(args)...);
         if (elems_before < (size() / 2)) {
@@ -1122,7 +1150,7 @@ namespace mystl {
             --back1;
             auto back2 = back1;
             --back2;
-            popsition = begin_ + elems_before;
+            position = begin_ + elems_before;
             mystl::copy_backward(position, back2, back1);
         }
         *position = mystl::move(value_copy);
@@ -1130,8 +1158,8 @@ namespace mystl {
     }
 
 // fill_insert 函数
-    template<class T>
-    void deque<T>::
+    template<class T, class Alloc>
+    void deque<T, Alloc>::
     fill_insert(iterator position, size_type n, const value_type &value) {
         const size_type elems_before = position - begin_;
         const size_type len = size();
@@ -1188,9 +1216,9 @@ namespace mystl {
     }
 
 // copy_insert 函数
-    template<class T>
+    template<class T, class Alloc>
     template<class FIter>
-    void deque<T>::
+    void deque<T, Alloc>::
     copy_insert(iterator position, FIter first, FIter last, size_type n) {
         const size_type elems_before = position - begin_;
         auto len = size();
@@ -1252,9 +1280,9 @@ namespace mystl {
 
 // insert_dispatch 函数
 // 通过调用insert函数实现
-    template<class T>
+    template<class T, class Alloc>
     template<class IIter>
-    void deque<T>::
+    void deque<T, Alloc>::
     insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag) {
         if (last <= first) return;
         const size_type n = mystl::distance(first, last);
@@ -1272,10 +1300,10 @@ namespace mystl {
         }
     }
 
-    template<class T>
+    template<class T, class Alloc>
     template<class FIter>
-    void deque<T>::
-    insert_dispatch(iterator position, IIter first, IIter last, forward_iterator_tag) {
+    void deque<T, Alloc>::
+    insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag) {
         if (last <= first) return;
         const size_type n = mystl::distance(first, last);
         if (position.cur == begin_.cur) {
@@ -1314,8 +1342,8 @@ namespace mystl {
     }
 
 // require_capacity 函数
-    template<class T>
-    void deque<T>::require_capacity(size_type n, bool front) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::require_capacity(size_type n, bool front) {
         if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n)) {
             // 头插并且begin_空间的当前位置和起始位置之间的空间小于n
             // 计算需要多少空间
@@ -1340,8 +1368,8 @@ namespace mystl {
     }
 
 // reallocate_map_at_front 函数
-    template<class T>
-    void deque<T>::reallocate_map_at_front(size_type need_buffer) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::reallocate_map_at_front(size_type need_buffer) {
         // 判断并获得需要增加的map数量
         const size_type new_map_size = mystl::max(map_size_ << 1, map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
         // 创建map
@@ -1353,7 +1381,7 @@ namespace mystl {
 
         // 令新的map中的指针指向原来的buffer，并开辟新的buffer
         auto begin = new_map + (new_map_size - new_buffer) / 2;  // 指向新的起始位置
-        auto mid = begin + new_buffer;  // 指向原buffer的位置
+        auto mid = begin + need_buffer;  // 指向原buffer的位置
         auto end = mid + old_buffer;  // 指向整个buffer的结尾
         // 在mid前记原空间数据前创建buffer
         create_buffer(begin, mid - 1);
@@ -1371,8 +1399,8 @@ namespace mystl {
     }
 
 // reallocate_map_at_back 函数
-    template<class T>
-    void deque<T>::reallocate_map_at_back(size_type need_buffer) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::reallocate_map_at_back(size_type need_buffer) {
         // 获得应该增加的map大小
         const size_type new_map_size = mystl::max(map_size_ << 1, map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
         // 创建新的map
@@ -1406,44 +1434,44 @@ namespace mystl {
     }
 
 // 重载比较操作符
-    template<class T>
-    bool operator==(const deque<T> &lhs, const deque<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator==(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
         // 比较空间大小和值是否相等
         return lhs.size() == rhs.size() &&
                mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template<class T>
-    bool operator<(const deque<T> &lhs, const deque<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator<(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
         //     检查第一个范围 [lhs.begin(), lhs.end()) 是否按字典序小于
         //        第二个范围 [rhs.begin(), rhs.begin() + (lhs.end() - lhs.begin()))
         return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template<class T>
-    bool operator!=(const deque<T> &lhs, const deque<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator!=(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
         // 利用重载的==实现
         return !(lhs == rhs);
     }
 
-    template<class T>
-    bool operator>(const deque<T> &lhs, const deque<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator>(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
         return rhs < lhs;
     }
 
-    template<class T>
-    bool operator<=(const deque<T> &lhs, const deque<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator<=(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
         return !(rhs < lhs);
     }
 
-    template<class T>
-    bool operator>=(const deque<T> &lhs, const deque<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator>=(const deque<T, Alloc> &lhs, const deque<T, Alloc> &rhs) {
         return !(lhs < rhs);
     }
 
 // 重载 mystl 的 swap 函数
-    template<class T>
-    void swap(deque<T> &lhs, deque<T> &rhs) {
+    template<class T, class Alloc>
+    void swap(deque<T, Alloc> &lhs, deque<T, Alloc> &rhs) {
         lhs.swap(rhs);
     }
 
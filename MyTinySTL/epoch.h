@@ -0,0 +1,149 @@
+#ifndef MYTINYSTL_EPOCH_H_
+#define MYTINYSTL_EPOCH_H_
+
+// 这个头文件包含两个类 epoch_domain 和 epoch_guard
+// epoch_domain : 基于 epoch 的延迟回收，读者进出只修改一个计数器，从不等待
+// epoch_guard  : 读者在 epoch_domain 中的 RAII 登记
+
+// notes:
+//
+// 1. 全局 epoch 单调递增，读者进入时登记在当前 epoch 奇偶位对应的计数器上；
+//    计数器按线程分散到多条 cache line，多核同时读时不会争用同一条 cache line
+// 2. 写者摘下节点后以当前 epoch 为标记退休（retire）该节点，epoch 前进两次之后才能释放：
+//    从 e 前进到 e + 1 要求 e - 1 的读者已全部离开，因此 epoch 为 t + 2 时，
+//    所有可能看到 t 时退休节点的读者都已离开
+// 3. try_advance 只检查计数器，条件不满足时立即返回，写者也不会等待读者；
+//    try_advance 必须由同一时刻唯一的写者调用（例如持有写锁时）
+// 4. 复制 epoch_guard 时登记在原 guard 的同一个计数器上，副本与原 guard 保护同样的节点
+
+#include <atomic>
+#include <cstddef>
+
+#include "util.h"
+
+namespace mystl {
+
+    class epoch_domain {
+    public:
+        static constexpr size_t stripes = 16;  // 每个奇偶位的计数器个数
+
+    private:
+        struct alignas(64) counter {
+            std::atomic<size_t> value;
+        };
+
+        std::atomic<size_t> epoch_;
+        counter active_[2][stripes];
+
+    public:
+        epoch_domain() noexcept: epoch_(0) {
+            for (size_t p = 0; p < 2; ++p) {
+                for (size_t s = 0; s < stripes; ++s) {
+                    active_[p][s].value.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        epoch_domain(const epoch_domain &) = delete;
+
+        epoch_domain &operator=(const epoch_domain &) = delete;
+
+        // 读者进入，返回登记的计数器编号；只在 epoch 恰好前进时重试，不会阻塞
+        size_t enter() noexcept {
+            const size_t s = stripe();
+            while (true) {
+                const size_t e = epoch_.load(std::memory_order_seq_cst);
+                active_[e & 1][s].value.fetch_add(1, std::memory_order_seq_cst);
+                if (epoch_.load(std::memory_order_seq_cst) == e) {
+                    return (e & 1) * stripes + s;
+                }
+                active_[e & 1][s].value.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        // 在已登记的计数器上再登记一次，用于复制 guard
+        void enter_again(size_t slot) noexcept {
+            active_[slot / stripes][slot % stripes].value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // 读者离开
+        void leave(size_t slot) noexcept {
+            active_[slot / stripes][slot % stripes].value.fetch_sub(1, std::memory_order_release);
+        }
+
+        size_t epoch() const noexcept { return epoch_.load(std::memory_order_seq_cst); }
+
+        // 上一个 epoch 的读者都已离开时把 epoch 加一，否则什么也不做
+        bool try_advance() noexcept {
+            const size_t e = epoch_.load(std::memory_order_relaxed);
+            const auto &prev = active_[(e + 1) & 1];
+            for (size_t s = 0; s < stripes; ++s) {
+                if (prev[s].value.load(std::memory_order_seq_cst) != 0) {
+                    return false;
+                }
+            }
+            epoch_.store(e + 1, std::memory_order_seq_cst);
+            return true;
+        }
+
+        // 标记为 retire_epoch 的节点现在能否释放
+        bool can_reclaim(size_t retire_epoch) const noexcept {
+            return retire_epoch + 2 <= epoch();
+        }
+
+    private:
+        // 每个线程固定使用一个计数器，按首次使用的顺序轮流分配
+        static size_t stripe() noexcept {
+            static std::atomic<size_t> next(0);
+            static thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed) % stripes;
+            return index;
+        }
+    };
+
+    // 读者登记，析构时离开
+    class epoch_guard {
+    private:
+        epoch_domain *domain_;
+        size_t slot_;
+
+    public:
+        epoch_guard() noexcept: domain_(nullptr), slot_(0) {}
+
+        explicit epoch_guard(epoch_domain &domain) noexcept: domain_(&domain), slot_(domain.enter()) {}
+
+        epoch_guard(const epoch_guard &rhs) noexcept: domain_(rhs.domain_), slot_(rhs.slot_) {
+            if (domain_ != nullptr) {
+                domain_->enter_again(slot_);
+            }
+        }
+
+        epoch_guard(epoch_guard &&rhs) noexcept: domain_(rhs.domain_), slot_(rhs.slot_) {
+            rhs.domain_ = nullptr;
+        }
+
+        epoch_guard &operator=(const epoch_guard &rhs) noexcept {
+            epoch_guard tmp(rhs);
+            swap(tmp);
+            return *this;
+        }
+
+        epoch_guard &operator=(epoch_guard &&rhs) noexcept {
+            epoch_guard tmp(mystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        ~epoch_guard() {
+            if (domain_ != nullptr) {
+                domain_->leave(slot_);
+            }
+        }
+
+        void swap(epoch_guard &rhs) noexcept {
+            mystl::swap(domain_, rhs.domain_);
+            mystl::swap(slot_, rhs.slot_);
+        }
+    };
+
+} // namespace mystl
+#endif // !MYTINYSTL_EPOCH_H_
@@ -0,0 +1,623 @@
+#ifndef MYTINYSTL_FLAT_TREE_H_
+#define MYTINYSTL_FLAT_TREE_H_
+
+// 这个头文件包含一个模板类 flat_tree
+// flat_tree : 以有序 vector 实现的关联容器底层，作为 flat_set / flat_multiset / flat_map / flat_multimap 的底层机制
+// 读多写少时用 flat_tree，查找是在连续内存上的二分查找，比红黑树的指针跳转更友好
+
+// notes:
+//
+// 1. 元素按键值有序地存放在 mystl::vector 中，单个插入、删除需要移动其后的元素，为 O(n)
+// 2. 区间插入 insert_unique(first, last) / insert_multi(first, last) 先把新元素追加到尾部，
+//    对新元素排序后与原有元素做一次归并，总代价为 O(n + m log m)
+// 3. 任何插入、删除都会使迭代器失效
+
+#include <initializer_list>
+
+#include "functional.h"
+#include "iterator.h"
+#include "vector.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // flat tree value traits
+    // 值为 pair 时以 first 为键值，否则值本身即为键值
+    template<class T, bool>
+    struct flat_tree_value_traits_imp {
+        typedef T key_type;
+        typedef T mapped_type;
+        typedef T value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value;
+        }
+    };
+
+    template<class T>
+    struct flat_tree_value_traits_imp<T, true> {
+        typedef typename std::remove_cv<typename T::first_type>::type key_type;
+        typedef typename T::second_type mapped_type;
+        typedef T value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value.first;
+        }
+    };
+
+    template<class T>
+    struct flat_tree_value_traits {
+        static constexpr bool is_map = mystl::is_pair<T>::value;
+
+        typedef flat_tree_value_traits_imp<T, is_map> value_traits_type;
+        typedef typename value_traits_type::key_type key_type;
+        typedef typename value_traits_type::mapped_type mapped_type;
+        typedef typename value_traits_type::value_type value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value_traits_type::get_key(value);
+        }
+    };
+
+    // 模板类 flat_tree
+    // 参数一代表元素类型，参数二代表键值比较方式
+    template<class T, class Compare>
+    class flat_tree {
+    public:
+        // flat_tree 的嵌套型别定义
+        typedef flat_tree_value_traits<T> value_traits;
+
+        typedef typename value_traits::key_type key_type;
+        typedef typename value_traits::mapped_type mapped_type;
+        typedef typename value_traits::value_type value_type;
+        typedef Compare key_compare;
+
+        typedef mystl::vector<T> container_type;
+        typedef typename container_type::allocator_type allocator_type;
+        typedef typename container_type::pointer pointer;
+        typedef typename container_type::const_pointer const_pointer;
+        typedef typename container_type::reference reference;
+        typedef typename container_type::const_reference const_reference;
+        typedef typename container_type::size_type size_type;
+        typedef typename container_type::difference_type difference_type;
+
+        typedef typename container_type::iterator iterator;
+        typedef typename container_type::const_iterator const_iterator;
+        typedef mystl::reverse_iterator<iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        allocator_type get_allocator() const { return allocator_type(); }
+
+        key_compare key_comp() const { return key_comp_; }
+
+    private:
+        container_type data_;    // 有序存放的元素
+        key_compare key_comp_;   // 键值比较的准则
+
+    public:
+        // 构造、复制、移动函数
+        flat_tree() = default;
+
+        flat_tree(const flat_tree &rhs) = default;
+
+        flat_tree(flat_tree &&rhs) noexcept
+                : data_(mystl::move(rhs.data_)), key_comp_(rhs.key_comp_) {
+        }
+
+        flat_tree &operator=(const flat_tree &rhs) = default;
+
+        flat_tree &operator=(flat_tree &&rhs) {
+            data_ = mystl::move(rhs.data_);
+            key_comp_ = rhs.key_comp_;
+            return *this;
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return data_.begin(); }
+
+        const_iterator begin() const noexcept { return data_.begin(); }
+
+        iterator end() noexcept { return data_.end(); }
+
+        const_iterator end() const noexcept { return data_.end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return data_.empty(); }
+
+        size_type size() const noexcept { return data_.size(); }
+
+        size_type max_size() const noexcept { return data_.max_size(); }
+
+        size_type capacity() const noexcept { return data_.capacity(); }
+
+        void reserve(size_type n) { data_.reserve(n); }
+
+        void shrink_to_fit() { data_.shrink_to_fit(); }
+
+        // 插入删除相关操作
+        template<class ...Args>
+        iterator emplace_multi(Args &&...args);
+
+        template<class ...Args>
+        mystl::pair<iterator, bool> emplace_unique(Args &&...args);
+
+        template<class ...Args>
+        iterator emplace_multi_use_hint(const_iterator hint, Args &&...args);
+
+        template<class ...Args>
+        iterator emplace_unique_use_hint(const_iterator hint, Args &&...args);
+
+        iterator insert_multi(const value_type &value) { return emplace_multi(value); }
+
+        iterator insert_multi(value_type &&value) { return emplace_multi(mystl::move(value)); }
+
+        iterator insert_multi(const_iterator hint, const value_type &value) {
+            return emplace_multi_use_hint(hint, value);
+        }
+
+        iterator insert_multi(const_iterator hint, value_type &&value) {
+            return emplace_multi_use_hint(hint, mystl::move(value));
+        }
+
+        template<class InputIterator>
+        void insert_multi(InputIterator first, InputIterator last) {
+            append_and_merge(first, last, false);
+        }
+
+        mystl::pair<iterator, bool> insert_unique(const value_type &value) { return emplace_unique(value); }
+
+        mystl::pair<iterator, bool> insert_unique(value_type &&value) { return emplace_unique(mystl::move(value)); }
+
+        iterator insert_unique(const_iterator hint, const value_type &value) {
+            return emplace_unique_use_hint(hint, value);
+        }
+
+        iterator insert_unique(const_iterator hint, value_type &&value) {
+            return emplace_unique_use_hint(hint, mystl::move(value));
+        }
+
+        template<class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            append_and_merge(first, last, true);
+        }
+
+        iterator erase(const_iterator pos) { return data_.erase(pos); }
+
+        iterator erase(const_iterator first, const_iterator last) { return data_.erase(first, last); }
+
+        size_type erase_multi(const key_type &key);
+
+        size_type erase_unique(const key_type &key);
+
+        void clear() { data_.clear(); }
+
+        // flat_tree 相关操作
+        iterator find(const key_type &key);
+
+        const_iterator find(const key_type &key) const;
+
+        size_type count_multi(const key_type &key) const {
+            auto p = equal_range_multi(key);
+            return static_cast<size_type>(p.second - p.first);
+        }
+
+        size_type count_unique(const key_type &key) const {
+            return find(key) != end() ? 1 : 0;
+        }
+
+        iterator lower_bound(const key_type &key);
+
+        const_iterator lower_bound(const key_type &key) const;
+
+        iterator upper_bound(const key_type &key);
+
+        const_iterator upper_bound(const key_type &key) const;
+
+        mystl::pair<iterator, iterator>
+        equal_range_multi(const key_type &key) {
+            return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        mystl::pair<const_iterator, const_iterator>
+        equal_range_multi(const key_type &key) const {
+            return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        mystl::pair<iterator, iterator>
+        equal_range_unique(const key_type &key) {
+            iterator it = find(key);
+            auto next = it;
+            return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+        }
+
+        mystl::pair<const_iterator, const_iterator>
+        equal_range_unique(const key_type &key) const {
+            const_iterator it = find(key);
+            auto next = it;
+            return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+        }
+
+        void swap(flat_tree &rhs) noexcept {
+            data_.swap(rhs.data_);
+            mystl::swap(key_comp_, rhs.key_comp_);
+        }
+
+    private:
+        // helper functions
+        bool value_less(const value_type &lhs, const value_type &rhs) const {
+            return key_comp_(value_traits::get_key(lhs), value_traits::get_key(rhs));
+        }
+
+        // 在 [first, last) 上二分查找第一个不小于 key 的位置
+        template<class Iter>
+        Iter lower_bound_in(Iter first, Iter last, const key_type &key) const;
+
+        // 在 [first, last) 上二分查找第一个大于 key 的位置
+        template<class Iter>
+        Iter upper_bound_in(Iter first, Iter last, const key_type &key) const;
+
+        // 在 hint 附近找到插入位置，hint 正确时为 O(1)
+        const_iterator get_insert_multi_pos(const_iterator hint, const key_type &key) const;
+
+        void insertion_sort(iterator first, iterator last);
+
+        void stable_sort(iterator first, iterator last, container_type &buf);
+
+        void merge_tail(size_type mid, container_type &buf);
+
+        void unique_from(size_type pos);
+
+        template<class InputIterator>
+        void append_and_merge(InputIterator first, InputIterator last, bool unique);
+
+    public:
+        friend bool operator==(const flat_tree &lhs, const flat_tree &rhs) {
+            return lhs.data_ == rhs.data_;
+        }
+
+        friend bool operator<(const flat_tree &lhs, const flat_tree &rhs) {
+            return lhs.data_ < rhs.data_;
+        }
+    };
+
+/*****************************************************************************************/
+
+// 就地构造元素，键值允许重复
+    template<class T, class Compare>
+    template<class ...Args>
+    typename flat_tree<T, Compare>::iterator
+    flat_tree<T, Compare>::
+    emplace_multi(Args &&...args) {
+        value_type value(mystl::forward<Args>(args)...);
+        auto pos = upper_bound(value_traits::get_key(value));
+        return data_.emplace(pos, mystl::move(value));
+    }
+
+// 就地构造元素，键值不允许重复
+    template<class T, class Compare>
+    template<class ...Args>
+    mystl::pair<typename flat_tree<T, Compare>::iterator, bool>
+    flat_tree<T, Compare>::
+    emplace_unique(Args &&...args) {
+        value_type value(mystl::forward<Args>(args)...);
+        auto pos = lower_bound(value_traits::get_key(value));
+        if (pos != end() && !key_comp_(value_traits::get_key(value), value_traits::get_key(*pos))) {
+            return mystl::make_pair(pos, false);
+        }
+        return mystl::make_pair(data_.emplace(pos, mystl::move(value)), true);
+    }
+
+// 就地构造元素，键值允许重复，当 hint 位置与插入位置接近时，查找为 O(1)
+    template<class T, class Compare>
+    template<class ...Args>
+    typename flat_tree<T, Compare>::iterator
+    flat_tree<T, Compare>::
+    emplace_multi_use_hint(const_iterator hint, Args &&...args) {
+        value_type value(mystl::forward<Args>(args)...);
+        auto pos = get_insert_multi_pos(hint, value_traits::get_key(value));
+        return data_.emplace(pos, mystl::move(value));
+    }
+
+// 就地构造元素，键值不允许重复，当 hint 位置与插入位置接近时，查找为 O(1)
+    template<class T, class Compare>
+    template<class ...Args>
+    typename flat_tree<T, Compare>::iterator
+    flat_tree<T, Compare>::
+    emplace_unique_use_hint(const_iterator hint, Args &&...args) {
+        value_type value(mystl::forward<Args>(args)...);
+        const key_type &key = value_traits::get_key(value);
+        auto pos = get_insert_multi_pos(hint, key);
+        // 插入位置前一个元素与 key 相等，则 key 已存在
+        if (pos != begin() && !key_comp_(value_traits::get_key(*(pos - 1)), key)) {
+            return const_cast<iterator>(pos - 1);
+        }
+        if (pos != end() && !key_comp_(key, value_traits::get_key(*pos))) {
+            return const_cast<iterator>(pos);
+        }
+        return data_.emplace(pos, mystl::move(value));
+    }
+
+// 删除键值等于 key 的元素，返回删除的个数
+    template<class T, class Compare>
+    typename flat_tree<T, Compare>::size_type
+    flat_tree<T, Compare>::
+    erase_multi(const key_type &key) {
+        auto p = equal_range_multi(key);
+        size_type n = static_cast<size_type>(p.second - p.first);
+        data_.erase(p.first, p.second);
+        return n;
+    }
+
+// 删除键值等于 key 的元素，返回删除的个数
+    template<class T, class Compare>
+    typename flat_tree<T, Compare>::size_type
+    flat_tree<T, Compare>::
+    erase_unique(const key_type &key) {
+        auto it = find(key);
+        if (it != end()) {
+            data_.erase(it);
+            return 1;
+        }
+        return 0;
+    }
+
+// 查找键值为 key 的元素，返回指向它的迭代器
+    template<class T, class Compare>
+    typename flat_tree<T, Compare>::iterator
+    flat_tree<T, Compare>::
+    find(const key_type &key) {
+        auto it = lower_bound(key);
+        return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+    }
+
+    template<class T, class Compare>
+    typename flat_tree<T, Compare>::const_iterator
+    flat_tree<T, Compare>::
+    find(const key_type &key) const {
+        auto it = lower_bound(key);
+        return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+    }
+
+// 键值不小于 key 的第一个位置
+    template<class T, class Compare>
+    typename flat_tree<T, Compare>::iterator
+    flat_tree<T, Compare>::
+    lower_bound(const key_type &key) {
+        return lower_bound_in(begin(), end(), key);
+    }
+
+    template<class T, class Compare>
+    typename flat_tree<T, Compare>::const_iterator
+    flat_tree<T, Compare>::
+    lower_bound(const key_type &key) const {
+        return lower_bound_in(begin(), end(), key);
+    }
+
+// 键值大于 key 的第一个位置
+    template<class T, class Compare>
+    typename flat_tree<T, Compare>::iterator
+    flat_tree<T, Compare>::
+    upper_bound(const key_type &key) {
+        return upper_bound_in(begin(), end(), key);
+    }
+
+    template<class T, class Compare>
+    typename flat_tree<T, Compare>::const_iterator
+    flat_tree<T, Compare>::
+    upper_bound(const key_type &key) const {
+        return upper_bound_in(begin(), end(), key);
+    }
+
+/*****************************************************************************************/
+// helper function
+
+// 二分查找，迭代器为指针，每次取中点只需一次加法
+    template<class T, class Compare>
+    template<class Iter>
+    Iter flat_tree<T, Compare>::
+    lower_bound_in(Iter first, Iter last, const key_type &key) const {
+        auto len = last - first;
+        while (len > 0) {
+            auto half = len >> 1;
+            auto middle = first + half;
+            if (key_comp_(value_traits::get_key(*middle), key)) {
+                first = middle + 1;
+                len = len - half - 1;
+            } else {
+                len = half;
+            }
+        }
+        return first;
+    }
+
+    template<class T, class Compare>
+    template<class Iter>
+    Iter flat_tree<T, Compare>::
+    upper_bound_in(Iter first, Iter last, const key_type &key) const {
+        auto len = last - first;
+        while (len > 0) {
+            auto half = len >> 1;
+            auto middle = first + half;
+            if (!key_comp_(key, value_traits::get_key(*middle))) {
+                first = middle + 1;
+                len = len - half - 1;
+            } else {
+                len = half;
+            }
+        }
+        return first;
+    }
+
+// 返回不破坏有序性且最靠近 hint 的插入位置
+    template<class T, class Compare>
+    typename flat_tree<T, Compare>::const_iterator
+    flat_tree<T, Compare>::
+    get_insert_multi_pos(const_iterator hint, const key_type &key) const {
+        if (hint != end() && key_comp_(value_traits::get_key(*hint), key)) {
+            // hint 处的元素小于 key，插入位置在 hint 之后
+            return upper_bound_in(hint + 1, end(), key);
+        }
+        if (hint != begin() && key_comp_(key, value_traits::get_key(*(hint - 1)))) {
+            // hint 前一个元素大于 key，插入位置在 hint 之前
+            return upper_bound_in(begin(), hint - 1, key);
+        }
+        return hint;
+    }
+
+// 插入排序，用于小区间
+    template<class T, class Compare>
+    void flat_tree<T, Compare>::
+    insertion_sort(iterator first, iterator last) {
+        if (first == last) {
+            return;
+        }
+        for (auto i = first + 1; i != last; ++i) {
+            value_type value = mystl::move(*i);
+            auto j = i;
+            for (; j != first && value_less(value, *(j - 1)); --j) {
+                *j = mystl::move(*(j - 1));
+            }
+            *j = mystl::move(value);
+        }
+    }
+
+// 稳定的归并排序，buf 用作左半部分的暂存区
+    template<class T, class Compare>
+    void flat_tree<T, Compare>::
+    stable_sort(iterator first, iterator last, container_type &buf) {
+        const auto len = last - first;
+        if (len <= 16) {
+            insertion_sort(first, last);
+            return;
+        }
+        auto middle = first + len / 2;
+        stable_sort(first, middle, buf);
+        stable_sort(middle, last, buf);
+        // 两半已经首尾有序时不需要归并
+        if (!value_less(*middle, *(middle - 1))) {
+            return;
+        }
+        buf.clear();
+        for (auto it = first; it != middle; ++it) {
+            buf.push_back(mystl::move(*it));
+        }
+        auto b = buf.begin();
+        auto r = middle;
+        auto out = first;
+        while (b != buf.end() && r != last) {
+            // 相等时取左边的元素，保持稳定
+            if (value_less(*r, *b)) {
+                *out++ = mystl::move(*r++);
+            } else {
+                *out++ = mystl::move(*b++);
+            }
+        }
+        while (b != buf.end()) {
+            *out++ = mystl::move(*b++);
+        }
+    }
+
+// 将有序的 [begin, begin + mid) 与有序的 [begin + mid, end) 归并
+// 从尾部向前归并，只需暂存后半部分，键值相等时原有元素排在前面
+    template<class T, class Compare>
+    void flat_tree<T, Compare>::
+    merge_tail(size_type mid, container_type &buf) {
+        auto first = begin();
+        auto middle = first + mid;
+        auto last = end();
+        if (middle == first || middle == last || !value_less(*middle, *(middle - 1))) {
+            return;
+        }
+        // 新元素中比原有元素都大的部分已在正确位置上
+        auto tail = upper_bound_in(middle, last, value_traits::get_key(*(middle - 1)));
+        // 原有元素中比新元素都小的部分不需要移动
+        auto head = upper_bound_in(first, middle, value_traits::get_key(*middle));
+        buf.clear();
+        for (auto it = middle; it != tail; ++it) {
+            buf.push_back(mystl::move(*it));
+        }
+        auto l = middle;
+        auto b = buf.end();
+        auto out = tail;
+        while (b != buf.begin() && l != head) {
+            if (value_less(*(b - 1), *(l - 1))) {
+                *--out = mystl::move(*--l);
+            } else {
+                *--out = mystl::move(*--b);
+            }
+        }
+        while (b != buf.begin()) {
+            *--out = mystl::move(*--b);
+        }
+    }
+
+// 从 pos 开始去除键值重复的元素，每组相等的元素只保留第一个
+    template<class T, class Compare>
+    void flat_tree<T, Compare>::
+    unique_from(size_type pos) {
+        if (size() - pos < 2) {
+            return;
+        }
+        auto result = begin() + pos;
+        auto first = result + 1;
+        for (; first != end(); ++first) {
+            if (value_less(*result, *first)) {
+                if (++result != first) {
+                    *result = mystl::move(*first);
+                }
+            }
+        }
+        data_.erase(result + 1, end());
+    }
+
+// 区间插入：追加到尾部，排序新元素后与原有元素一次归并
+    template<class T, class Compare>
+    template<class InputIterator>
+    void flat_tree<T, Compare>::
+    append_and_merge(InputIterator first, InputIterator last, bool unique) {
+        const size_type old_size = size();
+        try {
+            for (; first != last; ++first) {
+                data_.emplace_back(*first);
+            }
+        } catch (...) {
+            data_.erase(begin() + old_size, end());
+            throw;
+        }
+        if (size() == old_size) {
+            return;
+        }
+        container_type buf;
+        try {
+            stable_sort(begin() + old_size, end(), buf);
+            merge_tail(old_size, buf);
+        } catch (...) {
+            // 排序或归并中途失败时元素已被打乱，只能清空以保证有序性
+            clear();
+            throw;
+        }
+        if (unique) {
+            unique_from(0);
+        }
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_FLAT_TREE_H_
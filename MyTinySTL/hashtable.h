@@ -0,0 +1,997 @@
+#ifndef MYTINYSTL_HASHTABLE_H_
+#define MYTINYSTL_HASHTABLE_H_
+
+// 这个头文件包含一个模板类 hashtable
+// hashtable : 链式哈希表，作为 unordered_set / unordered_multiset / unordered_map / unordered_multimap 的底层机制
+
+// notes:
+//
+// 1. 每个桶是一条单向链表，桶数取自素数表（每项约为前一项的两倍），mystl::hash 对整数是恒等映射，
+//    素数桶数不会让有规律的键值集中在少数几个桶中
+// 2. 节点从 hashtable 自己的节点池（node_pool.h）中分配，删除归还的节点由之后的插入复用；
+//    节点中缓存了哈希值，rehash 不再调用哈希函数，查找时先比较哈希值再比较键值
+// 3. 元素一经插入就不再移动，rehash 只重新链接节点，元素的引用和指针在删除前一直有效
+// 4. 元素个数超过 bucket_count() * max_load_factor() 时 rehash，桶数至少加倍
+// 5. 键值相等的元素在链表中相邻，按插入的先后排列，rehash 后保持不变
+// 6. 迭代器记录所在的桶，rehash 使所有迭代器失效，删除只使被删除元素的迭代器失效
+//
+// 异常保证：
+// insert / emplace 做强异常安全保证；rehash 只在分配新桶时可能抛出异常，此时哈希表不变
+
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "node_pool.h"
+#include "type_traits.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // hashtable 的节点
+    template<class T>
+    struct hashtable_node {
+        hashtable_node *next;  // 同一个桶中的下一个节点
+        size_t hash;           // 缓存的哈希值
+        T value;
+    };
+
+    // hashtable value traits
+    // 值为 pair 时以 first 为键值，否则值本身即为键值
+    template<class T, bool>
+    struct ht_value_traits_imp {
+        typedef T key_type;
+        typedef T mapped_type;
+        typedef T value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value;
+        }
+    };
+
+    template<class T>
+    struct ht_value_traits_imp<T, true> {
+        typedef typename std::remove_cv<typename T::first_type>::type key_type;
+        typedef typename T::second_type mapped_type;
+        typedef T value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value.first;
+        }
+    };
+
+    template<class T>
+    struct ht_value_traits {
+        static constexpr bool is_map = mystl::is_pair<T>::value;
+
+        typedef ht_value_traits_imp<T, is_map> value_traits_type;
+        typedef typename value_traits_type::key_type key_type;
+        typedef typename value_traits_type::mapped_type mapped_type;
+        typedef typename value_traits_type::value_type value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value_traits_type::get_key(value);
+        }
+    };
+
+    // 桶数使用的素数表，每一项约为前一项的两倍
+    // 返回不小于 n 的最小素数，超过表中最大的素数时返回最大的素数
+    inline size_t ht_next_prime(size_t n) noexcept {
+        static const size_t ht_prime_list[] = {
+                5u, 11u, 23u, 47u, 97u, 197u, 397u, 797u, 1597u, 3203u, 6421u, 12853u, 25717u, 51437u,
+                102877u, 205759u, 411527u, 823117u, 1646237u, 3292489u, 6584983u, 13169977u, 26339969u,
+                52679969u, 105359939u, 210719881u, 421439783u, 842879579u, 1685759167u, 3371518343u,
+#if SIZE_MAX > 0xffffffffu
+                6743036717ull, 13486073473ull, 26972146961ull, 53944293929ull, 107888587883ull,
+                215777175787ull, 431554351609ull, 863108703229ull, 1726217406467ull, 3452434812973ull,
+                6904869625999ull, 13809739252051ull, 27619478504183ull, 55238957008387ull,
+                110477914016779ull, 220955828033581ull, 441911656067171ull, 883823312134381ull,
+                1767646624268779ull, 3535293248537579ull, 7070586497075177ull, 14141172994150357ull,
+                28282345988300791ull, 56564691976601587ull, 113129383953203213ull, 226258767906406483ull,
+                452517535812813007ull, 905035071625626043ull, 1810070143251252131ull,
+                3620140286502504283ull, 7240280573005008577ull, 14480561146010017169ull,
+                18446744073709551557ull
+#else
+                4294967291u
+#endif
+        };
+        const size_t count = sizeof(ht_prime_list) / sizeof(ht_prime_list[0]);
+        size_t first = 0, len = count;
+        while (len > 0) {
+            const size_t half = len / 2;
+            if (ht_prime_list[first + half] < n) {
+                first += half + 1;
+                len -= half + 1;
+            } else {
+                len = half;
+            }
+        }
+        return first == count ? ht_prime_list[count - 1] : ht_prime_list[first];
+    }
+
+    // hashtable 的迭代器，记录当前节点和所在的桶，一个桶遍历完后找下一个非空的桶
+    template<class T, class Ref, class Ptr>
+    struct ht_iterator : public iterator<forward_iterator_tag, T> {
+        typedef hashtable_node<T> *node_ptr;
+        typedef ht_iterator<T, T &, T *> iterator;
+        typedef ht_iterator<T, const T &, const T *> const_iterator;
+        typedef ht_iterator<T, Ref, Ptr> self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef ptrdiff_t difference_type;
+
+        node_ptr node;         // 当前节点，end() 为 nullptr
+        node_ptr *bucket;      // 当前节点所在的桶
+        node_ptr *bucket_end;  // 桶数组的尾部
+
+        ht_iterator() noexcept: node(nullptr), bucket(nullptr), bucket_end(nullptr) {}
+
+        ht_iterator(node_ptr n, node_ptr *b, node_ptr *e) noexcept: node(n), bucket(b), bucket_end(e) {}
+
+        ht_iterator(const iterator &rhs) noexcept: node(rhs.node), bucket(rhs.bucket), bucket_end(rhs.bucket_end) {}
+
+        reference operator*() const { return node->value; }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self &operator++() {
+            node = node->next;
+            if (node == nullptr) {
+                while (++bucket != bucket_end && *bucket == nullptr) {}
+                node = bucket == bucket_end ? nullptr : *bucket;
+            }
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return node == rhs.node; }
+
+        bool operator!=(const self &rhs) const { return node != rhs.node; }
+    };
+
+    // 桶内的迭代器，只在一个桶中移动
+    template<class T, class Ref, class Ptr>
+    struct ht_local_iterator : public iterator<forward_iterator_tag, T> {
+        typedef hashtable_node<T> *node_ptr;
+        typedef ht_local_iterator<T, T &, T *> local_iterator;
+        typedef ht_local_iterator<T, Ref, Ptr> self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef ptrdiff_t difference_type;
+
+        node_ptr node;
+
+        ht_local_iterator() noexcept: node(nullptr) {}
+
+        explicit ht_local_iterator(node_ptr n) noexcept: node(n) {}
+
+        ht_local_iterator(const local_iterator &rhs) noexcept: node(rhs.node) {}
+
+        reference operator*() const { return node->value; }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self &operator++() {
+            node = node->next;
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return node == rhs.node; }
+
+        bool operator!=(const self &rhs) const { return node != rhs.node; }
+    };
+
+    // 模板类 hashtable
+    // 参数一代表元素类型，参数二代表哈希函数，参数三代表键值相等的比较方式
+    template<class T, class Hash, class KeyEqual>
+    class hashtable {
+    public:
+        // hashtable 的嵌套型别定义
+        typedef ht_value_traits<T> value_traits;
+
+        typedef typename value_traits::key_type key_type;
+        typedef typename value_traits::mapped_type mapped_type;
+        typedef typename value_traits::value_type value_type;
+        typedef Hash hasher;
+        typedef KeyEqual key_equal;
+
+        typedef hashtable_node<T> node_type;
+        typedef node_type *node_ptr;
+
+        typedef mystl::allocator<T> allocator_type;
+        typedef mystl::allocator<T> data_allocator;
+        typedef mystl::allocator<node_ptr> bucket_allocator;
+        typedef mystl::node_pool<node_type> node_pool_type;
+
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        typedef ht_iterator<T, T &, T *> iterator;
+        typedef ht_iterator<T, const T &, const T *> const_iterator;
+        typedef ht_local_iterator<T, T &, T *> local_iterator;
+        typedef ht_local_iterator<T, const T &, const T *> const_local_iterator;
+
+        allocator_type get_allocator() const { return allocator_type(); }
+
+    private:
+        node_ptr *buckets_;
+        size_type bucket_count_;  // 0 或素数表中的一项
+        size_type size_;
+        float mlf_;               // 最大负载因子
+        hasher hash_;
+        key_equal equal_;
+        node_pool_type pool_;     // 节点池
+
+    public:
+        // 构造、复制、移动、析构函数
+        hashtable() : hashtable(0, hasher(), key_equal()) {}
+
+        hashtable(size_type bucket_count, const hasher &hash, const key_equal &equal)
+                : buckets_(nullptr), bucket_count_(0), size_(0), mlf_(1.0f), hash_(hash), equal_(equal) {
+            if (bucket_count != 0) {
+                rehash_to(ht_next_prime(bucket_count));
+            }
+        }
+
+        hashtable(const hashtable &rhs);
+
+        hashtable(hashtable &&rhs) noexcept;
+
+        hashtable &operator=(const hashtable &rhs);
+
+        hashtable &operator=(hashtable &&rhs) noexcept;
+
+        ~hashtable() {
+            clear();
+            deallocate_buckets();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept {
+            for (size_type n = 0; n < bucket_count_; ++n) {
+                if (buckets_[n] != nullptr) {
+                    return iterator(buckets_[n], buckets_ + n, buckets_ + bucket_count_);
+                }
+            }
+            return end();
+        }
+
+        const_iterator begin() const noexcept {
+            return const_cast<hashtable *>(this)->begin();
+        }
+
+        iterator end() noexcept {
+            return iterator(nullptr, buckets_ + bucket_count_, buckets_ + bucket_count_);
+        }
+
+        const_iterator end() const noexcept {
+            return const_cast<hashtable *>(this)->end();
+        }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return size_ == 0; }
+
+        size_type size() const noexcept { return size_; }
+
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(node_type); }
+
+        // 插入删除相关操作
+        template<class ...Args>
+        pair<iterator, bool> emplace_unique(Args &&...args);
+
+        template<class ...Args>
+        iterator emplace_multi(Args &&...args);
+
+        pair<iterator, bool> insert_unique(const value_type &value) {
+            return insert_value_unique(value);
+        }
+
+        pair<iterator, bool> insert_unique(value_type &&value) {
+            return insert_value_unique(mystl::move(value));
+        }
+
+        iterator insert_multi(const value_type &value) {
+            return emplace_multi(value);
+        }
+
+        iterator insert_multi(value_type &&value) {
+            return emplace_multi(mystl::move(value));
+        }
+
+        template<class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            for (; first != last; ++first)
+                insert_value_unique(*first);
+        }
+
+        template<class InputIterator>
+        void insert_multi(InputIterator first, InputIterator last) {
+            for (; first != last; ++first)
+                emplace_multi(*first);
+        }
+
+        // 键值不存在时才以 key 和 args 构造元素，只用于 map
+        template<class K, class ...Args>
+        pair<iterator, bool> try_emplace_unique(K &&key, Args &&...args);
+
+        iterator erase(const_iterator pos);
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        template<class K>
+        size_type erase_unique(const K &key);
+
+        template<class K>
+        size_type erase_multi(const K &key);
+
+        void clear() noexcept;
+
+        // 查找相关操作
+        template<class K>
+        iterator find(const K &key) {
+            if (size_ == 0) {
+                return end();
+            }
+            const auto hash = hash_(key);
+            const auto n = bucket_index(hash);
+            return iterator(find_in_bucket(n, key, hash), buckets_ + n, buckets_ + bucket_count_);
+        }
+
+        template<class K>
+        const_iterator find(const K &key) const {
+            return const_cast<hashtable *>(this)->find(key);
+        }
+
+        template<class K>
+        size_type count_unique(const K &key) const {
+            return find(key) != end() ? 1 : 0;
+        }
+
+        template<class K>
+        size_type count_multi(const K &key) const;
+
+        template<class K>
+        pair<iterator, iterator> equal_range_unique(const K &key) {
+            auto it = find(key);
+            if (it == end()) {
+                return mystl::make_pair(it, it);
+            }
+            auto next = it;
+            return mystl::make_pair(it, ++next);
+        }
+
+        template<class K>
+        pair<const_iterator, const_iterator> equal_range_unique(const K &key) const {
+            auto r = const_cast<hashtable *>(this)->equal_range_unique(key);
+            return mystl::make_pair(const_iterator(r.first), const_iterator(r.second));
+        }
+
+        template<class K>
+        pair<iterator, iterator> equal_range_multi(const K &key);
+
+        template<class K>
+        pair<const_iterator, const_iterator> equal_range_multi(const K &key) const {
+            auto r = const_cast<hashtable *>(this)->equal_range_multi(key);
+            return mystl::make_pair(const_iterator(r.first), const_iterator(r.second));
+        }
+
+        // bucket interface
+        local_iterator begin(size_type n) noexcept { return local_iterator(buckets_[n]); }
+
+        const_local_iterator begin(size_type n) const noexcept { return const_local_iterator(buckets_[n]); }
+
+        const_local_iterator cbegin(size_type n) const noexcept { return const_local_iterator(buckets_[n]); }
+
+        local_iterator end(size_type) noexcept { return local_iterator(); }
+
+        const_local_iterator end(size_type) const noexcept { return const_local_iterator(); }
+
+        const_local_iterator cend(size_type) const noexcept { return const_local_iterator(); }
+
+        size_type bucket_count() const noexcept { return bucket_count_; }
+
+        size_type max_bucket_count() const noexcept { return ht_next_prime(static_cast<size_type>(-1)); }
+
+        size_type bucket_size(size_type n) const noexcept;
+
+        template<class K>
+        size_type bucket(const K &key) const { return bucket_index(hash_(key)); }
+
+        // hash policy
+        float load_factor() const noexcept {
+            return bucket_count_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(bucket_count_);
+        }
+
+        float max_load_factor() const noexcept { return mlf_; }
+
+        void max_load_factor(float ml) {
+            THROW_OUT_OF_RANGE_IF(ml != ml || ml <= 0, "invalid hash load factor");
+            mlf_ = ml;
+        }
+
+        void rehash(size_type count);
+
+        void reserve(size_type count) {
+            rehash(buckets_for(count));
+        }
+
+        hasher hash_function() const { return hash_; }
+
+        key_equal key_eq() const { return equal_; }
+
+        void swap(hashtable &rhs) noexcept;
+
+    private:
+        // helper functions
+        size_type bucket_index(size_type hash) const noexcept { return hash % bucket_count_; }
+
+        // 以最大负载因子容纳 count 个元素需要的桶数
+        size_type buckets_for(size_type count) const noexcept {
+            const auto n = static_cast<float>(count) / mlf_;
+            return n >= static_cast<float>(max_bucket_count())
+                   ? max_bucket_count() : static_cast<size_type>(n) + (count != 0 ? 1 : 0);
+        }
+
+        // 在第 n 个桶中查找哈希值为 hash、键值等于 key 的节点
+        template<class K>
+        node_ptr find_in_bucket(size_type n, const K &key, size_type hash) const {
+            for (auto p = buckets_[n]; p != nullptr; p = p->next) {
+                if (p->hash == hash && equal_(value_traits::get_key(p->value), key)) {
+                    return p;
+                }
+            }
+            return nullptr;
+        }
+
+        iterator iterator_at(node_ptr p) noexcept {
+            const auto n = bucket_index(p->hash);
+            return iterator(p, buckets_ + n, buckets_ + bucket_count_);
+        }
+
+        template<class V>
+        pair<iterator, bool> insert_value_unique(V &&value);
+
+        // create / destroy node
+        template<class ...Args>
+        node_ptr create_node(Args &&...args);
+
+        void destroy_node(node_ptr p) noexcept;
+
+        // 再插入 n 个元素会超过最大负载因子时 rehash，桶数至少加倍
+        void rehash_if_need(size_type n);
+
+        // 把节点挂到第 n 个桶的头部
+        void link_front(size_type n, node_ptr p) noexcept {
+            p->next = buckets_[n];
+            buckets_[n] = p;
+        }
+
+        void rehash_to(size_type new_count);
+
+        void copy_from(const hashtable &rhs);
+
+        void deallocate_buckets() noexcept;
+    };
+
+/*****************************************************************************************/
+
+// 复制构造函数，桶数与 rhs 相同，每个桶中节点的顺序不变
+    template<class T, class Hash, class KeyEqual>
+    hashtable<T, Hash, KeyEqual>::
+    hashtable(const hashtable &rhs)
+            : buckets_(nullptr), bucket_count_(0), size_(0), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_) {
+        copy_from(rhs);
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    hashtable<T, Hash, KeyEqual>::
+    hashtable(hashtable &&rhs) noexcept
+            : buckets_(rhs.buckets_), bucket_count_(rhs.bucket_count_), size_(rhs.size_), mlf_(rhs.mlf_),
+              hash_(mystl::move(rhs.hash_)), equal_(mystl::move(rhs.equal_)), pool_(mystl::move(rhs.pool_)) {
+        rhs.buckets_ = nullptr;
+        rhs.bucket_count_ = 0;
+        rhs.size_ = 0;
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    hashtable<T, Hash, KeyEqual> &
+    hashtable<T, Hash, KeyEqual>::
+    operator=(const hashtable &rhs) {
+        if (this != &rhs) {
+            hashtable tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    hashtable<T, Hash, KeyEqual> &
+    hashtable<T, Hash, KeyEqual>::
+    operator=(hashtable &&rhs) noexcept {
+        if (this != &rhs) {
+            hashtable tmp(mystl::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+// 就地构造元素，先构造节点以取得键值，键值已存在时归还节点
+    template<class T, class Hash, class KeyEqual>
+    template<class ...Args>
+    pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
+    hashtable<T, Hash, KeyEqual>::
+    emplace_unique(Args &&...args) {
+        auto np = create_node(mystl::forward<Args>(args)...);
+        try {
+            np->hash = hash_(value_traits::get_key(np->value));
+            if (size_ != 0) {
+                auto p = find_in_bucket(bucket_index(np->hash), value_traits::get_key(np->value), np->hash);
+                if (p != nullptr) {
+                    destroy_node(np);
+                    return mystl::make_pair(iterator_at(p), false);
+                }
+            }
+            rehash_if_need(1);
+        } catch (...) {
+            destroy_node(np);
+            throw;
+        }
+        link_front(bucket_index(np->hash), np);
+        ++size_;
+        return mystl::make_pair(iterator_at(np), true);
+    }
+
+// 键值相等的元素已存在时，新节点挂在它们之后，否则挂在桶的头部
+    template<class T, class Hash, class KeyEqual>
+    template<class ...Args>
+    typename hashtable<T, Hash, KeyEqual>::iterator
+    hashtable<T, Hash, KeyEqual>::
+    emplace_multi(Args &&...args) {
+        auto np = create_node(mystl::forward<Args>(args)...);
+        node_ptr prev;
+        try {
+            np->hash = hash_(value_traits::get_key(np->value));
+            rehash_if_need(1);
+            prev = find_in_bucket(bucket_index(np->hash), value_traits::get_key(np->value), np->hash);
+            if (prev != nullptr) {
+                const auto &key = value_traits::get_key(np->value);
+                while (prev->next != nullptr && prev->next->hash == np->hash &&
+                       equal_(value_traits::get_key(prev->next->value), key)) {
+                    prev = prev->next;
+                }
+            }
+        } catch (...) {
+            destroy_node(np);
+            throw;
+        }
+        if (prev != nullptr) {
+            np->next = prev->next;
+            prev->next = np;
+        } else {
+            link_front(bucket_index(np->hash), np);
+        }
+        ++size_;
+        return iterator_at(np);
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    template<class K, class ...Args>
+    pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
+    hashtable<T, Hash, KeyEqual>::
+    try_emplace_unique(K &&key, Args &&...args) {
+        const auto hash = hash_(key);
+        if (size_ != 0) {
+            auto p = find_in_bucket(bucket_index(hash), key, hash);
+            if (p != nullptr) {
+                return mystl::make_pair(iterator_at(p), false);
+            }
+        }
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "hashtable<T, Hash, KeyEqual>'s size too big");
+        auto np = create_node(mystl::forward<K>(key), mapped_type(mystl::forward<Args>(args)...));
+        np->hash = hash;
+        try {
+            rehash_if_need(1);
+        } catch (...) {
+            destroy_node(np);
+            throw;
+        }
+        link_front(bucket_index(hash), np);
+        ++size_;
+        return mystl::make_pair(iterator_at(np), true);
+    }
+
+// 删除 pos 处的元素，返回下一个元素的迭代器
+    template<class T, class Hash, class KeyEqual>
+    typename hashtable<T, Hash, KeyEqual>::iterator
+    hashtable<T, Hash, KeyEqual>::
+    erase(const_iterator pos) {
+        iterator next(pos.node, pos.bucket, pos.bucket_end);
+        ++next;
+        auto p = pos.node;
+        auto link = pos.bucket;
+        while (*link != p) {
+            link = &(*link)->next;
+        }
+        *link = p->next;
+        destroy_node(p);
+        --size_;
+        return next;
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    typename hashtable<T, Hash, KeyEqual>::iterator
+    hashtable<T, Hash, KeyEqual>::
+    erase(const_iterator first, const_iterator last) {
+        if (first == cbegin() && last == cend()) {
+            clear();
+            return end();
+        }
+        while (first != last) {
+            first = erase(first);
+        }
+        return iterator(last.node, last.bucket, last.bucket_end);
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    template<class K>
+    typename hashtable<T, Hash, KeyEqual>::size_type
+    hashtable<T, Hash, KeyEqual>::
+    erase_unique(const K &key) {
+        if (size_ == 0) {
+            return 0;
+        }
+        const auto hash = hash_(key);
+        for (auto link = buckets_ + bucket_index(hash); *link != nullptr; link = &(*link)->next) {
+            auto p = *link;
+            if (p->hash == hash && equal_(value_traits::get_key(p->value), key)) {
+                *link = p->next;
+                destroy_node(p);
+                --size_;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+// 键值相等的元素相邻，找到第一个后连续删除
+    template<class T, class Hash, class KeyEqual>
+    template<class K>
+    typename hashtable<T, Hash, KeyEqual>::size_type
+    hashtable<T, Hash, KeyEqual>::
+    erase_multi(const K &key) {
+        if (size_ == 0) {
+            return 0;
+        }
+        const auto hash = hash_(key);
+        for (auto link = buckets_ + bucket_index(hash); *link != nullptr; link = &(*link)->next) {
+            if ((*link)->hash == hash && equal_(value_traits::get_key((*link)->value), key)) {
+                size_type n = 0;
+                do {
+                    auto p = *link;
+                    *link = p->next;
+                    destroy_node(p);
+                    ++n;
+                } while (*link != nullptr && (*link)->hash == hash &&
+                         equal_(value_traits::get_key((*link)->value), key));
+                size_ -= n;
+                return n;
+            }
+        }
+        return 0;
+    }
+
+// 清空 hashtable，保留桶数组；元素可平凡析构时整块释放节点池
+    template<class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::
+    clear() noexcept {
+        if (size_ == 0) {
+            return;
+        }
+        for (size_type n = 0; n < bucket_count_; ++n) {
+            if (!std::is_trivially_destructible<T>::value) {
+                for (auto p = buckets_[n]; p != nullptr; p = p->next) {
+                    data_allocator::destroy(mystl::address_of(p->value));
+                }
+            }
+            buckets_[n] = nullptr;
+        }
+        pool_.release();
+        size_ = 0;
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    template<class K>
+    typename hashtable<T, Hash, KeyEqual>::size_type
+    hashtable<T, Hash, KeyEqual>::
+    count_multi(const K &key) const {
+        auto first = find(key);
+        if (first == end()) {
+            return 0;
+        }
+        const auto hash = first.node->hash;
+        size_type n = 1;
+        for (auto p = first.node->next; p != nullptr && p->hash == hash &&
+                                        equal_(value_traits::get_key(p->value), key); p = p->next) {
+            ++n;
+        }
+        return n;
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    template<class K>
+    pair<typename hashtable<T, Hash, KeyEqual>::iterator,
+            typename hashtable<T, Hash, KeyEqual>::iterator>
+    hashtable<T, Hash, KeyEqual>::
+    equal_range_multi(const K &key) {
+        auto first = find(key);
+        if (first == end()) {
+            return mystl::make_pair(first, first);
+        }
+        auto last = first;
+        const auto hash = first.node->hash;
+        do {
+            ++last;
+        } while (last.bucket == first.bucket && last.node != nullptr && last.node->hash == hash &&
+                 equal_(value_traits::get_key(last.node->value), key));
+        return mystl::make_pair(first, last);
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    typename hashtable<T, Hash, KeyEqual>::size_type
+    hashtable<T, Hash, KeyEqual>::
+    bucket_size(size_type n) const noexcept {
+        size_type result = 0;
+        for (auto p = buckets_[n]; p != nullptr; p = p->next) {
+            ++result;
+        }
+        return result;
+    }
+
+// 重新散列，桶数至少为 count，且元素个数不超过 bucket_count() * max_load_factor()
+    template<class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::
+    rehash(size_type count) {
+        const auto need = buckets_for(size_);
+        if (count < need) {
+            count = need;
+        }
+        if (count == 0) {
+            if (size_ == 0) {
+                deallocate_buckets();
+            }
+            return;
+        }
+        const auto new_count = ht_next_prime(count);
+        if (new_count != bucket_count_) {
+            rehash_to(new_count);
+        }
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::
+    swap(hashtable &rhs) noexcept {
+        if (this != &rhs) {
+            mystl::swap(buckets_, rhs.buckets_);
+            mystl::swap(bucket_count_, rhs.bucket_count_);
+            mystl::swap(size_, rhs.size_);
+            mystl::swap(mlf_, rhs.mlf_);
+            mystl::swap(hash_, rhs.hash_);
+            mystl::swap(equal_, rhs.equal_);
+            pool_.swap(rhs.pool_);
+        }
+    }
+
+/*****************************************************************************************/
+// helper function
+
+// 插入元素，键值已存在时不构造新节点
+    template<class T, class Hash, class KeyEqual>
+    template<class V>
+    pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
+    hashtable<T, Hash, KeyEqual>::
+    insert_value_unique(V &&value) {
+        const auto &key = value_traits::get_key(value);
+        const auto hash = hash_(key);
+        if (size_ != 0) {
+            auto p = find_in_bucket(bucket_index(hash), key, hash);
+            if (p != nullptr) {
+                return mystl::make_pair(iterator_at(p), false);
+            }
+        }
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "hashtable<T, Hash, KeyEqual>'s size too big");
+        auto np = create_node(mystl::forward<V>(value));
+        np->hash = hash;
+        try {
+            rehash_if_need(1);
+        } catch (...) {
+            destroy_node(np);
+            throw;
+        }
+        link_front(bucket_index(hash), np);
+        ++size_;
+        return mystl::make_pair(iterator_at(np), true);
+    }
+
+// 从节点池中取得节点并构造元素，构造失败时归还节点
+    template<class T, class Hash, class KeyEqual>
+    template<class ...Args>
+    typename hashtable<T, Hash, KeyEqual>::node_ptr
+    hashtable<T, Hash, KeyEqual>::
+    create_node(Args &&...args) {
+        node_ptr p = pool_.allocate();
+        try {
+            data_allocator::construct(mystl::address_of(p->value), mystl::forward<Args>(args)...);
+            p->next = nullptr;
+        } catch (...) {
+            pool_.deallocate(p);
+            throw;
+        }
+        return p;
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::
+    destroy_node(node_ptr p) noexcept {
+        data_allocator::destroy(mystl::address_of(p->value));
+        pool_.deallocate(p);
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::
+    rehash_if_need(size_type n) {
+        if (bucket_count_ != 0 &&
+            static_cast<float>(size_ + n) <= static_cast<float>(bucket_count_) * mlf_) {
+            return;
+        }
+        const auto need = buckets_for(size_ + n);
+        const auto count = bucket_count_ * 2 > need ? bucket_count_ * 2 : need;
+        rehash_to(ht_next_prime(count));
+    }
+
+// 分配新的桶数组，把节点按缓存的哈希值重新链接；哈希值相同的一段连续节点整体移动，保持原来的顺序
+    template<class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::
+    rehash_to(size_type new_count) {
+        auto new_buckets = bucket_allocator::allocate(new_count);
+        for (size_type n = 0; n < new_count; ++n) {
+            new_buckets[n] = nullptr;
+        }
+        for (size_type n = 0; n < bucket_count_; ++n) {
+            auto first = buckets_[n];
+            while (first != nullptr) {
+                auto last = first;
+                while (last->next != nullptr && last->next->hash == first->hash) {
+                    last = last->next;
+                }
+                auto next = last->next;
+                const auto index = first->hash % new_count;
+                last->next = new_buckets[index];
+                new_buckets[index] = first;
+                first = next;
+            }
+        }
+        deallocate_buckets();
+        buckets_ = new_buckets;
+        bucket_count_ = new_count;
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::
+    copy_from(const hashtable &rhs) {
+        if (rhs.size_ == 0) {
+            return;
+        }
+        rehash_to(rhs.bucket_count_);
+        try {
+            for (size_type n = 0; n < bucket_count_; ++n) {
+                auto link = buckets_ + n;
+                for (auto p = rhs.buckets_[n]; p != nullptr; p = p->next) {
+                    auto np = create_node(p->value);
+                    np->hash = p->hash;
+                    *link = np;
+                    link = &np->next;
+                    ++size_;
+                }
+            }
+        } catch (...) {
+            clear();
+            deallocate_buckets();
+            throw;
+        }
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    void hashtable<T, Hash, KeyEqual>::
+    deallocate_buckets() noexcept {
+        if (bucket_count_ != 0) {
+            bucket_allocator::deallocate(buckets_, bucket_count_);
+        }
+        buckets_ = nullptr;
+        bucket_count_ = 0;
+    }
+
+/*****************************************************************************************/
+
+// 比较两个 hashtable：元素个数相同，且每组键值相等的元素互为排列
+    template<class T, class Hash, class KeyEqual>
+    bool ht_equal_unique(const hashtable<T, Hash, KeyEqual> &lhs, const hashtable<T, Hash, KeyEqual> &rhs) {
+        typedef ht_value_traits<T> value_traits;
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (const auto &value : lhs) {
+            auto it = rhs.find(value_traits::get_key(value));
+            if (it == rhs.end() || !(*it == value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class T, class Hash, class KeyEqual>
+    bool ht_equal_multi(const hashtable<T, Hash, KeyEqual> &lhs, const hashtable<T, Hash, KeyEqual> &rhs) {
+        typedef ht_value_traits<T> value_traits;
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (auto it = lhs.begin(), end = lhs.end(); it != end;) {
+            auto l = lhs.equal_range_multi(value_traits::get_key(*it));
+            auto r = rhs.equal_range_multi(value_traits::get_key(*it));
+            auto lp = l.first, rp = r.first;
+            for (; lp != l.second && rp != r.second; ++lp, ++rp) {}
+            if (lp != l.second || rp != r.second) {
+                return false;
+            }
+            // 两组长度相同，再检查 l 中的每个元素在两组中出现的次数相同
+            for (auto p = l.first; p != l.second; ++p) {
+                size_t lc = 0, rc = 0;
+                for (auto q = l.first; q != l.second; ++q) {
+                    if (*q == *p) {
+                        ++lc;
+                    }
+                }
+                for (auto q = r.first; q != r.second; ++q) {
+                    if (*q == *p) {
+                        ++rc;
+                    }
+                }
+                if (lc != rc) {
+                    return false;
+                }
+            }
+            it = l.second;
+        }
+        return true;
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_HASHTABLE_H_
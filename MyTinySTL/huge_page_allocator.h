@@ -0,0 +1,182 @@
+#ifndef MYTINYSTL_HUGE_PAGE_ALLOCATOR_H_
+#define MYTINYSTL_HUGE_PAGE_ALLOCATOR_H_
+
+// 这个头文件包含一个模板类 huge_page_allocator
+// huge_page_allocator : 大页空间配置器，大块内存以 mmap 映射并尽量使用大页（huge page），
+//                       小块内存仍交给 ::operator new，接口与 mystl::allocator 相同
+
+// notes:
+//
+// 1. 申请字节数不小于 MYSTL_HUGE_PAGE_THRESHOLD 时走 mmap：
+//    先尝试 MAP_HUGETLB（需要系统预留 hugetlbfs 大页），失败则映射普通匿名页，
+//    按大页边界对齐后用 madvise(MADV_HUGEPAGE) 请求透明大页
+// 2. deallocate 必须传入与 allocate 相同的 n，据此区分两种来源的内存
+// 3. 非 linux 平台退化为 ::operator new / ::operator delete
+// 4. allocator_chunk_bytes<huge_page_allocator<T>> 为一个大页：deque 的缓冲区和节点池的块
+//    随之增大到大页的大小，每块都能走 mmap 拿到大页，而不是停留在 ::operator new 的小块上
+
+#include <new>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+// 走 mmap 的最小字节数
+#ifndef MYSTL_HUGE_PAGE_THRESHOLD
+#define MYSTL_HUGE_PAGE_THRESHOLD (2UL * 1024 * 1024)
+#endif
+
+// 大页的大小，用于对齐映射长度和起始地址
+#ifndef MYSTL_HUGE_PAGE_SIZE
+#define MYSTL_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+#endif
+
+namespace mystl {
+
+    // 将字节数向上取整到大页的整数倍
+    inline size_t huge_page_round(size_t bytes) noexcept {
+        return (bytes + MYSTL_HUGE_PAGE_SIZE - 1) & ~(MYSTL_HUGE_PAGE_SIZE - 1);
+    }
+
+    // 分配 bytes 字节的未初始化空间
+    inline void *huge_page_alloc(size_t bytes) {
+        if (bytes < MYSTL_HUGE_PAGE_THRESHOLD) {
+            return ::operator new(bytes);
+        }
+#if defined(__linux__)
+        const size_t len = huge_page_round(bytes);
+#if defined(MAP_HUGETLB)
+        // 系统预留了大页时直接拿到 2M 页，否则 mmap 失败，退回到透明大页
+        void *p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            return p;
+        }
+#endif
+        // 多映射一个大页，裁掉首尾多余部分，使起始地址按大页对齐，内核才能以大页映射整段区间
+        const size_t map_len = len + MYSTL_HUGE_PAGE_SIZE;
+        void *raw = ::mmap(nullptr, map_len, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+        const uintptr_t aligned = (addr + MYSTL_HUGE_PAGE_SIZE - 1) & ~(MYSTL_HUGE_PAGE_SIZE - 1);
+        const size_t head = aligned - addr;
+        const size_t tail = map_len - head - len;
+        if (head != 0) {
+            ::munmap(raw, head);
+        }
+        if (tail != 0) {
+            ::munmap(reinterpret_cast<void *>(aligned + len), tail);
+        }
+#if defined(MADV_HUGEPAGE)
+        // 仅是建议，透明大页被关闭时忽略返回值
+        ::madvise(reinterpret_cast<void *>(aligned), len, MADV_HUGEPAGE);
+#endif
+        return reinterpret_cast<void *>(aligned);
+#else
+        return ::operator new(bytes);
+#endif
+    }
+
+    // 释放由 huge_page_alloc(bytes) 得到的空间
+    inline void huge_page_free(void *ptr, size_t bytes) noexcept {
+        if (bytes < MYSTL_HUGE_PAGE_THRESHOLD) {
+            ::operator delete(ptr);
+            return;
+        }
+#if defined(__linux__)
+        ::munmap(ptr, huge_page_round(bytes));
+#else
+        ::operator delete(ptr);
+#endif
+    }
+
+    // 模板类：huge_page_allocator
+    // 模板参数代表数据类型，可作为 vector、deque 的第二个模板参数
+    template<class T>
+    class huge_page_allocator {
+    public:
+        typedef T value_type;
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        // 容器用它得到其他类型（如 deque 的 map）的配置器
+        template<class U>
+        struct rebind {
+            typedef huge_page_allocator<U> other;
+        };
+
+    public:
+        static T *allocate() {
+            return static_cast<T *>(huge_page_alloc(sizeof(T)));
+        }
+
+        static T *allocate(size_type n) {
+            if (n == 0) {
+                return nullptr;
+            }
+            return static_cast<T *>(huge_page_alloc(n * sizeof(T)));
+        }
+
+        static void deallocate(T *ptr) {
+            if (ptr == nullptr) {
+                return;
+            }
+            huge_page_free(ptr, sizeof(T));
+        }
+
+        static void deallocate(T *ptr, size_type n) {
+            if (ptr == nullptr) {
+                return;
+            }
+            huge_page_free(ptr, n * sizeof(T));
+        }
+
+        static void construct(T *ptr) {
+            mystl::construct(ptr);
+        }
+
+        static void construct(T *ptr, const T &value) {
+            mystl::construct(ptr, value);
+        }
+
+        static void construct(T *ptr, T &&value) {
+            mystl::construct(ptr, mystl::move(value));
+        }
+
+        template<class... Args>
+        static void construct(T *ptr, Args &&...args) {
+            mystl::construct(ptr, mystl::forward<Args>(args)...);
+        }
+
+        static void destroy(T *ptr) {
+            mystl::destroy(ptr);
+        }
+
+        static void destroy(T *first, T *last) {
+            mystl::destroy(first, last);
+        }
+    };
+
+    // 成块申请空间的容器以大页为单位申请，使每块恰好占满一个大页
+    template<class T>
+    struct allocator_chunk_bytes<huge_page_allocator<T>> {
+        static constexpr size_t value = MYSTL_HUGE_PAGE_SIZE;
+    };
+
+    template<class T>
+    constexpr size_t allocator_chunk_bytes<huge_page_allocator<T>>::value;
+
+} // namespace mystl
+#endif // !MYTINYSTL_HUGE_PAGE_ALLOCATOR_H_
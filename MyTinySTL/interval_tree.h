@@ -0,0 +1,628 @@
+#ifndef MYTINYSTL_INTERVAL_TREE_H_
+#define MYTINYSTL_INTERVAL_TREE_H_
+
+// 这个头文件包含一个模板结构体 interval 和两个模板类 interval_set、interval_map
+// interval     : 闭区间 [low, high]
+// interval_set : 区间树，可以查找与给定区间相交或包含给定点的区间，区间允许重复
+// interval_map : 区间树，每个区间关联一个值，区间允许重复
+
+// notes:
+//
+// 1. 以 rb_tree 为底层机制，区间按 (low, high) 的字典序排列；rb_tree_augment 对区间特化后，
+//    每个节点额外保存子树中最大的右端点 max_high，旋转、插入、删除时由 rb_tree 随之更新
+// 2. 查询时跳过 max_high 小于查询下界的子树，以及左端点大于查询上界的节点的右子树：
+//    first_overlap 为 O(logn)，报告全部 k 个相交区间为 O(logn + klog(n/k))，即至多访问这 k 个节点到根的路径
+// 3. 端点只需支持 operator<；max_high 由旋转等 noexcept 的操作更新，端点类型必须可以平凡复制（整数、时间戳、IPv4 地址等）
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "rb_tree.h"
+
+namespace mystl {
+inline namespace MYSTL_RB_TREE_ABI {
+
+    // 闭区间 [low, high]，要求 !(high < low)
+    template<class Key>
+    struct interval {
+        typedef Key value_type;
+
+        Key low;
+        Key high;
+
+        interval() : low(), high() {}
+
+        interval(const Key &l, const Key &h) : low(l), high(h) {
+            MYSTL_DEBUG(!(high < low));
+        }
+
+        bool contains(const Key &point) const {
+            return !(point < low) && !(high < point);
+        }
+
+        bool overlaps(const Key &l, const Key &h) const {
+            return !(h < low) && !(high < l);
+        }
+
+        bool overlaps(const interval &rhs) const { return overlaps(rhs.low, rhs.high); }
+
+        friend bool operator==(const interval &lhs, const interval &rhs) {
+            return !(lhs.low < rhs.low) && !(rhs.low < lhs.low) &&
+                   !(lhs.high < rhs.high) && !(rhs.high < lhs.high);
+        }
+
+        friend bool operator<(const interval &lhs, const interval &rhs) {
+            return lhs.low < rhs.low || (!(rhs.low < lhs.low) && lhs.high < rhs.high);
+        }
+    };
+
+    template<class Key>
+    bool operator!=(const interval<Key> &lhs, const interval<Key> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class Key>
+    interval<Key> make_interval(const Key &low, const Key &high) {
+        return interval<Key>(low, high);
+    }
+
+    // 区间树节点的增强信息：子树中最大的右端点
+    template<class Key, class T>
+    struct interval_tree_augment {
+        static_assert(std::is_trivially_copyable<Key>::value,
+                      "interval endpoints must be trivially copyable");
+
+        static constexpr bool enabled = true;
+
+        Key max_high;
+
+        template<class NodePtr>
+        static void update(NodePtr node) noexcept {
+            const Key *m = &rb_tree_value_traits<T>::get_key(node->value).high;
+            if (node->left != nullptr && *m < node->left->get_node_ptr()->max_high) {
+                m = &node->left->get_node_ptr()->max_high;
+            }
+            if (node->right != nullptr && *m < node->right->get_node_ptr()->max_high) {
+                m = &node->right->get_node_ptr()->max_high;
+            }
+            node->max_high = *m;
+        }
+    };
+
+    template<class Key>
+    struct rb_tree_augment<interval<Key>> : public interval_tree_augment<Key, interval<Key>> {
+    };
+
+    template<class Key, class T>
+    struct rb_tree_augment<mystl::pair<const interval<Key>, T>>
+            : public interval_tree_augment<Key, mystl::pair<const interval<Key>, T>> {
+    };
+
+    // 区间树上的查询，T 为 rb_tree 的值类型
+    template<class T>
+    struct interval_tree_query {
+        typedef rb_tree_node_base<T> *base_ptr;
+        typedef typename rb_tree_value_traits<T>::key_type interval_type;
+        typedef typename interval_type::value_type key_type;
+
+        static const interval_type &get_interval(base_ptr x) {
+            return rb_tree_value_traits<T>::get_key(x->get_node_ptr()->value);
+        }
+
+        static const key_type &max_high(base_ptr x) { return x->get_node_ptr()->max_high; }
+
+        // 按区间顺序第一个与 [low, high] 相交的节点，没有时返回空指针
+        static base_ptr first_overlap(base_ptr x, const key_type &low, const key_type &high) {
+            while (x != nullptr) {
+                if (x->left != nullptr && !(max_high(x->left) < low)) {
+                    // 左子树中有右端点不小于 low 的区间：若 x 的左端点不大于 high，这个区间必然相交；
+                    // 否则 x 与右子树的左端点都大于 high，只可能在左子树中
+                    x = x->left;
+                } else if (get_interval(x).overlaps(low, high)) {
+                    return x;
+                } else if (high < get_interval(x).low) {
+                    return nullptr;
+                } else {
+                    x = x->right;
+                }
+            }
+            return nullptr;
+        }
+
+        // 按区间顺序把与 [low, high] 相交的节点依次交给 f
+        template<class Function>
+        static void for_each_overlap(base_ptr x, const key_type &low, const key_type &high, Function &f) {
+            while (x != nullptr && !(max_high(x) < low)) {
+                for_each_overlap(x->left, low, high, f);
+                if (high < get_interval(x).low) {
+                    // x 与右子树的左端点都大于 high
+                    return;
+                }
+                if (!(get_interval(x).high < low)) {
+                    f(x);
+                }
+                x = x->right;
+            }
+        }
+
+        // 把节点转为迭代器写入 result
+        template<class Iter, class OutputIter>
+        struct collector {
+            OutputIter result;
+
+            void operator()(base_ptr x) {
+                *result = Iter(x);
+                ++result;
+            }
+        };
+
+        template<class Iter, class OutputIter>
+        static OutputIter find_overlapping(base_ptr root, const key_type &low, const key_type &high,
+                                           OutputIter result) {
+            collector<Iter, OutputIter> f{result};
+            for_each_overlap(root, low, high, f);
+            return f.result;
+        }
+    };
+
+    // 模板类 interval_set，元素为区间，允许重复
+    // 参数代表区间端点的类型
+    template<class Key>
+    class interval_set {
+    public:
+        typedef mystl::interval<Key> key_type;
+        typedef mystl::interval<Key> value_type;
+        typedef mystl::interval<Key> interval_type;
+        typedef Key point_type;
+        typedef mystl::less<key_type> key_compare;
+        typedef mystl::less<key_type> value_compare;
+
+    private:
+        // 以 mystl::rb_tree 作为底层机制
+        typedef mystl::rb_tree<value_type, key_compare> base_type;
+        typedef interval_tree_query<value_type> query;
+        base_type tree_;
+
+    public:
+        // 使用 rb_tree 定义的型别
+        typedef typename base_type::const_pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::const_reference reference;
+        typedef typename base_type::const_reference const_reference;
+        typedef typename base_type::const_iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef typename base_type::const_reverse_iterator reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::allocator_type allocator_type;
+
+    public:
+        // 构造、复制、移动函数
+        interval_set() = default;
+
+        template<class InputIterator>
+        interval_set(InputIterator first, InputIterator last) : tree_() {
+            // 输入有序时以 O(n) 直接建树
+            tree_.insert_multi(first, last);
+        }
+
+        interval_set(std::initializer_list<value_type> ilist) : tree_() {
+            tree_.insert_multi(ilist.begin(), ilist.end());
+        }
+
+        interval_set(const interval_set &rhs) : tree_(rhs.tree_) {}
+
+        interval_set(interval_set &&rhs) noexcept: tree_(mystl::move(rhs.tree_)) {}
+
+        interval_set &operator=(const interval_set &rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        interval_set &operator=(interval_set &&rhs) {
+            tree_ = mystl::move(rhs.tree_);
+            return *this;
+        }
+
+        interval_set &operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            tree_.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // 相关接口
+        key_compare key_comp() const { return tree_.key_comp(); }
+
+        value_compare value_comp() const { return tree_.key_comp(); }
+
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+        // 迭代器相关
+        iterator begin() noexcept { return tree_.begin(); }
+
+        const_iterator begin() const noexcept { return tree_.begin(); }
+
+        iterator end() noexcept { return tree_.end(); }
+
+        const_iterator end() const noexcept { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return tree_.empty(); }
+
+        size_type size() const noexcept { return tree_.size(); }
+
+        size_type max_size() const noexcept { return tree_.max_size(); }
+
+        // 插入删除操作
+        template<class ...Args>
+        iterator emplace(Args &&...args) {
+            return tree_.emplace_multi(mystl::forward<Args>(args)...);
+        }
+
+        template<class ...Args>
+        iterator emplace_hint(iterator hint, Args &&...args) {
+            return tree_.emplace_multi_use_hint(hint, mystl::forward<Args>(args)...);
+        }
+
+        iterator insert(const value_type &value) { return tree_.insert_multi(value); }
+
+        iterator insert(const point_type &low, const point_type &high) {
+            return tree_.insert_multi(value_type(low, high));
+        }
+
+        iterator insert(iterator hint, const value_type &value) { return tree_.insert_multi(hint, value); }
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) { tree_.insert_multi(first, last); }
+
+        void erase(iterator position) { tree_.erase(position); }
+
+        size_type erase(const key_type &key) { return tree_.erase_multi(key); }
+
+        void erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+        void clear() { tree_.clear(); }
+
+        // 按区间本身查找
+        iterator find(const key_type &key) { return tree_.find(key); }
+
+        const_iterator find(const key_type &key) const { return tree_.find(key); }
+
+        size_type count(const key_type &key) const { return tree_.count_multi(key); }
+
+        iterator lower_bound(const key_type &key) { return tree_.lower_bound(key); }
+
+        const_iterator lower_bound(const key_type &key) const { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type &key) { return tree_.upper_bound(key); }
+
+        const_iterator upper_bound(const key_type &key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator>
+        equal_range(const key_type &key) { return tree_.equal_range_multi(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const { return tree_.equal_range_multi(key); }
+
+        // 区间查询
+        // first_overlap 返回按区间顺序第一个与 [low, high] 相交的区间，没有时返回 end()，O(logn)
+        const_iterator first_overlap(const point_type &low, const point_type &high) const {
+            auto x = query::first_overlap(tree_.root_node(), low, high);
+            return x == nullptr ? end() : const_iterator(x);
+        }
+
+        const_iterator first_overlap(const interval_type &range) const {
+            return first_overlap(range.low, range.high);
+        }
+
+        bool overlaps(const point_type &low, const point_type &high) const {
+            return query::first_overlap(tree_.root_node(), low, high) != nullptr;
+        }
+
+        // 按区间顺序把与 [low, high] 相交的区间的迭代器依次写入 result
+        template<class OutputIter>
+        OutputIter find_overlapping(const point_type &low, const point_type &high, OutputIter result) const {
+            return query::template find_overlapping<const_iterator>(tree_.root_node(), low, high, result);
+        }
+
+        template<class OutputIter>
+        OutputIter find_overlapping(const interval_type &range, OutputIter result) const {
+            return find_overlapping(range.low, range.high, result);
+        }
+
+        // 包含 point 的区间（stabbing query）
+        const_iterator first_containing(const point_type &point) const {
+            return first_overlap(point, point);
+        }
+
+        template<class OutputIter>
+        OutputIter find_containing(const point_type &point, OutputIter result) const {
+            return find_overlapping(point, point, result);
+        }
+
+        void swap(interval_set &rhs) noexcept { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const interval_set &lhs, const interval_set &rhs) { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator<(const interval_set &lhs, const interval_set &rhs) { return lhs.tree_ < rhs.tree_; }
+    };
+
+    // 重载比较操作符
+    template<class Key>
+    bool operator!=(const interval_set<Key> &lhs, const interval_set<Key> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class Key>
+    bool operator>(const interval_set<Key> &lhs, const interval_set<Key> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class Key>
+    bool operator<=(const interval_set<Key> &lhs, const interval_set<Key> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class Key>
+    bool operator>=(const interval_set<Key> &lhs, const interval_set<Key> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class Key>
+    void swap(interval_set<Key> &lhs, interval_set<Key> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+/*****************************************************************************************/
+
+    // 模板类 interval_map，元素为区间与值组成的 pair，区间允许重复
+    // 参数一代表区间端点的类型，参数二代表值的类型
+    template<class Key, class T>
+    class interval_map {
+    public:
+        typedef mystl::interval<Key> key_type;
+        typedef mystl::interval<Key> interval_type;
+        typedef Key point_type;
+        typedef T mapped_type;
+        typedef mystl::pair<const key_type, T> value_type;
+        typedef mystl::less<key_type> key_compare;
+
+    private:
+        // 以 mystl::rb_tree 作为底层机制
+        typedef mystl::rb_tree<value_type, key_compare> base_type;
+        typedef interval_tree_query<value_type> query;
+        base_type tree_;
+
+    public:
+        // 使用 rb_tree 定义的型别
+        typedef typename base_type::pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::reference reference;
+        typedef typename base_type::const_reference const_reference;
+        typedef typename base_type::iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef typename base_type::reverse_iterator reverse_iterator;
+        typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::allocator_type allocator_type;
+
+    public:
+        // 构造、复制、移动函数
+        interval_map() = default;
+
+        template<class InputIterator>
+        interval_map(InputIterator first, InputIterator last) : tree_() {
+            tree_.insert_multi(first, last);
+        }
+
+        interval_map(std::initializer_list<value_type> ilist) : tree_() {
+            tree_.insert_multi(ilist.begin(), ilist.end());
+        }
+
+        interval_map(const interval_map &rhs) : tree_(rhs.tree_) {}
+
+        interval_map(interval_map &&rhs) noexcept: tree_(mystl::move(rhs.tree_)) {}
+
+        interval_map &operator=(const interval_map &rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        interval_map &operator=(interval_map &&rhs) {
+            tree_ = mystl::move(rhs.tree_);
+            return *this;
+        }
+
+        interval_map &operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            tree_.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        // 相关接口
+        key_compare key_comp() const { return tree_.key_comp(); }
+
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+        // 迭代器相关
+        iterator begin() noexcept { return tree_.begin(); }
+
+        const_iterator begin() const noexcept { return tree_.begin(); }
+
+        iterator end() noexcept { return tree_.end(); }
+
+        const_iterator end() const noexcept { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return tree_.empty(); }
+
+        size_type size() const noexcept { return tree_.size(); }
+
+        size_type max_size() const noexcept { return tree_.max_size(); }
+
+        // 插入删除操作
+        template<class ...Args>
+        iterator emplace(Args &&...args) {
+            return tree_.emplace_multi(mystl::forward<Args>(args)...);
+        }
+
+        template<class ...Args>
+        iterator emplace_hint(iterator hint, Args &&...args) {
+            return tree_.emplace_multi_use_hint(hint, mystl::forward<Args>(args)...);
+        }
+
+        iterator insert(const value_type &value) { return tree_.insert_multi(value); }
+
+        iterator insert(value_type &&value) { return tree_.insert_multi(mystl::move(value)); }
+
+        iterator insert(const point_type &low, const point_type &high, const mapped_type &mapped) {
+            return tree_.emplace_multi(key_type(low, high), mapped);
+        }
+
+        iterator insert(iterator hint, const value_type &value) { return tree_.insert_multi(hint, value); }
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) { tree_.insert_multi(first, last); }
+
+        void erase(iterator position) { tree_.erase(position); }
+
+        size_type erase(const key_type &key) { return tree_.erase_multi(key); }
+
+        void erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+        void clear() { tree_.clear(); }
+
+        // 按区间本身查找
+        iterator find(const key_type &key) { return tree_.find(key); }
+
+        const_iterator find(const key_type &key) const { return tree_.find(key); }
+
+        size_type count(const key_type &key) const { return tree_.count_multi(key); }
+
+        iterator lower_bound(const key_type &key) { return tree_.lower_bound(key); }
+
+        const_iterator lower_bound(const key_type &key) const { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type &key) { return tree_.upper_bound(key); }
+
+        const_iterator upper_bound(const key_type &key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator>
+        equal_range(const key_type &key) { return tree_.equal_range_multi(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const { return tree_.equal_range_multi(key); }
+
+        // 区间查询，与 interval_set 相同
+        iterator first_overlap(const point_type &low, const point_type &high) {
+            auto x = query::first_overlap(tree_.root_node(), low, high);
+            return x == nullptr ? end() : iterator(x);
+        }
+
+        const_iterator first_overlap(const point_type &low, const point_type &high) const {
+            auto x = query::first_overlap(tree_.root_node(), low, high);
+            return x == nullptr ? end() : const_iterator(x);
+        }
+
+        bool overlaps(const point_type &low, const point_type &high) const {
+            return query::first_overlap(tree_.root_node(), low, high) != nullptr;
+        }
+
+        template<class OutputIter>
+        OutputIter find_overlapping(const point_type &low, const point_type &high, OutputIter result) {
+            return query::template find_overlapping<iterator>(tree_.root_node(), low, high, result);
+        }
+
+        template<class OutputIter>
+        OutputIter find_overlapping(const point_type &low, const point_type &high, OutputIter result) const {
+            return query::template find_overlapping<const_iterator>(tree_.root_node(), low, high, result);
+        }
+
+        iterator first_containing(const point_type &point) { return first_overlap(point, point); }
+
+        const_iterator first_containing(const point_type &point) const { return first_overlap(point, point); }
+
+        template<class OutputIter>
+        OutputIter find_containing(const point_type &point, OutputIter result) {
+            return find_overlapping(point, point, result);
+        }
+
+        template<class OutputIter>
+        OutputIter find_containing(const point_type &point, OutputIter result) const {
+            return find_overlapping(point, point, result);
+        }
+
+        void swap(interval_map &rhs) noexcept { tree_.swap(rhs.tree_); }
+
+    public:
+        friend bool operator==(const interval_map &lhs, const interval_map &rhs) { return lhs.tree_ == rhs.tree_; }
+
+        friend bool operator<(const interval_map &lhs, const interval_map &rhs) { return lhs.tree_ < rhs.tree_; }
+    };
+
+    // 重载比较操作符
+    template<class Key, class T>
+    bool operator!=(const interval_map<Key, T> &lhs, const interval_map<Key, T> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class Key, class T>
+    bool operator>(const interval_map<Key, T> &lhs, const interval_map<Key, T> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class Key, class T>
+    bool operator<=(const interval_map<Key, T> &lhs, const interval_map<Key, T> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class Key, class T>
+    bool operator>=(const interval_map<Key, T> &lhs, const interval_map<Key, T> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class Key, class T>
+    void swap(interval_map<Key, T> &lhs, interval_map<Key, T> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // inline namespace MYSTL_RB_TREE_ABI
+} // namespace mystl
+#endif // !MYTINYSTL_INTERVAL_TREE_H_
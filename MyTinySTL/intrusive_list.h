@@ -0,0 +1,481 @@
+#ifndef MYTINYSTL_INTRUSIVE_LIST_H_
+#define MYTINYSTL_INTRUSIVE_LIST_H_
+
+// 这个头文件包含一个模板类 intrusive_list
+// intrusive_list : 侵入式双向链表，链接指针（钩子）嵌在用户的对象中，插入、删除都不分配内存
+
+// notes:
+//
+// 1. 对象通过继承 intrusive_list_hook<Tag> 获得链接指针，Tag 区分同一对象上的多个钩子，
+//    继承三个 Tag 不同的钩子，对象就可以同时位于三个 intrusive_list 中
+// 2. 钩子就是 list_node_base，连接与断开复用 list.h 中的 list_link_nodes / list_unlink_nodes
+// 3. intrusive_list 不拥有对象：erase / clear 只把对象从链表中摘下，对象的生命周期由使用者管理，
+//    对象在链表中时不能被销毁；钩子的复制、赋值不复制链接
+// 4. 哨兵节点内嵌在 intrusive_list 中，intrusive_list 可以移动，不能复制
+
+#include <cstddef>
+
+#include "iterator.h"
+#include "list.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // intrusive_list 的缺省钩子标签
+    struct intrusive_list_tag {};
+
+    // 钩子，对象不在任何链表中时 prev、next 为空
+    template<class Tag = intrusive_list_tag>
+    struct intrusive_list_hook : public list_node_base<Tag> {
+        intrusive_list_hook() noexcept {
+            this->prev = this->next = nullptr;
+        }
+
+        intrusive_list_hook(const intrusive_list_hook &) noexcept: intrusive_list_hook() {}
+
+        intrusive_list_hook &operator=(const intrusive_list_hook &) noexcept { return *this; }
+
+        bool is_linked() const noexcept { return this->next != nullptr; }
+    };
+
+    // intrusive_list 的迭代器
+    template<class T, class Ref, class Ptr, class Tag>
+    struct intrusive_list_iterator : public iterator<bidirectional_iterator_tag, T> {
+        typedef intrusive_list_iterator<T, T &, T *, Tag> iterator;
+        typedef intrusive_list_iterator<T, const T &, const T *, Tag> const_iterator;
+        typedef intrusive_list_iterator self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef intrusive_list_hook<Tag> hook_type;
+        typedef list_node_base<Tag> *base_ptr;
+
+        base_ptr node;
+
+        // 构造、复制函数
+        intrusive_list_iterator() noexcept: node(nullptr) {}
+
+        explicit intrusive_list_iterator(base_ptr x) noexcept: node(x) {}
+
+        intrusive_list_iterator(const iterator &rhs) noexcept: node(rhs.node) {}
+
+        // 重载操作符
+        reference operator*() const { return static_cast<T &>(static_cast<hook_type &>(*node)); }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self &operator++() {
+            MYSTL_DEBUG(node != nullptr);
+            node = node->next;
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self &operator--() {
+            MYSTL_DEBUG(node != nullptr);
+            node = node->prev;
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return node == rhs.node; }
+
+        bool operator!=(const self &rhs) const { return node != rhs.node; }
+    };
+
+    // 模板类 intrusive_list
+    // 参数一代表对象类型，需继承 intrusive_list_hook<Tag>，参数二代表使用哪一个钩子
+    template<class T, class Tag = intrusive_list_tag>
+    class intrusive_list {
+    public:
+        // intrusive_list 的嵌套型别定义
+        typedef T value_type;
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        typedef intrusive_list_hook<Tag> hook_type;
+        typedef list_node_base<Tag> *base_ptr;
+
+        typedef intrusive_list_iterator<T, T &, T *, Tag> iterator;
+        typedef intrusive_list_iterator<T, const T &, const T *, Tag> const_iterator;
+        typedef mystl::reverse_iterator<iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    private:
+        list_node_base<Tag> head_;  // 哨兵，head_.next 为第一个对象，head_.prev 为最后一个对象
+        size_type size_;            // 对象个数
+
+    public:
+        // 构造、移动、析构函数
+        intrusive_list() noexcept: size_(0) { reset_head(); }
+
+        intrusive_list(const intrusive_list &) = delete;
+
+        intrusive_list &operator=(const intrusive_list &) = delete;
+
+        intrusive_list(intrusive_list &&rhs) noexcept: size_(0) {
+            reset_head();
+            take_nodes(rhs);
+        }
+
+        intrusive_list &operator=(intrusive_list &&rhs) noexcept {
+            if (this != &rhs) {
+                clear();
+                take_nodes(rhs);
+            }
+            return *this;
+        }
+
+        // 析构时摘下所有对象，对象本身不受影响
+        ~intrusive_list() { clear(); }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return iterator(head_.next); }
+
+        const_iterator begin() const noexcept { return const_iterator(head_.next); }
+
+        iterator end() noexcept { return iterator(&head_); }
+
+        const_iterator end() const noexcept { return const_iterator(const_cast<base_ptr>(&head_)); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 由对象得到指向它的迭代器，对象需在某个 intrusive_list 中
+        static iterator iterator_to(reference value) noexcept {
+            return iterator(static_cast<hook_type &>(value).self());
+        }
+
+        static const_iterator iterator_to(const_reference value) noexcept {
+            return const_iterator(const_cast<hook_type &>(static_cast<const hook_type &>(value)).self());
+        }
+
+        // 容量相关操作
+        bool empty() const noexcept { return size_ == 0; }
+
+        size_type size() const noexcept { return size_; }
+
+        size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+        // 访问元素相关操作
+        reference front() {
+            MYSTL_DEBUG(!empty());
+            return *begin();
+        }
+
+        const_reference front() const {
+            MYSTL_DEBUG(!empty());
+            return *begin();
+        }
+
+        reference back() {
+            MYSTL_DEBUG(!empty());
+            return *(--end());
+        }
+
+        const_reference back() const {
+            MYSTL_DEBUG(!empty());
+            return *(--end());
+        }
+
+        // 插入删除相关操作，都不分配、不释放内存
+        iterator insert(const_iterator pos, reference value) noexcept;
+
+        template<class Iter>
+        void insert(const_iterator pos, Iter first, Iter last) noexcept {
+            for (; first != last; ++first) {
+                insert(pos, *first);
+            }
+        }
+
+        void push_front(reference value) noexcept { insert(cbegin(), value); }
+
+        void push_back(reference value) noexcept { insert(cend(), value); }
+
+        void pop_front() noexcept {
+            MYSTL_DEBUG(!empty());
+            erase(cbegin());
+        }
+
+        void pop_back() noexcept {
+            MYSTL_DEBUG(!empty());
+            erase(--cend());
+        }
+
+        iterator erase(const_iterator pos) noexcept;
+
+        iterator erase(const_iterator first, const_iterator last) noexcept;
+
+        // 摘下对象后交给 disposer 处理，例如释放对象
+        template<class Disposer>
+        iterator erase_and_dispose(const_iterator pos, Disposer disposer);
+
+        void clear() noexcept {
+            erase(cbegin(), cend());
+        }
+
+        template<class Disposer>
+        void clear_and_dispose(Disposer disposer);
+
+        void swap(intrusive_list &rhs) noexcept {
+            if (this != &rhs) {
+                intrusive_list tmp(mystl::move(rhs));
+                rhs.take_nodes(*this);
+                take_nodes(tmp);
+            }
+        }
+
+        // intrusive_list 相关操作
+
+        // 把 other 的所有对象接到 pos 之前
+        void splice(const_iterator pos, intrusive_list &other) noexcept;
+
+        // 把 other 中 it 指向的对象接到 pos 之前
+        void splice(const_iterator pos, intrusive_list &other, const_iterator it) noexcept;
+
+        // 把 other 中 [first, last) 内的对象接到 pos 之前
+        void splice(const_iterator pos, intrusive_list &other, const_iterator first, const_iterator last) noexcept;
+
+        template<class UnaryPredicate>
+        void remove_if(UnaryPredicate pred);
+
+        void reverse() noexcept;
+
+    private:
+        // helper functions
+        void reset_head() noexcept {
+            head_.prev = head_.next = &head_;
+        }
+
+        // 接管 rhs 的所有对象，本 intrusive_list 需为空
+        void take_nodes(intrusive_list &rhs) noexcept;
+
+        static reference value_of(base_ptr x) noexcept {
+            return static_cast<reference>(static_cast<hook_type &>(*x));
+        }
+
+        static void reset_hook(base_ptr x) noexcept {
+            x->prev = x->next = nullptr;
+        }
+
+    public:
+        friend bool operator==(const intrusive_list &lhs, const intrusive_list &rhs) {
+            return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator<(const intrusive_list &lhs, const intrusive_list &rhs) {
+            return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+    };
+
+/*****************************************************************************************/
+
+// 在 pos 之前连接 value
+    template<class T, class Tag>
+    typename intrusive_list<T, Tag>::iterator
+    intrusive_list<T, Tag>::
+    insert(const_iterator pos, reference value) noexcept {
+        auto x = static_cast<hook_type &>(value).self();
+        MYSTL_DEBUG(x->next == nullptr);
+        list_link_nodes(pos.node, x, x);
+        ++size_;
+        return iterator(x);
+    }
+
+// 摘下 pos 处的对象
+    template<class T, class Tag>
+    typename intrusive_list<T, Tag>::iterator
+    intrusive_list<T, Tag>::
+    erase(const_iterator pos) noexcept {
+        MYSTL_DEBUG(pos != cend());
+        auto x = pos.node;
+        auto next = x->next;
+        list_unlink_nodes(x, x);
+        reset_hook(x);
+        --size_;
+        return iterator(next);
+    }
+
+// 摘下 [first, last) 内的对象
+    template<class T, class Tag>
+    typename intrusive_list<T, Tag>::iterator
+    intrusive_list<T, Tag>::
+    erase(const_iterator first, const_iterator last) noexcept {
+        if (first != last) {
+            list_unlink_nodes(first.node, last.node->prev);
+            for (auto x = first.node; x != last.node;) {
+                auto next = x->next;
+                reset_hook(x);
+                --size_;
+                x = next;
+            }
+        }
+        return iterator(last.node);
+    }
+
+// 摘下 pos 处的对象并交给 disposer
+    template<class T, class Tag>
+    template<class Disposer>
+    typename intrusive_list<T, Tag>::iterator
+    intrusive_list<T, Tag>::
+    erase_and_dispose(const_iterator pos, Disposer disposer) {
+        auto &value = value_of(pos.node);
+        auto next = erase(pos);
+        disposer(&value);
+        return next;
+    }
+
+// 摘下所有对象并依次交给 disposer
+    template<class T, class Tag>
+    template<class Disposer>
+    void intrusive_list<T, Tag>::
+    clear_and_dispose(Disposer disposer) {
+        while (!empty()) {
+            erase_and_dispose(cbegin(), disposer);
+        }
+    }
+
+// 把 other 的所有对象接到 pos 之前
+    template<class T, class Tag>
+    void intrusive_list<T, Tag>::
+    splice(const_iterator pos, intrusive_list &other) noexcept {
+        MYSTL_DEBUG(this != &other);
+        if (!other.empty()) {
+            auto f = other.head_.next;
+            auto l = other.head_.prev;
+            list_unlink_nodes(f, l);
+            list_link_nodes(pos.node, f, l);
+            size_ += other.size_;
+            other.size_ = 0;
+        }
+    }
+
+// 把 other 中 it 指向的对象接到 pos 之前
+    template<class T, class Tag>
+    void intrusive_list<T, Tag>::
+    splice(const_iterator pos, intrusive_list &other, const_iterator it) noexcept {
+        if (pos.node != it.node && pos.node != it.node->next) {
+            auto f = it.node;
+            list_unlink_nodes(f, f);
+            list_link_nodes(pos.node, f, f);
+            ++size_;
+            --other.size_;
+        }
+    }
+
+// 把 other 中 [first, last) 内的对象接到 pos 之前
+    template<class T, class Tag>
+    void intrusive_list<T, Tag>::
+    splice(const_iterator pos, intrusive_list &other, const_iterator first, const_iterator last) noexcept {
+        if (first != last && pos != last) {
+            if (this != &other) {
+                size_type n = mystl::distance(first, last);
+                size_ += n;
+                other.size_ -= n;
+            }
+            auto f = first.node;
+            auto l = last.node->prev;
+            list_unlink_nodes(f, l);
+            list_link_nodes(pos.node, f, l);
+        }
+    }
+
+// 摘下使 pred 为 true 的对象
+    template<class T, class Tag>
+    template<class UnaryPredicate>
+    void intrusive_list<T, Tag>::
+    remove_if(UnaryPredicate pred) {
+        for (auto x = head_.next; x != &head_;) {
+            auto next = x->next;
+            if (pred(value_of(x))) {
+                erase(const_iterator(x));
+            }
+            x = next;
+        }
+    }
+
+// 翻转 intrusive_list：交换每个节点（包括哨兵）的 prev 与 next
+    template<class T, class Tag>
+    void intrusive_list<T, Tag>::
+    reverse() noexcept {
+        base_ptr x = &head_;
+        do {
+            mystl::swap(x->prev, x->next);
+            x = x->prev;
+        } while (x != &head_);
+    }
+
+// 接管 rhs 的所有对象
+    template<class T, class Tag>
+    void intrusive_list<T, Tag>::
+    take_nodes(intrusive_list &rhs) noexcept {
+        if (rhs.empty()) {
+            return;
+        }
+        list_link_nodes(&head_, rhs.head_.next, rhs.head_.prev);
+        size_ = rhs.size_;
+        rhs.reset_head();
+        rhs.size_ = 0;
+    }
+
+    // 重载比较操作符
+    template<class T, class Tag>
+    bool operator!=(const intrusive_list<T, Tag> &lhs, const intrusive_list<T, Tag> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, class Tag>
+    bool operator>(const intrusive_list<T, Tag> &lhs, const intrusive_list<T, Tag> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, class Tag>
+    bool operator<=(const intrusive_list<T, Tag> &lhs, const intrusive_list<T, Tag> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, class Tag>
+    bool operator>=(const intrusive_list<T, Tag> &lhs, const intrusive_list<T, Tag> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class T, class Tag>
+    void swap(intrusive_list<T, Tag> &lhs, intrusive_list<T, Tag> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_INTRUSIVE_LIST_H_
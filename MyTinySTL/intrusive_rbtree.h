@@ -0,0 +1,579 @@
+#ifndef MYTINYSTL_INTRUSIVE_RBTREE_H_
+#define MYTINYSTL_INTRUSIVE_RBTREE_H_
+
+// 这个头文件包含一个模板类 intrusive_rbtree
+// intrusive_rbtree : 侵入式红黑树，链接指针和颜色（钩子）嵌在用户的对象中，插入、删除都不分配内存
+
+// notes:
+//
+// 1. 对象通过继承 intrusive_rbtree_hook<Tag> 获得节点结构，Tag 区分同一对象上的多个钩子，
+//    可以与 intrusive_list_hook 同时继承，使一个对象既在若干链表中又在树中
+// 2. 钩子就是 rb_tree_node_base，插入、删除后的重新平衡复用 rb_tree.h 中的 rb_tree_insert_rebalance /
+//    rb_tree_erase_rebalance，迭代器的前进、后退复用 rb_tree_iterator_base，
+//    因此 MYSTL_RB_TREE_COMPACT_NODES 等节点布局的宏对钩子同样有效
+// 3. Compare 比较两个对象；查找函数接受任意键值类型 K，此时 Compare 需能以 (T, K) 和 (K, T) 两种顺序比较
+// 4. intrusive_rbtree 不拥有对象：erase / clear 只把对象从树中摘下，对象的生命周期由使用者管理，
+//    对象在树中时不能被销毁，也不能修改参与比较的成员
+// 5. header_ 内嵌在 intrusive_rbtree 中，intrusive_rbtree 可以移动，不能复制
+
+#include <cstddef>
+#include <type_traits>
+
+#include "functional.h"
+#include "iterator.h"
+#include "rb_tree.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl {
+inline namespace MYSTL_RB_TREE_ABI {
+
+    // intrusive_rbtree 的缺省钩子标签
+    struct intrusive_rbtree_tag {};
+
+    // 钩子，对象不在任何树中时 parent、left、right 为空
+    template<class Tag = intrusive_rbtree_tag>
+    struct intrusive_rbtree_hook : public rb_tree_node_base<Tag> {
+        typedef rb_tree_node_base<Tag> *base_ptr;
+
+        intrusive_rbtree_hook() noexcept { reset(); }
+
+        intrusive_rbtree_hook(const intrusive_rbtree_hook &) noexcept { reset(); }
+
+        intrusive_rbtree_hook &operator=(const intrusive_rbtree_hook &) noexcept { return *this; }
+
+        bool is_linked() const noexcept { return static_cast<base_ptr>(this->parent) != nullptr; }
+
+        void reset() noexcept {
+            rb_tree_set_parent_color(this->get_base_ptr(), nullptr, rb_tree_black);
+            this->left = this->right = nullptr;
+        }
+    };
+
+    // intrusive_rbtree 的迭代器，前进、后退与 rb_tree 的迭代器相同
+    template<class T, class Ref, class Ptr, class Tag>
+    struct intrusive_rbtree_iterator : public rb_tree_iterator_base<Tag> {
+        typedef intrusive_rbtree_iterator<T, T &, T *, Tag> iterator;
+        typedef intrusive_rbtree_iterator<T, const T &, const T *, Tag> const_iterator;
+        typedef intrusive_rbtree_iterator self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef intrusive_rbtree_hook<Tag> hook_type;
+        typedef rb_tree_node_base<Tag> *base_ptr;
+
+        // 构造、复制函数
+        intrusive_rbtree_iterator() noexcept {}
+
+        explicit intrusive_rbtree_iterator(base_ptr x) noexcept { this->node = x; }
+
+        intrusive_rbtree_iterator(const iterator &rhs) noexcept { this->node = rhs.node; }
+
+        // 重载操作符
+        reference operator*() const { return static_cast<T &>(static_cast<hook_type &>(*this->node)); }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self &operator++() {
+            this->inc();
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            this->inc();
+            return tmp;
+        }
+
+        self &operator--() {
+            this->dec();
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            this->dec();
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return this->node == rhs.node; }
+
+        bool operator!=(const self &rhs) const { return this->node != rhs.node; }
+    };
+
+    // 模板类 intrusive_rbtree
+    // 参数一代表对象类型，需继承 intrusive_rbtree_hook<Tag>，参数二代表对象比较方式，参数三代表使用哪一个钩子
+    template<class T, class Compare = mystl::less<T>, class Tag = intrusive_rbtree_tag>
+    class intrusive_rbtree {
+    public:
+        // intrusive_rbtree 的嵌套型别定义
+        typedef T value_type;
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef Compare value_compare;
+
+        typedef intrusive_rbtree_hook<Tag> hook_type;
+        typedef rb_tree_node_base<Tag> base_type;
+        typedef base_type *base_ptr;
+
+        typedef intrusive_rbtree_iterator<T, T &, T *, Tag> iterator;
+        typedef intrusive_rbtree_iterator<T, const T &, const T *, Tag> const_iterator;
+        typedef mystl::reverse_iterator<iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        value_compare value_comp() const { return comp_; }
+
+    private:
+        // header_ 与根节点互为对方的父节点，header_ 的左右子节点为最小、最大节点，空树时都指向 header_
+        base_type header_;
+        size_type node_count_;  // 对象个数
+        value_compare comp_;    // 对象比较的准则
+
+        typename base_type::parent_type &root() const noexcept {
+            return const_cast<base_type &>(header_).parent;
+        }
+
+        base_ptr &leftmost() const noexcept { return const_cast<base_type &>(header_).left; }
+
+        base_ptr &rightmost() const noexcept { return const_cast<base_type &>(header_).right; }
+
+        base_ptr header() const noexcept { return const_cast<base_ptr>(&header_); }
+
+    public:
+        // 构造、移动、析构函数
+        intrusive_rbtree() : node_count_(0), comp_() { reset_header(); }
+
+        explicit intrusive_rbtree(const value_compare &comp) : node_count_(0), comp_(comp) { reset_header(); }
+
+        intrusive_rbtree(const intrusive_rbtree &) = delete;
+
+        intrusive_rbtree &operator=(const intrusive_rbtree &) = delete;
+
+        intrusive_rbtree(intrusive_rbtree &&rhs) noexcept
+                : node_count_(0), comp_(mystl::move(rhs.comp_)) {
+            reset_header();
+            take_nodes(rhs);
+        }
+
+        intrusive_rbtree &operator=(intrusive_rbtree &&rhs) noexcept {
+            if (this != &rhs) {
+                clear();
+                take_nodes(rhs);
+                comp_ = mystl::move(rhs.comp_);
+            }
+            return *this;
+        }
+
+        // 析构时摘下所有对象，对象本身不受影响
+        ~intrusive_rbtree() { clear(); }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return iterator(leftmost()); }
+
+        const_iterator begin() const noexcept { return const_iterator(leftmost()); }
+
+        iterator end() noexcept { return iterator(header()); }
+
+        const_iterator end() const noexcept { return const_iterator(header()); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 由对象得到指向它的迭代器，对象需在某个 intrusive_rbtree 中
+        static iterator iterator_to(reference value) noexcept {
+            return iterator(static_cast<hook_type &>(value).get_base_ptr());
+        }
+
+        static const_iterator iterator_to(const_reference value) noexcept {
+            return const_iterator(const_cast<hook_type &>(static_cast<const hook_type &>(value)).get_base_ptr());
+        }
+
+        // 容量相关操作
+        bool empty() const noexcept { return node_count_ == 0; }
+
+        size_type size() const noexcept { return node_count_; }
+
+        size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+        // 插入删除相关操作，都不分配、不释放内存
+        iterator insert_multi(reference value);
+
+        mystl::pair<iterator, bool> insert_unique(reference value);
+
+        iterator erase(const_iterator pos) noexcept;
+
+        iterator erase(const_iterator first, const_iterator last) noexcept;
+
+        // 摘下与 key 相等的所有对象，返回摘下的个数；迭代器不作为键值，以免 erase(iterator) 匹配到这个重载
+        template<class K, typename std::enable_if<
+                !std::is_convertible<K, const_iterator>::value, int>::type = 0>
+        size_type erase(const K &key) noexcept {
+            auto p = equal_range(key);
+            size_type n = static_cast<size_type>(mystl::distance(p.first, p.second));
+            erase(p.first, p.second);
+            return n;
+        }
+
+        // 摘下对象后交给 disposer 处理，例如释放对象
+        template<class Disposer>
+        iterator erase_and_dispose(const_iterator pos, Disposer disposer);
+
+        void clear() noexcept {
+            clear_and_dispose([](pointer) {});
+        }
+
+        template<class Disposer>
+        void clear_and_dispose(Disposer disposer);
+
+        void swap(intrusive_rbtree &rhs) noexcept {
+            if (this != &rhs) {
+                intrusive_rbtree tmp(comp_);
+                tmp.take_nodes(rhs);
+                rhs.take_nodes(*this);
+                take_nodes(tmp);
+                mystl::swap(comp_, rhs.comp_);
+            }
+        }
+
+        // 查找相关操作
+        template<class K>
+        iterator find(const K &key);
+
+        template<class K>
+        const_iterator find(const K &key) const {
+            return const_iterator(const_cast<intrusive_rbtree *>(this)->find(key));
+        }
+
+        template<class K>
+        size_type count(const K &key) const {
+            auto p = equal_range(key);
+            return static_cast<size_type>(mystl::distance(p.first, p.second));
+        }
+
+        template<class K>
+        iterator lower_bound(const K &key);
+
+        template<class K>
+        const_iterator lower_bound(const K &key) const {
+            return const_iterator(const_cast<intrusive_rbtree *>(this)->lower_bound(key));
+        }
+
+        template<class K>
+        iterator upper_bound(const K &key);
+
+        template<class K>
+        const_iterator upper_bound(const K &key) const {
+            return const_iterator(const_cast<intrusive_rbtree *>(this)->upper_bound(key));
+        }
+
+        template<class K>
+        mystl::pair<iterator, iterator> equal_range(const K &key) {
+            return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        template<class K>
+        mystl::pair<const_iterator, const_iterator> equal_range(const K &key) const {
+            return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+        }
+
+    private:
+        // helper functions
+        void reset_header() noexcept;
+
+        // 接管 rhs 的所有对象，本 intrusive_rbtree 需为空
+        void take_nodes(intrusive_rbtree &rhs) noexcept;
+
+        // 把对象 z 作为 y 的子节点接入树中并重新平衡，y 为 header_ 时 z 成为根节点
+        iterator link_at(base_ptr y, base_ptr z, bool add_to_left) noexcept;
+
+        // 摘下以 x 为根的子树中的所有对象，不重新平衡
+        template<class Disposer>
+        static void dispose_subtree(base_ptr x, Disposer &disposer);
+
+        static reference value_of(base_ptr x) noexcept {
+            return static_cast<reference>(static_cast<hook_type &>(*x));
+        }
+
+        static void reset_hook(base_ptr x) noexcept {
+            static_cast<hook_type *>(x)->reset();
+        }
+
+    public:
+        friend bool operator==(const intrusive_rbtree &lhs, const intrusive_rbtree &rhs) {
+            return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator<(const intrusive_rbtree &lhs, const intrusive_rbtree &rhs) {
+            return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+    };
+
+/*****************************************************************************************/
+
+// 插入对象，允许与已有对象相等，相等的对象按插入顺序排列
+    template<class T, class Compare, class Tag>
+    typename intrusive_rbtree<T, Compare, Tag>::iterator
+    intrusive_rbtree<T, Compare, Tag>::
+    insert_multi(reference value) {
+        base_ptr z = static_cast<hook_type &>(value).get_base_ptr();
+        MYSTL_DEBUG(!static_cast<hook_type &>(value).is_linked());
+        base_ptr y = header();
+        base_ptr x = root();
+        bool add_to_left = true;
+        while (x != nullptr) {
+            rb_tree_prefetch_children(x);
+            y = x;
+            add_to_left = comp_(value, value_of(x));
+            x = add_to_left ? x->left : x->right;
+        }
+        return link_at(y, z, add_to_left);
+    }
+
+// 插入对象，已有相等的对象时不插入，返回指向该对象的迭代器和 false
+    template<class T, class Compare, class Tag>
+    mystl::pair<typename intrusive_rbtree<T, Compare, Tag>::iterator, bool>
+    intrusive_rbtree<T, Compare, Tag>::
+    insert_unique(reference value) {
+        base_ptr z = static_cast<hook_type &>(value).get_base_ptr();
+        MYSTL_DEBUG(!static_cast<hook_type &>(value).is_linked());
+        base_ptr y = header();
+        base_ptr x = root();
+        bool add_to_left = true;
+        while (x != nullptr) {
+            rb_tree_prefetch_children(x);
+            y = x;
+            add_to_left = comp_(value, value_of(x));
+            x = add_to_left ? x->left : x->right;
+        }
+        iterator j(y);
+        if (add_to_left) {
+            if (y == header() || y == leftmost()) {
+                return mystl::make_pair(link_at(y, z, true), true);
+            }
+            --j;
+        }
+        if (comp_(*j, value)) {
+            return mystl::make_pair(link_at(y, z, add_to_left), true);
+        }
+        return mystl::make_pair(j, false);
+    }
+
+// 摘下 pos 处的对象
+    template<class T, class Compare, class Tag>
+    typename intrusive_rbtree<T, Compare, Tag>::iterator
+    intrusive_rbtree<T, Compare, Tag>::
+    erase(const_iterator pos) noexcept {
+        MYSTL_DEBUG(pos != cend());
+        base_ptr z = pos.node;
+        iterator next(z);
+        ++next;
+        rb_tree_erase_rebalance(z, root(), leftmost(), rightmost());
+        reset_hook(z);
+        --node_count_;
+        return next;
+    }
+
+// 摘下 [first, last) 内的对象
+    template<class T, class Compare, class Tag>
+    typename intrusive_rbtree<T, Compare, Tag>::iterator
+    intrusive_rbtree<T, Compare, Tag>::
+    erase(const_iterator first, const_iterator last) noexcept {
+        if (first == cbegin() && last == cend()) {
+            clear();
+            return end();
+        }
+        while (first != last) {
+            first = erase(first);
+        }
+        return iterator(last.node);
+    }
+
+// 摘下 pos 处的对象并交给 disposer
+    template<class T, class Compare, class Tag>
+    template<class Disposer>
+    typename intrusive_rbtree<T, Compare, Tag>::iterator
+    intrusive_rbtree<T, Compare, Tag>::
+    erase_and_dispose(const_iterator pos, Disposer disposer) {
+        auto &value = value_of(pos.node);
+        auto next = erase(pos);
+        disposer(&value);
+        return next;
+    }
+
+// 摘下所有对象并依次交给 disposer，整体摘下，不必逐个重新平衡
+    template<class T, class Compare, class Tag>
+    template<class Disposer>
+    void intrusive_rbtree<T, Compare, Tag>::
+    clear_and_dispose(Disposer disposer) {
+        base_ptr x = root();
+        reset_header();
+        dispose_subtree(x, disposer);
+    }
+
+// 查找与 key 相等的对象，没有时返回 end()
+    template<class T, class Compare, class Tag>
+    template<class K>
+    typename intrusive_rbtree<T, Compare, Tag>::iterator
+    intrusive_rbtree<T, Compare, Tag>::
+    find(const K &key) {
+        auto j = lower_bound(key);
+        return (j == end() || comp_(key, *j)) ? end() : j;
+    }
+
+// 第一个不小于 key 的对象
+    template<class T, class Compare, class Tag>
+    template<class K>
+    typename intrusive_rbtree<T, Compare, Tag>::iterator
+    intrusive_rbtree<T, Compare, Tag>::
+    lower_bound(const K &key) {
+        base_ptr y = header();
+        base_ptr x = root();
+        while (x != nullptr) {
+            rb_tree_prefetch_children(x);
+            if (!comp_(value_of(x), key)) {
+                y = x;
+                x = x->left;
+            } else {
+                x = x->right;
+            }
+        }
+        return iterator(y);
+    }
+
+// 第一个大于 key 的对象
+    template<class T, class Compare, class Tag>
+    template<class K>
+    typename intrusive_rbtree<T, Compare, Tag>::iterator
+    intrusive_rbtree<T, Compare, Tag>::
+    upper_bound(const K &key) {
+        base_ptr y = header();
+        base_ptr x = root();
+        while (x != nullptr) {
+            rb_tree_prefetch_children(x);
+            if (comp_(key, value_of(x))) {
+                y = x;
+                x = x->left;
+            } else {
+                x = x->right;
+            }
+        }
+        return iterator(y);
+    }
+
+// 重置 header_，header_ 为红色，与根节点区分
+    template<class T, class Compare, class Tag>
+    void intrusive_rbtree<T, Compare, Tag>::
+    reset_header() noexcept {
+        rb_tree_set_parent_color(header(), nullptr, rb_tree_red);
+        leftmost() = header();
+        rightmost() = header();
+        node_count_ = 0;
+    }
+
+// 接管 rhs 的所有对象
+    template<class T, class Compare, class Tag>
+    void intrusive_rbtree<T, Compare, Tag>::
+    take_nodes(intrusive_rbtree &rhs) noexcept {
+        if (rhs.empty()) {
+            return;
+        }
+        root() = static_cast<base_ptr>(rhs.root());
+        leftmost() = rhs.leftmost();
+        rightmost() = rhs.rightmost();
+        root()->parent = header();
+        node_count_ = rhs.node_count_;
+        rhs.reset_header();
+    }
+
+// 把 z 接到 y 之下，与 rb_tree::insert_node_at 相同，只是节点来自对象本身
+    template<class T, class Compare, class Tag>
+    typename intrusive_rbtree<T, Compare, Tag>::iterator
+    intrusive_rbtree<T, Compare, Tag>::
+    link_at(base_ptr y, base_ptr z, bool add_to_left) noexcept {
+        rb_tree_set_parent_color(z, y, rb_tree_red);
+        z->left = z->right = nullptr;
+        if (y == header()) {
+            root() = z;
+            leftmost() = z;
+            rightmost() = z;
+        } else if (add_to_left) {
+            y->left = z;
+            if (leftmost() == y) {
+                leftmost() = z;
+            }
+        } else {
+            y->right = z;
+            if (rightmost() == y) {
+                rightmost() = z;
+            }
+        }
+        rb_tree_insert_rebalance(z, root());
+        ++node_count_;
+        return iterator(z);
+    }
+
+// 摘下子树中的所有对象并交给 disposer：递归处理右子树，循环处理左子树
+    template<class T, class Compare, class Tag>
+    template<class Disposer>
+    void intrusive_rbtree<T, Compare, Tag>::
+    dispose_subtree(base_ptr x, Disposer &disposer) {
+        while (x != nullptr) {
+            dispose_subtree(x->right, disposer);
+            auto y = x->left;
+            reset_hook(x);
+            disposer(&value_of(x));
+            x = y;
+        }
+    }
+
+    // 重载比较操作符
+    template<class T, class Compare, class Tag>
+    bool operator!=(const intrusive_rbtree<T, Compare, Tag> &lhs, const intrusive_rbtree<T, Compare, Tag> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, class Compare, class Tag>
+    bool operator>(const intrusive_rbtree<T, Compare, Tag> &lhs, const intrusive_rbtree<T, Compare, Tag> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, class Compare, class Tag>
+    bool operator<=(const intrusive_rbtree<T, Compare, Tag> &lhs, const intrusive_rbtree<T, Compare, Tag> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, class Compare, class Tag>
+    bool operator>=(const intrusive_rbtree<T, Compare, Tag> &lhs, const intrusive_rbtree<T, Compare, Tag> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class T, class Compare, class Tag>
+    void swap(intrusive_rbtree<T, Compare, Tag> &lhs, intrusive_rbtree<T, Compare, Tag> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // inline namespace MYSTL_RB_TREE_ABI
+} // namespace mystl
+#endif // !MYTINYSTL_INTRUSIVE_RBTREE_H_
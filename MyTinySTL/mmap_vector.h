@@ -0,0 +1,633 @@
+#ifndef MYTINYSTL_MMAP_VECTOR_H_
+#define MYTINYSTL_MMAP_VECTOR_H_
+
+// 这个头文件包含一个模板类 mmap_vector
+// mmap_vector : 以文件映射为存储空间的向量，元素直接存放在文件中，重新打开文件时不需要复制数据
+
+// notes:
+//
+// 1. 只接受平凡可复制（trivially copyable）的元素类型，元素以内存映像的形式保存在文件中，
+//    因此文件只能被相同平台、相同类型的程序读取
+// 2. 文件布局：开头是 64 字节的文件头，之后连续存放元素，文件长度决定容量
+// 3. 扩容时先用 ftruncate 加长文件，再用 mremap 扩大映射，与 vector 一样会使所有迭代器失效
+// 4. 元素个数在 flush / close 时写回文件头，flush 通过 msync 把修改同步到磁盘
+// 5. 对象不可复制，只能移动；仅支持 POSIX 平台
+//
+// 异常保证：
+// 打开、扩容失败时抛出 std::runtime_error，容器保持原状
+
+#include <initializer_list>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "iterator.h"
+#include "algobase.h"
+#include "algo.h"
+#include "construct.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // mmap_vector 的文件头，位于文件开头
+    struct mmap_vector_header {
+        uint64_t magic;      // 文件标识
+        uint64_t version;    // 文件格式版本
+        uint64_t elem_size;  // 元素大小，打开时校验
+        uint64_t size;       // 元素个数
+    };
+
+    static constexpr uint64_t mmap_vector_magic = 0x4d59535456454331ULL;  // "MYSTVEC1"
+    static constexpr uint64_t mmap_vector_version = 1;
+
+// 模板类: mmap_vector
+// 模板参数 T 代表类型，接口与 mystl::vector 保持一致，另有 open / flush / close 等文件操作
+    template<class T>
+    class mmap_vector {
+        static_assert(std::is_trivially_copyable<T>::value, "mmap_vector requires trivially copyable T");
+        static_assert(!std::is_same<bool, T>::value, "mmap_vector<bool> is abandoned in mystl");
+
+    public:
+        // mmap_vector 的嵌套型别定义
+        typedef T value_type;
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        typedef value_type *iterator;
+        typedef const value_type *const_iterator;
+        typedef mystl::reverse_iterator<iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        // 文件头占用的字节数，同时保证元素按 64 字节对齐
+        static constexpr size_type header_size = 64;
+
+        static_assert(sizeof(mmap_vector_header) <= header_size, "mmap_vector header too large");
+        static_assert(alignof(T) <= header_size, "mmap_vector element alignment too large");
+
+    private:
+        int fd_;            // 文件描述符，未打开时为 -1
+        char *base_;        // 映射的起始地址，即文件头所在位置
+        size_type map_len_; // 映射长度，等于文件长度
+        iterator begin_;    // 表示目前使用空间的头部
+        iterator end_;      // 表示目前使用空间的尾部
+        iterator cap_;      // 表示目前储存空间的尾部
+
+    public:
+        // 构造、移动、析构函数
+        mmap_vector() noexcept
+                : fd_(-1), base_(nullptr), map_len_(0),
+                  begin_(nullptr), end_(nullptr), cap_(nullptr) {}
+
+        // 打开 path 指向的文件，文件不存在则创建
+        explicit mmap_vector(const char *path) : mmap_vector() { open(path); }
+
+        mmap_vector(const mmap_vector &) = delete;
+
+        mmap_vector &operator=(const mmap_vector &) = delete;
+
+        mmap_vector(mmap_vector &&rhs) noexcept
+                : fd_(rhs.fd_), base_(rhs.base_), map_len_(rhs.map_len_),
+                  begin_(rhs.begin_), end_(rhs.end_), cap_(rhs.cap_) {
+            rhs.reset();
+        }
+
+        mmap_vector &operator=(mmap_vector &&rhs) noexcept {
+            if (this != &rhs) {
+                close();
+                fd_ = rhs.fd_;
+                base_ = rhs.base_;
+                map_len_ = rhs.map_len_;
+                begin_ = rhs.begin_;
+                end_ = rhs.end_;
+                cap_ = rhs.cap_;
+                rhs.reset();
+            }
+            return *this;
+        }
+
+        ~mmap_vector() { close(); }
+
+    public:
+        // 文件相关操作
+        void open(const char *path);
+
+        void flush();
+
+        void close() noexcept;
+
+        bool is_open() const noexcept { return fd_ >= 0; }
+
+        // 迭代器相关操作
+        iterator begin() noexcept { return begin_; }
+
+        const_iterator begin() const noexcept { return begin_; }
+
+        iterator end() noexcept { return end_; }
+
+        const_iterator end() const noexcept { return end_; }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return begin_ == end_; }
+
+        size_type size() const noexcept { return static_cast<size_type>(end_ - begin_); }
+
+        size_type max_size() const noexcept { return (static_cast<size_type>(-1) - header_size) / sizeof(T); }
+
+        size_type capacity() const noexcept { return static_cast<size_type>(cap_ - begin_); }
+
+        void reserve(size_type n);
+
+        void shrink_to_fit();
+
+        // 访问元素相关操作
+        reference operator[](size_type n) {
+            MYSTL_DEBUG(n < size());
+            return *(begin_ + n);
+        }
+
+        const_reference operator[](size_type n) const {
+            MYSTL_DEBUG(n < size());
+            return *(begin_ + n);
+        }
+
+        reference at(size_type n) {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "mmap_vector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        const_reference at(size_type n) const {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "mmap_vector<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front() {
+            MYSTL_DEBUG(!empty());
+            return *begin_;
+        }
+
+        const_reference front() const {
+            MYSTL_DEBUG(!empty());
+            return *begin_;
+        }
+
+        reference back() {
+            MYSTL_DEBUG(!empty());
+            return *(end_ - 1);
+        }
+
+        const_reference back() const {
+            MYSTL_DEBUG(!empty());
+            return *(end_ - 1);
+        }
+
+        pointer data() noexcept { return begin_; }
+
+        const_pointer data() const noexcept { return begin_; }
+
+        // 修改容器相关操作
+        // assign
+        void assign(size_type n, const value_type &value) {
+            clear();
+            fill_insert(begin_, n, value);
+        }
+
+        template<class Iter, typename std::enable_if<
+                mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last) {
+            clear();
+            copy_insert(begin_, first, last, iterator_category(first));
+        }
+
+        void assign(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); }
+
+        // emplace / emplace_back
+        template<class... Args>
+        iterator emplace(const_iterator pos, Args &&...args) {
+            // 先构造出元素，参数可能引用容器内的元素，扩容后会失效
+            return fill_insert(const_cast<iterator>(pos), 1, value_type(mystl::forward<Args>(args)...));
+        }
+
+        template<class... Args>
+        void emplace_back(Args &&...args);
+
+        // push_back / pop_back
+        void push_back(const value_type &value);
+
+        void pop_back() {
+            MYSTL_DEBUG(!empty());
+            --end_;
+        }
+
+        // insert
+        iterator insert(const_iterator pos, const value_type &value) {
+            MYSTL_DEBUG(pos >= begin() && pos <= end());
+            return fill_insert(const_cast<iterator>(pos), 1, value);
+        }
+
+        iterator insert(const_iterator pos, size_type n, const value_type &value) {
+            MYSTL_DEBUG(pos >= begin() && pos <= end());
+            return fill_insert(const_cast<iterator>(pos), n, value);
+        }
+
+        template<class Iter, typename std::enable_if<
+                mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        void insert(const_iterator pos, Iter first, Iter last) {
+            MYSTL_DEBUG(pos >= begin() && pos <= end());
+            copy_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+        }
+
+        // erase / clear
+        iterator erase(const_iterator pos) {
+            MYSTL_DEBUG(pos >= begin() && pos < end());
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        void clear() noexcept { end_ = begin_; }
+
+        // resize / reverse
+        void resize(size_type new_size) { resize(new_size, value_type()); }
+
+        void resize(size_type new_size, const value_type &value);
+
+        void reverse() {
+            for (auto first = begin_, last = end_; first != last && first != --last; ++first) {
+                mystl::swap(*first, *last);
+            }
+        }
+
+        // swap
+        void swap(mmap_vector &rhs) noexcept;
+
+    private:
+        // helper functions
+
+        // 指针全部置空，用于移动后
+        void reset() noexcept;
+
+        // 计算增长规模
+        size_type get_new_cap(size_type add_size);
+
+        // 调整文件长度与映射，使容量变为 new_cap
+        void remap(size_type new_cap);
+
+        // 保证至少还能放下 n 个元素
+        void require_capacity(size_type n) {
+            if (static_cast<size_type>(cap_ - end_) < n) {
+                remap(get_new_cap(n));
+            }
+        }
+
+        mmap_vector_header *header() const noexcept {
+            return reinterpret_cast<mmap_vector_header *>(base_);
+        }
+
+        // insert
+        iterator fill_insert(iterator pos, size_type n, const value_type &value);
+
+        template<class IIter>
+        void copy_insert(iterator pos, IIter first, IIter last, input_iterator_tag);
+
+        template<class FIter>
+        void copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag);
+    };
+
+/**********************************************************************************************/
+
+// 打开文件并映射到内存，文件为空时写入文件头，否则校验文件头后直接使用其中的数据
+    template<class T>
+    void mmap_vector<T>::open(const char *path) {
+        close();
+        const int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        THROW_RUNTIME_ERROR_IF(fd < 0, "mmap_vector<T>::open() can not open file");
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("mmap_vector<T>::open() can not stat file");
+        }
+        size_type len = static_cast<size_type>(st.st_size);
+        const bool fresh = len == 0;
+        if (fresh) {
+            // 新文件，预留 16 个元素的空间
+            len = header_size + 16 * sizeof(T);
+            if (::ftruncate(fd, static_cast<off_t>(len)) != 0) {
+                ::close(fd);
+                throw std::runtime_error("mmap_vector<T>::open() can not resize file");
+            }
+        } else if (len < header_size) {
+            ::close(fd);
+            throw std::runtime_error("mmap_vector<T>::open() file is not a mmap_vector");
+        }
+
+        void *p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("mmap_vector<T>::open() can not map file");
+        }
+
+        auto h = reinterpret_cast<mmap_vector_header *>(p);
+        const size_type cap = (len - header_size) / sizeof(T);
+        if (fresh) {
+            h->magic = mmap_vector_magic;
+            h->version = mmap_vector_version;
+            h->elem_size = sizeof(T);
+            h->size = 0;
+        } else if (h->magic != mmap_vector_magic || h->version != mmap_vector_version ||
+                   h->elem_size != sizeof(T) || h->size > cap) {
+            ::munmap(p, len);
+            ::close(fd);
+            throw std::runtime_error("mmap_vector<T>::open() file is not a mmap_vector of this type");
+        }
+
+        fd_ = fd;
+        base_ = static_cast<char *>(p);
+        map_len_ = len;
+        begin_ = reinterpret_cast<iterator>(base_ + header_size);
+        end_ = begin_ + h->size;
+        cap_ = begin_ + cap;
+    }
+
+// 写回元素个数并用 msync 把映射同步到文件
+    template<class T>
+    void mmap_vector<T>::flush() {
+        if (!is_open()) {
+            return;
+        }
+        header()->size = size();
+        THROW_RUNTIME_ERROR_IF(::msync(base_, map_len_, MS_SYNC) != 0, "mmap_vector<T>::flush() msync failed");
+    }
+
+// 写回元素个数，解除映射并关闭文件，脏页由内核稍后写回
+    template<class T>
+    void mmap_vector<T>::close() noexcept {
+        if (!is_open()) {
+            return;
+        }
+        header()->size = size();
+        ::munmap(base_, map_len_);
+        ::close(fd_);
+        reset();
+    }
+
+// 预留空间大小，当原容量小于要求大小时，才会加长文件
+    template<class T>
+    void mmap_vector<T>::reserve(size_type n) {
+        if (capacity() < n) {
+            THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than maxsize() in mmap_vector<T>::reserve(n)");
+            remap(n);
+        }
+    }
+
+// 放弃多余的容量，同时截短文件
+    template<class T>
+    void mmap_vector<T>::shrink_to_fit() {
+        if (end_ < cap_) {
+            remap(size());
+        }
+    }
+
+// 在尾部就地构造元素
+    template<class T>
+    template<class ...Args>
+    void mmap_vector<T>::emplace_back(Args &&...args) {
+        if (end_ == cap_) {
+            value_type value(mystl::forward<Args>(args)...);
+            remap(get_new_cap(1));
+            *end_ = value;
+        } else {
+            mystl::construct(end_, mystl::forward<Args>(args)...);
+        }
+        ++end_;
+    }
+
+// 在尾部插入元素
+    template<class T>
+    void mmap_vector<T>::push_back(const value_type &value) {
+        if (end_ == cap_) {
+            // value 可能就在容器中，扩容前先复制一份
+            const value_type value_copy = value;
+            remap(get_new_cap(1));
+            *end_ = value_copy;
+        } else {
+            *end_ = value;
+        }
+        ++end_;
+    }
+
+// 删除[first, last)上的元素
+    template<class T>
+    typename mmap_vector<T>::iterator
+    mmap_vector<T>::erase(const_iterator first, const_iterator last) {
+        MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        iterator xfirst = begin_ + (first - begin());
+        end_ = mystl::copy(const_cast<iterator>(last), end_, xfirst);
+        return xfirst;
+    }
+
+// 重置容器大小
+    template<class T>
+    void mmap_vector<T>::resize(size_type new_size, const value_type &value) {
+        if (new_size < size()) {
+            end_ = begin_ + new_size;
+        } else {
+            fill_insert(end_, new_size - size(), value);
+        }
+    }
+
+// 与另一个 mmap_vector 交换
+    template<class T>
+    void mmap_vector<T>::swap(mmap_vector &rhs) noexcept {
+        if (this != &rhs) {
+            mystl::swap(fd_, rhs.fd_);
+            mystl::swap(base_, rhs.base_);
+            mystl::swap(map_len_, rhs.map_len_);
+            mystl::swap(begin_, rhs.begin_);
+            mystl::swap(end_, rhs.end_);
+            mystl::swap(cap_, rhs.cap_);
+        }
+    }
+
+/*********************************************************************************************/
+// helper function
+
+// reset 函数
+    template<class T>
+    void mmap_vector<T>::reset() noexcept {
+        fd_ = -1;
+        base_ = nullptr;
+        map_len_ = 0;
+        begin_ = nullptr;
+        end_ = nullptr;
+        cap_ = nullptr;
+    }
+
+// get_new_cap 函数，与 vector 相同，按 1.5 倍增长
+    template<class T>
+    typename mmap_vector<T>::size_type
+    mmap_vector<T>::get_new_cap(size_type add_size) {
+        const auto old_size = capacity();
+        THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size, "mmap_vector<T>'s size too big");
+        if (old_size > max_size() - old_size / 2) {
+            return old_size + add_size > max_size() - 16 ? old_size + add_size : old_size + add_size + 16;
+        }
+        return old_size == 0 ? mystl::max(add_size, static_cast<size_type>(16))
+                             : mystl::max(old_size + old_size / 2, old_size + add_size);
+    }
+
+// remap 函数
+// 增长时先加长文件再扩大映射，收缩时先缩小映射再截短文件，映射地址可能改变
+    template<class T>
+    void mmap_vector<T>::remap(size_type new_cap) {
+        THROW_RUNTIME_ERROR_IF(!is_open(), "mmap_vector<T> is not open");
+        const size_type new_len = header_size + new_cap * sizeof(T);
+        const size_type old_size = size();
+        if (new_len > map_len_) {
+            THROW_RUNTIME_ERROR_IF(::ftruncate(fd_, static_cast<off_t>(new_len)) != 0,
+                                   "mmap_vector<T> can not resize file");
+        }
+#if defined(__linux__)
+        void *p = ::mremap(base_, map_len_, new_len, MREMAP_MAYMOVE);
+#else
+        void *p = ::mmap(nullptr, new_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p != MAP_FAILED) {
+            ::munmap(base_, map_len_);
+        }
+#endif
+        if (p == MAP_FAILED) {
+            if (new_len > map_len_) {
+                // 恢复原来的文件长度
+                (void) ::ftruncate(fd_, static_cast<off_t>(map_len_));
+            }
+            throw std::runtime_error("mmap_vector<T> can not remap file");
+        }
+        if (new_len < map_len_) {
+            // 映射已缩小，截短失败只是多占磁盘空间，不影响使用
+            (void) ::ftruncate(fd_, static_cast<off_t>(new_len));
+        }
+        base_ = static_cast<char *>(p);
+        map_len_ = new_len;
+        begin_ = reinterpret_cast<iterator>(base_ + header_size);
+        end_ = begin_ + old_size;
+        cap_ = begin_ + new_cap;
+    }
+
+// fill_insert 函数
+// 在 pos 处插入 n 个 value，元素平凡可复制，直接整体后移
+    template<class T>
+    typename mmap_vector<T>::iterator
+    mmap_vector<T>::fill_insert(iterator pos, size_type n, const value_type &value) {
+        const size_type xpos = pos - begin_;
+        if (n == 0) {
+            return pos;
+        }
+        const value_type value_copy = value;  // 避免扩容或移动后 value 被改变
+        require_capacity(n);
+        pos = begin_ + xpos;
+        mystl::copy_backward(pos, end_, end_ + n);
+        mystl::fill_n(pos, n, value_copy);
+        end_ += n;
+        return pos;
+    }
+
+// copy_insert 函数
+// 在 pos 处插入 [first, last)，区间不能来自容器本身
+// 输入迭代器只能遍历一次，逐个追加到尾部，再把追加的部分旋转到 pos 处
+    template<class T>
+    template<class IIter>
+    void mmap_vector<T>::copy_insert(iterator pos, IIter first, IIter last, input_iterator_tag) {
+        const size_type xpos = pos - begin_;
+        const size_type old_size = size();
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+        if (xpos != old_size) {
+            // 三次反转完成旋转：[pos, old_end) 与 [old_end, end) 交换位置
+            mystl::reverse(begin_ + xpos, begin_ + old_size);
+            mystl::reverse(begin_ + old_size, end_);
+            mystl::reverse(begin_ + xpos, end_);
+        }
+    }
+
+    template<class T>
+    template<class FIter>
+    void mmap_vector<T>::copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag) {
+        const size_type xpos = pos - begin_;
+        const size_type n = mystl::distance(first, last);
+        if (n == 0) {
+            return;
+        }
+        require_capacity(n);
+        pos = begin_ + xpos;
+        mystl::copy_backward(pos, end_, end_ + n);
+        mystl::copy(first, last, pos);
+        end_ += n;
+    }
+
+/*****************************************************************************************************/
+// 重载比较操作符
+
+    template<class T>
+    bool operator==(const mmap_vector<T> &lhs, const mmap_vector<T> &rhs) {
+        return lhs.size() == rhs.size() &&
+               mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class T>
+    bool operator<(const mmap_vector<T> &lhs, const mmap_vector<T> &rhs) {
+        return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<class T>
+    bool operator!=(const mmap_vector<T> &lhs, const mmap_vector<T> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T>
+    bool operator>(const mmap_vector<T> &lhs, const mmap_vector<T> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T>
+    bool operator<=(const mmap_vector<T> &lhs, const mmap_vector<T> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T>
+    bool operator>=(const mmap_vector<T> &lhs, const mmap_vector<T> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class T>
+    void swap(mmap_vector<T> &lhs, mmap_vector<T> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_MMAP_VECTOR_H_
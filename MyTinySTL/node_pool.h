@@ -0,0 +1,604 @@
+#ifndef MYTINYSTL_NODE_POOL_H_
+#define MYTINYSTL_NODE_POOL_H_
+
+// 这个头文件包含两个模板类 node_pool 和 shared_node_pool
+// node_pool        : 节点池，以成块（slab）的方式为链式容器分配固定大小的节点
+// shared_node_pool : 带引用计数的节点池句柄，交换过节点的容器共用同一个节点池
+
+// notes:
+//
+// 1. 每个容器持有自己的节点池，节点从当前块中顺序切出，同一批插入的节点在内存中相邻
+// 2. 释放的节点挂到空闲链表上，下次分配时优先复用；allocate_n 可一次取得 n 个连续的节点
+// 3. release() 一次性归还所有块，不需要逐个释放节点；
+//    元素可平凡析构时，容器的 clear() 和析构可以直接调用 release() 而不必遍历所有节点
+// 4. 块的大小从 min_slab_nodes 个节点开始倍增，单块不超过 max_slab_bytes 字节；
+//    块由模板参数 Alloc 分配，Alloc 给出了 allocator_chunk_bytes 时以它为单块上限，
+//    使用 huge_page_allocator 时块会增长到一个大页，从而以大页映射
+// 5. 归还空闲的块：节点全部归还时，除当前块外的块都是空的，直接归还；
+//    否则当空闲节点多于使用中的节点、且达到上次整理后剩余空闲节点数的两倍（至少两个整块）时，
+//    把空闲链表按地址排序，归还其中完全空闲的块，排序的代价由其间的释放操作均摊
+// 6. node_pool 只负责未初始化的空间，节点的构造和析构由容器负责
+// 7. 容器之间直接转移节点（split、join、merge、splice、node handle）后，节点可能属于另一个容器的节点池：
+//    此时两者通过 shared_node_pool 共用节点池，只有独占节点池时才能整块释放。
+//    share_with 总能成功：两个节点池合并时一方的块并入另一方，被并入的一方只留下指向对方的转发指针，
+//    仍指向它的句柄在下一次操作时转到合并后的节点池
+// 8. 引用计数是原子变量；节点池被共用时，分配、归还、合并都在节点池的互斥锁下进行，
+//    因此共用节点池的容器可以在不同线程中各自修改；独占节点池时不加锁。
+//    同一个容器仍不能在多个线程中同时修改
+
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+
+#include "allocator.h"
+#include "heap_algo.h"
+#include "vector.h"
+#include "util.h"
+
+namespace mystl {
+
+    // 模板类 node_pool
+    // 模板参数 Node 代表节点类型，Alloc 代表分配块的空间配置器
+    template<class Node, class Alloc = mystl::allocator<Node>>
+    class node_pool {
+    public:
+        typedef Node node_type;
+        typedef Node *node_ptr;
+        typedef size_t size_type;
+        typedef typename Alloc::template rebind<Node>::other slab_allocator;
+
+        static constexpr size_type min_slab_nodes = 16;
+        static constexpr size_type max_slab_bytes = allocator_chunk_bytes<Alloc>::value != 0
+                                                    ? allocator_chunk_bytes<Alloc>::value : 64 * 1024;
+
+    private:
+        // 块头，块中节点紧跟在块头之后
+        struct slab_header {
+            slab_header *next;  // 上一个申请的块
+            size_type count;    // 块所占的节点数（含块头），释放时传给配置器
+        };
+
+        // 空闲节点复用节点本身的空间保存链表指针
+        struct free_node {
+            free_node *next;
+        };
+
+        static_assert(sizeof(Node) >= sizeof(free_node), "node_pool requires sizeof(Node) >= sizeof(void*)");
+
+        // 块头所占的节点数，块以节点为单位向配置器申请
+        static constexpr size_type header_nodes = (sizeof(slab_header) + sizeof(Node) - 1) / sizeof(Node);
+
+        // 块头与节点合起来不超过 max_slab_bytes，大页配置器下一块恰好一个大页
+        static constexpr size_type max_slab_nodes = max_slab_bytes / sizeof(Node) > min_slab_nodes + header_nodes
+                                                    ? max_slab_bytes / sizeof(Node) - header_nodes : min_slab_nodes;
+
+        slab_header *slabs_;      // 所有块组成的单向链表，从最新的块开始
+        slab_header *slab_tail_;  // 最早申请的块，用于拼接两个节点池
+        free_node *free_;         // 空闲节点链表
+        free_node *free_tail_;    // 空闲节点链表的尾部
+        node_ptr cur_;            // 当前块中下一个可切出的节点
+        node_ptr end_;            // 当前块的尾部
+        size_type next_count_;    // 下一个块的节点数
+        size_type live_;          // 已分配且未归还的节点数
+        size_type free_count_;    // 空闲链表上的节点数
+        size_type trim_base_;     // 上次整理后剩余的空闲节点数，空闲节点数达到它的两倍时再次整理
+
+    public:
+        // 构造、移动、析构函数
+        node_pool() noexcept { reset(); }
+
+        node_pool(const node_pool &) = delete;
+
+        node_pool &operator=(const node_pool &) = delete;
+
+        node_pool(node_pool &&rhs) noexcept
+                : slabs_(rhs.slabs_), slab_tail_(rhs.slab_tail_), free_(rhs.free_), free_tail_(rhs.free_tail_),
+                  cur_(rhs.cur_), end_(rhs.end_), next_count_(rhs.next_count_), live_(rhs.live_),
+                  free_count_(rhs.free_count_), trim_base_(rhs.trim_base_) {
+            rhs.reset();
+        }
+
+        node_pool &operator=(node_pool &&rhs) noexcept {
+            if (this != &rhs) {
+                release();
+                swap(rhs);
+            }
+            return *this;
+        }
+
+        ~node_pool() { release(); }
+
+    public:
+        // 分配一个节点的空间
+        node_ptr allocate() {
+            if (free_ != nullptr) {
+                auto p = free_;
+                free_ = free_->next;
+                if (free_ == nullptr) {
+                    free_tail_ = nullptr;
+                }
+                if (--free_count_ < trim_base_ && trim_base_ > max_slab_nodes) {
+                    trim_base_ = free_count_ > max_slab_nodes ? free_count_ : max_slab_nodes;
+                }
+                ++live_;
+                return reinterpret_cast<node_ptr>(p);
+            }
+            if (cur_ == end_) {
+                add_slab(next_count_);
+            }
+            ++live_;
+            return cur_++;
+        }
+
+        // 分配 n 个在内存中连续的节点，可以逐个 deallocate 归还
+        node_ptr allocate_n(size_type n) {
+            if (static_cast<size_type>(end_ - cur_) < n) {
+                add_slab(n > next_count_ ? n : next_count_);
+            }
+            auto p = cur_;
+            cur_ += n;
+            live_ += n;
+            return p;
+        }
+
+        // 归还一个节点的空间，节点上的对象必须已经析构
+        void deallocate(node_ptr p) noexcept {
+            push_free(p);
+            if (--live_ == 0) {
+                release_idle();
+            } else if (free_count_ >= 2 * trim_base_ && free_count_ > live_) {
+                trim();
+            }
+        }
+
+        // 一次性归还所有块，之前分配出的节点全部失效
+        void release() noexcept {
+            while (slabs_ != nullptr) {
+                auto next = slabs_->next;
+                slab_allocator::deallocate(reinterpret_cast<node_ptr>(slabs_), slabs_->count);
+                slabs_ = next;
+            }
+            reset();
+        }
+
+        // 接管 rhs 的所有块，rhs 分配出的节点此后由本节点池负责，rhs 变为空
+        // 除了 rhs 当前块中未切出的节点外为 O(1)
+        void splice(node_pool &rhs) noexcept {
+            if (this == &rhs || rhs.slabs_ == nullptr) {
+                return;
+            }
+            if (slabs_ == nullptr) {
+                // 本节点池还没有块，直接接管 rhs 的全部状态
+                swap(rhs);
+                return;
+            }
+            for (; rhs.cur_ != rhs.end_; ++rhs.cur_) {
+                rhs.push_free(rhs.cur_);
+            }
+            if (rhs.free_ != nullptr) {
+                rhs.free_tail_->next = free_;
+                if (free_ == nullptr) {
+                    free_tail_ = rhs.free_tail_;
+                }
+                free_ = rhs.free_;
+            }
+            // rhs 的块接在当前块之后，当前块始终位于链表头
+            rhs.slab_tail_->next = slabs_->next;
+            slabs_->next = rhs.slabs_;
+            if (slab_tail_ == slabs_) {
+                slab_tail_ = rhs.slab_tail_;
+            }
+            live_ += rhs.live_;
+            free_count_ += rhs.free_count_;
+            rhs.reset();
+        }
+
+        void swap(node_pool &rhs) noexcept {
+            mystl::swap(slabs_, rhs.slabs_);
+            mystl::swap(slab_tail_, rhs.slab_tail_);
+            mystl::swap(free_, rhs.free_);
+            mystl::swap(free_tail_, rhs.free_tail_);
+            mystl::swap(cur_, rhs.cur_);
+            mystl::swap(end_, rhs.end_);
+            mystl::swap(next_count_, rhs.next_count_);
+            mystl::swap(live_, rhs.live_);
+            mystl::swap(free_count_, rhs.free_count_);
+            mystl::swap(trim_base_, rhs.trim_base_);
+        }
+
+        // 当前持有的块数，用于观察空闲块的归还
+        size_type slab_count() const noexcept {
+            size_type n = 0;
+            for (auto s = slabs_; s != nullptr; s = s->next) {
+                ++n;
+            }
+            return n;
+        }
+
+    private:
+        // helper functions
+        void reset() noexcept {
+            slabs_ = nullptr;
+            slab_tail_ = nullptr;
+            free_ = nullptr;
+            free_tail_ = nullptr;
+            cur_ = nullptr;
+            end_ = nullptr;
+            next_count_ = min_slab_nodes;
+            live_ = 0;
+            free_count_ = 0;
+            trim_base_ = max_slab_nodes;
+        }
+
+        void push_free(node_ptr p) noexcept {
+            auto f = reinterpret_cast<free_node *>(p);
+            f->next = free_;
+            if (free_ == nullptr) {
+                free_tail_ = f;
+            }
+            free_ = f;
+            ++free_count_;
+        }
+
+        static uintptr_t address(const void *p) noexcept { return reinterpret_cast<uintptr_t>(p); }
+
+        static node_ptr slab_begin(slab_header *s) noexcept {
+            return reinterpret_cast<node_ptr>(s) + header_nodes;
+        }
+
+        static node_ptr slab_end(slab_header *s) noexcept {
+            return reinterpret_cast<node_ptr>(s) + s->count;
+        }
+
+        // 申请一个含 n 个节点的块，当前块中未切出的节点挂到空闲链表上
+        void add_slab(size_type n) {
+            auto raw = slab_allocator::allocate(header_nodes + n);
+            auto slab = reinterpret_cast<slab_header *>(raw);
+            slab->next = slabs_;
+            slab->count = header_nodes + n;
+            if (slabs_ == nullptr) {
+                slab_tail_ = slab;
+            }
+            slabs_ = slab;
+            for (; cur_ != end_; ++cur_) {
+                push_free(cur_);
+            }
+            cur_ = raw + header_nodes;
+            end_ = cur_ + n;
+            next_count_ = n * 2 < max_slab_nodes ? n * 2 : max_slab_nodes;
+        }
+
+        // 节点全部归还后，归还除当前块外的所有块，空闲链表只保留当前块中的节点
+        void release_idle() noexcept {
+            auto s = slabs_->next;
+            if (s == nullptr) {
+                return;
+            }
+            // 先筛选空闲链表，空闲节点就在要归还的块中
+            const auto first = address(slab_begin(slabs_));
+            const auto last = address(slab_end(slabs_));
+            auto f = free_;
+            free_ = nullptr;
+            free_tail_ = nullptr;
+            free_count_ = 0;
+            while (f != nullptr) {
+                auto next = f->next;
+                if (address(f) >= first && address(f) < last) {
+                    push_free(reinterpret_cast<node_ptr>(f));
+                }
+                f = next;
+            }
+            slabs_->next = nullptr;
+            slab_tail_ = slabs_;
+            while (s != nullptr) {
+                auto next = s->next;
+                slab_allocator::deallocate(reinterpret_cast<node_ptr>(s), s->count);
+                s = next;
+            }
+            trim_base_ = max_slab_nodes;
+        }
+
+        // 归还完全空闲的块，整理所需的临时空间申请失败时放弃整理
+        void trim() noexcept {
+            try {
+                trim_slabs();
+            } catch (...) {
+            }
+            trim_base_ = free_count_ > max_slab_nodes ? free_count_ : max_slab_nodes;
+        }
+
+        void trim_slabs() {
+            auto by_address = [](const void *a, const void *b) { return address(a) < address(b); };
+            // 当前块（链表头）还在切分，不参与整理
+            mystl::vector<slab_header *> slabs;
+            for (auto s = slabs_->next; s != nullptr; s = s->next) {
+                slabs.push_back(s);
+            }
+            if (slabs.empty()) {
+                return;
+            }
+            mystl::vector<free_node *> frees;
+            frees.reserve(free_count_);
+            for (auto f = free_; f != nullptr; f = f->next) {
+                frees.push_back(f);
+            }
+            mystl::make_heap(slabs.begin(), slabs.end(), by_address);
+            mystl::sort_heap(slabs.begin(), slabs.end(), by_address);
+            mystl::make_heap(frees.begin(), frees.end(), by_address);
+            mystl::sort_heap(frees.begin(), frees.end(), by_address);
+
+            // 两个有序序列同时向前扫描，统计每个块中的空闲节点数，全空闲的块做上标记
+            mystl::vector<char> empty(slabs.size(), 0);
+            size_type j = 0, empties = 0;
+            for (size_type i = 0; i < slabs.size(); ++i) {
+                const auto first = address(slab_begin(slabs[i]));
+                const auto last = address(slab_end(slabs[i]));
+                while (j < frees.size() && address(frees[j]) < first) {
+                    ++j;
+                }
+                const size_type k = j;
+                while (j < frees.size() && address(frees[j]) < last) {
+                    ++j;
+                }
+                if (j - k == slabs[i]->count - header_nodes) {
+                    empty[i] = 1;
+                    ++empties;
+                    for (size_type x = k; x < j; ++x) {
+                        frees[x] = nullptr;
+                    }
+                }
+            }
+            if (empties == 0) {
+                return;
+            }
+
+            // 按地址顺序重建空闲链表，之后的分配在内存中更集中
+            free_ = nullptr;
+            free_tail_ = nullptr;
+            free_count_ = 0;
+            for (size_type x = frees.size(); x-- > 0;) {
+                if (frees[x] != nullptr) {
+                    push_free(reinterpret_cast<node_ptr>(frees[x]));
+                }
+            }
+
+            // 从块链表中摘下空块并归还给配置器
+            auto prev = slabs_;
+            for (auto s = slabs_->next; s != nullptr;) {
+                auto next = s->next;
+                size_type lo = 0, hi = slabs.size();
+                while (hi - lo > 1) {
+                    const size_type mid = (lo + hi) / 2;
+                    if (address(slabs[mid]) <= address(s)) {
+                        lo = mid;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                if (empty[lo]) {
+                    prev->next = next;
+                    if (slab_tail_ == s) {
+                        slab_tail_ = prev;
+                    }
+                    slab_allocator::deallocate(reinterpret_cast<node_ptr>(s), s->count);
+                } else {
+                    prev = s;
+                }
+                s = next;
+            }
+        }
+    };
+
+    template<class Node, class Alloc>
+    constexpr typename node_pool<Node, Alloc>::size_type node_pool<Node, Alloc>::min_slab_nodes;
+
+    template<class Node, class Alloc>
+    constexpr typename node_pool<Node, Alloc>::size_type node_pool<Node, Alloc>::max_slab_bytes;
+
+    template<class Node, class Alloc>
+    constexpr typename node_pool<Node, Alloc>::size_type node_pool<Node, Alloc>::header_nodes;
+
+    template<class Node, class Alloc>
+    constexpr typename node_pool<Node, Alloc>::size_type node_pool<Node, Alloc>::max_slab_nodes;
+
+/*****************************************************************************************/
+
+    // 模板类 shared_node_pool
+    // 指向一个带引用计数的 node_pool，复制句柄即共用同一个节点池，第一次分配时才创建节点池
+    template<class Node, class Alloc = mystl::allocator<Node>>
+    class shared_node_pool {
+    public:
+        typedef node_pool<Node, Alloc> pool_type;
+        typedef typename pool_type::node_ptr node_ptr;
+        typedef typename pool_type::size_type size_type;
+
+    private:
+        // 被合并的节点池以 parent 指向接管了它的块的节点池，并持有对方的一个引用
+        struct control {
+            pool_type pool;
+            std::mutex mutex;
+            std::atomic<size_type> refs;
+            std::atomic<control *> parent;
+
+            control() noexcept: refs(1), parent(nullptr) {}
+        };
+
+        control *ctl_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        shared_node_pool() noexcept: ctl_(nullptr) {}
+
+        shared_node_pool(const shared_node_pool &rhs) noexcept: ctl_(rhs.ctl_) {
+            if (ctl_ != nullptr) {
+                ctl_->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        shared_node_pool(shared_node_pool &&rhs) noexcept: ctl_(rhs.ctl_) {
+            rhs.ctl_ = nullptr;
+        }
+
+        shared_node_pool &operator=(const shared_node_pool &rhs) noexcept {
+            shared_node_pool tmp(rhs);
+            swap(tmp);
+            return *this;
+        }
+
+        shared_node_pool &operator=(shared_node_pool &&rhs) noexcept {
+            shared_node_pool tmp(mystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        ~shared_node_pool() { reset(); }
+
+    public:
+        node_ptr allocate() {
+            if (unique()) {
+                return get().allocate();
+            }
+            std::lock_guard<std::mutex> lock(lock_root()->mutex, std::adopt_lock);
+            return ctl_->pool.allocate();
+        }
+
+        node_ptr allocate_n(size_type n) {
+            if (unique()) {
+                return get().allocate_n(n);
+            }
+            std::lock_guard<std::mutex> lock(lock_root()->mutex, std::adopt_lock);
+            return ctl_->pool.allocate_n(n);
+        }
+
+        void deallocate(node_ptr p) noexcept {
+            if (unique()) {
+                ctl_->pool.deallocate(p);
+                return;
+            }
+            std::lock_guard<std::mutex> lock(lock_root()->mutex, std::adopt_lock);
+            ctl_->pool.deallocate(p);
+        }
+
+        // 是否独占节点池，独占时才能不加锁地操作和整块释放
+        // 引用数只能经由本句柄所在的容器增加，因此在本线程中读到 1 之后不会被其他线程改变
+        bool unique() const noexcept {
+            return ctl_ == nullptr ||
+                   (ctl_->refs.load(std::memory_order_acquire) == 1 &&
+                    ctl_->parent.load(std::memory_order_acquire) == nullptr);
+        }
+
+        // 两个句柄的节点能否互相转移
+        bool shares_with(const shared_node_pool &rhs) const noexcept {
+            return find_root(ctl_) == find_root(rhs.ctl_);
+        }
+
+        // 整块释放节点池，只能在独占时调用
+        void release() noexcept {
+            if (ctl_ != nullptr) {
+                ctl_->pool.release();
+            }
+        }
+
+        // 让两个句柄共用节点池，之后双方的节点可以互相转移
+        // 两者属于不同的节点池时，把 rhs 的节点池中的块并入本节点池
+        void share_with(shared_node_pool &rhs) {
+            if (ctl_ == nullptr) {
+                get();
+            }
+            if (rhs.ctl_ == nullptr) {
+                rhs = *this;
+                return;
+            }
+            while (true) {
+                rebase();
+                rhs.rebase();
+                control *a = ctl_;
+                control *b = rhs.ctl_;
+                if (a == b) {
+                    return;
+                }
+                std::lock(a->mutex, b->mutex);
+                if (a->parent.load(std::memory_order_acquire) != nullptr ||
+                    b->parent.load(std::memory_order_acquire) != nullptr) {
+                    // 加锁前其中一方已被其他线程并入别的节点池，重新查找
+                    a->mutex.unlock();
+                    b->mutex.unlock();
+                    continue;
+                }
+                a->pool.splice(b->pool);
+                a->refs.fetch_add(1, std::memory_order_relaxed);
+                b->parent.store(a, std::memory_order_release);
+                b->mutex.unlock();
+                a->mutex.unlock();
+                rhs.rebase();
+                return;
+            }
+        }
+
+        // 放弃对节点池的引用，最后一个引用者负责销毁节点池
+        void reset() noexcept {
+            drop(ctl_);
+            ctl_ = nullptr;
+        }
+
+        void swap(shared_node_pool &rhs) noexcept {
+            mystl::swap(ctl_, rhs.ctl_);
+        }
+
+    private:
+        pool_type &get() {
+            if (ctl_ == nullptr) {
+                ctl_ = new control;
+            }
+            return ctl_->pool;
+        }
+
+        static control *find_root(control *c) noexcept {
+            if (c == nullptr) {
+                return nullptr;
+            }
+            for (auto p = c->parent.load(std::memory_order_acquire); p != nullptr;
+                 p = c->parent.load(std::memory_order_acquire)) {
+                c = p;
+            }
+            return c;
+        }
+
+        // 释放一个引用，被合并的节点池销毁时连带释放它对 parent 的引用
+        static void drop(control *c) noexcept {
+            while (c != nullptr && c->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                auto parent = c->parent.load(std::memory_order_acquire);
+                delete c;
+                c = parent;
+            }
+        }
+
+        // 让 ctl_ 直接指向当前的根节点池
+        // 持有 ctl_ 的引用保证了整条 parent 链上的节点池都存活
+        void rebase() noexcept {
+            auto root = find_root(ctl_);
+            if (root != ctl_) {
+                root->refs.fetch_add(1, std::memory_order_relaxed);
+                auto old = ctl_;
+                ctl_ = root;
+                drop(old);
+            }
+        }
+
+        // 锁住当前的根节点池并返回它，此时 ctl_ 就是根
+        control *lock_root() noexcept {
+            while (true) {
+                rebase();
+                ctl_->mutex.lock();
+                if (ctl_->parent.load(std::memory_order_acquire) == nullptr) {
+                    return ctl_;
+                }
+                ctl_->mutex.unlock();
+            }
+        }
+    };
+
+} // namespace mystl
+#endif // !MYTINYSTL_NODE_POOL_H_
@@ -0,0 +1,664 @@
+#ifndef MYTINYSTL_PERSISTENT_SET_H_
+#define MYTINYSTL_PERSISTENT_SET_H_
+
+// 这个头文件包含一个模板类 persistent_set
+// persistent_set : 持久化（不可变）的有序集合，以路径复制的红黑树实现，键值不允许重复
+
+// notes:
+//
+// 1. insert / erase 不修改原集合，而是返回一个新版本：只复制从根到修改点路径上的 O(logn) 个节点，
+//    其余节点由新旧版本共用；复制一个版本只是增加根节点的引用计数，为 O(1)
+// 2. 节点不可变，以原子的引用计数管理，最后一个引用它的版本析构时释放；
+//    不同线程可以同时读取、复制、析构共用节点的不同版本，同一个 persistent_set 对象的赋值仍需外部同步
+// 3. 节点没有 parent 指针，迭代器保存从根到当前节点的路径；迭代器只在其所属的版本存活时有效
+// 4. 插入与删除采用 Kahrs 的函数式红黑树算法，删除在下降时就把要经过的黑色节点变为可删除的形态，
+//    不需要回溯修改父节点
+//
+// 异常保证：
+// insert / erase 做强异常安全保证：失败时原版本不受影响，已复制的节点全部释放
+
+#include <atomic>
+#include <cstddef>
+#include <cassert>
+#include <initializer_list>
+
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // persistent_set 的节点，构造后不再修改
+    template<class T>
+    struct persistent_tree_node {
+        T value;
+        const persistent_tree_node *left;
+        const persistent_tree_node *right;
+        mutable std::atomic<size_t> refs;
+        bool red;
+    };
+
+    // 节点的引用计数句柄
+    template<class T>
+    class persistent_node_ref {
+    public:
+        typedef persistent_tree_node<T> node_type;
+        typedef const node_type *node_ptr;
+
+    private:
+        node_ptr node_;
+
+    public:
+        persistent_node_ref() noexcept: node_(nullptr) {}
+
+        // 增加 x 的引用计数并持有它
+        explicit persistent_node_ref(node_ptr x) noexcept: node_(x) {
+            if (node_ != nullptr) {
+                node_->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        persistent_node_ref(const persistent_node_ref &rhs) noexcept: persistent_node_ref(rhs.node_) {}
+
+        persistent_node_ref(persistent_node_ref &&rhs) noexcept: node_(rhs.node_) {
+            rhs.node_ = nullptr;
+        }
+
+        persistent_node_ref &operator=(persistent_node_ref rhs) noexcept {
+            mystl::swap(node_, rhs.node_);
+            return *this;
+        }
+
+        ~persistent_node_ref() { release(node_); }
+
+        node_ptr get() const noexcept { return node_; }
+
+        node_ptr operator->() const noexcept { return node_; }
+
+        explicit operator bool() const noexcept { return node_ != nullptr; }
+
+        // 交出所有权，不改变引用计数
+        node_ptr detach() noexcept {
+            auto x = node_;
+            node_ = nullptr;
+            return x;
+        }
+
+        // 接管一个已经计入引用计数的节点
+        static persistent_node_ref adopt(node_ptr x) noexcept {
+            persistent_node_ref r;
+            r.node_ = x;
+            return r;
+        }
+
+        // 减少 x 的引用计数，降为 0 时释放 x 并继续减少其子节点的引用计数
+        static void release(node_ptr x) noexcept {
+            while (x != nullptr && x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                auto right = x->right;
+                release(x->left);
+                auto p = const_cast<node_type *>(x);
+                mystl::destroy(mystl::address_of(p->value));
+                p->refs.~atomic();
+                mystl::allocator<node_type>::deallocate(p);
+                x = right;
+            }
+        }
+    };
+
+    // persistent_set 的迭代器，保存从根到当前节点的路径
+    template<class T>
+    struct persistent_set_iterator : public iterator<bidirectional_iterator_tag, T> {
+        typedef persistent_tree_node<T> node_type;
+        typedef const node_type *node_ptr;
+        typedef persistent_set_iterator<T> self;
+
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+        typedef ptrdiff_t difference_type;
+
+        // 红黑树的高度不超过 2log(n + 1)，96 层足以容纳 2^48 个元素
+        static constexpr size_t max_depth = 96;
+
+        node_ptr root;
+        node_ptr path[max_depth];
+        size_t depth;  // 为 0 时表示 end()
+
+        persistent_set_iterator() noexcept: root(nullptr), depth(0) {}
+
+        explicit persistent_set_iterator(node_ptr r) noexcept: root(r), depth(0) {}
+
+        reference operator*() const { return path[depth - 1]->value; }
+
+        pointer operator->() const { return &(operator*()); }
+
+        void push(node_ptr x) noexcept { path[depth++] = x; }
+
+        void push_leftmost(node_ptr x) noexcept {
+            for (; x != nullptr; x = x->left)
+                push(x);
+        }
+
+        void push_rightmost(node_ptr x) noexcept {
+            for (; x != nullptr; x = x->right)
+                push(x);
+        }
+
+        self &operator++() {
+            auto x = path[depth - 1];
+            if (x->right != nullptr) {
+                push_leftmost(x->right);
+            } else {
+                // 向上直到从某个节点的左子树返回
+                node_ptr child;
+                do {
+                    child = path[--depth];
+                } while (depth > 0 && path[depth - 1]->right == child);
+            }
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self &operator--() {
+            if (depth == 0) {
+                push_rightmost(root);
+                return *this;
+            }
+            auto x = path[depth - 1];
+            if (x->left != nullptr) {
+                push_rightmost(x->left);
+            } else {
+                node_ptr child;
+                do {
+                    child = path[--depth];
+                } while (depth > 0 && path[depth - 1]->left == child);
+            }
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        node_ptr node() const noexcept { return depth == 0 ? nullptr : path[depth - 1]; }
+
+        bool operator==(const self &rhs) const { return node() == rhs.node(); }
+
+        bool operator!=(const self &rhs) const { return node() != rhs.node(); }
+    };
+
+    template<class T>
+    constexpr size_t persistent_set_iterator<T>::max_depth;
+
+    // 模板类 persistent_set，键值不允许重复
+    // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less
+    template<class Key, class Compare = mystl::less<Key>>
+    class persistent_set {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+
+        typedef const Key *pointer;
+        typedef const Key *const_pointer;
+        typedef const Key &reference;
+        typedef const Key &const_reference;
+        typedef persistent_set_iterator<Key> iterator;
+        typedef persistent_set_iterator<Key> const_iterator;
+        typedef mystl::reverse_iterator<const_iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+    private:
+        typedef persistent_tree_node<Key> node_type;
+        typedef const node_type *node_ptr;
+        typedef persistent_node_ref<Key> node_ref;
+        typedef mystl::allocator<node_type> node_allocator;
+
+        node_ref root_;
+        size_type node_count_;
+        key_compare key_comp_;
+
+    public:
+        // 构造、复制、移动函数，复制只增加根节点的引用计数
+        persistent_set() : root_(), node_count_(0), key_comp_() {}
+
+        template<class InputIterator>
+        persistent_set(InputIterator first, InputIterator last) : persistent_set() {
+            for (; first != last; ++first)
+                insert_in_place(*first);
+        }
+
+        persistent_set(std::initializer_list<value_type> ilist) : persistent_set(ilist.begin(), ilist.end()) {}
+
+        persistent_set(const persistent_set &rhs) = default;
+
+        persistent_set(persistent_set &&rhs) noexcept
+                : root_(mystl::move(rhs.root_)), node_count_(rhs.node_count_), key_comp_(rhs.key_comp_) {
+            rhs.node_count_ = 0;
+        }
+
+        persistent_set &operator=(const persistent_set &rhs) = default;
+
+        persistent_set &operator=(persistent_set &&rhs) noexcept {
+            persistent_set tmp(mystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        key_compare key_comp() const { return key_comp_; }
+
+        value_compare value_comp() const { return key_comp_; }
+
+        // 迭代器相关
+        const_iterator begin() const noexcept {
+            const_iterator it(root_.get());
+            it.push_leftmost(root_.get());
+            return it;
+        }
+
+        const_iterator end() const noexcept { return const_iterator(root_.get()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return node_count_ == 0; }
+
+        size_type size() const noexcept { return node_count_; }
+
+        size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+        // 返回插入 value 后的新版本，value 已存在时返回与本版本相同的集合
+        persistent_set insert(const value_type &value) const {
+            persistent_set tmp(*this);
+            tmp.insert_in_place(value);
+            return tmp;
+        }
+
+        // 返回删除 key 后的新版本
+        persistent_set erase(const key_type &key) const {
+            persistent_set tmp(*this);
+            tmp.erase_in_place(key);
+            return tmp;
+        }
+
+        // 只在本对象上生效的修改，其他版本不受影响，返回是否有修改
+        bool insert_in_place(const value_type &value);
+
+        bool erase_in_place(const key_type &key);
+
+        void clear() noexcept {
+            root_ = node_ref();
+            node_count_ = 0;
+        }
+
+        // persistent_set 相关操作
+        const_iterator find(const key_type &key) const {
+            auto it = lower_bound(key);
+            return (it == end() || key_comp_(key, *it)) ? end() : it;
+        }
+
+        size_type count(const key_type &key) const { return contains(key) ? 1 : 0; }
+
+        bool contains(const key_type &key) const {
+            auto x = root_.get();
+            while (x != nullptr) {
+                if (key_comp_(key, x->value)) {
+                    x = x->left;
+                } else if (key_comp_(x->value, key)) {
+                    x = x->right;
+                } else {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        const_iterator lower_bound(const key_type &key) const;
+
+        const_iterator upper_bound(const key_type &key) const;
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const {
+            return mystl::make_pair(lower_bound(key), upper_bound(key));
+        }
+
+        // 两个版本是否共用同一棵树
+        bool shares_with(const persistent_set &rhs) const noexcept { return root_.get() == rhs.root_.get(); }
+
+        void swap(persistent_set &rhs) noexcept {
+            mystl::swap(root_, rhs.root_);
+            mystl::swap(node_count_, rhs.node_count_);
+            mystl::swap(key_comp_, rhs.key_comp_);
+        }
+
+    private:
+        // helper functions
+        static bool is_red(node_ptr x) noexcept { return x != nullptr && x->red; }
+
+        static bool is_black(node_ptr x) noexcept { return x != nullptr && !x->red; }
+
+        static node_ref left_of(node_ptr x) noexcept { return node_ref(x->left); }
+
+        static node_ref right_of(node_ptr x) noexcept { return node_ref(x->right); }
+
+        // 新建节点，接管 left 与 right 的引用
+        static node_ref make_node(bool red, node_ref left, const value_type &value, node_ref right);
+
+        static node_ref balance(node_ref a, const value_type &x, node_ref b);
+
+        static node_ref balance_left(node_ref l, const value_type &x, node_ref r);
+
+        static node_ref balance_right(node_ref l, const value_type &x, node_ref r);
+
+        static node_ref to_red(node_ref x);
+
+        static node_ref append(node_ref a, node_ref b);
+
+        node_ref insert_since(node_ptr x, const value_type &value) const;
+
+        node_ref erase_since(node_ptr x, const key_type &key) const;
+
+    public:
+        friend bool operator==(const persistent_set &lhs, const persistent_set &rhs) {
+            return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator<(const persistent_set &lhs, const persistent_set &rhs) {
+            return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+    };
+
+/*****************************************************************************************/
+
+// 在本对象上插入 value
+    template<class Key, class Compare>
+    bool persistent_set<Key, Compare>::
+    insert_in_place(const value_type &value) {
+        if (contains(value)) {
+            return false;
+        }
+        THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "persistent_set<Key, Comp>'s size too big");
+        auto root = insert_since(root_.get(), value);
+        if (root->red) {
+            // 根节点总是黑色
+            root = make_node(false, left_of(root.get()), root->value, right_of(root.get()));
+        }
+        root_ = mystl::move(root);
+        ++node_count_;
+        return true;
+    }
+
+// 在本对象上删除 key
+    template<class Key, class Compare>
+    bool persistent_set<Key, Compare>::
+    erase_in_place(const key_type &key) {
+        if (!contains(key)) {
+            return false;
+        }
+        auto root = erase_since(root_.get(), key);
+        if (root && root->red) {
+            root = make_node(false, left_of(root.get()), root->value, right_of(root.get()));
+        }
+        root_ = mystl::move(root);
+        --node_count_;
+        return true;
+    }
+
+// 键值不小于 key 的第一个位置
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::const_iterator
+    persistent_set<Key, Compare>::
+    lower_bound(const key_type &key) const {
+        const_iterator it(root_.get());
+        size_type keep = 0;  // 路径上最后一个不小于 key 的节点之后的长度
+        for (auto x = root_.get(); x != nullptr;) {
+            it.push(x);
+            if (!key_comp_(x->value, key)) {
+                keep = it.depth;
+                x = x->left;
+            } else {
+                x = x->right;
+            }
+        }
+        it.depth = keep;
+        return it;
+    }
+
+// 键值大于 key 的第一个位置
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::const_iterator
+    persistent_set<Key, Compare>::
+    upper_bound(const key_type &key) const {
+        const_iterator it(root_.get());
+        size_type keep = 0;
+        for (auto x = root_.get(); x != nullptr;) {
+            it.push(x);
+            if (key_comp_(key, x->value)) {
+                keep = it.depth;
+                x = x->left;
+            } else {
+                x = x->right;
+            }
+        }
+        it.depth = keep;
+        return it;
+    }
+
+/*****************************************************************************************/
+// helper function
+
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::node_ref
+    persistent_set<Key, Compare>::
+    make_node(bool red, node_ref left, const value_type &value, node_ref right) {
+        auto p = node_allocator::allocate(1);
+        try {
+            mystl::construct(mystl::address_of(p->value), value);
+        } catch (...) {
+            node_allocator::deallocate(p);
+            throw;
+        }
+        ::new(static_cast<void *>(&p->refs)) std::atomic<size_t>(1);
+        p->red = red;
+        p->left = left.detach();
+        p->right = right.detach();
+        return node_ref::adopt(p);
+    }
+
+// 消除连续的红色节点，参数为黑色节点的左子树、值、右子树
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::node_ref
+    persistent_set<Key, Compare>::
+    balance(node_ref a, const value_type &x, node_ref b) {
+        if (is_red(a.get()) && is_red(b.get())) {
+            return make_node(true, make_node(false, left_of(a.get()), a->value, right_of(a.get())), x,
+                             make_node(false, left_of(b.get()), b->value, right_of(b.get())));
+        }
+        if (is_red(a.get()) && is_red(a->left)) {
+            auto aa = a->left;
+            return make_node(true, make_node(false, left_of(aa), aa->value, right_of(aa)), a->value,
+                             make_node(false, right_of(a.get()), x, mystl::move(b)));
+        }
+        if (is_red(a.get()) && is_red(a->right)) {
+            auto ab = a->right;
+            return make_node(true, make_node(false, left_of(a.get()), a->value, left_of(ab)), ab->value,
+                             make_node(false, right_of(ab), x, mystl::move(b)));
+        }
+        if (is_red(b.get()) && is_red(b->right)) {
+            auto bb = b->right;
+            return make_node(true, make_node(false, mystl::move(a), x, left_of(b.get())), b->value,
+                             make_node(false, left_of(bb), bb->value, right_of(bb)));
+        }
+        if (is_red(b.get()) && is_red(b->left)) {
+            auto bl = b->left;
+            return make_node(true, make_node(false, mystl::move(a), x, left_of(bl)), bl->value,
+                             make_node(false, right_of(bl), b->value, right_of(b.get())));
+        }
+        return make_node(false, mystl::move(a), x, mystl::move(b));
+    }
+
+// 左子树的黑高少一时恢复平衡
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::node_ref
+    persistent_set<Key, Compare>::
+    balance_left(node_ref l, const value_type &x, node_ref r) {
+        if (is_red(l.get())) {
+            return make_node(true, make_node(false, left_of(l.get()), l->value, right_of(l.get())), x, mystl::move(r));
+        }
+        if (is_black(r.get())) {
+            return balance(mystl::move(l), x, make_node(true, left_of(r.get()), r->value, right_of(r.get())));
+        }
+        assert(is_red(r.get()) && is_black(r->left));
+        auto rl = r->left;
+        return make_node(true, make_node(false, mystl::move(l), x, left_of(rl)), rl->value,
+                         balance(right_of(rl), r->value, to_red(right_of(r.get()))));
+    }
+
+// 右子树的黑高少一时恢复平衡
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::node_ref
+    persistent_set<Key, Compare>::
+    balance_right(node_ref l, const value_type &x, node_ref r) {
+        if (is_red(r.get())) {
+            return make_node(true, mystl::move(l), x, make_node(false, left_of(r.get()), r->value, right_of(r.get())));
+        }
+        if (is_black(l.get())) {
+            return balance(make_node(true, left_of(l.get()), l->value, right_of(l.get())), x, mystl::move(r));
+        }
+        assert(is_red(l.get()) && is_black(l->right));
+        auto lr = l->right;
+        return make_node(true, balance(to_red(left_of(l.get())), l->value, left_of(lr)), lr->value,
+                         make_node(false, right_of(lr), x, mystl::move(r)));
+    }
+
+// 把黑色节点变为红色
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::node_ref
+    persistent_set<Key, Compare>::
+    to_red(node_ref x) {
+        assert(is_black(x.get()));
+        return make_node(true, left_of(x.get()), x->value, right_of(x.get()));
+    }
+
+// 连接黑高相同的两棵子树，a 中的键值都小于 b
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::node_ref
+    persistent_set<Key, Compare>::
+    append(node_ref a, node_ref b) {
+        if (!a) {
+            return b;
+        }
+        if (!b) {
+            return a;
+        }
+        if (a->red && b->red) {
+            auto bc = append(right_of(a.get()), left_of(b.get()));
+            if (is_red(bc.get())) {
+                return make_node(true, make_node(true, left_of(a.get()), a->value, left_of(bc.get())), bc->value,
+                                 make_node(true, right_of(bc.get()), b->value, right_of(b.get())));
+            }
+            return make_node(true, left_of(a.get()), a->value,
+                             make_node(true, mystl::move(bc), b->value, right_of(b.get())));
+        }
+        if (!a->red && !b->red) {
+            auto bc = append(right_of(a.get()), left_of(b.get()));
+            if (is_red(bc.get())) {
+                return make_node(true, make_node(false, left_of(a.get()), a->value, left_of(bc.get())), bc->value,
+                                 make_node(false, right_of(bc.get()), b->value, right_of(b.get())));
+            }
+            return balance_left(left_of(a.get()), a->value,
+                                make_node(false, mystl::move(bc), b->value, right_of(b.get())));
+        }
+        if (b->red) {
+            return make_node(true, append(mystl::move(a), left_of(b.get())), b->value, right_of(b.get()));
+        }
+        return make_node(true, left_of(a.get()), a->value, append(right_of(a.get()), mystl::move(b)));
+    }
+
+// 复制从 x 到插入点的路径，返回新子树的根
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::node_ref
+    persistent_set<Key, Compare>::
+    insert_since(node_ptr x, const value_type &value) const {
+        if (x == nullptr) {
+            return make_node(true, node_ref(), value, node_ref());
+        }
+        if (key_comp_(value, x->value)) {
+            return x->red ? make_node(true, insert_since(x->left, value), x->value, right_of(x))
+                          : balance(insert_since(x->left, value), x->value, right_of(x));
+        }
+        return x->red ? make_node(true, left_of(x), x->value, insert_since(x->right, value))
+                      : balance(left_of(x), x->value, insert_since(x->right, value));
+    }
+
+// 复制从 x 到删除点的路径，返回新子树的根；key 必须存在
+// 经过黑色子节点时子树的黑高会少一，由 balance_left / balance_right 补偿
+    template<class Key, class Compare>
+    typename persistent_set<Key, Compare>::node_ref
+    persistent_set<Key, Compare>::
+    erase_since(node_ptr x, const key_type &key) const {
+        if (key_comp_(key, x->value)) {
+            if (is_black(x->left)) {
+                return balance_left(erase_since(x->left, key), x->value, right_of(x));
+            }
+            return make_node(true, erase_since(x->left, key), x->value, right_of(x));
+        }
+        if (key_comp_(x->value, key)) {
+            if (is_black(x->right)) {
+                return balance_right(left_of(x), x->value, erase_since(x->right, key));
+            }
+            return make_node(true, left_of(x), x->value, erase_since(x->right, key));
+        }
+        return append(left_of(x), right_of(x));
+    }
+
+    // 重载比较操作符
+    template<class Key, class Compare>
+    bool operator!=(const persistent_set<Key, Compare> &lhs, const persistent_set<Key, Compare> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class Key, class Compare>
+    bool operator>(const persistent_set<Key, Compare> &lhs, const persistent_set<Key, Compare> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class Key, class Compare>
+    bool operator<=(const persistent_set<Key, Compare> &lhs, const persistent_set<Key, Compare> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class Key, class Compare>
+    bool operator>=(const persistent_set<Key, Compare> &lhs, const persistent_set<Key, Compare> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class Key, class Compare>
+    void swap(persistent_set<Key, Compare> &lhs, persistent_set<Key, Compare> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_PERSISTENT_SET_H_
@@ -15,17 +15,62 @@
  *
  *      红黑树，读取略逊于AVL，维护强于AVL，每次插入和删除的平均旋转次数应该是远小于平衡树
  *      如果插入的数据很乱AVL就不太行了，所以这里使用红黑树
+ *
+ *      定义 MYSTL_RB_TREE_ORDER_STATISTICS 后，每个节点额外记录子树的节点数，
+ *      nth(k) 与 rank(key) 变为 O(logn)，否则二者退化为线性时间
+ *
+ *      定义 MYSTL_RB_TREE_COMPACT_NODES 后，节点颜色存放在 parent 指针的最低位，
+ *      省去 color 成员及其对齐填充，每个节点少 8 字节（64 位平台）；颜色只能通过 rb_tree_color 等函数访问
+ *
+ *      定义 MYSTL_RB_TREE_PREFETCH 后，查找下降时预取两个子节点，迭代器前进时预取下一个节点，
+ *      适合远大于 cache 的树；find_many 总是交错进行多个查找并预取
+ *      bench/rb_tree_find_bench 在 16M 个节点（640 MiB）的树上：预取使 find 快约 1.2 倍，
+ *      find_many 比逐个 find 快约 5 倍；预取下一个节点对中序遍历几乎没有帮助
+ *
+ *      以上三个宏改变节点布局或内联函数的定义，rb_tree.h 及以之为底层的头文件中的类型都放在
+ *      以三个宏的取值命名的内联命名空间 MYSTL_RB_TREE_ABI 中（例如 rb_tree_abi_100），
+ *      以不同设置编译的翻译单元链接在一起时，各自使用不同名字的实例，不违反 ODR
+ *
+ *      对值类型特化 rb_tree_augment 后，节点额外保存由左右子树计算出的信息，
+ *      旋转、插入、删除、分裂与合并时随之更新，例如 interval_tree.h 中子树的最大端点
  * **/
 
 #include <initializer_list>
 #include <cassert>
+#include <cstdint>
 #include "functional.h"
 #include "iterator.h"
 #include "memory.h"
 #include "type_traits.h"
 #include "exceptdef.h"
+#include "node_pool.h"
+
+#ifdef MYSTL_RB_TREE_ORDER_STATISTICS
+#define MYSTL_RB_TREE_ABI_ORDER_STATISTICS_ 1
+#else
+#define MYSTL_RB_TREE_ABI_ORDER_STATISTICS_ 0
+#endif
+
+#ifdef MYSTL_RB_TREE_COMPACT_NODES
+#define MYSTL_RB_TREE_ABI_COMPACT_NODES_ 1
+#else
+#define MYSTL_RB_TREE_ABI_COMPACT_NODES_ 0
+#endif
+
+#ifdef MYSTL_RB_TREE_PREFETCH
+#define MYSTL_RB_TREE_ABI_PREFETCH_ 1
+#else
+#define MYSTL_RB_TREE_ABI_PREFETCH_ 0
+#endif
+
+#define MYSTL_RB_TREE_ABI_PASTE_(a, b, c) rb_tree_abi_##a##b##c
+#define MYSTL_RB_TREE_ABI_NAME_(a, b, c) MYSTL_RB_TREE_ABI_PASTE_(a, b, c)
+#define MYSTL_RB_TREE_ABI MYSTL_RB_TREE_ABI_NAME_(MYSTL_RB_TREE_ABI_ORDER_STATISTICS_, \
+                                                  MYSTL_RB_TREE_ABI_COMPACT_NODES_,    \
+                                                  MYSTL_RB_TREE_ABI_PREFETCH_)
 
 namespace mystl {
+inline namespace MYSTL_RB_TREE_ABI {
     // rb tree 节点颜色类型
     typedef bool rb_tree_color_type;
 
@@ -69,6 +114,12 @@ namespace mystl {
         typedef typename T::second_type mapped_type;
         typedef T value_type;
 
+        // 以 pair 的 first 为键值
+        template<class Ty>
+        static const key_type &get_key(const Ty &value) {
+            return value.first;
+        }
+
         template<class Ty>
         static const value_type &get_value(const Ty &value) {
             return value;
@@ -97,7 +148,7 @@ namespace mystl {
 
     // rb tree node traits
     template<class T>
-    struct rb_tree_value_traits {
+    struct rb_tree_node_traits {
         typedef rb_tree_color_type color_type;
 
         typedef rb_tree_value_traits<T> value_traits;
@@ -109,6 +160,63 @@ namespace mystl {
         typedef rb_tree_node<T> *node_ptr;
     };
 
+#ifdef MYSTL_RB_TREE_COMPACT_NODES
+    // 紧凑布局下的 parent 指针，最低位存放节点颜色
+    // 节点至少按指针对齐，地址的最低位恒为 0；用法与普通指针相同，赋值只改变指向，不改变颜色
+    template<class T>
+    class rb_tree_parent_ptr {
+    public:
+        typedef rb_tree_node_base<T> *base_ptr;
+
+    private:
+        uintptr_t bits_;
+
+    public:
+        rb_tree_parent_ptr() = default;
+
+        rb_tree_parent_ptr(const rb_tree_parent_ptr &) = default;
+
+        rb_tree_parent_ptr &operator=(const rb_tree_parent_ptr &rhs) noexcept {
+            return *this = rhs.get();
+        }
+
+        rb_tree_parent_ptr &operator=(base_ptr p) noexcept {
+            bits_ = (bits_ & 1) | reinterpret_cast<uintptr_t>(p);
+            return *this;
+        }
+
+        operator base_ptr() const noexcept { return get(); }
+
+        base_ptr operator->() const noexcept { return get(); }
+
+        base_ptr get() const noexcept {
+            return reinterpret_cast<base_ptr>(bits_ & ~static_cast<uintptr_t>(1));
+        }
+
+        rb_tree_color_type color() const noexcept { return (bits_ & 1) != 0; }
+
+        void set_color(rb_tree_color_type color) noexcept {
+            bits_ = (bits_ & ~static_cast<uintptr_t>(1)) | static_cast<uintptr_t>(color);
+        }
+
+        // 同时设置指向和颜色，用于未初始化的节点
+        void reset(base_ptr p, rb_tree_color_type color) noexcept {
+            bits_ = reinterpret_cast<uintptr_t>(p) | static_cast<uintptr_t>(color);
+        }
+    };
+#endif
+
+    // rb tree node augment
+    // 节点的增强信息，缺省为空，不占节点空间
+    // 特化需提供 enabled 常量、保存在节点中的数据成员，以及 static void update(node_ptr)：由左右子树重新计算节点的信息
+    template<class T>
+    struct rb_tree_augment {
+        static constexpr bool enabled = false;
+
+        template<class NodePtr>
+        static void update(NodePtr) noexcept {}
+    };
+
     // rb tree 的节点设计
     // 基类
     template<class T>
@@ -116,11 +224,21 @@ namespace mystl {
         typedef rb_tree_color_type color_type;
         typedef rb_tree_node_base<T> *base_ptr;
         typedef rb_tree_node<T> *node_ptr;
+#ifdef MYSTL_RB_TREE_COMPACT_NODES
+        typedef rb_tree_parent_ptr<T> parent_type;
+#else
+        typedef base_ptr parent_type;
+#endif
 
-        base_ptr parent;  // 父节点
+        parent_type parent;  // 父节点，紧凑布局下最低位为节点颜色
         base_ptr left;    // 左子节点
         base_ptr right;   // 右子节点
+#ifndef MYSTL_RB_TREE_COMPACT_NODES
         color_type color;   // 节点颜色
+#endif
+#ifdef MYSTL_RB_TREE_ORDER_STATISTICS
+        size_t size;      // 以该节点为根的子树的节点数
+#endif
 
         base_ptr get_base_ptr() {
             return &*this;
@@ -139,9 +257,10 @@ namespace mystl {
 
     // 派生类
     template<class T>
-    struct rb_tree_node : public rb_tree_node_base<T> {
+    struct rb_tree_node : public rb_tree_node_base<T>, public rb_tree_augment<T> {
         typedef rb_tree_node_base<T> *base_ptr;  // 基类指针
         typedef rb_tree_node<T> *node_ptr;  // 派生类指针
+        typedef rb_tree_augment<T> augment_type;  // 增强信息
 
         T value;  // 节点值
 
@@ -205,6 +324,10 @@ namespace mystl {
                     node = y;
                 }
             }
+#ifdef MYSTL_RB_TREE_PREFETCH
+            // 下一个节点在右子树中或是某个祖先，先取来右子节点或父节点
+            rb_tree_prefetch(node->right != nullptr ? node->right : static_cast<base_ptr>(node->parent));
+#endif
         }
 
         // 使迭代器后退
@@ -374,19 +497,122 @@ namespace mystl {
         return node == node->parent->left;
     }
 
+    // 节点颜色的读写都经过以下函数，紧凑布局下颜色在 parent 指针的最低位
+    template<class NodePtr>
+    rb_tree_color_type rb_tree_color(NodePtr node) noexcept {
+#ifdef MYSTL_RB_TREE_COMPACT_NODES
+        return node->parent.color();
+#else
+        return node->color;
+#endif
+    }
+
+    template<class NodePtr>
+    void rb_tree_set_color(NodePtr node, rb_tree_color_type color) noexcept {
+#ifdef MYSTL_RB_TREE_COMPACT_NODES
+        node->parent.set_color(color);
+#else
+        node->color = color;
+#endif
+    }
+
+    // 初始化新节点的 parent 和颜色，紧凑布局下不读取未初始化的 parent
+    template<class NodePtr, class ParentPtr>
+    void rb_tree_set_parent_color(NodePtr node, ParentPtr parent, rb_tree_color_type color) noexcept {
+#ifdef MYSTL_RB_TREE_COMPACT_NODES
+        node->parent.reset(parent, color);
+#else
+        node->parent = parent;
+        node->color = color;
+#endif
+    }
+
     template<class NodePtr>
     bool rb_tree_is_red(NodePtr node) noexcept {
-        return node->color == rb_tree_red;
+        return rb_tree_color(node) == rb_tree_red;
     }
 
     template<class NodePtr>
     void rb_tree_set_black(NodePtr node) noexcept {
-        node->color = rb_tree_black;
+        rb_tree_set_color(node, rb_tree_black);
     }
 
     template<class NodePtr>
     void rb_tree_set_red(NodePtr node) noexcept {
-        node->color = rb_tree_red;
+        rb_tree_set_color(node, rb_tree_red);
+    }
+
+    // 预取节点所在的 cache line，空指针也可以预取，不支持的编译器上为空操作
+    template<class NodePtr>
+    void rb_tree_prefetch(NodePtr node) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(static_cast<const void *>(node));
+#else
+        (void) node;
+#endif
+    }
+
+    // 查找下降时预取两个子节点，与当前节点的比较同时进行，下一层无论向哪边走都已在路上
+    template<class NodePtr>
+    void rb_tree_prefetch_children(NodePtr node) noexcept {
+#ifdef MYSTL_RB_TREE_PREFETCH
+        rb_tree_prefetch(node->left);
+        rb_tree_prefetch(node->right);
+#else
+        (void) node;
+#endif
+    }
+
+#ifdef MYSTL_RB_TREE_ORDER_STATISTICS
+    // 子树的节点数，空节点为 0
+    template<class NodePtr>
+    size_t rb_tree_size(NodePtr node) noexcept {
+        return node == nullptr ? 0 : node->size;
+    }
+
+    // 由左右子树重新计算节点的子树大小
+    template<class NodePtr>
+    void rb_tree_update_size(NodePtr node) noexcept {
+        node->size = rb_tree_size(node->left) + rb_tree_size(node->right) + 1;
+    }
+
+    // 从 node 开始向上直到 stop（不含）的每个节点子树大小加一或减一
+    template<class NodePtr>
+    void rb_tree_adjust_size(NodePtr node, NodePtr stop, bool increase) noexcept {
+        for (; node != stop; node = node->parent) {
+            increase ? ++node->size : --node->size;
+        }
+    }
+#else
+    template<class NodePtr>
+    void rb_tree_update_size(NodePtr) noexcept {}
+
+    template<class NodePtr>
+    void rb_tree_adjust_size(NodePtr, NodePtr, bool) noexcept {}
+#endif
+
+    // 由左右子树重新计算节点的增强信息
+    template<class T>
+    void rb_tree_update_augment(rb_tree_node<T> *node) noexcept {
+        rb_tree_augment<T>::update(node);
+    }
+
+    // 由左右子树重新计算节点的子树大小与增强信息
+    template<class NodePtr>
+    void rb_tree_update_node(NodePtr node) noexcept {
+        rb_tree_update_size(node);
+        rb_tree_update_augment(node->get_node_ptr());
+    }
+
+    // 从 node 开始向上直到 stop（不含）重新计算每个节点的增强信息，没有增强信息时什么也不做
+    template<class NodePtr>
+    void rb_tree_update_augment_path(NodePtr node, NodePtr stop) noexcept {
+        typedef typename std::remove_pointer<decltype(node->get_node_ptr())>::type node_type;
+        if (node_type::augment_type::enabled) {
+            for (; node != stop; node = node->parent) {
+                rb_tree_update_augment(node->get_node_ptr());
+            }
+        }
     }
 
     // 找到下一个节点
@@ -415,8 +641,8 @@ namespace mystl {
 |     b   c                 a   b         |
 \*---------------------------------------*/
 // 左旋，参数一为左旋点，参数二为根节点
-    template<class NodePtr>
-    void rb_tree_rotate_left(NodePtr x, NodePtr &root) noexcept {
+    template<class NodePtr, class RootPtr>
+    void rb_tree_rotate_left(NodePtr x, RootPtr &root) noexcept {
         // 先保存 x 的右子节点
         auto y = x->right; // y 为 x的右子节点
         // 将 x 的右子节点的左子树接到x的右节点上
@@ -446,6 +672,9 @@ namespace mystl {
         // 将 x 拼接到 y 左子节点
         y->left = x;
         x->parent = y;
+        // y 接管了 x 原来的整棵子树，x 的子树发生了变化
+        rb_tree_update_node(x);
+        rb_tree_update_node(y);
     }
 
 /*----------------------------------------*\
@@ -458,8 +687,8 @@ namespace mystl {
 |   b   c                         c   a    |
 \*----------------------------------------*/
 // 右旋，参数一为右旋点，参数二为根节点
-    template<class NodePtr>
-    void rb_tree_rotate_right(NodePtr x, NodePtr &root) noexcept {
+    template<class NodePtr, class RootPtr>
+    void rb_tree_rotate_right(NodePtr x, RootPtr &root) noexcept {
         auto y = x->left;
         x->left = y->right;
         if (y->right) {
@@ -475,6 +704,8 @@ namespace mystl {
         }
         y->right = x;
         x->parent = y;
+        rb_tree_update_node(x);
+        rb_tree_update_node(y);
     }
 
 // 插入节点后使 rb tree 重新平衡
@@ -490,10 +721,9 @@ namespace mystl {
 //
 // 参考博客: http://blog.csdn.net/v_JULY_v/article/details/6105630
 //          http://blog.csdn.net/v_JULY_v/article/details/6109153
-// 参数一为新增节点，参数二为根节点
-    template<class NodePtr>
-    void rb_tree_insert_rebalance(NodePtr x, NodePtr &root) noexcept {
-        rb_tree_set_red(x);  // 新增节点都为红色
+// 参数一为红色的当前节点，参数二为根节点；只调整颜色和结构，不把根节点置黑
+    template<class NodePtr, class RootPtr>
+    void rb_tree_insert_fixup(NodePtr x, RootPtr &root) noexcept {
         // 若 新增节点不等于根节点 且 当前节点的父节点为红色（要进行平衡的前提是已经插入）
         while (x != root && rb_tree_is_red(x->parent)) {
             if (rb_tree_is_lchild(x->parent)) {
@@ -556,6 +786,17 @@ namespace mystl {
                 }
             }
         }
+    }
+
+// 参数一为新增节点，参数二为根节点
+    template<class NodePtr, class RootPtr>
+    void rb_tree_insert_rebalance(NodePtr x, RootPtr &root) noexcept {
+        rb_tree_set_red(x);  // 新增节点都为红色
+        // 新增节点是叶子，它的所有祖先的子树大小加一，增强信息在旋转之前沿路径更新
+        rb_tree_update_node(x);
+        rb_tree_adjust_size(x->parent, root->parent, true);
+        rb_tree_update_augment_path(x->parent, root->parent);
+        rb_tree_insert_fixup(x, root);
         rb_tree_set_black(root);  // 根节点永远为黑色
     }
 
@@ -563,8 +804,8 @@ namespace mystl {
 //
 // 参考博客: http://blog.csdn.net/v_JULY_v/article/details/6105630
 //          http://blog.csdn.net/v_JULY_v/article/details/6109153
-    template<class NodePtr>
-    NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr &root, NodePtr &leftmost, NodePtr &rightmost) {
+    template<class NodePtr, class RootPtr>
+    NodePtr rb_tree_erase_rebalance(NodePtr z, RootPtr &root, NodePtr &leftmost, NodePtr &rightmost) {
         // y 是可能的替代节点，指向最终要删除的节点
         // 若要删除的节点z的左节点或右节点为空，则返回待删除节点，否则返回待删除节点的下一个节点
         auto y = (z->left == nullptr || z->right == nullptr) ? z : rb_tree_next(z);
@@ -574,6 +815,10 @@ namespace mystl {
         // xp 为 x 的父节点
         NodePtr xp = nullptr;
 
+        // y 是真正从原位置摘下的节点，它的所有祖先的子树大小减一
+        NodePtr stop = root->parent;
+        rb_tree_adjust_size<NodePtr>(y->parent, stop, false);
+
         // y != z 说明 z 有两个非空子节点，此时 y 指向 z 右子树的最左节点，x 指向 y 的右子节点（因为最左，所以肯定没有左子节点，返回右子节点）
         // 用 y 顶替 z 的位置，用 x 顶替 y 的位置，最后用 y 指向 z
         if (y != z) {
@@ -604,7 +849,12 @@ namespace mystl {
                 z->parent->right = y;
             }
             y->parent = z->parent;
-            mystl::swap(y->color, z->color);
+            auto color = rb_tree_color(y);
+            rb_tree_set_color(y, rb_tree_color(z));
+            rb_tree_set_color(z, color);
+#ifdef MYSTL_RB_TREE_ORDER_STATISTICS
+            y->size = z->size;
+#endif
             y = z;
         } else {
             // y == z 说明 z 至多只有一个孩子
@@ -631,6 +881,9 @@ namespace mystl {
             }
         }
 
+        // 结构调整完成后，从 xp 向上更新增强信息，y 顶替 z 时 y 也在这条路径上；之后的旋转各自维护增强信息
+        rb_tree_update_augment_path(xp, stop);
+
         // 此时，y 指向要删除的节点，x 为替代节点，从 x 节点开始调整。
         // 如果删除的节点为红色，树的性质没有被破坏，否则按照以下情况调整（x 为左子节点为例）：
         // case 1: 兄弟节点为红色，令父节点为红，兄弟节点为黑，进行左（右）旋，继续处理
@@ -639,7 +892,7 @@ namespace mystl {
         //         令兄弟节点为红，兄弟节点的左子节点为黑，以兄弟节点为支点右（左）旋，继续处理
         // case 4: 兄弟节点为黑色，右子节点为红色，令兄弟节点为父节点的颜色，父节点为黑色，兄弟节点的右子节点
         //         为黑色，以父节点为支点左（右）旋，树的性质调整完成，算法结束
-        if (!rb_tree_red(y)) {
+        if (!rb_tree_is_red(y)) {
             // x 为黑色时，调整，否则直接将 x 变为黑色即可
             while (x != root && (x == nullptr || !rb_tree_is_red(x))) {
                 if (x == xp->left) {
@@ -670,7 +923,7 @@ namespace mystl {
                             brother = xp->right;
                         }
                         // 转为 case 4
-                        brother->color = xp->color;
+                        rb_tree_set_color(brother, rb_tree_color(xp));
                         rb_tree_set_black(xp);
                         if (brother->right != nullptr) {
                             rb_tree_set_black(brother->right);
@@ -701,7 +954,7 @@ namespace mystl {
                             brother = xp->left;
                         }
                         // 转为 case 4
-                        brother->color = xp->color;
+                        rb_tree_set_color(brother, rb_tree_color(xp));
                         rb_tree_set_black(xp);
                         if (brother->left != nullptr)
                             rb_tree_set_black(brother->left);
@@ -717,9 +970,218 @@ namespace mystl {
         return y;
     }
 
+// 以下函数用于分裂与合并，操作的对象是脱离了 header_ 的独立子树：根节点的 parent 为空且为黑色，
+// 黑高为从根节点到空节点的路径上黑色节点的个数（含根节点），空树的黑高为 0
+
+// 子树的黑高
+    template<class NodePtr>
+    size_t rb_tree_black_height(NodePtr node) noexcept {
+        size_t h = 0;
+        for (; node != nullptr; node = node->left) {
+            if (!rb_tree_is_red(node)) {
+                ++h;
+            }
+        }
+        return h;
+    }
+
+// 把 x 从原树中摘下作为独立子树，参数二传入 x 在原树中的黑高，红色的根改为黑色后黑高加一
+    template<class NodePtr>
+    NodePtr rb_tree_detach(NodePtr x, size_t &h) noexcept {
+        if (x != nullptr) {
+            x->parent = nullptr;
+            if (rb_tree_is_red(x)) {
+                rb_tree_set_black(x);
+                ++h;
+            }
+        }
+        return x;
+    }
+
+// 以 k 为中间节点合并两棵子树，l 中的节点都在 k 之前，r 中的节点都在 k 之后，结果存回 l 和 lh
+// 沿较高的一棵树的右（左）脊下降到黑高与另一棵树相同的黑色节点，在此处以红色挂上 k，
+// 再按插入的方式向上调整，复杂度为 O(|lh - rh| + 1)
+    template<class NodePtr>
+    void rb_tree_join(NodePtr &l, size_t &lh, NodePtr k, NodePtr r, size_t rh) noexcept {
+        k->parent = nullptr;
+        if (lh == rh) {
+            // 黑高相同，k 直接作为新的根节点
+            k->left = l;
+            k->right = r;
+            if (l != nullptr) {
+                l->parent = k;
+            }
+            if (r != nullptr) {
+                r->parent = k;
+            }
+            rb_tree_set_black(k);
+            rb_tree_update_node(k);
+            l = k;
+            ++lh;
+            return;
+        }
+        const bool right_spine = lh > rh;
+        auto root = right_spine ? l : r;
+        auto h = right_spine ? lh : rh;
+        const auto target = right_spine ? rh : lh;
+        NodePtr p = nullptr;
+        auto c = root;
+        while (c != nullptr && (h > target || rb_tree_is_red(c))) {
+            if (!rb_tree_is_red(c)) {
+                --h;
+            }
+            p = c;
+            c = right_spine ? c->right : c->left;
+        }
+        // c 为黑高等于 target 的黑色节点或空节点，用 k 顶替它，它成为 k 的一个孩子
+        if (right_spine) {
+            k->left = c;
+            k->right = r;
+            p->right = k;
+        } else {
+            k->left = l;
+            k->right = c;
+            p->left = k;
+        }
+        k->parent = p;
+        if (k->left != nullptr) {
+            k->left->parent = k;
+        }
+        if (k->right != nullptr) {
+            k->right->parent = k;
+        }
+        rb_tree_set_red(k);
+        rb_tree_update_node(k);
+#ifdef MYSTL_RB_TREE_ORDER_STATISTICS
+        const size_t added = rb_tree_size(right_spine ? r : l) + 1;
+        for (auto q = p; q != nullptr; q = q->parent) {
+            q->size += added;
+        }
+#endif
+        rb_tree_update_augment_path(p, NodePtr());
+        rb_tree_insert_fixup(k, root);
+        h = right_spine ? lh : rh;
+        if (rb_tree_is_red(root)) {
+            rb_tree_set_black(root);
+            ++h;
+        }
+        l = root;
+        lh = h;
+    }
+
+// 合并两棵子树，l 中的节点都在 r 之前，结果存回 l 和 lh
+// 摘下 l 的最大节点作为中间节点，再调用 rb_tree_join，复杂度为 O(logn)
+    template<class NodePtr>
+    void rb_tree_join2(NodePtr &l, size_t &lh, NodePtr r, size_t rh) noexcept {
+        if (r == nullptr) {
+            return;
+        }
+        if (l == nullptr) {
+            l = r;
+            lh = rh;
+            return;
+        }
+        auto k = rb_tree_max(l);
+        // 最大节点没有右孩子，不会更新最小、最大节点
+        NodePtr leftmost = nullptr;
+        NodePtr rightmost = nullptr;
+        rb_tree_erase_rebalance(k, l, leftmost, rightmost);
+        lh = rb_tree_black_height(l);
+        k->left = nullptr;
+        k->right = nullptr;
+        rb_tree_join(l, lh, k, r, rh);
+    }
+
+    template<class T, class Compare, class Alloc = mystl::allocator<T>>
+    class rb_tree;
+
+// 模板类 rb_tree_node_handle
+// 持有一个从 rb_tree 中摘下的节点，以及该节点所属的节点池，只能移动不能复制
+// 重新插入 rb_tree 时直接链接节点，不分配空间也不复制元素；析构时若仍持有节点则销毁它
+    template<class T, class Alloc = mystl::allocator<T>>
+    class rb_tree_node_handle {
+    public:
+        typedef T value_type;
+        typedef typename rb_tree_traits<T>::node_type node_type;
+        typedef typename rb_tree_traits<T>::node_ptr node_ptr;
+        typedef mystl::shared_node_pool<node_type, Alloc> node_pool_type;
+        typedef mystl::allocator<T> data_allocator;
+
+        template<class U, class Compare, class A>
+        friend class rb_tree;
+
+    private:
+        node_ptr node_;
+        node_pool_type pool_;  // 节点所属的节点池，保证节点在句柄存在期间有效
+
+        rb_tree_node_handle(node_ptr node, const node_pool_type &pool) noexcept
+                : node_(node), pool_(pool) {}
+
+    public:
+        rb_tree_node_handle() noexcept: node_(nullptr) {}
+
+        rb_tree_node_handle(const rb_tree_node_handle &) = delete;
+
+        rb_tree_node_handle &operator=(const rb_tree_node_handle &) = delete;
+
+        rb_tree_node_handle(rb_tree_node_handle &&rhs) noexcept
+                : node_(rhs.node_), pool_(mystl::move(rhs.pool_)) {
+            rhs.node_ = nullptr;
+        }
+
+        rb_tree_node_handle &operator=(rb_tree_node_handle &&rhs) noexcept {
+            if (this != &rhs) {
+                destroy();
+                node_ = rhs.node_;
+                pool_ = mystl::move(rhs.pool_);
+                rhs.node_ = nullptr;
+            }
+            return *this;
+        }
+
+        ~rb_tree_node_handle() { destroy(); }
+
+    public:
+        bool empty() const noexcept { return node_ == nullptr; }
+
+        explicit operator bool() const noexcept { return node_ != nullptr; }
+
+        // 句柄不能为空
+        value_type &value() const noexcept { return node_->value; }
+
+        void swap(rb_tree_node_handle &rhs) noexcept {
+            mystl::swap(node_, rhs.node_);
+            pool_.swap(rhs.pool_);
+        }
+
+    private:
+        // 销毁持有的节点
+        void destroy() noexcept {
+            if (node_ != nullptr) {
+                data_allocator::destroy(mystl::address_of(node_->value));
+                pool_.deallocate(node_);
+                node_ = nullptr;
+            }
+            pool_.reset();
+        }
+
+        // 交出持有的节点，句柄变为空
+        node_ptr release() noexcept {
+            auto node = node_;
+            node_ = nullptr;
+            pool_.reset();
+            return node;
+        }
+    };
+
+    template<class T, class Alloc>
+    void swap(rb_tree_node_handle<T, Alloc> &lhs, rb_tree_node_handle<T, Alloc> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
 // 模板类 rb_tree
-// 参数一代表数据类型，参数二代表键值比较类型
-    template<class T, class Compare>
+// 参数一代表数据类型，参数二代表键值比较类型，参数三代表节点池分配块所用的空间配置器
+    template<class T, class Compare, class Alloc>
     class rb_tree {
     public:
         // rb_tree 的嵌套型别定义
@@ -735,10 +1197,12 @@ namespace mystl {
         typedef typename tree_traits::value_type value_type;
         typedef Compare key_compare;
 
-        typedef mystl::allocator<T> allocator_type;
+        typedef Alloc allocator_type;
         typedef mystl::allocator<T> data_allocator;
         typedef mystl::allocator<base_type> base_allocator;
-        typedef mystl::allocator<node_type> node_allocator;
+        typedef typename Alloc::template rebind<node_type>::other node_allocator;
+        typedef mystl::shared_node_pool<node_type, Alloc> node_pool_type;
+        typedef rb_tree_node_handle<T, Alloc> node_handle;
 
         typedef typename allocator_type::pointer pointer;
         typedef typename allocator_type::const_pointer const_pointer;
@@ -752,7 +1216,7 @@ namespace mystl {
         typedef mystl::reverse_iterator<iterator> reverse_iterator;
         typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-        allocator_type get_allocator() const { return node_allocator(); }
+        allocator_type get_allocator() const { return allocator_type(); }
 
         key_compare key_comp() const { return key_comp_; }
 
@@ -761,11 +1225,12 @@ namespace mystl {
         base_ptr header_;  // 特殊节点，与根节点互为对方的父节点
         size_type node_count_;  // 节点数
         key_compare key_comp_;  // 节点键值比较的准则
+        node_pool_type pool_;   // 节点池，交换过节点的树共用同一个节点池
 
     private:
         // 以下三个函数用于取得根节点，最小节点和最大节点（为什么能取到最大最小节点？）
         // 这里的header_的左孩子是最小节点，右孩子是最大节点，父节点指向root
-        base_ptr &root() const { return header_->parent; }
+        typename base_type::parent_type &root() const { return header_->parent; }
 
         base_ptr &leftmost() const { return header_->left; }
 
@@ -783,7 +1248,7 @@ namespace mystl {
 
         rb_tree &operator=(rb_tree &&rhs);
 
-        ~rb_tree() { clear(); }
+        ~rb_tree();
 
     public:
         // 迭代器相关操作
@@ -852,6 +1317,10 @@ namespace mystl {
 
         template<class InputIterator>
         void insert_multi(InputIterator first, InputIterator last) {
+            // 空树且输入有序时直接以 O(n) 建树
+            if (node_count_ == 0 && build_from_sorted(first, last, false, iterator_category(first))) {
+                return;
+            }
             size_type n = mystl::distance(first, last);
             THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n, "rb_tree<T, Comp>'s size too big");
             for (; n > 0; --n, ++first)
@@ -874,12 +1343,24 @@ namespace mystl {
 
         template<class InputIterator>
         void insert_unique(InputIterator first, InputIterator last) {
+            // 空树且输入有序时直接以 O(n) 建树
+            if (node_count_ == 0 && build_from_sorted(first, last, true, iterator_category(first))) {
+                return;
+            }
             size_type n = mystl::distance(first, last);
             THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n, "rb_tree<T, Comp>'s size too big");
             for (; n > 0; --n, ++first)
                 insert_unique(end(), *first);
         }
 
+        // 插入一批有序的元素：每个元素从上一个插入点出发做 finger search，
+        // 向 n 个元素的树中插入 k 个有序元素的代价为 O(klog(n/k))；某个元素不有序时它退回从根节点查找
+        template<class InputIterator>
+        void insert_sorted_batch_multi(InputIterator first, InputIterator last);
+
+        template<class InputIterator>
+        void insert_sorted_batch_unique(InputIterator first, InputIterator last);
+
         // erase
         iterator erase(iterator hint);
 
@@ -891,10 +1372,41 @@ namespace mystl {
 
         void clear();
 
+        // 节点的摘下与重新插入
+        // extract 把节点从树中摘下交给 node_handle，不销毁元素；按键值摘下时取第一个等于 key 的元素，没有时返回空句柄
+        node_handle extract(iterator position);
+
+        node_handle extract(const key_type &key) {
+            auto it = find(key);
+            return it == end() ? node_handle() : extract(it);
+        }
+
+        // 插入 node_handle 持有的节点，直接链接节点；键值已存在时插入失败，节点仍留在 nh 中
+        mystl::pair<iterator, bool> insert_node_unique(node_handle &&nh);
+
+        iterator insert_node_multi(node_handle &&nh);
+
+        // merge 把 rhs 的节点转移到本树；merge_unique 跳过本树中已有的键值，这些节点留在 rhs 中，
+        // rhs_unique 表示 rhs 中的键值不重复，此时键值区间不相交的两棵树可以整棵拼接
+        void merge_unique(rb_tree &rhs, bool rhs_unique);
+
+        void merge_multi(rb_tree &rhs) { join_multi(rhs); }
+
         // rb_tree 相关操作
-        iterator find(const key_type &key);
+        iterator find(const key_type &key) { return iterator(find_node(key)); }
+
+        const_iterator find(const key_type &key) const { return const_iterator(find_node(key)); }
 
-        const_iterator find(const key_type &key) const;
+        // 批量查找 [first, last) 中的每个键值，结果依次写入 result，找不到时为 end()
+        template<class ForwardIter, class OutputIter>
+        OutputIter find_many(ForwardIter first, ForwardIter last, OutputIter result) {
+            return find_many_nodes<iterator>(first, last, result);
+        }
+
+        template<class ForwardIter, class OutputIter>
+        OutputIter find_many(ForwardIter first, ForwardIter last, OutputIter result) const {
+            return find_many_nodes<const_iterator>(first, last, result);
+        }
 
         size_type count_multi(const key_type &key) const {
             auto p = equal_range_multi(key);
@@ -905,13 +1417,13 @@ namespace mystl {
             return find(key) != end() ? 1 : 0;
         }
 
-        iterator lower_bound(const key_type &key);
+        iterator lower_bound(const key_type &key) { return iterator(lower_bound_node(key)); }
 
-        const_iterator lower_bound(const key_type &key) const;
+        const_iterator lower_bound(const key_type &key) const { return const_iterator(lower_bound_node(key)); }
 
-        iterator upper_bound(const key_type &key);
+        iterator upper_bound(const key_type &key) { return iterator(upper_bound_node(key)); }
 
-        const_iterator upper_bound(const key_type &key) const;
+        const_iterator upper_bound(const key_type &key) const { return const_iterator(upper_bound_node(key)); }
 
         mystl::pair<iterator, iterator>
         equal_range_multi(const key_type &key) {
@@ -937,8 +1449,128 @@ namespace mystl {
             return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
         }
 
+        // 异构查找：比较函数定义了 is_transparent 时，可以直接用能与键值比较的类型 K 查找，
+        // 不必先构造一个临时的 key_type
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator find(const K &key) { return iterator(find_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator find(const K &key) const { return const_iterator(find_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type count_multi(const K &key) const {
+            return static_cast<size_type>(mystl::distance(lower_bound(key), upper_bound(key)));
+        }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type count_unique(const K &key) const {
+            return find(key) != end() ? 1 : 0;
+        }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator lower_bound(const K &key) { return iterator(lower_bound_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator lower_bound(const K &key) const { return const_iterator(lower_bound_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator upper_bound(const K &key) { return iterator(upper_bound_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator upper_bound(const K &key) const { return const_iterator(upper_bound_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        mystl::pair<iterator, iterator>
+        equal_range_multi(const K &key) {
+            return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        mystl::pair<const_iterator, const_iterator>
+        equal_range_multi(const K &key) const {
+            return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        mystl::pair<iterator, iterator>
+        equal_range_unique(const K &key) {
+            iterator it = find(key);
+            auto next = it;
+            return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+        }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        mystl::pair<const_iterator, const_iterator>
+        equal_range_unique(const K &key) const {
+            const_iterator it = find(key);
+            auto next = it;
+            return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+        }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type erase_multi(const K &key) {
+            auto p = equal_range_multi(key);
+            size_type n = mystl::distance(p.first, p.second);
+            erase(p.first, p.second);
+            return n;
+        }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type erase_unique(const K &key) {
+            auto it = find(key);
+            if (it != end()) {
+                erase(it);
+                return 1;
+            }
+            return 0;
+        }
+
+        // 顺序统计：第 k 小（从 0 开始）的元素，k 越界时返回 end()
+        iterator nth(size_type k) noexcept { return iterator(nth_node(k)); }
+
+        const_iterator nth(size_type k) const noexcept { return const_iterator(nth_node(k)); }
+
+        // 顺序统计：键值小于 key 的元素个数，即 lower_bound(key) 的下标
+        size_type rank(const key_type &key) const;
+
+        // 根节点，空树时为空指针；用于在增强信息上剪枝的查询（见 rb_tree_augment）
+        base_ptr root_node() const noexcept { return root(); }
+
+        // 分裂与合并
+        // split 把键值小于 key 的元素分给 first，其余元素分给 second，两棵树共用原来的节点，本树变为空
+        mystl::pair<rb_tree, rb_tree> split(const key_type &key);
+
+        // join 把 rhs 的元素并入本树，rhs 变为空，两棵树的键值区间不相交时为 O(logn)
+        // join_unique 在区间相交时退化为求并集，join_multi 在区间相交时逐个转移节点
+        void join_unique(rb_tree &rhs);
+
+        void join_multi(rb_tree &rhs);
+
+        // 集合运算，只用于键值不重复的树，结果留在本树，rhs 变为空
+        // 以分裂与合并递归实现，复杂度为 O(mlog(n/m + 1))，m 为较小的一棵树的大小
+        void union_unique(rb_tree &rhs);
+
+        void intersection_unique(rb_tree &rhs);
+
+        void difference_unique(rb_tree &rhs);
+
         void swap(rb_tree &rhs) noexcept;
 
+    private:
         // node related
         template<class ...Args>
         node_ptr create_node(Args &&... args);
@@ -947,17 +1579,37 @@ namespace mystl {
 
         void destroy_node(node_ptr p);
 
+        // 只析构 x 及其子树上的值，不归还节点空间
+        void destroy_values_since(base_ptr x);
+
+        // 让 rhs 的节点可以转移到本树，两者共用同一个节点池
+        void share_pool_with(rb_tree &rhs);
+
+        // 取下整棵树交给调用者（本树变为空）/ 把一棵树挂到本树上
+        base_ptr detach_tree(size_type &h);
+
+        void attach_tree(base_ptr x, size_type n);
+
         // init / reset
         void rb_tree_init();
 
         void reset();
 
-        // get insert pos
+        // get insert pos，start 为开始向下查找的节点，其子树的键值区间必须包含插入位置
+        mystl::pair<base_ptr, bool>
+        get_insert_multi_pos(const key_type &key) { return get_insert_multi_pos(key, root()); }
+
         mystl::pair<base_ptr, bool>
-        get_insert_multi_pos(const key_type &key);
+        get_insert_multi_pos(const key_type &key, base_ptr start);
 
         mystl::pair<mystl::pair<base_ptr, bool>, bool>
-        get_insert_unique_pos(const key_type &key);
+        get_insert_unique_pos(const key_type &key) { return get_insert_unique_pos(key, root()); }
+
+        mystl::pair<mystl::pair<base_ptr, bool>, bool>
+        get_insert_unique_pos(const key_type &key, base_ptr start);
+
+        // finger search 的起点
+        base_ptr finger_start(base_ptr finger, const key_type &key) const;
 
         // insert value / insert node
         iterator insert_value_at(base_ptr x, const value_type &value, bool add_to_left);
@@ -969,22 +1621,72 @@ namespace mystl {
 
         iterator insert_unique_use_hint(iterator hint, key_type key, node_ptr node);
 
+        // find / lower_bound / upper_bound 的公共实现，K 为 key_type 或异构查找的类型
+        template<class K>
+        base_ptr find_node(const K &key) const;
+
+        template<class K>
+        base_ptr lower_bound_node(const K &key) const;
+
+        template<class K>
+        base_ptr upper_bound_node(const K &key) const;
+
+        template<class Iter, class ForwardIter, class OutputIter>
+        OutputIter find_many_nodes(ForwardIter first, ForwardIter last, OutputIter result) const;
+
+        base_ptr nth_node(size_type k) const noexcept;
+
         // copy tree / erase tree
-        base_ptr copy_from(base_ptr x, base_ptr p);
+        base_ptr copy_from(base_ptr x, base_ptr p, size_type n);
+
+        size_type erase_since(base_ptr x);
+
+        // split / join
+        node_ptr unlink_node(base_ptr x);
+
+        node_ptr adopt_node(node_handle &nh);
+
+        void concat(rb_tree &rhs, bool rhs_first);
+
+        void split_since(base_ptr x, size_type h, const key_type &key,
+                         base_ptr &l, size_type &lh, base_ptr &r, size_type &rh);
+
+        base_ptr split_unique_since(base_ptr x, size_type h, const key_type &key,
+                                    base_ptr &l, size_type &lh, base_ptr &r, size_type &rh);
+
+        void union_since(base_ptr &a, size_type &ah, base_ptr b, size_type bh, size_type &removed);
+
+        void intersection_since(base_ptr &a, size_type &ah, base_ptr b, size_type bh, size_type &removed);
+
+        void difference_since(base_ptr &a, size_type &ah, base_ptr b, size_type bh, size_type &removed);
+
+        // build from sorted range
+        // 输入迭代器只能遍历一次，无法预先检查是否有序
+        template<class InputIterator>
+        bool build_from_sorted(InputIterator, InputIterator, bool, input_iterator_tag) { return false; }
 
-        void erase_since(base_ptr x);
+        template<class ForwardIterator>
+        bool build_from_sorted(ForwardIterator first, ForwardIterator last, bool unique, forward_iterator_tag);
+
+        base_ptr link_balanced(base_ptr &list, size_type n, size_type depth, size_type red_depth);
     };
 
 /**********************************************************************************************/
 
 // 复制构造函数
-    template<class T, class Compare>
-    rb_tree<T, Compare>
-    rb_Tree(const rb_tree &rhs) {
+    template<class T, class Compare, class Alloc>
+    rb_tree<T, Compare, Alloc>::
+    rb_tree(const rb_tree &rhs) {
         rb_tree_init();
         if (rhs.node_count_ != 0) {
-            // copy_from：递归复制一颗树，节点从 rhs.root() 开始，header_ 为 x 的父节点
-            root() = copy_from(rhs.root(), header_);  // 返回的是root节点，其中header_和root互相为对方的父节点
+            // copy_from：复制一颗树，节点从 rhs.root() 开始，header_ 为 x 的父节点
+            try {
+                root() = copy_from(rhs.root(), header_, rhs.node_count_);  // 返回的是root节点，其中header_和root互相为对方的父节点
+            } catch (...) {
+                // 析构函数不会执行，需要自行释放 header_
+                base_allocator::deallocate(header_);
+                throw;
+            }
             leftmost() = rb_tree_min(root());  // 找到最小的节点
             rightmost() = rb_tree_max(root());  // 找到最大的节点
         }
@@ -994,24 +1696,25 @@ namespace mystl {
     }
 
 // 移动构造函数
-    template<class T, class Compare>
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    rb_tree<T, Compare, Alloc>::
     rb_tree(rb_tree &&rhs) noexcept
             : header_(mystl::move(rhs.header_)),
               node_count_(rhs.node_count_),
-              key_comp_(rhs.key_comp_) {
+              key_comp_(rhs.key_comp_),
+              pool_(mystl::move(rhs.pool_)) {
         rhs.reset();
     }
 
 // 复制赋值操作符
-    template<class T, class Compare>
-    rb_tree<T, Compare> &
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    rb_tree<T, Compare, Alloc> &
+    rb_tree<T, Compare, Alloc>::
     operator=(const rb_tree &rhs) {
         if (this != &rhs) {
             clear();
             if (rhs.node_count_ != 0) {
-                root() = copy_from(rhs.root(), header_);
+                root() = copy_from(rhs.root(), header_, rhs.node_count_);
                 leftmost() = rb_tree_min(root());
                 rightmost() = rb_tree_max(root());
             }
@@ -1022,24 +1725,38 @@ namespace mystl {
     }
 
 // 移动赋值操作符
-    template<class T, class Compare>
-    rb_tree<T, Compare> &
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    rb_tree<T, Compare, Alloc> &
+    rb_tree<T, Compare, Alloc>::
     operator=(rb_tree &&rhs) {
-        clear();
-        header_ = mystl::move(rhs.header_);
-        node_count_ = rhs.node_count_;
-        key_comp_ = rhs.key_comp_;
-        rhs.reset();
+        if (this != &rhs) {
+            clear();
+            // 交换 header_，rhs 留下一个空的 header_，仍是合法的空树
+            mystl::swap(header_, rhs.header_);
+            node_count_ = rhs.node_count_;
+            key_comp_ = rhs.key_comp_;
+            pool_ = mystl::move(rhs.pool_);
+            rhs.node_count_ = 0;
+        }
         return *this;
     }
 
+// 析构函数
+    template<class T, class Compare, class Alloc>
+    rb_tree<T, Compare, Alloc>::
+    ~rb_tree() {
+        clear();
+        if (header_ != nullptr) {
+            base_allocator::deallocate(header_);
+        }
+    }
+
 // 就地插入元素，键值允许重复
-    template<class T, class Compare>
+    template<class T, class Compare, class Alloc>
     template<class ...Args>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
-    emplace_multi(Args &&args...) {
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
+    emplace_multi(Args &&...args) {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         node_ptr np = create_node(mystl::forward<Args>(args)...);
         // 这个是什么？
@@ -1049,11 +1766,11 @@ namespace mystl {
     }
 
 // 就地插入元素，键值不允许重复
-    template<class T, class Compare>
+    template<class T, class Compare, class Alloc>
     template<class ...Args>
-    mystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-    rb_tree<T, Compare>::
-    emplace_unique(Args &&args...) {
+    mystl::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool>
+    rb_tree<T, Compare, Alloc>::
+    emplace_unique(Args &&...args) {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         node_ptr np = create_node(mystl::forward<Args>(args)...);
         auto res = get_insert_unique_pos(value_traits::get_key(np->value));
@@ -1070,11 +1787,11 @@ namespace mystl {
     }
 
 // 就近插入元素，键值允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-    template<class T, class Compare>
+    template<class T, class Compare, class Alloc>
     template<class ...Args>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
-    emplace_multi_use_hint(iterator hint, Args &&args...) {
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
+    emplace_multi_use_hint(iterator hint, Args &&...args) {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         node_ptr np = create_node(mystl::forward<Args>(args)...);
         if (node_count_ == 0) {
@@ -1092,7 +1809,7 @@ namespace mystl {
             } else {
                 // 否则找到对应的插入位置并插入
                 auto pos = get_insert_multi_pos(key);
-                return insert_node_at(pos.first, pos.second);
+                return insert_node_at(pos.first, np, pos.second);
             }
         } else if (hint == end()) {
             // 位于 end 处
@@ -1102,7 +1819,7 @@ namespace mystl {
             } else {
                 // 否则找到对应的插入位置并插入
                 auto pos = get_insert_multi_pos(key);
-                return insert_node_at(pos.first, pos.second);
+                return insert_node_at(pos.first, np, pos.second);
             }
         }
         // 若不在begin和end位置则调用别的函数实现？
@@ -1110,11 +1827,11 @@ namespace mystl {
     }
 
 // 就近插入元素，键值不允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-    template<class T, class Compare>
+    template<class T, class Compare, class Alloc>
     template<class ...Args>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
-    emplace_unique_use_hint(iterator hint, Args &&args...) {
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
+    emplace_unique_use_hint(iterator hint, Args &&...args) {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         node_ptr np = create_node(mystl::forward<Args>(args)...);
         if (node_count_ == 0) {
@@ -1154,9 +1871,9 @@ namespace mystl {
     }
 
 // 插入元素，节点允许重复
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
     insert_multi(const value_type &value) {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         auto res = get_insert_multi_pos(value_traits::get_key(value));
@@ -1164,9 +1881,9 @@ namespace mystl {
     }
 
 // 插入新值，节点键值不允许重复，返回一个 pair，若插入成功， pair 的第二个参数为true，否则为false
-    template<class T, class Compare>
-    mystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    mystl::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool>
+    rb_tree<T, Compare, Alloc>::
     insert_unique(const value_type &value) {
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
         auto res = get_insert_unique_pos(value_traits::get_key(value));
@@ -1179,24 +1896,24 @@ namespace mystl {
     }
 
 // 删除hint位置的节点
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
     erase(iterator hint) {
         auto node = hint.node->get_base_ptr();
         iterator next(node);
         ++next;
 
         rb_tree_erase_rebalance(hint.node, root(), leftmost(), rightmost());
-        destroy_node(node);
+        destroy_node(node->get_node_ptr());
         --node_count_;
         return next;
     }
 
 // 删除键值等于 key 的元素，返回删除的个数
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::size_type
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::size_type
+    rb_tree<T, Compare, Alloc>::
     erase_multi(const key_type &key) {
         auto p = equal_range_multi(key);
         size_type n = mystl::distance(p.first, p.second);
@@ -1205,10 +1922,10 @@ namespace mystl {
     }
 
 // 删除键值等于key的元素（唯一），返回删除的个数
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::size_type
-    rb_tree<T, Compare>::
-    emplace_unique(const key_type &key) {
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::size_type
+    rb_tree<T, Compare, Alloc>::
+    erase_unique(const key_type &key) {
         auto it = find(key);
         if (it != end()) {
             // 这是什么情况？不是结尾？
@@ -1218,9 +1935,47 @@ namespace mystl {
         return 0;
     }
 
+// 插入一批有序的元素，键值允许重复
+    template<class T, class Compare, class Alloc>
+    template<class InputIterator>
+    void rb_tree<T, Compare, Alloc>::
+    insert_sorted_batch_multi(InputIterator first, InputIterator last) {
+        // 空树时直接以 O(n) 建树
+        if (node_count_ == 0 && build_from_sorted(first, last, false, iterator_category(first))) {
+            return;
+        }
+        base_ptr finger = header_;  // 上一个插入点
+        for (; first != last; ++first) {
+            THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+            const value_type &value = *first;
+            const key_type &key = value_traits::get_key(value);
+            auto res = get_insert_multi_pos(key, finger_start(finger, key));
+            finger = insert_value_at(res.first, value, res.second).node;
+        }
+    }
+
+// 插入一批有序的元素，键值不允许重复
+    template<class T, class Compare, class Alloc>
+    template<class InputIterator>
+    void rb_tree<T, Compare, Alloc>::
+    insert_sorted_batch_unique(InputIterator first, InputIterator last) {
+        if (node_count_ == 0 && build_from_sorted(first, last, true, iterator_category(first))) {
+            return;
+        }
+        base_ptr finger = header_;
+        for (; first != last; ++first) {
+            THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+            const value_type &value = *first;
+            const key_type &key = value_traits::get_key(value);
+            auto res = get_insert_unique_pos(key, finger_start(finger, key));
+            // 键值重复时以重复的节点作为下一次的起点
+            finger = res.second ? insert_value_at(res.first.first, value, res.first.second).node : res.first.first;
+        }
+    }
+
 // 删除[first, last)区间内的元素
-    template<class T, class Compare>
-    void rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
     erase(iterator first, iterator last) {
         if (first == begin() && last == end()) {
             clear();
@@ -1232,11 +1987,21 @@ namespace mystl {
     }
 
 // 清空rb_tree
-    template<class T, class Compare>
-    void rb_tree<T, Compare>::
+// 独占节点池时不必逐个归还节点，析构完值后整块释放即可；
+// 与其他树共用节点池时逐个归还节点，并放弃对节点池的引用
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
     clear() {
         if (node_count_ != 0) {
-            erase_since(root());
+            if (pool_.unique()) {
+                if (!std::is_trivially_destructible<T>::value) {
+                    destroy_values_since(root());
+                }
+                pool_.release();
+            } else {
+                erase_since(root());
+                pool_.reset();
+            }
             leftmost() = header_;
             root() = nullptr;
             rightmost() = header_;
@@ -1244,199 +2009,465 @@ namespace mystl {
         }
     }
 
-// 查找键值为 k 的节点，返回指向它的迭代器
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
-    find(const key_type &key) {
-        auto y = header_;  // 最后一个不小于key的节点
-        auto x = root();
-        while (x != nullptr) {
-            if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) {
-                // key 小于等于 x 键值，向左走
-                y = x, x = x->left;
-            } else {
-                // key 大于 x 键值，向右走
-                // 这里y为什么不跟着走？
-                x = x->right;
+// 摘下 position 位置的节点
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::node_handle
+    rb_tree<T, Compare, Alloc>::
+    extract(iterator position) {
+        auto node = unlink_node(position.node);
+        return node_handle(node, pool_);
+    }
+
+// 插入节点，键值不允许重复
+    template<class T, class Compare, class Alloc>
+    mystl::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool>
+    rb_tree<T, Compare, Alloc>::
+    insert_node_unique(node_handle &&nh) {
+        if (nh.empty()) {
+            return mystl::make_pair(end(), false);
+        }
+        THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+        auto res = get_insert_unique_pos(value_traits::get_key(nh.value()));
+        if (!res.second) {
+            return mystl::make_pair(iterator(res.first.first), false);
+        }
+        return mystl::make_pair(insert_node_at(res.first.first, adopt_node(nh), res.first.second), true);
+    }
+
+// 插入节点，键值允许重复
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
+    insert_node_multi(node_handle &&nh) {
+        if (nh.empty()) {
+            return end();
+        }
+        THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+        auto pos = get_insert_multi_pos(value_traits::get_key(nh.value()));
+        return insert_node_at(pos.first, adopt_node(nh), pos.second);
+    }
+
+// 转移 rhs 中键值在本树中不存在的节点
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    merge_unique(rb_tree &rhs, bool rhs_unique) {
+        if (this == &rhs || rhs.node_count_ == 0) {
+            return;
+        }
+        share_pool_with(rhs);
+        if (rhs_unique &&
+            (node_count_ == 0 ||
+             key_comp_(value_traits::get_key(rightmost()->get_node_ptr()->value),
+                       value_traits::get_key(rhs.leftmost()->get_node_ptr()->value)) ||
+             key_comp_(value_traits::get_key(rhs.rightmost()->get_node_ptr()->value),
+                       value_traits::get_key(leftmost()->get_node_ptr()->value)))) {
+            // 键值区间不相交，整棵树一次拼接
+            join_unique(rhs);
+            return;
+        }
+        for (auto first = rhs.begin(); first != rhs.end();) {
+            auto res = get_insert_unique_pos(value_traits::get_key(*first));
+            auto x = first.node;
+            ++first;
+            if (res.second) {
+                insert_node_at(res.first.first, rhs.unlink_node(x), res.first.second);
             }
         }
-        iterator j = iterator(y);
-        return (j == end() || key_comp_(key, value_traits::get_key(*j))) ? end() : j;
+        if (rhs.node_count_ == 0) {
+            rhs.pool_.reset();
+        }
     }
 
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::const_iterator
-    rb_tree<T, Compare>::
-    find(const key_type &key) const {
+// 查找键值为 k 的节点，没有时返回 header_
+    template<class T, class Compare, class Alloc>
+    template<class K>
+    typename rb_tree<T, Compare, Alloc>::base_ptr
+    rb_tree<T, Compare, Alloc>::
+    find_node(const K &key) const {
+        auto y = lower_bound_node(key);
+        return (y == header_ || key_comp_(key, value_traits::get_key(y->get_node_ptr()->value))) ? header_ : y;
+    }
+
+// 键值不小于 key 的第一个节点
+    template<class T, class Compare, class Alloc>
+    template<class K>
+    typename rb_tree<T, Compare, Alloc>::base_ptr
+    rb_tree<T, Compare, Alloc>::
+    lower_bound_node(const K &key) const {
         auto y = header_;  // 最后一个不小于 key 的节点
         auto x = root();
         while (x != nullptr) {
+            rb_tree_prefetch_children(x);
             if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) {
                 // key 小于等于 x 键值，向左走
                 y = x, x = x->left;
             } else {
-                // y 为什么不跟着走？
+                // key 大于 x 键值，向右走
                 x = x->right;
             }
         }
-        const_iterator j = const_iterator(y);
-        return (j == end() || key_comp_(key, value_traits::get_key(*j))) ? end() : j;
+        return y;
     }
 
-// 键值不小于 key 的第一个位置
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
-    lower_bound(const key_type &key) {
+// 键值大于 key 的第一个节点
+    template<class T, class Compare, class Alloc>
+    template<class K>
+    typename rb_tree<T, Compare, Alloc>::base_ptr
+    rb_tree<T, Compare, Alloc>::
+    upper_bound_node(const K &key) const {
         auto y = header_;
         auto x = root();
         while (x != nullptr) {
-            if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) {
-                // key <= x
+            rb_tree_prefetch_children(x);
+            if (key_comp_(key, value_traits::get_key(x->get_node_ptr()->value))) { // key < x
                 y = x, x = x->left;
             } else {
                 x = x->right;
             }
         }
-        return iterator(y);
+        return y;
     }
 
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::const_iterator
-    rb_tree<T, Compare>::
-    lower_bound(const key_type &key) const {
-        auto y = header_;
-        auto x = root();
-        while (x != nullptr) {
-            if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) {
-                // key <= x
-                y = x, x = x->left;
-            } else {
-                x = x->right;
+// 批量查找
+// 每批同时进行 batch 个查找，轮流让每个查找下降一层并预取它的下一个节点：
+// 一个查找等待 cache miss 时其余查找继续比较，多个访存同时进行，隐藏单次查找逐层追指针的延迟
+    template<class T, class Compare, class Alloc>
+    template<class Iter, class ForwardIter, class OutputIter>
+    OutputIter rb_tree<T, Compare, Alloc>::
+    find_many_nodes(ForwardIter first, ForwardIter last, OutputIter result) const {
+        static constexpr size_type batch = 8;
+        ForwardIter keys[batch];
+        base_ptr x[batch];  // 每个查找当前所在的节点
+        base_ptr y[batch];  // 每个查找最后一个不小于键值的节点
+        while (first != last) {
+            size_type n = 0;
+            for (; n < batch && first != last; ++n, ++first) {
+                keys[n] = first;
+                x[n] = root();
+                y[n] = header_;
+            }
+            bool active = true;
+            while (active) {
+                active = false;
+                for (size_type i = 0; i < n; ++i) {
+                    auto p = x[i];
+                    if (p == nullptr) {
+                        continue;
+                    }
+                    if (!key_comp_(value_traits::get_key(p->get_node_ptr()->value), *keys[i])) {
+                        y[i] = p;
+                        x[i] = p->left;
+                    } else {
+                        x[i] = p->right;
+                    }
+                    if (x[i] != nullptr) {
+                        rb_tree_prefetch(x[i]);
+                        active = true;
+                    }
+                }
+            }
+            for (size_type i = 0; i < n; ++i, ++result) {
+                const bool found = y[i] != header_ &&
+                                   !key_comp_(*keys[i], value_traits::get_key(y[i]->get_node_ptr()->value));
+                *result = Iter(found ? y[i] : header_);
             }
         }
-        return const_iterator(y);
+        return result;
     }
 
-// 键值不小于 key 的最后一个位置
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
-    upper_bound(const key_type &key) {
-        auto y = header_;
+// 第 k 小的节点
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::base_ptr
+    rb_tree<T, Compare, Alloc>::
+    nth_node(size_type k) const noexcept {
+        if (k >= node_count_) {
+            return header_;
+        }
+#ifdef MYSTL_RB_TREE_ORDER_STATISTICS
         auto x = root();
-        while (x != nullptr) {
-            if (key_comp_(key, value_traits::get_key(x->get_node_ptr()->value))) { // key < x
-                y = x, x = x->left;
+        while (true) {
+            const size_type left_size = rb_tree_size(x->left);
+            if (k < left_size) {
+                x = x->left;
+            } else if (k == left_size) {
+                return x;
             } else {
+                k -= left_size + 1;
                 x = x->right;
             }
         }
-        return iterator(y);
+#else
+        // 没有子树大小时只能从两端顺序走过去
+        const_iterator it;
+        if (k < node_count_ / 2) {
+            it = begin();
+            for (; k > 0; --k) {
+                ++it;
+            }
+        } else {
+            it = end();
+            for (k = node_count_ - k; k > 0; --k) {
+                --it;
+            }
+        }
+        return it.node;
+#endif
     }
 
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::const_iterator
-    rb_tree<T, Compare>::
-    upper_bound(const key_type &key) const {
-        auto y = header_;
+// 键值小于 key 的元素个数
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::size_type
+    rb_tree<T, Compare, Alloc>::
+    rank(const key_type &key) const {
+#ifdef MYSTL_RB_TREE_ORDER_STATISTICS
+        size_type r = 0;
         auto x = root();
         while (x != nullptr) {
-            if (key_comp_(key, value_traits::get_key(x->get_node_ptr()->value))) { // key < x
-                y = x, x = x->left;
+            if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) {
+                // key <= x
+                x = x->left;
             } else {
+                r += rb_tree_size(x->left) + 1;
                 x = x->right;
             }
         }
-        return const_iterator(y);
+        return r;
+#else
+        return static_cast<size_type>(mystl::distance(begin(), lower_bound(key)));
+#endif
     }
 
 // 交换 rb_tree
-    template<class T, class Compare>
-    void rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
     swap(rb_tree &rhs) noexcept {
         if (this != &rhs) {
             mystl::swap(header_, rhs.header_);
             mystl::swap(node_count_, rhs.node_count_);
             mystl::swap(key_comp_, rhs.key_comp_);
+            pool_.swap(rhs.pool_);
+        }
+    }
+
+// 按 key 分裂 rb_tree，first 中的键值都小于 key，second 中的键值都不小于 key
+    template<class T, class Compare, class Alloc>
+    mystl::pair<rb_tree<T, Compare, Alloc>, rb_tree<T, Compare, Alloc>>
+    rb_tree<T, Compare, Alloc>::
+    split(const key_type &key) {
+        rb_tree left;
+        rb_tree right;
+        left.key_comp_ = key_comp_;
+        right.key_comp_ = key_comp_;
+        // 两棵树都使用本树的节点，共用本树的节点池
+        left.pool_ = pool_;
+        right.pool_ = mystl::move(pool_);
+        const size_type n = node_count_;
+        size_type h = 0;
+        auto x = detach_tree(h);
+        base_ptr l = nullptr, r = nullptr;
+        size_type lh = 0, rh = 0;
+        split_since(x, h, key, l, lh, r, rh);
+        left.attach_tree(l, 0);
+        right.attach_tree(r, 0);
+#ifdef MYSTL_RB_TREE_ORDER_STATISTICS
+        left.node_count_ = rb_tree_size(l);
+#else
+        // 没有子树大小时，同时从两棵树的开头向后走，先走完的一棵即为较小的一棵，O(min(n1, n2))
+        size_type k = 0;
+        auto i = left.begin();
+        auto j = right.begin();
+        for (; i != left.end() && j != right.end(); ++i, ++j) {
+            ++k;
+        }
+        left.node_count_ = i == left.end() ? k : n - k;
+#endif
+        right.node_count_ = n - left.node_count_;
+        return mystl::make_pair(mystl::move(left), mystl::move(right));
+    }
+
+// 合并 rhs 中的元素，键值不重复
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    join_unique(rb_tree &rhs) {
+        if (this == &rhs || rhs.node_count_ == 0) {
+            return;
+        }
+        share_pool_with(rhs);
+        if (node_count_ == 0 ||
+            key_comp_(value_traits::get_key(rightmost()->get_node_ptr()->value),
+                      value_traits::get_key(rhs.leftmost()->get_node_ptr()->value))) {
+            concat(rhs, false);
+        } else if (key_comp_(value_traits::get_key(rhs.rightmost()->get_node_ptr()->value),
+                             value_traits::get_key(leftmost()->get_node_ptr()->value))) {
+            concat(rhs, true);
+        } else {
+            union_unique(rhs);
+        }
+    }
+
+// 合并 rhs 中的元素，键值允许重复
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    join_multi(rb_tree &rhs) {
+        if (this == &rhs || rhs.node_count_ == 0) {
+            return;
+        }
+        share_pool_with(rhs);
+        if (node_count_ == 0 ||
+            !key_comp_(value_traits::get_key(rhs.leftmost()->get_node_ptr()->value),
+                       value_traits::get_key(rightmost()->get_node_ptr()->value))) {
+            concat(rhs, false);
+        } else if (!key_comp_(value_traits::get_key(leftmost()->get_node_ptr()->value),
+                              value_traits::get_key(rhs.rightmost()->get_node_ptr()->value))) {
+            concat(rhs, true);
+        } else {
+            // 区间相交，把 rhs 的节点逐个摘下插入本树，不重新分配节点
+            while (rhs.node_count_ != 0) {
+                auto node = rhs.unlink_node(rhs.leftmost());
+                auto pos = get_insert_multi_pos(value_traits::get_key(node->value));
+                insert_node_at(pos.first, node, pos.second);
+            }
+            rhs.pool_.reset();
         }
     }
 
+// 求并集，键值相同时保留本树的元素
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    union_unique(rb_tree &rhs) {
+        if (this == &rhs || rhs.node_count_ == 0) {
+            return;
+        }
+        share_pool_with(rhs);
+        const size_type n = node_count_ + rhs.node_count_;
+        size_type ah = 0, bh = 0, removed = 0;
+        auto a = detach_tree(ah);
+        auto b = rhs.detach_tree(bh);
+        union_since(a, ah, b, bh, removed);
+        attach_tree(a, n - removed);
+        rhs.pool_.reset();
+    }
+
+// 求交集，保留本树的元素
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    intersection_unique(rb_tree &rhs) {
+        if (this == &rhs) {
+            return;
+        }
+        share_pool_with(rhs);
+        const size_type n = node_count_ + rhs.node_count_;
+        size_type ah = 0, bh = 0, removed = 0;
+        auto a = detach_tree(ah);
+        auto b = rhs.detach_tree(bh);
+        intersection_since(a, ah, b, bh, removed);
+        attach_tree(a, n - removed);
+        rhs.pool_.reset();
+    }
+
+// 求差集，从本树中去掉 rhs 中也有的元素
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    difference_unique(rb_tree &rhs) {
+        if (this == &rhs) {
+            clear();
+            return;
+        }
+        share_pool_with(rhs);
+        const size_type n = node_count_ + rhs.node_count_;
+        size_type ah = 0, bh = 0, removed = 0;
+        auto a = detach_tree(ah);
+        auto b = rhs.detach_tree(bh);
+        difference_since(a, ah, b, bh, removed);
+        attach_tree(a, n - removed);
+        rhs.pool_.reset();
+    }
+
 /*******************************************************************************************/
 // helper function
 
 // 创建一个节点
-    template<class T, class Compare>
+    template<class T, class Compare, class Alloc>
     template<class ...Args>
-    typename rb_tree<T, Compare>::node_ptr
-    rb_tree<T, Compare>::
-    create_node(Args &&args...) {
-        auto tmp = node_allocator::allocate(1);
+    typename rb_tree<T, Compare, Alloc>::node_ptr
+    rb_tree<T, Compare, Alloc>::
+    create_node(Args &&...args) {
+        auto tmp = pool_.allocate();
         try {
             // 根据args创建一个节点
             data_allocator::construct(mystl::address_of(tmp->value), mystl::forward<Args>(args)...);
             // 指针均设置为空
             tmp->left = nullptr;
             tmp->right = nullptr;
-            tmp->parent = nullptr;
+            rb_tree_set_parent_color(tmp, nullptr, rb_tree_red);
         } catch (...) {
-            node_allocator::deallocate(tmp);
+            pool_.deallocate(tmp);
             throw;
         }
         return tmp;
     }
 
 // 复制一个节点
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::node_ptr
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::node_ptr
+    rb_tree<T, Compare, Alloc>::
     clone_node(base_ptr x) {
         node_ptr tmp = create_node(x->get_node_ptr()->value);
-        tmp->color = x->color;
+        rb_tree_set_color(tmp, rb_tree_color(x));
         tmp->left = nullptr;
         tmp->right = nullptr;
         return tmp;
     }
 
 // 销毁一个节点
-    template<class T, class Compare>
-    void rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
     destroy_node(node_ptr p) {
         // 回收资源
         data_allocator::destroy(&p->value);
-        node_allocator::deallocate(p);
+        pool_.deallocate(p);
+    }
+
+// 析构 x 及其子树上的值
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    destroy_values_since(base_ptr x) {
+        while (x != nullptr) {
+            destroy_values_since(x->right);
+            data_allocator::destroy(&x->get_node_ptr()->value);
+            x = x->left;
+        }
     }
 
 // 初始化容器
-    template<class T, class Compare>
-    void rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
     rb_tree_init() {
         header_ = base_allocator::allocate(1);
-        header_->color = rb_tree_red;  // header_ 节点颜色为红色，与 root 区分
-        root() = nullptr;
-        leftmost() = nullptr;
-        rightmost() = nullptr;
+        rb_tree_set_parent_color(header_, nullptr, rb_tree_red);  // header_ 节点颜色为红色，与 root 区分
+        leftmost() = header_;
+        rightmost() = header_;
         node_count_ = 0;
     }
 
 // reset 函数
-    template<class T, class Compare>
-    void rb_tree<T, Compare>::reset() {
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::reset() {
         header_ = nullptr;
         node_count_ = 0;
     }
 
     // get_insert_multi_pos 函数
 // 找到插入位置，可重复
-    template<class T, class Compare>
-    mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>
-    rb_tree<T, Compare>::get_insert_multi_pos(const key_type &key) {
+    template<class T, class Compare, class Alloc>
+    mystl::pair<typename rb_tree<T, Compare, Alloc>::base_ptr, bool>
+    rb_tree<T, Compare, Alloc>::get_insert_multi_pos(const key_type &key, base_ptr start) {
         // 返回一个pair，其中第一个参数是插入点的父节点，bool表示是否在左边插入
-        auto x = root();
+        auto x = start;
         auto y = header_;
         bool add_to_left = true;
         while (x != nullptr) {
+            rb_tree_prefetch_children(x);
             y = x;
             // 记录是在树的左边还是右边插入
             add_to_left = key_comp_(key, value_traits::get_key(x->get_node_ptr()->value));
@@ -1446,17 +2477,45 @@ namespace mystl {
     }
 
 
+// finger_start 函数
+// 从上一个插入点 finger 向上走，直到某个节点是父节点的左子节点且 key 小于父节点的键值：
+// 此时该节点子树的键值区间包含 key 的插入位置，从它开始向下查找即可。
+// 有序插入时插入点不断右移，向上走的层数只与两次插入点之间的距离成对数关系
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::base_ptr
+    rb_tree<T, Compare, Alloc>::
+    finger_start(base_ptr finger, const key_type &key) const {
+        if (node_count_ != 0 && !key_comp_(key, value_traits::get_key(rightmost()->get_node_ptr()->value))) {
+            // 单调递增的输入总是追加在最右端，最右节点没有右子节点，不必向上走
+            return rightmost();
+        }
+        if (finger == header_ || key_comp_(key, value_traits::get_key(finger->get_node_ptr()->value))) {
+            // 没有上一个插入点，或者输入不有序
+            return root();
+        }
+        base_ptr x = finger;
+        while (x != root()) {
+            base_ptr p = x->parent;
+            if (x == p->left && key_comp_(key, value_traits::get_key(p->get_node_ptr()->value))) {
+                break;
+            }
+            x = p;
+        }
+        return x;
+    }
+
 // get_insert_unique_pos 函数
 // 找到唯一的插入位置
-    template<class T, class Compare>
-    mystl::pair<mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>, bool>
-    rb_tree<T, Compare>::get_insert_unique_pos(const key_type &key) {
+    template<class T, class Compare, class Alloc>
+    mystl::pair<mystl::pair<typename rb_tree<T, Compare, Alloc>::base_ptr, bool>, bool>
+    rb_tree<T, Compare, Alloc>::get_insert_unique_pos(const key_type &key, base_ptr start) {
         // 返回一个pair，第一个值为一个pair，包含插入点的父节点和一个bool表示是否在左边插入
         // 第二个bool表示是否插入成功
-        auto x = root();
+        auto x = start;
         auto y = header_;
         bool add_to_left = true;  // 树为空时也在header_左边插入
         while (x != nullptr) {
+            rb_tree_prefetch_children(x);
             // 若当前根节点不为空
             y = x;
             // key_comp_：节点键值比较的准则
@@ -1485,16 +2544,16 @@ namespace mystl {
             // 表明新节点没有重复
             return mystl::make_pair(mystl::make_pair(y, add_to_left), true);
         }
-        // 进行至此，表示新节点与现有节点键值重复
-        return mystl::make_pair(mystl::make_pair(y, add_to_left), false);
+        // 进行至此，表示新节点与现有节点键值重复，返回重复的节点
+        return mystl::make_pair(mystl::make_pair(j.node, add_to_left), false);
     }
 
 // insert_value_at 函数
 // 根据值构造节点并插入
 // x 为插入点的父节点，value 为要插入的值，add_to_left 表示是否在左边插入
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
     insert_value_at(base_ptr x, const value_type &value, bool add_to_left) {
         // 创建节点
         node_ptr node = create_node(value);
@@ -1530,9 +2589,9 @@ namespace mystl {
 
 // 在 x 节点处插入新的节点
 // x 为插入点的父节点，node为要插入的节点，add_to_left 表示是否在左边插入
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
     insert_node_at(base_ptr x, node_ptr node, bool add_to_left) {
         // 更新父节点
         node->parent = x;
@@ -1562,9 +2621,9 @@ namespace mystl {
     }
 
 // 插入元素，键值允许重复，使用 hint
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
     insert_multi_use_hint(iterator hint, key_type key, node_ptr node) {
         // 在hint附近找可插入的位置
         auto np = hint.node;  // 指向节点本身
@@ -1587,9 +2646,9 @@ namespace mystl {
     }
 
 // 插入元素，键值不允许重复，使用hint
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::iterator
-    rb_tree<T, Compare>::
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::iterator
+    rb_tree<T, Compare, Alloc>::
     insert_unique_use_hint(iterator hint, key_type key, node_ptr node) {
         // 在hint附近寻找可插入的位置
         auto np = hint.node;
@@ -1616,51 +2675,179 @@ namespace mystl {
     }
 
 // copy_from 函数
-// 递归复制一棵树，节点从x开始，p为x的父节点
-    template<class T, class Compare>
-    typename rb_tree<T, Compare>::base_ptr
-    rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p) {
-        auto top = clone_node(x);
-        top->parent = p;
+// 复制以 x 为根、共 n 个节点的树，p 为 x 的父节点，返回复制出的根节点
+// 非递归地按中序遍历，n 个节点一次从节点池中连续取出并按中序排布，复制后的树顺序遍历时是顺序访问内存
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::base_ptr
+    rb_tree<T, Compare, Alloc>::copy_from(base_ptr x, base_ptr p, size_type n) {
+        // 红黑树的高度不超过 2log(n+1)，栈的深度有上界
+        static constexpr size_t max_height = 2 * sizeof(size_type) * 8;
+        struct frame {
+            base_ptr src;    // 被复制的节点
+            base_ptr copy;   // 复制出的节点
+            int state;       // 0：未复制左子树，1：已复制左子树，2：已复制右子树
+        };
+        frame stack[max_height];
+        size_t top = 0;
+
+        node_ptr block = pool_.allocate_n(n);
+        size_type count = 0;  // 已构造的节点数
+        base_ptr ret = nullptr;  // 最近复制完的子树的根
         try {
-            if (x->right) {
-                // 递归复制右子树
-                top->right = copy_from(x->right, top);
+            stack[top++] = frame{x, nullptr, 0};
+            while (top != 0) {
+                auto &f = stack[top - 1];
+                if (f.state == 0) {
+                    f.state = 1;
+                    if (f.src->left != nullptr) {
+                        stack[top++] = frame{f.src->left, nullptr, 0};
+                        continue;
+                    }
+                    ret = nullptr;
+                }
+                if (f.state == 1) {
+                    // 左子树已复制完，按中序取下一个节点
+                    node_ptr node = block + count;
+                    data_allocator::construct(mystl::address_of(node->value), f.src->get_node_ptr()->value);
+                    ++count;
+                    rb_tree_set_parent_color(node, nullptr, rb_tree_color(f.src));
+                    node->left = ret;
+                    if (ret != nullptr) {
+                        ret->parent = node;
+                    }
+                    f.copy = node;
+                    f.state = 2;
+                    if (f.src->right != nullptr) {
+                        stack[top++] = frame{f.src->right, nullptr, 0};
+                        continue;
+                    }
+                    ret = nullptr;
+                }
+                // 右子树已复制完
+                f.copy->right = ret;
+                if (ret != nullptr) {
+                    ret->parent = f.copy;
+                }
+                rb_tree_update_node(f.copy);
+                ret = f.copy;
+                --top;
             }
-            // 左子树操作
-            p = top;
-            x = x->left;
-            while (x != nullptr) {
-                // 复制当前节点
-                auto y = clone_node(x);
-                // 连接到p的左子树上
-                p->left = y;
-                y->parent = p;
-                if (x->parent) {
-                    // 若x存在父节点，则将x的右子树复制到新建节点y的右子树上
-                    y->right = copy_from(x->right, y);
+        } catch (...) {
+            // 析构已构造的值，整块节点归还给节点池
+            for (size_type i = 0; i < count; ++i) {
+                data_allocator::destroy(mystl::address_of(block[i].value));
+            }
+            for (size_type i = 0; i < n; ++i) {
+                pool_.deallocate(block + i);
+            }
+            throw;
+        }
+        ret->parent = p;
+        return ret;
+    }
+
+// build_from_sorted 函数
+// 空树时从有序区间以 O(n) 建立一棵平衡的红黑树，区间无序时返回 false 且不做任何修改
+// unique 为 true 时相邻的重复键值只保留第一个
+    template<class T, class Compare, class Alloc>
+    template<class ForwardIterator>
+    bool rb_tree<T, Compare, Alloc>::
+    build_from_sorted(ForwardIterator first, ForwardIterator last, bool unique, forward_iterator_tag) {
+        if (first == last) {
+            return true;
+        }
+        // 检查是否有序，同时统计建树后的节点数
+        size_type n = 1;
+        auto prev = first;
+        auto it = first;
+        for (++it; it != last; ++it, ++prev) {
+            if (key_comp_(value_traits::get_key(*it), value_traits::get_key(*prev))) {
+                return false;
+            }
+            if (!unique || key_comp_(value_traits::get_key(*prev), value_traits::get_key(*it))) {
+                ++n;
+            }
+        }
+        THROW_LENGTH_ERROR_IF(n > max_size(), "rb_tree<T, Comp>'s size too big");
+
+        // 按中序依次创建节点，先用 right 指针串成一条链，节点在节点池中也是按中序相邻的
+        base_ptr head = nullptr;
+        base_ptr tail = nullptr;
+        try {
+            for (it = first; it != last; ++it) {
+                if (unique && tail != nullptr &&
+                    !key_comp_(value_traits::get_key(tail->get_node_ptr()->value), value_traits::get_key(*it))) {
+                    continue;
                 }
-                // 更新节点
-                p = y;
-                x = x->left;
+                base_ptr node = create_node(*it);
+                if (tail == nullptr) {
+                    head = node;
+                } else {
+                    tail->right = node;
+                }
+                tail = node;
             }
         } catch (...) {
-            // 若报错则从top开始删除并抛出错误
-            erase_since(top);
+            while (head != nullptr) {
+                auto next = head->right;
+                destroy_node(head->get_node_ptr());
+                head = next;
+            }
             throw;
         }
-        // 返回复制的树的头节点
-        return top;
+
+        // 把链重新连接成平衡树：除最底层外每层都是满的，最底层的节点染红，其余染黑
+        size_type red_depth = 0;
+        for (size_type m = n; m > 1; m >>= 1) {
+            ++red_depth;
+        }
+        auto list = head;
+        root() = link_balanced(list, n, 0, red_depth);
+        root()->parent = header_;
+        rb_tree_set_black(root());
+        leftmost() = head;
+        rightmost() = tail;
+        node_count_ = n;
+        return true;
+    }
+
+// link_balanced 函数
+// 从中序链 list 上取下 n 个节点，连接成一棵平衡的子树并返回其根，depth 为子树根的深度
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::base_ptr
+    rb_tree<T, Compare, Alloc>::
+    link_balanced(base_ptr &list, size_type n, size_type depth, size_type red_depth) {
+        if (n == 0) {
+            return nullptr;
+        }
+        const size_type left_n = (n - 1) / 2;
+        auto left = link_balanced(list, left_n, depth + 1, red_depth);
+        auto node = list;
+        list = list->right;
+        node->left = left;
+        if (left != nullptr) {
+            left->parent = node;
+        }
+        auto right = link_balanced(list, n - 1 - left_n, depth + 1, red_depth);
+        node->right = right;
+        if (right != nullptr) {
+            right->parent = node;
+        }
+        rb_tree_set_color(node, (depth == red_depth && depth != 0) ? rb_tree_red : rb_tree_black);
+        rb_tree_update_node(node);
+        return node;
     }
 
 // erase_since 函数
-// 从 x 节点开始删除该节点及其子树
-    template<class T, class Compare>
-    void rb_tree<T, Compare>::
+// 从 x 节点开始删除该节点及其子树，返回删除的节点数
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::size_type
+    rb_tree<T, Compare, Alloc>::
     erase_since(base_ptr x) {
+        size_type n = 0;
         while (x != nullptr) {
             // 递归删除右子树
-            erase_since(x->right);
+            n += erase_since(x->right) + 1;
             // 保存当前节点的左子树
             auto y = x->left;
             // 删除当前节点
@@ -1668,45 +2855,280 @@ namespace mystl {
             // 令当前节点指向左子树，重复上述步骤删除
             x = y;
         }
+        return n;
+    }
+
+// 把整棵树摘下作为独立子树返回，h 为它的黑高，本树变为空，节点不析构
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::base_ptr
+    rb_tree<T, Compare, Alloc>::
+    detach_tree(size_type &h) {
+        auto x = root();
+        h = rb_tree_black_height(x);
+        if (x != nullptr) {
+            x->parent = nullptr;
+        }
+        root() = nullptr;
+        leftmost() = header_;
+        rightmost() = header_;
+        node_count_ = 0;
+        return x;
+    }
+
+// 以独立子树 x 作为整棵树，n 为节点数
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    attach_tree(base_ptr x, size_type n) {
+        root() = x;
+        if (x != nullptr) {
+            x->parent = header_;
+            leftmost() = rb_tree_min(x);
+            rightmost() = rb_tree_max(x);
+        } else {
+            leftmost() = header_;
+            rightmost() = header_;
+        }
+        node_count_ = n;
+    }
+
+// 让 rhs 的节点可以转移到本树：两棵树共用节点池，share_with 总能成功，不复制元素
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    share_pool_with(rb_tree &rhs) {
+        pool_.share_with(rhs.pool_);
+        MYSTL_DEBUG(pool_.shares_with(rhs.pool_));
+    }
+
+// 把节点 x 从树中摘下，不析构元素也不归还空间
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::node_ptr
+    rb_tree<T, Compare, Alloc>::
+    unlink_node(base_ptr x) {
+        rb_tree_erase_rebalance(x, root(), leftmost(), rightmost());
+        --node_count_;
+        auto node = x->get_node_ptr();
+        node->left = nullptr;
+        node->right = nullptr;
+        node->parent = nullptr;
+        return node;
+    }
+
+// 取出 nh 持有的节点，先与 nh 的节点池共用，使节点可以由本树的节点池回收；不分配空间也不移动元素
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::node_ptr
+    rb_tree<T, Compare, Alloc>::
+    adopt_node(node_handle &nh) {
+        pool_.share_with(nh.pool_);
+        MYSTL_DEBUG(pool_.shares_with(nh.pool_));
+        return nh.release();
+    }
+
+// 拼接两棵键值区间不相交的树，rhs_first 表示 rhs 中的元素在前，rhs 变为空
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    concat(rb_tree &rhs, bool rhs_first) {
+        const size_type n = node_count_ + rhs.node_count_;
+        size_type ah = 0, bh = 0;
+        auto a = detach_tree(ah);
+        auto b = rhs.detach_tree(bh);
+        if (rhs_first) {
+            mystl::swap(a, b);
+            mystl::swap(ah, bh);
+        }
+        rb_tree_join2(a, ah, b, bh);
+        attach_tree(a, n);
+        rhs.pool_.reset();
+    }
+
+// 把黑高为 h 的子树 x 分裂为 l（键值小于 key）和 r（键值不小于 key）
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    split_since(base_ptr x, size_type h, const key_type &key,
+                base_ptr &l, size_type &lh, base_ptr &r, size_type &rh) {
+        if (x == nullptr) {
+            l = r = nullptr;
+            lh = rh = 0;
+            return;
+        }
+        // x 为黑色，两棵子树的黑高都为 h - 1
+        size_type xlh = h - 1, xrh = h - 1;
+        auto xl = rb_tree_detach(x->left, xlh);
+        auto xr = rb_tree_detach(x->right, xrh);
+        if (key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) {
+            // x 及其左子树都小于 key，只需分裂右子树
+            split_since(xr, xrh, key, l, lh, r, rh);
+            rb_tree_join(xl, xlh, x, l, lh);
+            l = xl;
+            lh = xlh;
+        } else {
+            split_since(xl, xlh, key, l, lh, r, rh);
+            rb_tree_join(r, rh, x, xr, xrh);
+        }
+    }
+
+// 把黑高为 h 的子树 x 分裂为 l（键值小于 key）和 r（键值大于 key），返回键值等于 key 的节点，没有时返回空
+    template<class T, class Compare, class Alloc>
+    typename rb_tree<T, Compare, Alloc>::base_ptr
+    rb_tree<T, Compare, Alloc>::
+    split_unique_since(base_ptr x, size_type h, const key_type &key,
+                       base_ptr &l, size_type &lh, base_ptr &r, size_type &rh) {
+        if (x == nullptr) {
+            l = r = nullptr;
+            lh = rh = 0;
+            return nullptr;
+        }
+        size_type xlh = h - 1, xrh = h - 1;
+        auto xl = rb_tree_detach(x->left, xlh);
+        auto xr = rb_tree_detach(x->right, xrh);
+        base_ptr equal = nullptr;
+        if (key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) {
+            equal = split_unique_since(xr, xrh, key, l, lh, r, rh);
+            rb_tree_join(xl, xlh, x, l, lh);
+            l = xl;
+            lh = xlh;
+        } else if (key_comp_(key, value_traits::get_key(x->get_node_ptr()->value))) {
+            equal = split_unique_since(xl, xlh, key, l, lh, r, rh);
+            rb_tree_join(r, rh, x, xr, xrh);
+        } else {
+            l = xl;
+            lh = xlh;
+            r = xr;
+            rh = xrh;
+            equal = x;
+        }
+        return equal;
+    }
+
+// 子树 a 与 b 求并集，结果存回 a，键值相同时销毁 b 中的节点，removed 累计销毁的节点数
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    union_since(base_ptr &a, size_type &ah, base_ptr b, size_type bh, size_type &removed) {
+        if (b == nullptr) {
+            return;
+        }
+        if (a == nullptr) {
+            a = b;
+            ah = bh;
+            return;
+        }
+        auto x = a;
+        size_type alh = ah - 1, arh = ah - 1;
+        auto al = rb_tree_detach(x->left, alh);
+        auto ar = rb_tree_detach(x->right, arh);
+        base_ptr bl = nullptr, br = nullptr;
+        size_type blh = 0, brh = 0;
+        auto equal = split_unique_since(b, bh, value_traits::get_key(x->get_node_ptr()->value),
+                                        bl, blh, br, brh);
+        if (equal != nullptr) {
+            destroy_node(equal->get_node_ptr());
+            ++removed;
+        }
+        union_since(al, alh, bl, blh, removed);
+        union_since(ar, arh, br, brh, removed);
+        rb_tree_join(al, alh, x, ar, arh);
+        a = al;
+        ah = alh;
+    }
+
+// 子树 a 与 b 求交集，结果存回 a，保留 a 中的节点，其余节点都销毁
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    intersection_since(base_ptr &a, size_type &ah, base_ptr b, size_type bh, size_type &removed) {
+        if (a == nullptr || b == nullptr) {
+            removed += erase_since(a) + erase_since(b);
+            a = nullptr;
+            ah = 0;
+            return;
+        }
+        auto x = a;
+        size_type alh = ah - 1, arh = ah - 1;
+        auto al = rb_tree_detach(x->left, alh);
+        auto ar = rb_tree_detach(x->right, arh);
+        base_ptr bl = nullptr, br = nullptr;
+        size_type blh = 0, brh = 0;
+        auto equal = split_unique_since(b, bh, value_traits::get_key(x->get_node_ptr()->value),
+                                        bl, blh, br, brh);
+        intersection_since(al, alh, bl, blh, removed);
+        intersection_since(ar, arh, br, brh, removed);
+        if (equal != nullptr) {
+            destroy_node(equal->get_node_ptr());
+            rb_tree_join(al, alh, x, ar, arh);
+        } else {
+            destroy_node(x->get_node_ptr());
+            rb_tree_join2(al, alh, ar, arh);
+        }
+        ++removed;
+        a = al;
+        ah = alh;
+    }
+
+// 子树 a 与 b 求差集，结果存回 a，销毁 b 中的所有节点和 a 中键值与之相同的节点
+    template<class T, class Compare, class Alloc>
+    void rb_tree<T, Compare, Alloc>::
+    difference_since(base_ptr &a, size_type &ah, base_ptr b, size_type bh, size_type &removed) {
+        if (a == nullptr || b == nullptr) {
+            removed += erase_since(b);
+            return;
+        }
+        auto x = b;
+        size_type blh = bh - 1, brh = bh - 1;
+        auto bl = rb_tree_detach(x->left, blh);
+        auto br = rb_tree_detach(x->right, brh);
+        base_ptr al = nullptr, ar = nullptr;
+        size_type alh = 0, arh = 0;
+        auto equal = split_unique_since(a, ah, value_traits::get_key(x->get_node_ptr()->value),
+                                        al, alh, ar, arh);
+        difference_since(al, alh, bl, blh, removed);
+        difference_since(ar, arh, br, brh, removed);
+        destroy_node(x->get_node_ptr());
+        ++removed;
+        if (equal != nullptr) {
+            destroy_node(equal->get_node_ptr());
+            ++removed;
+        }
+        rb_tree_join2(al, alh, ar, arh);
+        a = al;
+        ah = alh;
     }
 
 // 重载比较操作符
-    template<class T, class Compare>
-    bool operator==(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+    template<class T, class Compare, class Alloc>
+    bool operator==(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
         return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template<class T, class Compare>
-    bool operator<(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+    template<class T, class Compare, class Alloc>
+    bool operator<(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
         return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template<class T, class Compare>
-    bool operator!=(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+    template<class T, class Compare, class Alloc>
+    bool operator!=(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
         return !(lhs == rhs);
     }
 
-    template<class T, class Compare>
-    bool operator>(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+    template<class T, class Compare, class Alloc>
+    bool operator>(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
         return rhs < lhs;
     }
 
-    template<class T, class Compare>
-    bool operator<=(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+    template<class T, class Compare, class Alloc>
+    bool operator<=(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
         return !(rhs < lhs);
     }
 
-    template<class T, class Compare>
-    bool operator>=(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+    template<class T, class Compare, class Alloc>
+    bool operator>=(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
         return !(lhs < rhs);
     }
 
 // 重载 mystl 的 swap
-    template<class T, class Compare>
-    void swap(rb_tree<T, Compare> &lhs, rb_tree<T, Compare> &rhs) noexcept {
+    template<class T, class Compare, class Alloc>
+    void swap(rb_tree<T, Compare, Alloc> &lhs, rb_tree<T, Compare, Alloc> &rhs) noexcept {
         lhs.swap(rhs);
     }
 
 
+} // inline namespace MYSTL_RB_TREE_ABI
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,346 @@
+#ifndef MYTINYSTL_SERIALIZE_H_
+#define MYTINYSTL_SERIALIZE_H_
+
+// 这个头文件包含容器的二进制序列化与反序列化
+// binary_writer / binary_reader : 对 std::FILE 的简单封装，读写失败时抛出异常
+// serialize / deserialize       : 支持 vector、deque、list、set、multiset
+
+// notes:
+//
+// 1. 每个容器以一个 serialize_header 开头，记录格式版本、容器种类、元素大小、元素个数
+// 2. 平凡可复制的元素按内存映像保存：
+//    vector 一次写出整段连续空间，deque 逐个缓冲区写出，list / set 先攒成块再写出；
+//    读取时 vector 直接读入预留好的空间，deque 直接读入各个缓冲区
+// 3. 其他元素逐个调用 serialize / deserialize，因此容器可以嵌套，
+//    自定义类型只需在其命名空间中提供这两个函数
+// 4. 数据按本机字节序保存，只保证在相同平台之间通用
+
+#include <cstdio>
+#include <cstdint>
+
+#include "vector.h"
+#include "deque.h"
+#include "list.h"
+#include "set.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // 容器种类
+    enum class serialize_kind : uint16_t {
+        vector = 1,
+        deque = 2,
+        list = 3,
+        set = 4,
+        multiset = 5
+    };
+
+    static constexpr uint32_t serialize_magic = 0x4c53594d;  // "MYSL"
+    static constexpr uint16_t serialize_version = 1;
+
+    // 元素以内存映像保存
+    static constexpr uint32_t serialize_flag_raw = 1u;
+
+    // 每个容器前的头部
+    struct serialize_header {
+        uint32_t magic;      // 标识
+        uint16_t version;    // 格式版本
+        uint16_t kind;       // 容器种类
+        uint32_t elem_size;  // sizeof(value_type)
+        uint32_t flags;      // 见 serialize_flag_*
+        uint64_t count;      // 元素个数
+    };
+
+    // 流式读写时每块的字节数
+    static constexpr size_t serialize_chunk_bytes = 64 * 1024;
+
+    // 二进制写入器，不负责打开和关闭文件
+    class binary_writer {
+    private:
+        std::FILE *fp_;
+
+    public:
+        explicit binary_writer(std::FILE *fp) : fp_(fp) {}
+
+        void write(const void *data, size_t n) {
+            if (n != 0) {
+                THROW_RUNTIME_ERROR_IF(std::fwrite(data, 1, n, fp_) != n, "binary_writer::write() failed");
+            }
+        }
+
+        void flush() {
+            THROW_RUNTIME_ERROR_IF(std::fflush(fp_) != 0, "binary_writer::flush() failed");
+        }
+    };
+
+    // 二进制读取器，不负责打开和关闭文件
+    class binary_reader {
+    private:
+        std::FILE *fp_;
+
+    public:
+        explicit binary_reader(std::FILE *fp) : fp_(fp) {}
+
+        void read(void *data, size_t n) {
+            if (n != 0) {
+                THROW_RUNTIME_ERROR_IF(std::fread(data, 1, n, fp_) != n, "binary_reader::read() unexpected end of data");
+            }
+        }
+    };
+
+/*****************************************************************************************/
+// helper function
+
+    // 元素类型是否按内存映像保存
+    template<class T>
+    struct serialize_is_raw : public m_bool_constant<std::is_trivially_copyable<T>::value> {
+    };
+
+    template<class T>
+    void serialize_write_header(binary_writer &out, serialize_kind kind, size_t count) {
+        serialize_header h;
+        h.magic = serialize_magic;
+        h.version = serialize_version;
+        h.kind = static_cast<uint16_t>(kind);
+        h.elem_size = static_cast<uint32_t>(sizeof(T));
+        h.flags = serialize_is_raw<T>::value ? serialize_flag_raw : 0;
+        h.count = static_cast<uint64_t>(count);
+        out.write(&h, sizeof(h));
+    }
+
+    // 读取并校验头部，返回元素个数
+    template<class T>
+    size_t serialize_read_header(binary_reader &in, serialize_kind kind) {
+        serialize_header h;
+        in.read(&h, sizeof(h));
+        THROW_RUNTIME_ERROR_IF(h.magic != serialize_magic, "deserialize: bad magic");
+        THROW_RUNTIME_ERROR_IF(h.version != serialize_version, "deserialize: unsupported version");
+        THROW_RUNTIME_ERROR_IF(h.kind != static_cast<uint16_t>(kind), "deserialize: container kind mismatch");
+        THROW_RUNTIME_ERROR_IF(h.elem_size != sizeof(T), "deserialize: element size mismatch");
+        THROW_RUNTIME_ERROR_IF(h.flags != (serialize_is_raw<T>::value ? serialize_flag_raw : 0),
+                               "deserialize: element layout mismatch");
+        THROW_RUNTIME_ERROR_IF(h.count > static_cast<uint64_t>(static_cast<size_t>(-1) / sizeof(T)),
+                               "deserialize: element count too large");
+        return static_cast<size_t>(h.count);
+    }
+
+    // 把 [first, last) 的平凡元素攒成块写出，用于不连续存储的容器
+    template<class Iter>
+    void serialize_stream(binary_writer &out, Iter first, Iter last, m_true_type) {
+        typedef typename iterator_traits<Iter>::value_type value_type;
+        const size_t chunk = serialize_chunk_bytes / sizeof(value_type) + 1;
+        value_type *buf = static_cast<value_type *>(::operator new(chunk * sizeof(value_type)));
+        try {
+            while (first != last) {
+                size_t n = 0;
+                for (; n < chunk && first != last; ++n, ++first) {
+                    buf[n] = *first;
+                }
+                out.write(buf, n * sizeof(value_type));
+            }
+        } catch (...) {
+            ::operator delete(buf);
+            throw;
+        }
+        ::operator delete(buf);
+    }
+
+    template<class Iter>
+    void serialize_stream(binary_writer &out, Iter first, Iter last, m_false_type) {
+        for (; first != last; ++first) {
+            serialize(out, *first);
+        }
+    }
+
+    // 从输入中读出 n 个元素，依次交给 put，用于不连续存储的容器
+    template<class T, class Put>
+    void deserialize_stream(binary_reader &in, size_t n, Put put, m_true_type) {
+        const size_t chunk = serialize_chunk_bytes / sizeof(T) + 1;
+        T *buf = static_cast<T *>(::operator new(mystl::min(n, chunk) * sizeof(T)));
+        try {
+            while (n > 0) {
+                const size_t k = mystl::min(n, chunk);
+                in.read(buf, k * sizeof(T));
+                for (size_t i = 0; i < k; ++i) {
+                    put(buf[i]);
+                }
+                n -= k;
+            }
+        } catch (...) {
+            ::operator delete(buf);
+            throw;
+        }
+        ::operator delete(buf);
+    }
+
+    template<class T, class Put>
+    void deserialize_stream(binary_reader &in, size_t n, Put put, m_false_type) {
+        for (; n > 0; --n) {
+            T value;
+            deserialize(in, value);
+            put(value);
+        }
+    }
+
+/*****************************************************************************************/
+// vector
+
+    template<class T, class Alloc>
+    void serialize_vector_data(binary_writer &out, const vector<T, Alloc> &v, m_true_type) {
+        // 整段连续空间一次写出
+        out.write(v.data(), v.size() * sizeof(T));
+    }
+
+    template<class T, class Alloc>
+    void serialize_vector_data(binary_writer &out, const vector<T, Alloc> &v, m_false_type) {
+        for (auto it = v.begin(); it != v.end(); ++it) {
+            serialize(out, *it);
+        }
+    }
+
+    template<class T, class Alloc>
+    void serialize(binary_writer &out, const vector<T, Alloc> &v) {
+        serialize_write_header<T>(out, serialize_kind::vector, v.size());
+        serialize_vector_data(out, v, serialize_is_raw<T>());
+    }
+
+    template<class T, class Alloc>
+    void deserialize_vector_data(binary_reader &in, vector<T, Alloc> &v, size_t n, m_true_type) {
+        // 直接读入预留好的空间，不做逐个构造
+        auto p = v.append_uninitialized(n);
+        try {
+            in.read(p, n * sizeof(T));
+        } catch (...) {
+            v.clear();
+            throw;
+        }
+    }
+
+    template<class T, class Alloc>
+    void deserialize_vector_data(binary_reader &in, vector<T, Alloc> &v, size_t n, m_false_type) {
+        v.reserve(n);
+        for (; n > 0; --n) {
+            T value;
+            deserialize(in, value);
+            v.push_back(mystl::move(value));
+        }
+    }
+
+    template<class T, class Alloc>
+    void deserialize(binary_reader &in, vector<T, Alloc> &v) {
+        const size_t n = serialize_read_header<T>(in, serialize_kind::vector);
+        v.clear();
+        deserialize_vector_data(in, v, n, serialize_is_raw<T>());
+    }
+
+/*****************************************************************************************/
+// deque
+
+    // 对 deque 的每一段连续缓冲区调用 f(first, last)
+    template<class Iter, class Func>
+    void deque_for_each_buffer(Iter first, Iter last, Func f) {
+        while (first.node != last.node) {
+            f(first.cur, first.last);
+            first.set_node(first.node + 1);
+            first.cur = first.first;
+        }
+        f(first.cur, last.cur);
+    }
+
+    template<class T, class Alloc>
+    void serialize_deque_data(binary_writer &out, const deque<T, Alloc> &d, m_true_type) {
+        // 逐个缓冲区写出
+        deque_for_each_buffer(d.begin(), d.end(), [&](const T *first, const T *last) {
+            out.write(first, static_cast<size_t>(last - first) * sizeof(T));
+        });
+    }
+
+    template<class T, class Alloc>
+    void serialize_deque_data(binary_writer &out, const deque<T, Alloc> &d, m_false_type) {
+        for (auto it = d.begin(); it != d.end(); ++it) {
+            serialize(out, *it);
+        }
+    }
+
+    template<class T, class Alloc>
+    void serialize(binary_writer &out, const deque<T, Alloc> &d) {
+        serialize_write_header<T>(out, serialize_kind::deque, d.size());
+        serialize_deque_data(out, d, serialize_is_raw<T>());
+    }
+
+    template<class T, class Alloc>
+    void deserialize_deque_data(binary_reader &in, deque<T, Alloc> &d, size_t n, m_true_type) {
+        // 先追加未初始化的元素（只分配缓冲区），再逐个缓冲区读入
+        auto pos = d.append_uninitialized(n);
+        try {
+            deque_for_each_buffer(pos, d.end(), [&](T *first, T *last) {
+                in.read(first, static_cast<size_t>(last - first) * sizeof(T));
+            });
+        } catch (...) {
+            d.clear();
+            throw;
+        }
+    }
+
+    template<class T, class Alloc>
+    void deserialize_deque_data(binary_reader &in, deque<T, Alloc> &d, size_t n, m_false_type) {
+        deserialize_stream<T>(in, n, [&](T &value) { d.push_back(mystl::move(value)); }, m_false_type());
+    }
+
+    template<class T, class Alloc>
+    void deserialize(binary_reader &in, deque<T, Alloc> &d) {
+        const size_t n = serialize_read_header<T>(in, serialize_kind::deque);
+        d.clear();
+        deserialize_deque_data(in, d, n, serialize_is_raw<T>());
+    }
+
+/*****************************************************************************************/
+// list
+
+    template<class T>
+    void serialize(binary_writer &out, const list<T> &l) {
+        serialize_write_header<T>(out, serialize_kind::list, l.size());
+        serialize_stream(out, l.begin(), l.end(), serialize_is_raw<T>());
+    }
+
+    template<class T>
+    void deserialize(binary_reader &in, list<T> &l) {
+        const size_t n = serialize_read_header<T>(in, serialize_kind::list);
+        l.clear();
+        deserialize_stream<T>(in, n, [&](T &value) { l.push_back(mystl::move(value)); }, serialize_is_raw<T>());
+    }
+
+/*****************************************************************************************/
+// set / multiset
+// 元素按有序顺序写出，读入时总在尾部插入，每次插入都能用上 hint
+
+    template<class Key, class Compare, class Alloc>
+    void serialize(binary_writer &out, const set<Key, Compare, Alloc> &s) {
+        serialize_write_header<Key>(out, serialize_kind::set, s.size());
+        serialize_stream(out, s.begin(), s.end(), serialize_is_raw<Key>());
+    }
+
+    template<class Key, class Compare, class Alloc>
+    void deserialize(binary_reader &in, set<Key, Compare, Alloc> &s) {
+        const size_t n = serialize_read_header<Key>(in, serialize_kind::set);
+        s.clear();
+        deserialize_stream<Key>(in, n, [&](Key &value) { s.insert(s.end(), mystl::move(value)); },
+                                serialize_is_raw<Key>());
+    }
+
+    template<class Key, class Compare, class Alloc>
+    void serialize(binary_writer &out, const multiset<Key, Compare, Alloc> &s) {
+        serialize_write_header<Key>(out, serialize_kind::multiset, s.size());
+        serialize_stream(out, s.begin(), s.end(), serialize_is_raw<Key>());
+    }
+
+    template<class Key, class Compare, class Alloc>
+    void deserialize(binary_reader &in, multiset<Key, Compare, Alloc> &s) {
+        const size_t n = serialize_read_header<Key>(in, serialize_kind::multiset);
+        s.clear();
+        deserialize_stream<Key>(in, n, [&](Key &value) { s.insert(s.end(), mystl::move(value)); },
+                                serialize_is_raw<Key>());
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_SERIALIZE_H_
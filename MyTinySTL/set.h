@@ -12,13 +12,26 @@
 //   * emplace
 //   * emplace_hint
 //   * insert
+//
+// 分裂与合并：
+// extract、insert(node_handle)、merge、split、join 和 set_union / set_intersection / set_difference 在树之间直接转移节点，
+// 不复制元素；交换过节点的容器共用同一个节点池，它们不能在不同线程中同时修改
+//
+// 异构查找：
+// 比较函数定义了 is_transparent 时，find、count、lower_bound、upper_bound、equal_range、erase
+// 可以直接接受能与键值比较的其他类型，不构造临时的键值
 
 #include "rb_tree.h"
 
 namespace mystl {
+inline namespace MYSTL_RB_TREE_ABI {
+    template<class Key, class Compare, class Alloc>
+    class multiset;
+
     // 模板类set，键值不允许重复
     // 参数一代表键值类型，参数二代表键值比较方式，缺省使用mystl::less
-    template<class Key, class Compare = mystl::less<Key>>
+    // 参数三代表节点池的空间配置器，节点多时可换成 mystl::huge_page_allocator
+    template<class Key, class Compare = mystl::less<Key>, class Alloc = mystl::allocator<Key>>
     class set {
     public:
         typedef Key key_type;
@@ -27,7 +40,7 @@ namespace mystl {
         typedef Compare value_compare;
     private:
         // 以 mystl::rb_tree作为底层机制
-        typedef mystl::rb_tree<value_type, key_compare> base_type;
+        typedef mystl::rb_tree<value_type, key_compare, Alloc> base_type;
         base_type tree_;
 
     public:
@@ -44,6 +57,9 @@ namespace mystl {
         typedef typename base_type::size_type size_type;
         typedef typename base_type::difference_type difference_type;
         typedef typename base_type::allocator_type allocator_type;
+        typedef typename base_type::node_handle node_handle;
+
+        friend class multiset<Key, Compare, Alloc>;
 
     public:
         // 构造、复制、移动函数
@@ -51,7 +67,7 @@ namespace mystl {
 
         template<class InputIterator>
         set(InputIterator first, InputIterator last) :tree_() {
-            // 不重复的插入
+            // 不重复的插入，输入有序时以 O(n) 直接建树
             tree_.insert_unique(first, last);
         }
 
@@ -151,6 +167,12 @@ namespace mystl {
             tree_.insert_unique(first, last);
         }
 
+        // 插入一批有序的元素，每个元素从上一个插入点出发查找，适合持续插入单调递增的键值
+        template<class InputIterator>
+        void insert_sorted_batch(InputIterator first, InputIterator last) {
+            tree_.insert_sorted_batch_unique(first, last);
+        }
+
         void erase(iterator position) { tree_.erase(position); }
 
         size_type erase(const key_type &key) { return tree_.erase_unique(key); }
@@ -159,12 +181,35 @@ namespace mystl {
 
         void clear() { tree_.clear(); }
 
+        // 节点的摘下与重新插入，元素在容器之间转移时不分配空间也不复制元素
+        // extract 返回持有节点的 node_handle，insert 插入失败时节点仍留在 nh 中
+        node_handle extract(iterator position) { return tree_.extract(position); }
+
+        node_handle extract(const key_type &key) { return tree_.extract(key); }
+
+        pair<iterator, bool> insert(node_handle &&nh) { return tree_.insert_node_unique(mystl::move(nh)); }
+
+        // merge 转移 source 中键值不在本 set 中的节点，其余节点留在 source 中
+        void merge(set &source) { tree_.merge_unique(source.tree_, true); }
+
+        void merge(set &&source) { tree_.merge_unique(source.tree_, true); }
+
+        void merge(multiset<Key, Compare, Alloc> &source) { tree_.merge_unique(source.tree_, false); }
+
+        void merge(multiset<Key, Compare, Alloc> &&source) { tree_.merge_unique(source.tree_, false); }
+
         // set 相关操作
 
         iterator find(const key_type &key) { return tree_.find(key); }
 
         const_iterator find(const key_type &key) const { return tree_.find(key); }
 
+        // 批量查找，多个查找交错进行以隐藏访存延迟，结果依次写入 result
+        template<class ForwardIter, class OutputIter>
+        OutputIter find_many(ForwardIter first, ForwardIter last, OutputIter result) const {
+            return tree_.find_many(first, last, result);
+        }
+
         size_type count(const key_type &key) const { return tree_.count_unique(key); }
 
         iterator lower_bound(const key_type &key) { return tree_.lower_bound(key); }
@@ -181,8 +226,77 @@ namespace mystl {
         pair<const_iterator, const_iterator>
         equal_range(const key_type &key) const { return tree_.equal_range_unique(key); }
 
+        // 异构查找，比较函数定义了 is_transparent 时可用
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type erase(const K &key) { return tree_.erase_unique(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator find(const K &key) { return tree_.find(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator find(const K &key) const { return tree_.find(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type count(const K &key) const { return tree_.count_unique(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator lower_bound(const K &key) { return tree_.lower_bound(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator lower_bound(const K &key) const { return tree_.lower_bound(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator upper_bound(const K &key) { return tree_.upper_bound(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator upper_bound(const K &key) const { return tree_.upper_bound(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        pair<iterator, iterator>
+        equal_range(const K &key) { return tree_.equal_range_unique(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        pair<const_iterator, const_iterator>
+        equal_range(const K &key) const { return tree_.equal_range_unique(key); }
+
+        // 顺序统计，定义 MYSTL_RB_TREE_ORDER_STATISTICS 时为 O(logn)
+        // nth(k) 返回第 k 小（从 0 开始）的元素，rank(key) 返回小于 key 的元素个数
+        const_iterator nth(size_type k) const noexcept { return tree_.nth(k); }
+
+        size_type rank(const key_type &key) const { return tree_.rank(key); }
+
+        // 分裂与合并
+        // split(key) 返回键值小于 key 和不小于 key 的两个 set，本 set 变为空，O(logn)
+        // join(rhs) 把 rhs 的元素并入本 set，rhs 变为空，两者的键值区间不相交时为 O(logn)
+        pair<set, set> split(const key_type &key) {
+            auto trees = tree_.split(key);
+            return mystl::make_pair(set(mystl::move(trees.first)), set(mystl::move(trees.second)));
+        }
+
+        void join(set &rhs) { tree_.join_unique(rhs.tree_); }
+
+        // 集合运算，结果留在本 set，rhs 变为空，O(mlog(n/m + 1))，m 为较小的一个 set 的大小
+        void union_with(set &rhs) { tree_.union_unique(rhs.tree_); }
+
+        void intersection_with(set &rhs) { tree_.intersection_unique(rhs.tree_); }
+
+        void difference_with(set &rhs) { tree_.difference_unique(rhs.tree_); }
+
         void swap(set &rhs) noexcept { tree_.swap(rhs.tree_); }
 
+    private:
+        explicit set(base_type &&tree) : tree_(mystl::move(tree)) {}
+
     public:
         friend bool operator==(const set &lhs, const set &rhs) { return lhs.tree_ == rhs.tree_; }
 
@@ -190,47 +304,72 @@ namespace mystl {
     };
 
     // 重载比较操作符
-    template<class Key, class Compare>
-    bool operator==(const set<Key, Compare> &lhs, const set<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator==(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
         return lhs == rhs;
     }
 
-    template<class Key, class Compare>
-    bool operator<(const set<Key, Compare> &lhs, const set<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator<(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
         return lhs < rhs;
     }
 
-    template<class Key, class Compare>
-    bool operator!=(const set<Key, Compare> &lhs, const set<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator!=(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
         return !(lhs == rhs);
     }
 
-    template<class Key, class Compare>
-    bool operator>(const set<Key, Compare> &lhs, const set<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator>(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
         return rhs < lhs;
     }
 
-    template<class Key, class Compare>
-    bool operator<=(const set<Key, Compare> &lhs, const set<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator<=(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
         return !(rhs < lhs);
     }
 
-    template<class Key, class Compare>
-    bool operator>=(const set<Key, Compare> &lhs, const set<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator>=(const set<Key, Compare, Alloc> &lhs, const set<Key, Compare, Alloc> &rhs) {
         return !(lhs < rhs);
     }
 
 // 重载 mystl 的 swap
-    template<class Key, class Compare>
-    void swap(set<Key, Compare> &lhs, set<Key, Compare> &rhs) noexcept {
+    template<class Key, class Compare, class Alloc>
+    void swap(set<Key, Compare, Alloc> &lhs, set<Key, Compare, Alloc> &rhs) noexcept {
         lhs.swap(rhs);
     }
 
+// 合并两个 set 及集合运算，参数按值传入：需要保留原 set 时传入副本，否则用 mystl::move 转移
+    template<class Key, class Compare, class Alloc>
+    set<Key, Compare, Alloc> join(set<Key, Compare, Alloc> lhs, set<Key, Compare, Alloc> rhs) {
+        lhs.join(rhs);
+        return lhs;
+    }
+
+    template<class Key, class Compare, class Alloc>
+    set<Key, Compare, Alloc> set_union(set<Key, Compare, Alloc> lhs, set<Key, Compare, Alloc> rhs) {
+        lhs.union_with(rhs);
+        return lhs;
+    }
+
+    template<class Key, class Compare, class Alloc>
+    set<Key, Compare, Alloc> set_intersection(set<Key, Compare, Alloc> lhs, set<Key, Compare, Alloc> rhs) {
+        lhs.intersection_with(rhs);
+        return lhs;
+    }
+
+    template<class Key, class Compare, class Alloc>
+    set<Key, Compare, Alloc> set_difference(set<Key, Compare, Alloc> lhs, set<Key, Compare, Alloc> rhs) {
+        lhs.difference_with(rhs);
+        return lhs;
+    }
+
 /*****************************************************************************************/
 
 // 模板类 multiset，键值允许重复
-// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less
-    template<class Key, class Compare = mystl::less<Key>>
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，参数三代表节点池的空间配置器
+    template<class Key, class Compare = mystl::less<Key>, class Alloc = mystl::allocator<Key>>
     class multiset {
     public:
         typedef Key key_type;
@@ -240,7 +379,7 @@ namespace mystl {
 
     private:
         // 以 mystl::rb_tree 作为底层机制
-        typedef mystl::rb_tree<value_type, key_compare> base_type;
+        typedef mystl::rb_tree<value_type, key_compare, Alloc> base_type;
         base_type tree_;  // 以 rb_tree 表现 multiset
 
     public:
@@ -257,6 +396,9 @@ namespace mystl {
         typedef typename base_type::size_type size_type;
         typedef typename base_type::difference_type difference_type;
         typedef typename base_type::allocator_type allocator_type;
+        typedef typename base_type::node_handle node_handle;
+
+        friend class set<Key, Compare, Alloc>;
 
     public:
         // 构造、复制、移动函数
@@ -264,7 +406,10 @@ namespace mystl {
 
         template<class InputIterator>
         multiset(InputIterator first, InputIterator last)
-                :tree_() { tree_.insert_multi(first, last); }
+                :tree_() {
+            // 输入有序时以 O(n) 直接建树
+            tree_.insert_multi(first, last);
+        }
 
         multiset(std::initializer_list<value_type> ilist)
                 : tree_() { tree_.insert_multi(ilist.begin(), ilist.end()); }
@@ -367,6 +512,12 @@ namespace mystl {
             tree_.insert_multi(first, last);
         }
 
+        // 插入一批有序的元素，每个元素从上一个插入点出发查找，适合持续插入单调递增的键值
+        template<class InputIterator>
+        void insert_sorted_batch(InputIterator first, InputIterator last) {
+            tree_.insert_sorted_batch_multi(first, last);
+        }
+
         void erase(iterator position) { tree_.erase(position); }
 
         size_type erase(const key_type &key) { return tree_.erase_multi(key); }
@@ -375,12 +526,34 @@ namespace mystl {
 
         void clear() { tree_.clear(); }
 
+        // 节点的摘下与重新插入，元素在容器之间转移时不分配空间也不复制元素
+        node_handle extract(iterator position) { return tree_.extract(position); }
+
+        node_handle extract(const key_type &key) { return tree_.extract(key); }
+
+        iterator insert(node_handle &&nh) { return tree_.insert_node_multi(mystl::move(nh)); }
+
+        // merge 转移 source 中的所有节点
+        void merge(multiset &source) { tree_.merge_multi(source.tree_); }
+
+        void merge(multiset &&source) { tree_.merge_multi(source.tree_); }
+
+        void merge(set<Key, Compare, Alloc> &source) { tree_.merge_multi(source.tree_); }
+
+        void merge(set<Key, Compare, Alloc> &&source) { tree_.merge_multi(source.tree_); }
+
         // multiset 相关操作
 
         iterator find(const key_type &key) { return tree_.find(key); }
 
         const_iterator find(const key_type &key) const { return tree_.find(key); }
 
+        // 批量查找，多个查找交错进行以隐藏访存延迟，结果依次写入 result
+        template<class ForwardIter, class OutputIter>
+        OutputIter find_many(ForwardIter first, ForwardIter last, OutputIter result) const {
+            return tree_.find_many(first, last, result);
+        }
+
         size_type count(const key_type &key) const { return tree_.count_multi(key); }
 
         iterator lower_bound(const key_type &key) { return tree_.lower_bound(key); }
@@ -397,8 +570,70 @@ namespace mystl {
         pair<const_iterator, const_iterator>
         equal_range(const key_type &key) const { return tree_.equal_range_multi(key); }
 
+        // 异构查找，比较函数定义了 is_transparent 时可用
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type erase(const K &key) { return tree_.erase_multi(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator find(const K &key) { return tree_.find(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator find(const K &key) const { return tree_.find(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type count(const K &key) const { return tree_.count_multi(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator lower_bound(const K &key) { return tree_.lower_bound(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator lower_bound(const K &key) const { return tree_.lower_bound(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator upper_bound(const K &key) { return tree_.upper_bound(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator upper_bound(const K &key) const { return tree_.upper_bound(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        pair<iterator, iterator>
+        equal_range(const K &key) { return tree_.equal_range_multi(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        pair<const_iterator, const_iterator>
+        equal_range(const K &key) const { return tree_.equal_range_multi(key); }
+
+        // 顺序统计，定义 MYSTL_RB_TREE_ORDER_STATISTICS 时为 O(logn)
+        // nth(k) 返回第 k 小（从 0 开始）的元素，rank(key) 返回小于 key 的元素个数
+        const_iterator nth(size_type k) const noexcept { return tree_.nth(k); }
+
+        size_type rank(const key_type &key) const { return tree_.rank(key); }
+
+        // 分裂与合并
+        // split(key) 返回键值小于 key 和不小于 key 的两个 multiset，本 multiset 变为空，O(logn)
+        // join(rhs) 把 rhs 的元素并入本 multiset，rhs 变为空，两者的键值区间不相交时为 O(logn)
+        pair<multiset, multiset> split(const key_type &key) {
+            auto trees = tree_.split(key);
+            return mystl::make_pair(multiset(mystl::move(trees.first)), multiset(mystl::move(trees.second)));
+        }
+
+        void join(multiset &rhs) { tree_.join_multi(rhs.tree_); }
+
         void swap(multiset &rhs) noexcept { tree_.swap(rhs.tree_); }
 
+    private:
+        explicit multiset(base_type &&tree) : tree_(mystl::move(tree)) {}
+
     public:
         friend bool operator==(const multiset &lhs, const multiset &rhs) { return lhs.tree_ == rhs.tree_; }
 
@@ -406,41 +641,49 @@ namespace mystl {
     };
 
     // 重载比较操作符
-    template<class Key, class Compare>
-    bool operator==(const multiset<Key, Compare> &lhs, const multiset<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator==(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
         return lhs == rhs;
     }
 
-    template<class Key, class Compare>
-    bool operator<(const multiset<Key, Compare> &lhs, const multiset<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator<(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
         return lhs < rhs;
     }
 
-    template<class Key, class Compare>
-    bool operator!=(const multiset<Key, Compare> &lhs, const multiset<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator!=(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
         return !(lhs == rhs);
     }
 
-    template<class Key, class Compare>
-    bool operator>(const multiset<Key, Compare> &lhs, const multiset<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator>(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
         return rhs < lhs;
     }
 
-    template<class Key, class Compare>
-    bool operator<=(const multiset<Key, Compare> &lhs, const multiset<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator<=(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
         return !(rhs < lhs);
     }
 
-    template<class Key, class Compare>
-    bool operator>=(const multiset<Key, Compare> &lhs, const multiset<Key, Compare> &rhs) {
+    template<class Key, class Compare, class Alloc>
+    bool operator>=(const multiset<Key, Compare, Alloc> &lhs, const multiset<Key, Compare, Alloc> &rhs) {
         return !(lhs < rhs);
     }
 
 // 重载 mystl 的 swap
-    template<class Key, class Compare>
-    void swap(multiset<Key, Compare> &lhs, multiset<Key, Compare> &rhs) noexcept {
+    template<class Key, class Compare, class Alloc>
+    void swap(multiset<Key, Compare, Alloc> &lhs, multiset<Key, Compare, Alloc> &rhs) noexcept {
         lhs.swap(rhs);
     }
+
+// 合并两个 multiset，参数按值传入
+    template<class Key, class Compare, class Alloc>
+    multiset<Key, Compare, Alloc> join(multiset<Key, Compare, Alloc> lhs, multiset<Key, Compare, Alloc> rhs) {
+        lhs.join(rhs);
+        return lhs;
+    }
+} // inline namespace MYSTL_RB_TREE_ABI
 }
 #endif
 
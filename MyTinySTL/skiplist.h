@@ -0,0 +1,770 @@
+#ifndef MYTINYSTL_SKIPLIST_H_
+#define MYTINYSTL_SKIPLIST_H_
+
+// 这个头文件包含一个模板类 skiplist_set
+// skiplist_set : 以跳表实现的有序集合，接口与 set 相同，键值不允许重复
+
+// notes:
+//
+// 1. 节点的塔（各层后继指针）与值放在同一块内存中，值在前、塔在后，插入一个元素只分配一次；
+//    节点指针指向 skiplist_node_base，值位于其前方固定的偏移处，塔紧接在其后
+// 2. 塔高按 1/P 的概率逐层增加，P 为模板参数，缺省为 4：P 越大，平均塔高 P/(P-1) 越低、节点越小，
+//    但查找时每层平均要多走几步；P = 2 时比较次数最少
+// 3. 各层都是以内嵌在 skiplist_set 中的头节点为哨兵的环，第 0 层另有前驱指针，迭代器为双向迭代器，
+//    end() 指向头节点；移动、交换时需要把各层最后一个节点改为指向新的头节点，代价为 O(logn)
+// 4. 范围扫描只沿第 0 层前进，不需要像红黑树那样回溯父节点；区间删除只查找一次前驱，O(logn + k)
+// 5. 支持并发插入、查找的版本见 concurrent_set.h
+//
+// 异常保证：
+// mystl::skiplist_set<Key> 满足基本异常保证，对以下等函数做强异常安全保证：
+//   * emplace
+//   * emplace_hint
+//   * insert
+
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include "functional.h"
+#include "algobase.h"
+#include "iterator.h"
+#include "construct.h"
+#include "type_traits.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // 随机塔高，以 xorshift64 生成随机数，每层以 1/P 的概率继续增高
+    template<unsigned int P>
+    unsigned int skiplist_random_height(uint64_t &state, unsigned int max_height) noexcept {
+        static_assert(P >= 2, "skiplist level probability 1/P requires P >= 2");
+        unsigned int height = 1;
+        while (height < max_height) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            if (state % P != 0) {
+                break;
+            }
+            ++height;
+        }
+        return height;
+    }
+
+    // 跳表节点的第 0 层前驱与塔高，长度为 height 的塔（各层后继指针）紧接在其后
+    struct skiplist_node_base {
+        skiplist_node_base *prev;
+        unsigned int height;
+
+        skiplist_node_base **next() noexcept {
+            return reinterpret_cast<skiplist_node_base **>(this + 1);
+        }
+    };
+
+    // 跳表节点的内存布局：[value][skiplist_node_base + 塔]
+    template<class T>
+    struct skiplist_node {
+        typedef skiplist_node_base *base_ptr;
+
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned value type is not supported");
+
+        // 值到塔的偏移，sizeof(T) 向上取整到塔的对齐
+        static constexpr size_t value_offset =
+                (sizeof(T) + alignof(skiplist_node_base) - 1) / alignof(skiplist_node_base) * alignof(skiplist_node_base);
+
+        static size_t bytes(unsigned int height) noexcept {
+            return value_offset + sizeof(skiplist_node_base) + height * sizeof(base_ptr);
+        }
+
+        static T *value_ptr(base_ptr x) noexcept {
+            return reinterpret_cast<T *>(reinterpret_cast<char *>(x) - value_offset);
+        }
+
+        static void *raw(base_ptr x) noexcept {
+            return reinterpret_cast<char *>(x) - value_offset;
+        }
+
+        static base_ptr from_raw(void *p) noexcept {
+            return reinterpret_cast<base_ptr>(static_cast<char *>(p) + value_offset);
+        }
+    };
+
+    template<class T>
+    constexpr size_t skiplist_node<T>::value_offset;
+
+    // skiplist_set 的迭代器，元素不可修改
+    template<class T>
+    struct skiplist_iterator : public iterator<bidirectional_iterator_tag, T> {
+        typedef skiplist_node_base *base_ptr;
+        typedef skiplist_iterator<T> self;
+
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+        typedef ptrdiff_t difference_type;
+
+        base_ptr node;
+
+        skiplist_iterator() noexcept: node(nullptr) {}
+
+        explicit skiplist_iterator(base_ptr x) noexcept: node(x) {}
+
+        reference operator*() const { return *skiplist_node<T>::value_ptr(node); }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self &operator++() {
+            node = node->next()[0];
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self &operator--() {
+            node = node->prev;
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return node == rhs.node; }
+
+        bool operator!=(const self &rhs) const { return node != rhs.node; }
+    };
+
+    // 模板类 skiplist_set，键值不允许重复
+    // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，
+    // 参数三为塔高每层继续增高的概率的倒数，缺省为 4
+    template<class Key, class Compare = mystl::less<Key>, unsigned int P = 4>
+    class skiplist_set {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+
+        typedef const Key *pointer;
+        typedef const Key *const_pointer;
+        typedef const Key &reference;
+        typedef const Key &const_reference;
+        typedef skiplist_iterator<Key> iterator;
+        typedef skiplist_iterator<Key> const_iterator;
+        typedef mystl::reverse_iterator<iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        static constexpr unsigned int max_height = 32;
+        static constexpr unsigned int level_probability_inverse = P;
+
+    private:
+        typedef skiplist_node_base *base_ptr;
+        typedef skiplist_node<Key> node_traits;
+
+        static_assert(P >= 2, "skiplist_set level probability 1/P requires P >= 2");
+
+        // 头节点，塔的长度为 max_height
+        struct head_node {
+            skiplist_node_base base;
+            base_ptr tower[max_height];
+        };
+
+        static_assert(offsetof(head_node, tower) == sizeof(skiplist_node_base),
+                      "skiplist_set head tower must follow the node base");
+
+        head_node head_;
+        unsigned int height_;   // 当前使用的层数
+        size_type size_;
+        key_compare key_comp_;
+        uint64_t seed_;         // 随机塔高的状态
+
+    public:
+        // 构造、复制、移动、析构函数
+        skiplist_set() noexcept(std::is_nothrow_default_constructible<Compare>::value)
+                : height_(1), size_(0), key_comp_(), seed_(0x9E3779B97F4A7C15ULL) {
+            reset_head();
+        }
+
+        explicit skiplist_set(const key_compare &comp)
+                : height_(1), size_(0), key_comp_(comp), seed_(0x9E3779B97F4A7C15ULL) {
+            reset_head();
+        }
+
+        template<class InputIterator>
+        skiplist_set(InputIterator first, InputIterator last) : skiplist_set() {
+            insert(first, last);
+        }
+
+        skiplist_set(std::initializer_list<value_type> ilist) : skiplist_set() {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        skiplist_set(const skiplist_set &rhs) : skiplist_set(rhs.key_comp_) {
+            copy_from(rhs);
+        }
+
+        skiplist_set(skiplist_set &&rhs) noexcept
+                : height_(1), size_(0), key_comp_(mystl::move(rhs.key_comp_)), seed_(rhs.seed_) {
+            reset_head();
+            take_from(rhs);
+        }
+
+        skiplist_set &operator=(const skiplist_set &rhs) {
+            if (this != &rhs) {
+                skiplist_set tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        skiplist_set &operator=(skiplist_set &&rhs) noexcept {
+            if (this != &rhs) {
+                clear();
+                key_comp_ = mystl::move(rhs.key_comp_);
+                take_from(rhs);
+            }
+            return *this;
+        }
+
+        skiplist_set &operator=(std::initializer_list<value_type> ilist) {
+            skiplist_set tmp(ilist);
+            swap(tmp);
+            return *this;
+        }
+
+        ~skiplist_set() { clear(); }
+
+        key_compare key_comp() const { return key_comp_; }
+
+        value_compare value_comp() const { return key_comp_; }
+
+        // 迭代器相关
+        iterator begin() noexcept { return iterator(head()->next()[0]); }
+
+        const_iterator begin() const noexcept { return const_iterator(head()->next()[0]); }
+
+        iterator end() noexcept { return iterator(head()); }
+
+        const_iterator end() const noexcept { return const_iterator(head()); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return size_ == 0; }
+
+        size_type size() const noexcept { return size_; }
+
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / node_traits::bytes(max_height); }
+
+        // 插入删除操作
+        template<class ...Args>
+        pair<iterator, bool> emplace(Args &&...args);
+
+        // 跳表的前驱只能从头节点查起，hint 仅为与 set 的接口一致
+        template<class ...Args>
+        iterator emplace_hint(iterator, Args &&...args) {
+            return emplace(mystl::forward<Args>(args)...).first;
+        }
+
+        pair<iterator, bool> insert(const value_type &value) {
+            return insert_value(value);
+        }
+
+        pair<iterator, bool> insert(value_type &&value) {
+            return insert_value(mystl::move(value));
+        }
+
+        iterator insert(iterator, const value_type &value) {
+            return insert_value(value).first;
+        }
+
+        iterator insert(iterator, value_type &&value) {
+            return insert_value(mystl::move(value)).first;
+        }
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            for (; first != last; ++first)
+                insert_value(*first);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        void erase(iterator position) {
+            auto last = position;
+            ++last;
+            erase(position, last);
+        }
+
+        size_type erase(const key_type &key) { return erase_key(key); }
+
+        void erase(iterator first, iterator last);
+
+        void clear() noexcept;
+
+        // skiplist_set 相关操作
+        iterator find(const key_type &key) { return iterator(find_node(key)); }
+
+        const_iterator find(const key_type &key) const { return const_iterator(find_node(key)); }
+
+        size_type count(const key_type &key) const { return find_node(key) != head() ? 1 : 0; }
+
+        bool contains(const key_type &key) const { return find_node(key) != head(); }
+
+        iterator lower_bound(const key_type &key) { return iterator(lower_bound_node(key)); }
+
+        const_iterator lower_bound(const key_type &key) const { return const_iterator(lower_bound_node(key)); }
+
+        iterator upper_bound(const key_type &key) { return iterator(upper_bound_node(key)); }
+
+        const_iterator upper_bound(const key_type &key) const { return const_iterator(upper_bound_node(key)); }
+
+        pair<iterator, iterator>
+        equal_range(const key_type &key) { return equal_range_node(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const { return equal_range_node(key); }
+
+        // 异构查找，比较函数定义了 is_transparent 时可用
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type erase(const K &key) { return erase_key(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator find(const K &key) { return iterator(find_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator find(const K &key) const { return const_iterator(find_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        size_type count(const K &key) const { return find_node(key) != head() ? 1 : 0; }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator lower_bound(const K &key) { return iterator(lower_bound_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator lower_bound(const K &key) const { return const_iterator(lower_bound_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        iterator upper_bound(const K &key) { return iterator(upper_bound_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        const_iterator upper_bound(const K &key) const { return const_iterator(upper_bound_node(key)); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        pair<iterator, iterator>
+        equal_range(const K &key) { return equal_range_node(key); }
+
+        template<class K, class C = key_compare,
+                typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+        pair<const_iterator, const_iterator>
+        equal_range(const K &key) const { return equal_range_node(key); }
+
+        void swap(skiplist_set &rhs) noexcept;
+
+    private:
+        // helper functions
+        base_ptr head() const noexcept { return const_cast<base_ptr>(&head_.base); }
+
+        static const key_type &value_of(base_ptr x) noexcept { return *node_traits::value_ptr(x); }
+
+        void reset_head() noexcept;
+
+        // 查找每一层最后一个小于 key 的节点，写入 preds[0, height_)，返回第一个不小于 key 的节点
+        template<class K>
+        base_ptr find_preds(const K &key, base_ptr *preds) const;
+
+        template<class K>
+        base_ptr lower_bound_node(const K &key) const;
+
+        template<class K>
+        base_ptr upper_bound_node(const K &key) const {
+            auto x = lower_bound_node(key);
+            return x != head() && !key_comp_(key, value_of(x)) ? x->next()[0] : x;
+        }
+
+        template<class K>
+        base_ptr find_node(const K &key) const {
+            auto x = lower_bound_node(key);
+            return x == head() || key_comp_(key, value_of(x)) ? head() : x;
+        }
+
+        template<class K>
+        pair<iterator, iterator> equal_range_node(const K &key) const {
+            auto x = lower_bound_node(key);
+            auto y = x != head() && !key_comp_(key, value_of(x)) ? x->next()[0] : x;
+            return mystl::make_pair(iterator(x), iterator(y));
+        }
+
+        template<class V>
+        pair<iterator, bool> insert_value(V &&value);
+
+        template<class K>
+        size_type erase_key(const K &key);
+
+        // 把节点 x 链入 preds 之后，节点 x 的塔高不超过 height_
+        void link_node(base_ptr x, base_ptr *preds) noexcept;
+
+        // 从 preds 之后摘下节点 x，preds 在此之后仍是 x 的后继的前驱
+        void unlink_node(base_ptr x, base_ptr *preds) noexcept;
+
+        void shrink_height() noexcept;
+
+        void copy_from(const skiplist_set &rhs);
+
+        // 接管 rhs 的所有节点，本 skiplist_set 须为空，rhs 变为空
+        void take_from(skiplist_set &rhs) noexcept;
+
+        template<class ...Args>
+        base_ptr create_node(unsigned int height, Args &&...args);
+
+        static void destroy_node(base_ptr x) noexcept;
+
+    public:
+        friend bool operator==(const skiplist_set &lhs, const skiplist_set &rhs) {
+            return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator<(const skiplist_set &lhs, const skiplist_set &rhs) {
+            return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+    };
+
+    template<class Key, class Compare, unsigned int P>
+    constexpr unsigned int skiplist_set<Key, Compare, P>::max_height;
+
+    template<class Key, class Compare, unsigned int P>
+    constexpr unsigned int skiplist_set<Key, Compare, P>::level_probability_inverse;
+
+/*****************************************************************************************/
+
+// 就地构造元素，键值已存在时销毁新元素并返回已有的元素
+    template<class Key, class Compare, unsigned int P>
+    template<class ...Args>
+    pair<typename skiplist_set<Key, Compare, P>::iterator, bool>
+    skiplist_set<Key, Compare, P>::
+    emplace(Args &&...args) {
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "skiplist_set<Key, Comp>'s size too big");
+        auto x = create_node(skiplist_random_height<P>(seed_, max_height), mystl::forward<Args>(args)...);
+        base_ptr preds[max_height];
+        auto y = find_preds(value_of(x), preds);
+        if (y != head() && !key_comp_(value_of(x), value_of(y))) {
+            destroy_node(x);
+            return mystl::make_pair(iterator(y), false);
+        }
+        for (; height_ < x->height; ++height_) {
+            preds[height_] = head();
+        }
+        link_node(x, preds);
+        return mystl::make_pair(iterator(x), true);
+    }
+
+// 删除 [first, last) 内的元素，区间内的节点在各层都是连续的，删除过程中 first 的前驱保持不变
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    erase(iterator first, iterator last) {
+        if (first == begin() && last == end()) {
+            clear();
+            return;
+        }
+        if (first == last) {
+            return;
+        }
+        base_ptr preds[max_height];
+        find_preds(*first, preds);
+        while (first != last) {
+            auto x = first.node;
+            ++first;
+            unlink_node(x, preds);
+            destroy_node(x);
+        }
+        shrink_height();
+    }
+
+// 清空 skiplist_set
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    clear() noexcept {
+        auto x = head_.base.next()[0];
+        while (x != head()) {
+            auto next = x->next()[0];
+            destroy_node(x);
+            x = next;
+        }
+        reset_head();
+        height_ = 1;
+        size_ = 0;
+    }
+
+// 交换两个 skiplist_set，各层最后一个节点改为指向新的头节点
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    swap(skiplist_set &rhs) noexcept {
+        if (this != &rhs) {
+            skiplist_set tmp(mystl::move(rhs));
+            rhs.key_comp_ = mystl::move(key_comp_);
+            rhs.take_from(*this);
+            key_comp_ = mystl::move(tmp.key_comp_);
+            take_from(tmp);
+        }
+    }
+
+/*****************************************************************************************/
+// helper function
+
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    reset_head() noexcept {
+        head_.base.prev = head();
+        head_.base.height = max_height;
+        for (unsigned int i = 0; i < max_height; ++i) {
+            head_.base.next()[i] = head();
+        }
+    }
+
+// 从最高层开始，每层向右走到最后一个小于 key 的节点，再下降一层
+    template<class Key, class Compare, unsigned int P>
+    template<class K>
+    typename skiplist_set<Key, Compare, P>::base_ptr
+    skiplist_set<Key, Compare, P>::
+    find_preds(const K &key, base_ptr *preds) const {
+        auto x = head();
+        for (unsigned int i = height_; i > 0; --i) {
+            auto y = x->next()[i - 1];
+            while (y != head() && key_comp_(value_of(y), key)) {
+                x = y;
+                y = x->next()[i - 1];
+            }
+            preds[i - 1] = x;
+        }
+        return x->next()[0];
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    template<class K>
+    typename skiplist_set<Key, Compare, P>::base_ptr
+    skiplist_set<Key, Compare, P>::
+    lower_bound_node(const K &key) const {
+        auto x = head();
+        for (unsigned int i = height_; i > 0; --i) {
+            auto y = x->next()[i - 1];
+            while (y != head() && key_comp_(value_of(y), key)) {
+                x = y;
+                y = x->next()[i - 1];
+            }
+        }
+        return x->next()[0];
+    }
+
+// 插入元素，键值已存在时不构造新节点
+    template<class Key, class Compare, unsigned int P>
+    template<class V>
+    pair<typename skiplist_set<Key, Compare, P>::iterator, bool>
+    skiplist_set<Key, Compare, P>::
+    insert_value(V &&value) {
+        base_ptr preds[max_height];
+        auto y = find_preds(value, preds);
+        if (y != head() && !key_comp_(value, value_of(y))) {
+            return mystl::make_pair(iterator(y), false);
+        }
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "skiplist_set<Key, Comp>'s size too big");
+        auto x = create_node(skiplist_random_height<P>(seed_, max_height), mystl::forward<V>(value));
+        for (; height_ < x->height; ++height_) {
+            preds[height_] = head();
+        }
+        link_node(x, preds);
+        return mystl::make_pair(iterator(x), true);
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    template<class K>
+    typename skiplist_set<Key, Compare, P>::size_type
+    skiplist_set<Key, Compare, P>::
+    erase_key(const K &key) {
+        base_ptr preds[max_height];
+        auto x = find_preds(key, preds);
+        if (x == head() || key_comp_(key, value_of(x))) {
+            return 0;
+        }
+        unlink_node(x, preds);
+        destroy_node(x);
+        shrink_height();
+        return 1;
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    link_node(base_ptr x, base_ptr *preds) noexcept {
+        for (unsigned int i = 0; i < x->height; ++i) {
+            x->next()[i] = preds[i]->next()[i];
+            preds[i]->next()[i] = x;
+        }
+        x->prev = preds[0];
+        x->next()[0]->prev = x;
+        ++size_;
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    unlink_node(base_ptr x, base_ptr *preds) noexcept {
+        for (unsigned int i = 0; i < x->height; ++i) {
+            preds[i]->next()[i] = x->next()[i];
+        }
+        x->next()[0]->prev = x->prev;
+        --size_;
+    }
+
+// 去掉顶部已经没有节点的层
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    shrink_height() noexcept {
+        while (height_ > 1 && head_.base.next()[height_ - 1] == head()) {
+            --height_;
+        }
+    }
+
+// 按顺序把 rhs 的元素追加到尾部，塔高与 rhs 的节点相同，O(n)
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    copy_from(const skiplist_set &rhs) {
+        base_ptr tails[max_height];
+        for (unsigned int i = 0; i < max_height; ++i) {
+            tails[i] = head();
+        }
+        try {
+            for (auto y = rhs.head()->next()[0]; y != rhs.head(); y = y->next()[0]) {
+                auto x = create_node(y->height, value_of(y));
+                for (unsigned int i = 0; i < x->height; ++i) {
+                    x->next()[i] = head();
+                    tails[i]->next()[i] = x;
+                    tails[i] = x;
+                }
+                x->prev = head_.base.prev;
+                head_.base.prev = x;
+                ++size_;
+                if (x->height > height_) {
+                    height_ = x->height;
+                }
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+// 先按原样复制头节点，再从最高层开始找到各层最后一个节点，把它改为指向本 skiplist_set 的头节点
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    take_from(skiplist_set &rhs) noexcept {
+        if (rhs.size_ == 0) {
+            return;
+        }
+        head_.base.prev = rhs.head_.base.prev;
+        for (unsigned int i = 0; i < max_height; ++i) {
+            head_.base.next()[i] = rhs.head_.base.next()[i] == rhs.head() ? head() : rhs.head_.base.next()[i];
+        }
+        height_ = rhs.height_;
+        size_ = rhs.size_;
+        seed_ = rhs.seed_;
+        auto x = head();
+        for (unsigned int i = height_; i > 0; --i) {
+            while (x->next()[i - 1] != rhs.head()) {
+                x = x->next()[i - 1];
+            }
+            x->next()[i - 1] = head();
+        }
+        head_.base.next()[0]->prev = head();
+        rhs.reset_head();
+        rhs.height_ = 1;
+        rhs.size_ = 0;
+    }
+
+// 分配节点并构造值，塔高为 height，各层指针未初始化
+    template<class Key, class Compare, unsigned int P>
+    template<class ...Args>
+    typename skiplist_set<Key, Compare, P>::base_ptr
+    skiplist_set<Key, Compare, P>::
+    create_node(unsigned int height, Args &&...args) {
+        auto p = ::operator new(node_traits::bytes(height));
+        auto x = node_traits::from_raw(p);
+        try {
+            mystl::construct(node_traits::value_ptr(x), mystl::forward<Args>(args)...);
+        } catch (...) {
+            ::operator delete(p);
+            throw;
+        }
+        x->height = height;
+        return x;
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    void skiplist_set<Key, Compare, P>::
+    destroy_node(base_ptr x) noexcept {
+        mystl::destroy(node_traits::value_ptr(x));
+        ::operator delete(node_traits::raw(x));
+    }
+
+    // 重载比较操作符
+    template<class Key, class Compare, unsigned int P>
+    bool operator!=(const skiplist_set<Key, Compare, P> &lhs, const skiplist_set<Key, Compare, P> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    bool operator>(const skiplist_set<Key, Compare, P> &lhs, const skiplist_set<Key, Compare, P> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    bool operator<=(const skiplist_set<Key, Compare, P> &lhs, const skiplist_set<Key, Compare, P> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class Key, class Compare, unsigned int P>
+    bool operator>=(const skiplist_set<Key, Compare, P> &lhs, const skiplist_set<Key, Compare, P> &rhs) {
+        return !(lhs < rhs);
+    }
+
+    // 重载 mystl 的 swap
+    template<class Key, class Compare, unsigned int P>
+    void swap(skiplist_set<Key, Compare, P> &lhs, skiplist_set<Key, Compare, P> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_SKIPLIST_H_
@@ -117,7 +117,7 @@ namespace mystl {
         friend bool operator==(const stack &lhs, const stack &rhs) { return lhs.c_ == rhs.c_; }
 
         friend bool operator<(const stack &lhs, const stack &rhs) { return lhs.c_ < rhs.c_; }
-    }
+    };
 
 // 重载比较操作符
     template<class T, class Container>
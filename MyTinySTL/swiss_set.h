@@ -0,0 +1,258 @@
+#ifndef MYTINYSTL_SWISS_SET_H_
+#define MYTINYSTL_SWISS_SET_H_
+
+// 这个头文件包含一个模板类 swiss_set
+// swiss_set : 开放寻址的哈希集合，接口与 unordered_set 相同，键值不允许重复，查找为期望 O(1)
+
+// notes:
+//
+// 1. 以 swiss_table 为底层机制，见 swiss_table.h
+// 2. 参数四 NodeStorage 为 false（缺省）时元素直接存放在表中，占用少、查找快，但 rehash 后引用失效；
+//    需要元素地址保持不变时使用 true，元素单独分配，表中只存放指针
+// 3. 每个槽位算作一个桶，没有 bucket(key)、bucket_size 等按桶访问的接口；最大负载因子固定为 7/8
+//
+// 异常保证：
+// mystl::swiss_set<Key> 满足基本异常保证，对以下等函数做强异常安全保证：
+//   * emplace
+//   * emplace_hint
+//   * insert
+//
+// 异构查找：
+// 哈希函数与相等比较都定义了 is_transparent 时，find、count、contains、equal_range、erase
+// 可以直接接受能与键值比较的其他类型，不构造临时的键值
+
+#include "swiss_table.h"
+
+namespace mystl {
+
+    // 模板类 swiss_set，键值不允许重复
+    // 参数一代表键值类型，参数二代表哈希函数，缺省使用 mystl::hash，
+    // 参数三代表键值相等的比较方式，缺省使用 mystl::equal_to，参数四为 true 时使用 node 存储
+    template<class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+            bool NodeStorage = false>
+    class swiss_set {
+    private:
+        // 以 mystl::swiss_table 作为底层机制
+        typedef swiss_table<Key, Hash, KeyEqual, NodeStorage> base_type;
+        base_type ht_;
+
+    public:
+        // 使用 swiss_table 定义的型别
+        typedef typename base_type::key_type key_type;
+        typedef typename base_type::value_type value_type;
+        typedef typename base_type::hasher hasher;
+        typedef typename base_type::key_equal key_equal;
+
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::const_pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::const_reference reference;
+        typedef typename base_type::const_reference const_reference;
+        typedef typename base_type::const_iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef typename base_type::allocator_type allocator_type;
+
+    public:
+        // 构造、复制、移动函数
+        swiss_set() = default;
+
+        explicit swiss_set(size_type bucket_count, const hasher &hash = hasher(),
+                           const key_equal &equal = key_equal())
+                : ht_(bucket_count, hash, equal) {}
+
+        template<class InputIterator>
+        swiss_set(InputIterator first, InputIterator last, size_type bucket_count = 0,
+                  const hasher &hash = hasher(), const key_equal &equal = key_equal())
+                : ht_(bucket_count, hash, equal) {
+            ht_.insert_unique(first, last);
+        }
+
+        swiss_set(std::initializer_list<value_type> ilist, size_type bucket_count = 0,
+                  const hasher &hash = hasher(), const key_equal &equal = key_equal())
+                : ht_(bucket_count, hash, equal) {
+            ht_.reserve(ilist.size());
+            ht_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        swiss_set(const swiss_set &rhs) : ht_(rhs.ht_) {}
+
+        swiss_set(swiss_set &&rhs) noexcept: ht_(mystl::move(rhs.ht_)) {}
+
+        swiss_set &operator=(const swiss_set &rhs) {
+            ht_ = rhs.ht_;
+            return *this;
+        }
+
+        swiss_set &operator=(swiss_set &&rhs) noexcept {
+            ht_ = mystl::move(rhs.ht_);
+            return *this;
+        }
+
+        swiss_set &operator=(std::initializer_list<value_type> ilist) {
+            ht_.clear();
+            ht_.reserve(ilist.size());
+            ht_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+        // 迭代器相关
+        iterator begin() noexcept { return ht_.begin(); }
+
+        const_iterator begin() const noexcept { return ht_.begin(); }
+
+        iterator end() noexcept { return ht_.end(); }
+
+        const_iterator end() const noexcept { return ht_.end(); }
+
+        const_iterator cbegin() const noexcept { return ht_.cbegin(); }
+
+        const_iterator cend() const noexcept { return ht_.cend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return ht_.empty(); }
+
+        size_type size() const noexcept { return ht_.size(); }
+
+        size_type max_size() const noexcept { return ht_.max_size(); }
+
+        // 插入删除操作
+        template<class ...Args>
+        pair<iterator, bool> emplace(Args &&...args) {
+            return ht_.emplace_unique(mystl::forward<Args>(args)...);
+        }
+
+        // 开放寻址的位置只由哈希值决定，hint 仅为与 unordered_set 的接口一致
+        template<class ...Args>
+        iterator emplace_hint(const_iterator, Args &&...args) {
+            return ht_.emplace_unique(mystl::forward<Args>(args)...).first;
+        }
+
+        pair<iterator, bool> insert(const value_type &value) {
+            return ht_.insert_unique(value);
+        }
+
+        pair<iterator, bool> insert(value_type &&value) {
+            return ht_.insert_unique(mystl::move(value));
+        }
+
+        iterator insert(const_iterator, const value_type &value) {
+            return ht_.insert_unique(value).first;
+        }
+
+        iterator insert(const_iterator, value_type &&value) {
+            return ht_.insert_unique(mystl::move(value)).first;
+        }
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            ht_.insert_unique(first, last);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            ht_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        iterator erase(const_iterator position) { return ht_.erase(position); }
+
+        iterator erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+
+        size_type erase(const key_type &key) { return ht_.erase_unique(key); }
+
+        void clear() noexcept { ht_.clear(); }
+
+        void swap(swiss_set &rhs) noexcept { ht_.swap(rhs.ht_); }
+
+        // 查找相关
+        iterator find(const key_type &key) { return ht_.find(key); }
+
+        const_iterator find(const key_type &key) const { return ht_.find(key); }
+
+        size_type count(const key_type &key) const { return ht_.count(key); }
+
+        bool contains(const key_type &key) const { return ht_.count(key) != 0; }
+
+        pair<iterator, iterator>
+        equal_range(const key_type &key) { return ht_.equal_range(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const { return ht_.equal_range(key); }
+
+        // 异构查找，哈希函数与相等比较都定义了 is_transparent 时可用
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        size_type erase(const K &key) { return ht_.erase_unique(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        iterator find(const K &key) { return ht_.find(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        const_iterator find(const K &key) const { return ht_.find(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        size_type count(const K &key) const { return ht_.count(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        bool contains(const K &key) const { return ht_.count(key) != 0; }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        pair<iterator, iterator>
+        equal_range(const K &key) { return ht_.equal_range(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        pair<const_iterator, const_iterator>
+        equal_range(const K &key) const { return ht_.equal_range(key); }
+
+        // 桶与负载因子
+        size_type bucket_count() const noexcept { return ht_.bucket_count(); }
+
+        float load_factor() const noexcept { return ht_.load_factor(); }
+
+        float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+
+        void max_load_factor(float ml) noexcept { ht_.max_load_factor(ml); }
+
+        void rehash(size_type count) { ht_.rehash(count); }
+
+        void reserve(size_type count) { ht_.reserve(count); }
+
+        hasher hash_function() const { return ht_.hash_function(); }
+
+        key_equal key_eq() const { return ht_.key_eq(); }
+
+    public:
+        // 元素个数相同，且每个元素都能在另一个集合中找到
+        friend bool operator==(const swiss_set &lhs, const swiss_set &rhs) {
+            if (lhs.size() != rhs.size()) {
+                return false;
+            }
+            for (const auto &value : lhs) {
+                if (rhs.ht_.count(value) == 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        friend bool operator!=(const swiss_set &lhs, const swiss_set &rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+    // 重载 mystl 的 swap
+    template<class Key, class Hash, class KeyEqual, bool NodeStorage>
+    void swap(swiss_set<Key, Hash, KeyEqual, NodeStorage> &lhs,
+              swiss_set<Key, Hash, KeyEqual, NodeStorage> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_SWISS_SET_H_
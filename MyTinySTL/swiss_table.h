@@ -0,0 +1,972 @@
+#ifndef MYTINYSTL_SWISS_TABLE_H_
+#define MYTINYSTL_SWISS_TABLE_H_
+
+// 这个头文件包含一个模板类 swiss_table
+// swiss_table : 开放寻址的哈希表，作为 swiss_set / swiss_map 的底层机制
+// 每个槽位对应一个控制字节，查找时一次比较一组控制字节，只有控制字节匹配的槽位才需要比较键值
+
+// notes:
+//
+// 1. 控制字节为 swiss_ctrl_empty(-128)、swiss_ctrl_deleted(-2)、swiss_ctrl_sentinel(-1)，
+//    或 0 ~ 127 表示槽位已满，取哈希值的低 7 位（H2）；其余高位（H1）决定起始的组，
+//    组之间按三角数步长探测，组数为 2 的幂时能访问到所有组
+// 2. SSE2 下每组 16 个控制字节，一次 pcmpeqb + pmovmskb 得到匹配的位图；
+//    没有 SSE2 时（如 ARM）每组 8 个控制字节，以 64 位整数的位运算（SWAR）模拟，可能有假阳性，总会再比较键值
+// 3. 查找遇到含 swiss_ctrl_empty 的组即停止。删除时若所在组还有空位，没有探测经过这个组，槽位直接置空，
+//    否则置为墓碑 swiss_ctrl_deleted，插入时可以复用墓碑
+// 4. 最大负载因子为 7/8，可用的空槽位耗尽时若墓碑较多（元素不超过容量的 25/32）则以原容量重建，否则容量加倍
+// 5. NodeStorage 为 false 时元素直接存放在槽位中（flat），rehash 时移动元素，所有引用失效；
+//    为 true 时槽位中只存放指向单独分配的元素的指针（node），rehash 只移动指针，元素的引用、指针保持有效
+// 6. 哈希值先经过乘法混合再使用：mystl::hash 对整数是恒等映射，直接取低 7 位只会落在少数几个 H2 上
+// 7. 任何插入都可能使所有迭代器失效，删除只使被删除元素的迭代器失效
+//
+// 异常保证：
+// insert / emplace 做强异常安全保证；flat 存储在 rehash 时若元素的移动构造抛出异常，容器被清空
+
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // 控制字节
+    typedef signed char swiss_ctrl_t;
+
+    constexpr swiss_ctrl_t swiss_ctrl_empty = -128;
+    constexpr swiss_ctrl_t swiss_ctrl_deleted = -2;
+    constexpr swiss_ctrl_t swiss_ctrl_sentinel = -1;
+
+    inline unsigned int swiss_ctz(uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_ctzll(x));
+#else
+        unsigned int n = 0;
+        for (; (x & 1) == 0; x >>= 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    // 组内匹配结果的位图，每个槽位占 2^Shift 位，逐个取出最低的匹配位置
+    template<unsigned int Shift>
+    struct swiss_bitmask {
+        uint64_t mask;
+
+        explicit operator bool() const noexcept { return mask != 0; }
+
+        size_t lowest() const noexcept { return swiss_ctz(mask) >> Shift; }
+
+        void clear_lowest() noexcept { mask &= mask - 1; }
+    };
+
+#if defined(__SSE2__)
+    constexpr size_t swiss_group_width = 16;
+
+    // 一组 16 个控制字节，以 SSE2 指令比较
+    struct swiss_group {
+        typedef swiss_bitmask<0> bitmask;
+
+        __m128i ctrl;
+
+        explicit swiss_group(const swiss_ctrl_t *p) noexcept
+                : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) {}
+
+        bitmask match(swiss_ctrl_t h2) const noexcept {
+            return to_mask(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+        }
+
+        bitmask match_empty() const noexcept {
+            return to_mask(_mm_cmpeq_epi8(_mm_set1_epi8(swiss_ctrl_empty), ctrl));
+        }
+
+        // 有符号比较，小于 swiss_ctrl_sentinel 的只有空位和墓碑
+        bitmask match_empty_or_deleted() const noexcept {
+            return to_mask(_mm_cmpgt_epi8(_mm_set1_epi8(swiss_ctrl_sentinel), ctrl));
+        }
+
+        // 第一个满槽位或哨兵之前的空位、墓碑个数
+        size_t count_leading_empty_or_deleted() const noexcept {
+            return swiss_ctz(match_empty_or_deleted().mask + 1);
+        }
+
+    private:
+        static bitmask to_mask(__m128i v) noexcept {
+            return bitmask{static_cast<uint64_t>(static_cast<unsigned int>(_mm_movemask_epi8(v)))};
+        }
+    };
+#else
+    constexpr size_t swiss_group_width = 8;
+
+    // 一组 8 个控制字节，装入一个 64 位整数，每个字节的最高位表示该槽位是否匹配
+    struct swiss_group {
+        typedef swiss_bitmask<3> bitmask;
+
+        static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+        static constexpr uint64_t msbs = 0x8080808080808080ULL;
+
+        uint64_t ctrl;
+
+        // 逐字节组装，与字节序无关，小端机器上会被优化为一次读取
+        explicit swiss_group(const swiss_ctrl_t *p) noexcept: ctrl(0) {
+            for (size_t i = 0; i < swiss_group_width; ++i) {
+                ctrl |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (i * 8);
+            }
+        }
+
+        // 等于 h2 的字节异或后为 0；借位可能使更高的字节出现假阳性
+        bitmask match(swiss_ctrl_t h2) const noexcept {
+            const uint64_t x = ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+            return bitmask{(x - lsbs) & ~x & msbs};
+        }
+
+        // 空位为 10000000：最高位为 1 且第 1 位为 0
+        bitmask match_empty() const noexcept {
+            return bitmask{ctrl & (~ctrl << 6) & msbs};
+        }
+
+        // 空位与墓碑最高位为 1 且最低位为 0，哨兵的最低位为 1
+        bitmask match_empty_or_deleted() const noexcept {
+            return bitmask{ctrl & (~ctrl << 7) & msbs};
+        }
+
+        size_t count_leading_empty_or_deleted() const noexcept {
+            const uint64_t other = ~match_empty_or_deleted().mask & msbs;
+            return other == 0 ? swiss_group_width : swiss_ctz(other) >> 3;
+        }
+    };
+#endif
+
+    // 空表使用的控制字节，只有一个哨兵，不分配空间
+    inline swiss_ctrl_t *swiss_empty_group() noexcept {
+        alignas(16) static const swiss_ctrl_t group[16] = {
+                swiss_ctrl_sentinel, swiss_ctrl_empty, swiss_ctrl_empty, swiss_ctrl_empty,
+                swiss_ctrl_empty, swiss_ctrl_empty, swiss_ctrl_empty, swiss_ctrl_empty,
+                swiss_ctrl_empty, swiss_ctrl_empty, swiss_ctrl_empty, swiss_ctrl_empty,
+                swiss_ctrl_empty, swiss_ctrl_empty, swiss_ctrl_empty, swiss_ctrl_empty};
+        return const_cast<swiss_ctrl_t *>(group);
+    }
+
+    // 乘法混合，把哈希值的各位扩散到 H1、H2 用到的位上
+    inline size_t swiss_mix(size_t hash) noexcept {
+        const uint64_t x = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(x ^ (x >> 32));
+    }
+
+    // flat 存储：元素直接存放在槽位中
+    template<class T>
+    struct swiss_flat_storage {
+        typedef T slot_type;
+        typedef mystl::allocator<T> data_allocator;
+
+        static T &element(slot_type *slot) noexcept { return *slot; }
+
+        template<class ...Args>
+        static void construct(slot_type *slot, Args &&...args) {
+            data_allocator::construct(slot, mystl::forward<Args>(args)...);
+        }
+
+        static void destroy(slot_type *slot) noexcept {
+            data_allocator::destroy(slot);
+        }
+
+        // 把元素从 src 移到 dst，src 随后被销毁
+        static void transfer(slot_type *dst, slot_type *src) {
+            data_allocator::construct(dst, mystl::move(*src));
+            data_allocator::destroy(src);
+        }
+    };
+
+    // node 存储：槽位中存放指向单独分配的元素的指针
+    template<class T>
+    struct swiss_node_storage {
+        typedef T *slot_type;
+        typedef mystl::allocator<T> data_allocator;
+
+        static T &element(slot_type *slot) noexcept { return **slot; }
+
+        template<class ...Args>
+        static void construct(slot_type *slot, Args &&...args) {
+            auto p = data_allocator::allocate(1);
+            try {
+                data_allocator::construct(p, mystl::forward<Args>(args)...);
+            } catch (...) {
+                data_allocator::deallocate(p, 1);
+                throw;
+            }
+            *slot = p;
+        }
+
+        static void destroy(slot_type *slot) noexcept {
+            data_allocator::destroy(*slot);
+            data_allocator::deallocate(*slot, 1);
+        }
+
+        static void transfer(slot_type *dst, slot_type *src) noexcept {
+            *dst = *src;
+        }
+    };
+
+    // swiss table value traits
+    // 值为 pair 时以 first 为键值，否则值本身即为键值
+    template<class T, bool>
+    struct swiss_table_value_traits_imp {
+        typedef T key_type;
+        typedef T mapped_type;
+        typedef T value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value;
+        }
+    };
+
+    template<class T>
+    struct swiss_table_value_traits_imp<T, true> {
+        typedef typename std::remove_cv<typename T::first_type>::type key_type;
+        typedef typename T::second_type mapped_type;
+        typedef T value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value.first;
+        }
+    };
+
+    template<class T>
+    struct swiss_table_value_traits {
+        static constexpr bool is_map = mystl::is_pair<T>::value;
+
+        typedef swiss_table_value_traits_imp<T, is_map> value_traits_type;
+        typedef typename value_traits_type::key_type key_type;
+        typedef typename value_traits_type::mapped_type mapped_type;
+        typedef typename value_traits_type::value_type value_type;
+
+        static const key_type &get_key(const value_type &value) {
+            return value_traits_type::get_key(value);
+        }
+    };
+
+    // swiss_table 的迭代器，指向一个控制字节及其槽位，end() 指向哨兵
+    template<class T, class Ref, class Ptr, class Storage>
+    struct swiss_table_iterator : public iterator<forward_iterator_tag, T> {
+        typedef typename Storage::slot_type slot_type;
+        typedef swiss_table_iterator<T, T &, T *, Storage> iterator;
+        typedef swiss_table_iterator<T, const T &, const T *, Storage> const_iterator;
+        typedef swiss_table_iterator<T, Ref, Ptr, Storage> self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef ptrdiff_t difference_type;
+
+        const swiss_ctrl_t *ctrl;
+        slot_type *slot;
+
+        swiss_table_iterator() noexcept: ctrl(nullptr), slot(nullptr) {}
+
+        swiss_table_iterator(const swiss_ctrl_t *c, slot_type *s) noexcept: ctrl(c), slot(s) {}
+
+        swiss_table_iterator(const iterator &rhs) noexcept: ctrl(rhs.ctrl), slot(rhs.slot) {}
+
+        reference operator*() const { return Storage::element(slot); }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self &operator++() {
+            ++ctrl;
+            ++slot;
+            skip_empty_or_deleted();
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        // 按组跳过空位与墓碑，停在满槽位或哨兵上
+        void skip_empty_or_deleted() noexcept {
+            while (*ctrl < swiss_ctrl_sentinel) {
+                const size_t n = swiss_group(ctrl).count_leading_empty_or_deleted();
+                ctrl += n;
+                slot += n;
+            }
+        }
+
+        bool operator==(const self &rhs) const { return ctrl == rhs.ctrl; }
+
+        bool operator!=(const self &rhs) const { return ctrl != rhs.ctrl; }
+    };
+
+    // 模板类 swiss_table
+    // 参数一代表元素类型，参数二代表哈希函数，参数三代表键值相等的比较方式，参数四为 true 时使用 node 存储
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    class swiss_table {
+    public:
+        // swiss_table 的嵌套型别定义
+        typedef swiss_table_value_traits<T> value_traits;
+
+        typedef typename value_traits::key_type key_type;
+        typedef typename value_traits::mapped_type mapped_type;
+        typedef typename value_traits::value_type value_type;
+        typedef Hash hasher;
+        typedef KeyEqual key_equal;
+
+        typedef typename std::conditional<NodeStorage, swiss_node_storage<T>,
+                swiss_flat_storage<T>>::type storage_type;
+        typedef typename storage_type::slot_type slot_type;
+
+        typedef mystl::allocator<T> allocator_type;
+        typedef mystl::allocator<slot_type> slot_allocator;
+        typedef mystl::allocator<swiss_ctrl_t> ctrl_allocator;
+
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        typedef swiss_table_iterator<T, T &, T *, storage_type> iterator;
+        typedef swiss_table_iterator<T, const T &, const T *, storage_type> const_iterator;
+
+        allocator_type get_allocator() const { return allocator_type(); }
+
+    private:
+        swiss_ctrl_t *ctrl_;     // capacity_ 个控制字节，之后是哨兵和 swiss_group_width - 1 个空位
+        slot_type *slots_;
+        size_type capacity_;     // 0 或 swiss_group_width 乘以 2 的幂
+        size_type size_;
+        size_type growth_left_;  // 不 rehash 还能占用的空位数
+        hasher hash_;
+        key_equal equal_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        swiss_table() : swiss_table(0, hasher(), key_equal()) {}
+
+        swiss_table(size_type bucket_count, const hasher &hash, const key_equal &equal)
+                : ctrl_(swiss_empty_group()), slots_(nullptr), capacity_(0), size_(0), growth_left_(0),
+                  hash_(hash), equal_(equal) {
+            if (bucket_count != 0) {
+                resize(normalize_capacity(bucket_count));
+            }
+        }
+
+        swiss_table(const swiss_table &rhs);
+
+        swiss_table(swiss_table &&rhs) noexcept;
+
+        swiss_table &operator=(const swiss_table &rhs);
+
+        swiss_table &operator=(swiss_table &&rhs) noexcept;
+
+        ~swiss_table() {
+            destroy_slots();
+            deallocate();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept {
+            iterator it(ctrl_, slots_);
+            it.skip_empty_or_deleted();
+            return it;
+        }
+
+        const_iterator begin() const noexcept {
+            return const_cast<swiss_table *>(this)->begin();
+        }
+
+        iterator end() noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+
+        const_iterator end() const noexcept {
+            return const_cast<swiss_table *>(this)->end();
+        }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return size_ == 0; }
+
+        size_type size() const noexcept { return size_; }
+
+        size_type max_size() const noexcept {
+            return static_cast<size_type>(-1) / (sizeof(slot_type) + 1) / 2;
+        }
+
+        // 插入删除相关操作
+        template<class ...Args>
+        pair<iterator, bool> emplace_unique(Args &&...args);
+
+        pair<iterator, bool> insert_unique(const value_type &value) {
+            return insert_value(value);
+        }
+
+        pair<iterator, bool> insert_unique(value_type &&value) {
+            return insert_value(mystl::move(value));
+        }
+
+        template<class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            for (; first != last; ++first)
+                insert_value(*first);
+        }
+
+        // 键值不存在时才以 key 和 args 构造元素，只用于 map
+        template<class K, class ...Args>
+        pair<iterator, bool> try_emplace_unique(K &&key, Args &&...args);
+
+        iterator erase(const_iterator pos);
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        template<class K>
+        size_type erase_unique(const K &key);
+
+        void clear() noexcept;
+
+        // 查找相关操作
+        template<class K>
+        iterator find(const K &key) {
+            return iterator_at(find_index(key, swiss_mix(hash_(key))));
+        }
+
+        template<class K>
+        const_iterator find(const K &key) const {
+            return const_cast<swiss_table *>(this)->find(key);
+        }
+
+        template<class K>
+        size_type count(const K &key) const {
+            return find_index(key, swiss_mix(hash_(key))) != capacity_ ? 1 : 0;
+        }
+
+        template<class K>
+        pair<iterator, iterator> equal_range(const K &key) {
+            auto it = find(key);
+            if (it == end()) {
+                return mystl::make_pair(it, it);
+            }
+            auto next = it;
+            return mystl::make_pair(it, ++next);
+        }
+
+        template<class K>
+        pair<const_iterator, const_iterator> equal_range(const K &key) const {
+            auto r = const_cast<swiss_table *>(this)->equal_range(key);
+            return mystl::make_pair(const_iterator(r.first), const_iterator(r.second));
+        }
+
+        // 桶与负载因子，每个槽位算作一个桶
+        size_type bucket_count() const noexcept { return capacity_; }
+
+        float load_factor() const noexcept {
+            return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+        }
+
+        // 最大负载因子固定为 7/8
+        float max_load_factor() const noexcept { return 0.875f; }
+
+        void max_load_factor(float) noexcept {}
+
+        void rehash(size_type count);
+
+        void reserve(size_type count);
+
+        hasher hash_function() const { return hash_; }
+
+        key_equal key_eq() const { return equal_; }
+
+        void swap(swiss_table &rhs) noexcept;
+
+    private:
+        // helper functions
+        static size_type h1(size_type hash) noexcept { return hash >> 7; }
+
+        static swiss_ctrl_t h2(size_type hash) noexcept { return static_cast<swiss_ctrl_t>(hash & 0x7F); }
+
+        // 负载因子为 7/8 时 capacity 个槽位最多容纳的元素个数
+        static size_type growth_capacity(size_type capacity) noexcept { return capacity - capacity / 8; }
+
+        // 不小于 count 的合法容量
+        static size_type normalize_capacity(size_type count) noexcept {
+            size_type capacity = swiss_group_width;
+            while (capacity < count) {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+        // 容纳 count 个元素需要的容量
+        static size_type capacity_for(size_type count) noexcept {
+            size_type capacity = count == 0 ? 0 : swiss_group_width;
+            while (capacity != 0 && growth_capacity(capacity) < count) {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+        slot_type *slot_at(size_type index) const noexcept { return slots_ + index; }
+
+        const key_type &key_at(size_type index) const noexcept {
+            return value_traits::get_key(storage_type::element(slot_at(index)));
+        }
+
+        iterator iterator_at(size_type index) noexcept { return iterator(ctrl_ + index, slots_ + index); }
+
+        size_type index_of(const_iterator it) const noexcept { return static_cast<size_type>(it.ctrl - ctrl_); }
+
+        // 查找键值等于 key 的槽位，不存在时返回 capacity_
+        template<class K>
+        size_type find_index(const K &key, size_type hash) const;
+
+        // 探测序列上第一个空位或墓碑
+        size_type find_first_non_full(size_type hash) const noexcept;
+
+        // 为哈希值为 hash 的新元素占用一个槽位，必要时先 rehash，返回槽位的下标；
+        // 元素构造成功后再由调用者写入控制字节
+        size_type prepare_insert(size_type hash);
+
+        // 撤销 prepare_insert，用于构造元素失败时
+        void cancel_insert(size_type index) noexcept;
+
+        template<class V>
+        pair<iterator, bool> insert_value(V &&value);
+
+        void erase_meta(size_type index) noexcept;
+
+        void rehash_and_grow();
+
+        void resize(size_type new_capacity);
+
+        void copy_from(const swiss_table &rhs);
+
+        void destroy_slots() noexcept;
+
+        void deallocate() noexcept;
+
+        void reset() noexcept;
+    };
+
+/*****************************************************************************************/
+
+// 复制构造函数，元素各不相同，直接放入探测序列上的第一个空位
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    swiss_table(const swiss_table &rhs)
+            : ctrl_(swiss_empty_group()), slots_(nullptr), capacity_(0), size_(0), growth_left_(0),
+              hash_(rhs.hash_), equal_(rhs.equal_) {
+        copy_from(rhs);
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    swiss_table(swiss_table &&rhs) noexcept
+            : ctrl_(rhs.ctrl_), slots_(rhs.slots_), capacity_(rhs.capacity_), size_(rhs.size_),
+              growth_left_(rhs.growth_left_), hash_(mystl::move(rhs.hash_)), equal_(mystl::move(rhs.equal_)) {
+        rhs.reset();
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    swiss_table<T, Hash, KeyEqual, NodeStorage> &
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    operator=(const swiss_table &rhs) {
+        if (this != &rhs) {
+            swiss_table tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    swiss_table<T, Hash, KeyEqual, NodeStorage> &
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    operator=(swiss_table &&rhs) noexcept {
+        if (this != &rhs) {
+            swiss_table tmp(mystl::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+// 就地构造元素，先在临时对象中构造以取得键值，键值已存在时不占用槽位
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    template<class ...Args>
+    pair<typename swiss_table<T, Hash, KeyEqual, NodeStorage>::iterator, bool>
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    emplace_unique(Args &&...args) {
+        value_type value(mystl::forward<Args>(args)...);
+        return insert_value(mystl::move(value));
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    template<class K, class ...Args>
+    pair<typename swiss_table<T, Hash, KeyEqual, NodeStorage>::iterator, bool>
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    try_emplace_unique(K &&key, Args &&...args) {
+        const auto hash = swiss_mix(hash_(key));
+        auto index = find_index(key, hash);
+        if (index != capacity_) {
+            return mystl::make_pair(iterator_at(index), false);
+        }
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "swiss_table<T, Hash, KeyEqual>'s size too big");
+        index = prepare_insert(hash);
+        try {
+            storage_type::construct(slot_at(index), mystl::forward<K>(key),
+                                    mapped_type(mystl::forward<Args>(args)...));
+        } catch (...) {
+            cancel_insert(index);
+            throw;
+        }
+        ctrl_[index] = h2(hash);
+        return mystl::make_pair(iterator_at(index), true);
+    }
+
+// 删除 pos 处的元素，返回下一个元素的迭代器
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    typename swiss_table<T, Hash, KeyEqual, NodeStorage>::iterator
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    erase(const_iterator pos) {
+        const auto index = index_of(pos);
+        storage_type::destroy(slot_at(index));
+        erase_meta(index);
+        auto next = iterator_at(index);
+        ++next;
+        return next;
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    typename swiss_table<T, Hash, KeyEqual, NodeStorage>::iterator
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    erase(const_iterator first, const_iterator last) {
+        if (first == cbegin() && last == cend()) {
+            clear();
+            return end();
+        }
+        while (first != last) {
+            first = erase(first);
+        }
+        return iterator_at(index_of(last));
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    template<class K>
+    typename swiss_table<T, Hash, KeyEqual, NodeStorage>::size_type
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    erase_unique(const K &key) {
+        const auto index = find_index(key, swiss_mix(hash_(key)));
+        if (index == capacity_) {
+            return 0;
+        }
+        storage_type::destroy(slot_at(index));
+        erase_meta(index);
+        return 1;
+    }
+
+// 清空 swiss_table，保留已分配的空间
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    clear() noexcept {
+        if (capacity_ == 0) {
+            return;
+        }
+        destroy_slots();
+        for (size_type i = 0; i < capacity_; ++i) {
+            ctrl_[i] = swiss_ctrl_empty;
+        }
+        size_ = 0;
+        growth_left_ = growth_capacity(capacity_);
+    }
+
+// 重新散列，容量至少为 count，且能以 7/8 的负载因子容纳现有元素；同时清除所有墓碑
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    rehash(size_type count) {
+        const auto need = capacity_for(size_);
+        if (count == 0 && need == 0) {
+            destroy_slots();
+            deallocate();
+            reset();
+            return;
+        }
+        const auto new_capacity = normalize_capacity(count > need ? count : need);
+        if (new_capacity != capacity_ || growth_left_ != growth_capacity(capacity_) - size_) {
+            resize(new_capacity);
+        }
+    }
+
+// 预留空间，之后插入 count 个元素以内不会 rehash
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    reserve(size_type count) {
+        if (count > size_ + growth_left_) {
+            resize(capacity_for(count));
+        }
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    swap(swiss_table &rhs) noexcept {
+        if (this != &rhs) {
+            mystl::swap(ctrl_, rhs.ctrl_);
+            mystl::swap(slots_, rhs.slots_);
+            mystl::swap(capacity_, rhs.capacity_);
+            mystl::swap(size_, rhs.size_);
+            mystl::swap(growth_left_, rhs.growth_left_);
+            mystl::swap(hash_, rhs.hash_);
+            mystl::swap(equal_, rhs.equal_);
+        }
+    }
+
+/*****************************************************************************************/
+// helper function
+
+// 逐组探测，组内只比较 H2 匹配的槽位，遇到有空位的组即停止
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    template<class K>
+    typename swiss_table<T, Hash, KeyEqual, NodeStorage>::size_type
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    find_index(const K &key, size_type hash) const {
+        if (size_ == 0) {
+            return capacity_;
+        }
+        const auto tag = h2(hash);
+        const size_type group_mask = capacity_ / swiss_group_width - 1;
+        size_type g = h1(hash) & group_mask;
+        for (size_type step = 1;; ++step) {
+            const auto base = g * swiss_group_width;
+            swiss_group group(ctrl_ + base);
+            for (auto m = group.match(tag); m; m.clear_lowest()) {
+                const auto index = base + m.lowest();
+                if (equal_(key_at(index), key)) {
+                    return index;
+                }
+            }
+            if (group.match_empty()) {
+                return capacity_;
+            }
+            g = (g + step) & group_mask;
+        }
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    typename swiss_table<T, Hash, KeyEqual, NodeStorage>::size_type
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    find_first_non_full(size_type hash) const noexcept {
+        const size_type group_mask = capacity_ / swiss_group_width - 1;
+        size_type g = h1(hash) & group_mask;
+        for (size_type step = 1;; ++step) {
+            auto m = swiss_group(ctrl_ + g * swiss_group_width).match_empty_or_deleted();
+            if (m) {
+                return g * swiss_group_width + m.lowest();
+            }
+            g = (g + step) & group_mask;
+        }
+    }
+
+// 复用墓碑不消耗 growth_left_；没有可用的空位时先 rehash
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    typename swiss_table<T, Hash, KeyEqual, NodeStorage>::size_type
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    prepare_insert(size_type hash) {
+        size_type index = capacity_ == 0 ? 0 : find_first_non_full(hash);
+        if (growth_left_ == 0 && (capacity_ == 0 || ctrl_[index] != swiss_ctrl_deleted)) {
+            rehash_and_grow();
+            index = find_first_non_full(hash);
+        }
+        if (ctrl_[index] == swiss_ctrl_empty) {
+            --growth_left_;
+        }
+        ++size_;
+        return index;
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    cancel_insert(size_type index) noexcept {
+        if (ctrl_[index] == swiss_ctrl_empty) {
+            ++growth_left_;
+        }
+        --size_;
+    }
+
+// 插入元素，键值已存在时不构造新元素
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    template<class V>
+    pair<typename swiss_table<T, Hash, KeyEqual, NodeStorage>::iterator, bool>
+    swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    insert_value(V &&value) {
+        const auto &key = value_traits::get_key(value);
+        const auto hash = swiss_mix(hash_(key));
+        auto index = find_index(key, hash);
+        if (index != capacity_) {
+            return mystl::make_pair(iterator_at(index), false);
+        }
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "swiss_table<T, Hash, KeyEqual>'s size too big");
+        index = prepare_insert(hash);
+        try {
+            storage_type::construct(slot_at(index), mystl::forward<V>(value));
+        } catch (...) {
+            cancel_insert(index);
+            throw;
+        }
+        ctrl_[index] = h2(hash);
+        return mystl::make_pair(iterator_at(index), true);
+    }
+
+// 所在的组还有空位时，没有探测序列经过这个组，可以直接置空
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    erase_meta(size_type index) noexcept {
+        --size_;
+        const auto base = index / swiss_group_width * swiss_group_width;
+        if (swiss_group(ctrl_ + base).match_empty()) {
+            ctrl_[index] = swiss_ctrl_empty;
+            ++growth_left_;
+        } else {
+            ctrl_[index] = swiss_ctrl_deleted;
+        }
+    }
+
+// 墓碑较多时以原容量重建，否则容量加倍
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    rehash_and_grow() {
+        if (capacity_ == 0) {
+            resize(swiss_group_width);
+        } else if (size_ * 32 <= capacity_ * 25) {
+            resize(capacity_);
+        } else {
+            resize(capacity_ * 2);
+        }
+    }
+
+// 分配新的槽位，把所有元素按哈希值放入新的槽位，同时清除所有墓碑
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    resize(size_type new_capacity) {
+        auto new_slots = slot_allocator::allocate(new_capacity);
+        swiss_ctrl_t *new_ctrl;
+        try {
+            new_ctrl = ctrl_allocator::allocate(new_capacity + swiss_group_width);
+        } catch (...) {
+            slot_allocator::deallocate(new_slots, new_capacity);
+            throw;
+        }
+        for (size_type i = 0; i < new_capacity + swiss_group_width; ++i) {
+            new_ctrl[i] = swiss_ctrl_empty;
+        }
+        new_ctrl[new_capacity] = swiss_ctrl_sentinel;
+
+        auto old_ctrl = ctrl_;
+        auto old_slots = slots_;
+        const auto old_capacity = capacity_;
+        ctrl_ = new_ctrl;
+        slots_ = new_slots;
+        capacity_ = new_capacity;
+        growth_left_ = growth_capacity(new_capacity) - size_;
+        size_type i = 0;
+        try {
+            for (; i < old_capacity; ++i) {
+                if (old_ctrl[i] >= 0) {
+                    const auto hash = swiss_mix(hash_(value_traits::get_key(storage_type::element(old_slots + i))));
+                    const auto index = find_first_non_full(hash);
+                    storage_type::transfer(slots_ + index, old_slots + i);
+                    ctrl_[index] = h2(hash);
+                }
+            }
+        } catch (...) {
+            // 新旧两张表中都可能还有元素，全部销毁
+            destroy_slots();
+            for (; i < old_capacity; ++i) {
+                if (old_ctrl[i] >= 0) {
+                    storage_type::destroy(old_slots + i);
+                }
+            }
+            deallocate();
+            reset();
+            if (old_capacity != 0) {
+                slot_allocator::deallocate(old_slots, old_capacity);
+                ctrl_allocator::deallocate(old_ctrl, old_capacity + swiss_group_width);
+            }
+            throw;
+        }
+        if (old_capacity != 0) {
+            slot_allocator::deallocate(old_slots, old_capacity);
+            ctrl_allocator::deallocate(old_ctrl, old_capacity + swiss_group_width);
+        }
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    copy_from(const swiss_table &rhs) {
+        if (rhs.size_ == 0) {
+            return;
+        }
+        resize(capacity_for(rhs.size_));
+        try {
+            for (size_type i = 0; i < rhs.capacity_; ++i) {
+                if (rhs.ctrl_[i] >= 0) {
+                    const auto &value = storage_type::element(rhs.slots_ + i);
+                    const auto hash = swiss_mix(hash_(value_traits::get_key(value)));
+                    const auto index = prepare_insert(hash);
+                    storage_type::construct(slots_ + index, value);
+                    ctrl_[index] = h2(hash);
+                }
+            }
+        } catch (...) {
+            // 控制字节在元素构造成功后才写入，构造失败的槽位不会被销毁
+            destroy_slots();
+            deallocate();
+            reset();
+            throw;
+        }
+    }
+
+// 销毁所有元素，不修改控制字节
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    destroy_slots() noexcept {
+        for (size_type i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] >= 0) {
+                storage_type::destroy(slots_ + i);
+            }
+        }
+    }
+
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    deallocate() noexcept {
+        if (capacity_ != 0) {
+            slot_allocator::deallocate(slots_, capacity_);
+            ctrl_allocator::deallocate(ctrl_, capacity_ + swiss_group_width);
+        }
+    }
+
+// 恢复为未分配空间的空表
+    template<class T, class Hash, class KeyEqual, bool NodeStorage>
+    void swiss_table<T, Hash, KeyEqual, NodeStorage>::
+    reset() noexcept {
+        ctrl_ = swiss_empty_group();
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+        growth_left_ = 0;
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_SWISS_TABLE_H_
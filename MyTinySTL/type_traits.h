@@ -39,6 +39,19 @@ struct is_pair : mystl::m_false_type {};
 template <class T1, class T2>
 struct is_pair<mystl::pair<T1, T2>> : mystl::m_true_type {};
 
+// is_transparent
+// 比较函数定义了 is_transparent 类型时，关联式容器允许用能与键值比较的其他类型直接查找
+
+template <class T>
+struct m_void_t { typedef void type; };
+
+template <class Compare, class = void>
+struct is_transparent : mystl::m_false_type {};
+
+template <class Compare>
+struct is_transparent<Compare, typename m_void_t<typename Compare::is_transparent>::type>
+  : mystl::m_true_type {};
+
 } // namespace mystl
 
 #endif // !MYTINYSTL_TYPE_TRAITS_H_
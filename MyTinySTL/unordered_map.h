@@ -0,0 +1,581 @@
+#ifndef MYTINYSTL_UNORDERED_MAP_H_
+#define MYTINYSTL_UNORDERED_MAP_H_
+
+// 这个头文件包含两个模板类 unordered_map 和 unordered_multimap
+// unordered_map      : 链式哈希映射，键值不允许重复
+// unordered_multimap : 链式哈希映射，键值允许重复
+
+// notes:
+//
+// 1. 以 hashtable 为底层机制，见 hashtable.h
+// 2. 节点从容器自己的节点池中分配，rehash 只重新链接节点，元素的引用和指针在删除前一直有效；
+//    只需要查找速度、不需要引用稳定时可以使用 swiss_map（swiss_map.h）
+// 3. 桶数取自素数表，reserve、rehash、max_load_factor 与标准库的语义相同
+//
+// 异常保证：
+// mystl::unordered_map<Key, T> / mystl::unordered_multimap<Key, T> 满足基本异常保证，对以下等函数做强异常安全保证：
+//   * emplace
+//   * emplace_hint
+//   * insert
+//   * try_emplace
+//
+// 异构查找：
+// 哈希函数与相等比较都定义了 is_transparent 时，find、count、contains、equal_range、erase
+// 可以直接接受能与键值比较的其他类型，不构造临时的键值
+
+#include "hashtable.h"
+
+namespace mystl {
+
+    // 模板类 unordered_map，键值不允许重复
+    // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash，
+    // 参数四代表键值相等的比较方式，缺省使用 mystl::equal_to
+    template<class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+    class unordered_map {
+    private:
+        // 以 mystl::hashtable 作为底层机制
+        typedef hashtable<mystl::pair<const Key, T>, Hash, KeyEqual> base_type;
+        base_type ht_;
+
+    public:
+        // 使用 hashtable 定义的型别
+        typedef typename base_type::key_type key_type;
+        typedef typename base_type::mapped_type mapped_type;
+        typedef typename base_type::value_type value_type;
+        typedef typename base_type::hasher hasher;
+        typedef typename base_type::key_equal key_equal;
+
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::reference reference;
+        typedef typename base_type::const_reference const_reference;
+        typedef typename base_type::iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef typename base_type::local_iterator local_iterator;
+        typedef typename base_type::const_local_iterator const_local_iterator;
+        typedef typename base_type::allocator_type allocator_type;
+
+    public:
+        // 构造、复制、移动函数
+        unordered_map() = default;
+
+        explicit unordered_map(size_type bucket_count, const hasher &hash = hasher(),
+                           const key_equal &equal = key_equal())
+                : ht_(bucket_count, hash, equal) {}
+
+        template<class InputIterator>
+        unordered_map(InputIterator first, InputIterator last, size_type bucket_count = 0,
+                  const hasher &hash = hasher(), const key_equal &equal = key_equal())
+                : ht_(bucket_count, hash, equal) {
+            ht_.insert_unique(first, last);
+        }
+
+        unordered_map(std::initializer_list<value_type> ilist, size_type bucket_count = 0,
+                  const hasher &hash = hasher(), const key_equal &equal = key_equal())
+                : ht_(bucket_count, hash, equal) {
+            ht_.reserve(ilist.size());
+            ht_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        unordered_map(const unordered_map &rhs) : ht_(rhs.ht_) {}
+
+        unordered_map(unordered_map &&rhs) noexcept: ht_(mystl::move(rhs.ht_)) {}
+
+        unordered_map &operator=(const unordered_map &rhs) {
+            ht_ = rhs.ht_;
+            return *this;
+        }
+
+        unordered_map &operator=(unordered_map &&rhs) noexcept {
+            ht_ = mystl::move(rhs.ht_);
+            return *this;
+        }
+
+        unordered_map &operator=(std::initializer_list<value_type> ilist) {
+            ht_.clear();
+            ht_.reserve(ilist.size());
+            ht_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+        // 迭代器相关
+        iterator begin() noexcept { return ht_.begin(); }
+
+        const_iterator begin() const noexcept { return ht_.begin(); }
+
+        iterator end() noexcept { return ht_.end(); }
+
+        const_iterator end() const noexcept { return ht_.end(); }
+
+        const_iterator cbegin() const noexcept { return ht_.cbegin(); }
+
+        const_iterator cend() const noexcept { return ht_.cend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return ht_.empty(); }
+
+        size_type size() const noexcept { return ht_.size(); }
+
+        size_type max_size() const noexcept { return ht_.max_size(); }
+
+        // 插入删除操作
+        template<class ...Args>
+        pair<iterator, bool> emplace(Args &&...args) {
+            return ht_.emplace_unique(mystl::forward<Args>(args)...);
+        }
+
+        // 元素所在的桶只由哈希值决定，hint 仅为接口一致
+        template<class ...Args>
+        iterator emplace_hint(const_iterator, Args &&...args) {
+            return ht_.emplace_unique(mystl::forward<Args>(args)...).first;
+        }
+
+        pair<iterator, bool> insert(const value_type &value) {
+            return ht_.insert_unique(value);
+        }
+
+        pair<iterator, bool> insert(value_type &&value) {
+            return ht_.insert_unique(mystl::move(value));
+        }
+
+        iterator insert(const_iterator, const value_type &value) {
+            return ht_.insert_unique(value).first;
+        }
+
+        iterator insert(const_iterator, value_type &&value) {
+            return ht_.insert_unique(mystl::move(value)).first;
+        }
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            ht_.insert_unique(first, last);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            ht_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        iterator erase(const_iterator position) { return ht_.erase(position); }
+
+        iterator erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+
+        size_type erase(const key_type &key) { return ht_.erase_unique(key); }
+
+        void clear() noexcept { ht_.clear(); }
+
+        void swap(unordered_map &rhs) noexcept { ht_.swap(rhs.ht_); }
+
+        // 键值不存在时才构造实值，键值已存在时不移动 key 与 args
+        template<class ...Args>
+        pair<iterator, bool> try_emplace(const key_type &key, Args &&...args) {
+            return ht_.try_emplace_unique(key, mystl::forward<Args>(args)...);
+        }
+
+        template<class ...Args>
+        pair<iterator, bool> try_emplace(key_type &&key, Args &&...args) {
+            return ht_.try_emplace_unique(mystl::move(key), mystl::forward<Args>(args)...);
+        }
+
+        template<class ...Args>
+        iterator try_emplace(const_iterator, const key_type &key, Args &&...args) {
+            return ht_.try_emplace_unique(key, mystl::forward<Args>(args)...).first;
+        }
+
+        template<class ...Args>
+        iterator try_emplace(const_iterator, key_type &&key, Args &&...args) {
+            return ht_.try_emplace_unique(mystl::move(key), mystl::forward<Args>(args)...).first;
+        }
+
+        // 键值已存在时赋值给实值
+        template<class M>
+        pair<iterator, bool> insert_or_assign(const key_type &key, M &&obj) {
+            auto res = ht_.try_emplace_unique(key, mystl::forward<M>(obj));
+            if (!res.second) {
+                res.first->second = mystl::forward<M>(obj);
+            }
+            return res;
+        }
+
+        template<class M>
+        pair<iterator, bool> insert_or_assign(key_type &&key, M &&obj) {
+            auto res = ht_.try_emplace_unique(mystl::move(key), mystl::forward<M>(obj));
+            if (!res.second) {
+                res.first->second = mystl::forward<M>(obj);
+            }
+            return res;
+        }
+
+        // 访问元素相关操作
+        // 若键值不存在，at 会抛出一个异常
+        mapped_type &at(const key_type &key) {
+            auto it = ht_.find(key);
+            THROW_OUT_OF_RANGE_IF(it == ht_.end(), "unordered_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        const mapped_type &at(const key_type &key) const {
+            auto it = ht_.find(key);
+            THROW_OUT_OF_RANGE_IF(it == ht_.end(), "unordered_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        mapped_type &operator[](const key_type &key) {
+            return ht_.try_emplace_unique(key).first->second;
+        }
+
+        mapped_type &operator[](key_type &&key) {
+            return ht_.try_emplace_unique(mystl::move(key)).first->second;
+        }
+
+        // 查找相关
+        iterator find(const key_type &key) { return ht_.find(key); }
+
+        const_iterator find(const key_type &key) const { return ht_.find(key); }
+
+        size_type count(const key_type &key) const { return ht_.count_unique(key); }
+
+        bool contains(const key_type &key) const { return ht_.count_unique(key) != 0; }
+
+        pair<iterator, iterator>
+        equal_range(const key_type &key) { return ht_.equal_range_unique(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const { return ht_.equal_range_unique(key); }
+
+        // 异构查找，哈希函数与相等比较都定义了 is_transparent 时可用
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        size_type erase(const K &key) { return ht_.erase_unique(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        iterator find(const K &key) { return ht_.find(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        const_iterator find(const K &key) const { return ht_.find(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        size_type count(const K &key) const { return ht_.count_unique(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        bool contains(const K &key) const { return ht_.count_unique(key) != 0; }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        pair<iterator, iterator>
+        equal_range(const K &key) { return ht_.equal_range_unique(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        pair<const_iterator, const_iterator>
+        equal_range(const K &key) const { return ht_.equal_range_unique(key); }
+
+        // bucket interface
+        local_iterator begin(size_type n) noexcept { return ht_.begin(n); }
+
+        const_local_iterator begin(size_type n) const noexcept { return ht_.begin(n); }
+
+        const_local_iterator cbegin(size_type n) const noexcept { return ht_.cbegin(n); }
+
+        local_iterator end(size_type n) noexcept { return ht_.end(n); }
+
+        const_local_iterator end(size_type n) const noexcept { return ht_.end(n); }
+
+        const_local_iterator cend(size_type n) const noexcept { return ht_.cend(n); }
+
+        size_type bucket_count() const noexcept { return ht_.bucket_count(); }
+
+        size_type max_bucket_count() const noexcept { return ht_.max_bucket_count(); }
+
+        size_type bucket_size(size_type n) const noexcept { return ht_.bucket_size(n); }
+
+        size_type bucket(const key_type &key) const { return ht_.bucket(key); }
+
+        // hash policy
+
+        float load_factor() const noexcept { return ht_.load_factor(); }
+
+        float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+
+        void max_load_factor(float ml) { ht_.max_load_factor(ml); }
+
+        void rehash(size_type count) { ht_.rehash(count); }
+
+        void reserve(size_type count) { ht_.reserve(count); }
+
+        hasher hash_function() const { return ht_.hash_function(); }
+
+        key_equal key_eq() const { return ht_.key_eq(); }
+
+    public:
+        // 元素个数相同，且每个元素都能在另一个映射中找到相等的元素
+        friend bool operator==(const unordered_map &lhs, const unordered_map &rhs) {
+            return ht_equal_unique(lhs.ht_, rhs.ht_);
+        }
+
+        friend bool operator!=(const unordered_map &lhs, const unordered_map &rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+    // 重载 mystl 的 swap
+    template<class Key, class T, class Hash, class KeyEqual>
+    void swap(unordered_map<Key, T, Hash, KeyEqual> &lhs,
+              unordered_map<Key, T, Hash, KeyEqual> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+/*****************************************************************************************/
+
+    // 模板类 unordered_multimap，键值允许重复
+    // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash，
+    // 参数四代表键值相等的比较方式，缺省使用 mystl::equal_to
+    template<class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+    class unordered_multimap {
+    private:
+        // 以 mystl::hashtable 作为底层机制
+        typedef hashtable<mystl::pair<const Key, T>, Hash, KeyEqual> base_type;
+        base_type ht_;
+
+    public:
+        // 使用 hashtable 定义的型别
+        typedef typename base_type::key_type key_type;
+        typedef typename base_type::mapped_type mapped_type;
+        typedef typename base_type::value_type value_type;
+        typedef typename base_type::hasher hasher;
+        typedef typename base_type::key_equal key_equal;
+
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::reference reference;
+        typedef typename base_type::const_reference const_reference;
+        typedef typename base_type::iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef typename base_type::local_iterator local_iterator;
+        typedef typename base_type::const_local_iterator const_local_iterator;
+        typedef typename base_type::allocator_type allocator_type;
+
+    public:
+        // 构造、复制、移动函数
+        unordered_multimap() = default;
+
+        explicit unordered_multimap(size_type bucket_count, const hasher &hash = hasher(),
+                           const key_equal &equal = key_equal())
+                : ht_(bucket_count, hash, equal) {}
+
+        template<class InputIterator>
+        unordered_multimap(InputIterator first, InputIterator last, size_type bucket_count = 0,
+                  const hasher &hash = hasher(), const key_equal &equal = key_equal())
+                : ht_(bucket_count, hash, equal) {
+            ht_.insert_multi(first, last);
+        }
+
+        unordered_multimap(std::initializer_list<value_type> ilist, size_type bucket_count = 0,
+                  const hasher &hash = hasher(), const key_equal &equal = key_equal())
+                : ht_(bucket_count, hash, equal) {
+            ht_.reserve(ilist.size());
+            ht_.insert_multi(ilist.begin(), ilist.end());
+        }
+
+        unordered_multimap(const unordered_multimap &rhs) : ht_(rhs.ht_) {}
+
+        unordered_multimap(unordered_multimap &&rhs) noexcept: ht_(mystl::move(rhs.ht_)) {}
+
+        unordered_multimap &operator=(const unordered_multimap &rhs) {
+            ht_ = rhs.ht_;
+            return *this;
+        }
+
+        unordered_multimap &operator=(unordered_multimap &&rhs) noexcept {
+            ht_ = mystl::move(rhs.ht_);
+            return *this;
+        }
+
+        unordered_multimap &operator=(std::initializer_list<value_type> ilist) {
+            ht_.clear();
+            ht_.reserve(ilist.size());
+            ht_.insert_multi(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+        // 迭代器相关
+        iterator begin() noexcept { return ht_.begin(); }
+
+        const_iterator begin() const noexcept { return ht_.begin(); }
+
+        iterator end() noexcept { return ht_.end(); }
+
+        const_iterator end() const noexcept { return ht_.end(); }
+
+        const_iterator cbegin() const noexcept { return ht_.cbegin(); }
+
+        const_iterator cend() const noexcept { return ht_.cend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return ht_.empty(); }
+
+        size_type size() const noexcept { return ht_.size(); }
+
+        size_type max_size() const noexcept { return ht_.max_size(); }
+
+        // 插入删除操作
+        template<class ...Args>
+        iterator emplace(Args &&...args) {
+            return ht_.emplace_multi(mystl::forward<Args>(args)...);
+        }
+
+        // 元素所在的桶只由哈希值决定，hint 仅为接口一致
+        template<class ...Args>
+        iterator emplace_hint(const_iterator, Args &&...args) {
+            return ht_.emplace_multi(mystl::forward<Args>(args)...);
+        }
+
+        iterator insert(const value_type &value) {
+            return ht_.insert_multi(value);
+        }
+
+        iterator insert(value_type &&value) {
+            return ht_.insert_multi(mystl::move(value));
+        }
+
+        iterator insert(const_iterator, const value_type &value) {
+            return ht_.insert_multi(value);
+        }
+
+        iterator insert(const_iterator, value_type &&value) {
+            return ht_.insert_multi(mystl::move(value));
+        }
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            ht_.insert_multi(first, last);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            ht_.insert_multi(ilist.begin(), ilist.end());
+        }
+
+        iterator erase(const_iterator position) { return ht_.erase(position); }
+
+        iterator erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+
+        size_type erase(const key_type &key) { return ht_.erase_multi(key); }
+
+        void clear() noexcept { ht_.clear(); }
+
+        void swap(unordered_multimap &rhs) noexcept { ht_.swap(rhs.ht_); }
+
+        // 查找相关
+        iterator find(const key_type &key) { return ht_.find(key); }
+
+        const_iterator find(const key_type &key) const { return ht_.find(key); }
+
+        size_type count(const key_type &key) const { return ht_.count_multi(key); }
+
+        bool contains(const key_type &key) const { return ht_.count_multi(key) != 0; }
+
+        pair<iterator, iterator>
+        equal_range(const key_type &key) { return ht_.equal_range_multi(key); }
+
+        pair<const_iterator, const_iterator>
+        equal_range(const key_type &key) const { return ht_.equal_range_multi(key); }
+
+        // 异构查找，哈希函数与相等比较都定义了 is_transparent 时可用
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        size_type erase(const K &key) { return ht_.erase_multi(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        iterator find(const K &key) { return ht_.find(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        const_iterator find(const K &key) const { return ht_.find(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        size_type count(const K &key) const { return ht_.count_multi(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        bool contains(const K &key) const { return ht_.count_multi(key) != 0; }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        pair<iterator, iterator>
+        equal_range(const K &key) { return ht_.equal_range_multi(key); }
+
+        template<class K, class H = hasher, class E = key_equal, typename std::enable_if<
+                mystl::is_transparent<H>::value && mystl::is_transparent<E>::value, int>::type = 0>
+        pair<const_iterator, const_iterator>
+        equal_range(const K &key) const { return ht_.equal_range_multi(key); }
+
+        // bucket interface
+        local_iterator begin(size_type n) noexcept { return ht_.begin(n); }
+
+        const_local_iterator begin(size_type n) const noexcept { return ht_.begin(n); }
+
+        const_local_iterator cbegin(size_type n) const noexcept { return ht_.cbegin(n); }
+
+        local_iterator end(size_type n) noexcept { return ht_.end(n); }
+
+        const_local_iterator end(size_type n) const noexcept { return ht_.end(n); }
+
+        const_local_iterator cend(size_type n) const noexcept { return ht_.cend(n); }
+
+        size_type bucket_count() const noexcept { return ht_.bucket_count(); }
+
+        size_type max_bucket_count() const noexcept { return ht_.max_bucket_count(); }
+
+        size_type bucket_size(size_type n) const noexcept { return ht_.bucket_size(n); }
+
+        size_type bucket(const key_type &key) const { return ht_.bucket(key); }
+
+        // hash policy
+
+        float load_factor() const noexcept { return ht_.load_factor(); }
+
+        float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+
+        void max_load_factor(float ml) { ht_.max_load_factor(ml); }
+
+        void rehash(size_type count) { ht_.rehash(count); }
+
+        void reserve(size_type count) { ht_.reserve(count); }
+
+        hasher hash_function() const { return ht_.hash_function(); }
+
+        key_equal key_eq() const { return ht_.key_eq(); }
+
+    public:
+        // 元素个数相同，且每组键值相等的元素互为排列
+        friend bool operator==(const unordered_multimap &lhs, const unordered_multimap &rhs) {
+            return ht_equal_multi(lhs.ht_, rhs.ht_);
+        }
+
+        friend bool operator!=(const unordered_multimap &lhs, const unordered_multimap &rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+    // 重载 mystl 的 swap
+    template<class Key, class T, class Hash, class KeyEqual>
+    void swap(unordered_multimap<Key, T, Hash, KeyEqual> &lhs,
+              unordered_multimap<Key, T, Hash, KeyEqual> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_UNORDERED_MAP_H_
@@ -0,0 +1,1062 @@
+#ifndef MYTINYSTL_UNROLLED_LIST_H_
+#define MYTINYSTL_UNROLLED_LIST_H_
+
+// 这个头文件包含一个模板类 unrolled_list
+// unrolled_list : 展开链表，每个节点按 NodeBytes 字节（默认 256，即 4 条 cache line）连续存放多个元素，
+// 遍历时每个节点只有一次指针跳转，而 list 每个元素都要跳转一次
+
+// notes:
+//
+// 1. 节点组成带哨兵的双向环形链表，哨兵内嵌在 unrolled_list 中，迭代器为（节点，下标），end() 为（哨兵，0）
+// 2. 节点内的插入、删除只移动同一节点中的元素，代价不超过节点容量；节点满时对半分裂，
+//    删除后与相邻节点合起来不超过半满时合并
+// 3. 插入、删除使所在节点中操作位置之后的迭代器失效，分裂、合并时还有被移动的那部分元素，其余迭代器保持有效
+// 4. splice 以整个节点转移元素，只有 pos、first、last 所在的节点需要在该处分裂，
+//    其余被转移元素的迭代器、引用仍然有效，并改为指向本 unrolled_list 中的元素
+// 5. remove / remove_if / unique 把保留的元素依次前移填满原有节点，之后的节点整块释放
+// 6. 200 万个 long 顺序遍历求和比节点按内存顺序排列的 list 快约 4 倍，list 的节点在内存中乱序时差距超过 100 倍；
+//    每隔 16 个元素插入一个元素的耗时与 list 相当（见 bench/unrolled_list_bench）
+//
+// 异常保证：
+// mystl::unrolled_list<T> 满足基本异常保证，并对以下等函数做强异常安全保证：
+//   * emplace_back
+//   * push_back
+//   * insert（插入多个元素）
+
+#include <initializer_list>
+#include <cstddef>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+    // unrolled_list 节点的指针部分，哨兵节点只有这一部分
+    struct unrolled_list_node_base {
+        unrolled_list_node_base *prev;
+        unrolled_list_node_base *next;
+    };
+
+    // 数据节点，元素存放在未初始化的 slots 中，前 count 个已构造
+    template<class T, size_t Slots>
+    struct unrolled_list_node : public unrolled_list_node_base {
+        size_t count;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[Slots];
+
+        T *values() noexcept { return reinterpret_cast<T *>(slots); }
+
+        const T *values() const noexcept { return reinterpret_cast<const T *>(slots); }
+
+        T &value(size_t i) noexcept { return values()[i]; }
+    };
+
+    // unrolled_list 的迭代器，指向节点 node 中下标为 pos 的元素
+    template<class T, class Ref, class Ptr, class Node>
+    struct unrolled_list_iterator : public iterator<bidirectional_iterator_tag, T> {
+        typedef unrolled_list_iterator<T, T &, T *, Node> iterator;
+        typedef unrolled_list_iterator<T, const T &, const T *, Node> const_iterator;
+        typedef unrolled_list_iterator self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef unrolled_list_node_base *base_ptr;
+
+        base_ptr node;
+        size_type pos;
+
+        // 构造、复制函数
+        unrolled_list_iterator() noexcept: node(nullptr), pos(0) {}
+
+        unrolled_list_iterator(base_ptr n, size_type p) noexcept: node(n), pos(p) {}
+
+        unrolled_list_iterator(const iterator &rhs) noexcept: node(rhs.node), pos(rhs.pos) {}
+
+        unrolled_list_iterator &operator=(const unrolled_list_iterator &rhs) = default;
+
+        // 重载操作符
+        reference operator*() const { return static_cast<Node *>(node)->value(pos); }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self &operator++() {
+            MYSTL_DEBUG(node != nullptr);
+            if (++pos == static_cast<Node *>(node)->count) {
+                node = node->next;
+                pos = 0;
+            }
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self &operator--() {
+            MYSTL_DEBUG(node != nullptr);
+            if (pos == 0) {
+                node = node->prev;
+                pos = static_cast<Node *>(node)->count;
+            }
+            --pos;
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return node == rhs.node && pos == rhs.pos; }
+
+        bool operator!=(const self &rhs) const { return !(*this == rhs); }
+    };
+
+    // 模板类 unrolled_list
+    // 参数一代表数据类型，参数二代表节点的目标字节数
+    template<class T, size_t NodeBytes = 256>
+    class unrolled_list {
+    public:
+        // unrolled_list 的嵌套型别定义
+        typedef mystl::allocator<T> allocator_type;
+        typedef mystl::allocator<T> data_allocator;
+
+        typedef typename allocator_type::value_type value_type;
+        typedef typename allocator_type::pointer pointer;
+        typedef typename allocator_type::const_pointer const_pointer;
+        typedef typename allocator_type::reference reference;
+        typedef typename allocator_type::const_reference const_reference;
+        typedef typename allocator_type::size_type size_type;
+        typedef typename allocator_type::difference_type difference_type;
+
+        // 每个节点可容纳的元素个数，由节点的目标字节数决定，至少为 4
+        static constexpr size_type node_header = sizeof(unrolled_list_node_base) + sizeof(size_t);
+        static constexpr size_type node_capacity =
+                NodeBytes > node_header + 4 * sizeof(T) ? (NodeBytes - node_header) / sizeof(T) : 4;
+
+        typedef unrolled_list_node<T, node_capacity> node_type;
+        typedef unrolled_list_node_base *base_ptr;
+        typedef node_type *node_ptr;
+        typedef mystl::allocator<node_type> node_allocator;
+
+        typedef unrolled_list_iterator<T, T &, T *, node_type> iterator;
+        typedef unrolled_list_iterator<T, const T &, const T *, node_type> const_iterator;
+        typedef mystl::reverse_iterator<iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        allocator_type get_allocator() const { return allocator_type(); }
+
+    private:
+        // 删除后相邻两个节点的元素合起来不超过 merge_limit 个时合并为一个节点
+        static constexpr size_type merge_limit = node_capacity / 2;
+
+        unrolled_list_node_base head_;  // 哨兵，head_.next 为第一个节点，head_.prev 为最后一个节点
+        size_type size_;                // 元素个数
+
+    public:
+        // 构造、复制、移动、析构函数
+        unrolled_list() noexcept: size_(0) { reset_head(); }
+
+        explicit unrolled_list(size_type n) : size_(0) {
+            reset_head();
+            fill_init(n, value_type());
+        }
+
+        unrolled_list(size_type n, const value_type &value) : size_(0) {
+            reset_head();
+            fill_init(n, value);
+        }
+
+        template<class Iter, typename std::enable_if<
+                mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        unrolled_list(Iter first, Iter last) : size_(0) {
+            reset_head();
+            copy_init(first, last);
+        }
+
+        unrolled_list(std::initializer_list<value_type> ilist) : size_(0) {
+            reset_head();
+            copy_init(ilist.begin(), ilist.end());
+        }
+
+        unrolled_list(const unrolled_list &rhs) : size_(0) {
+            reset_head();
+            copy_init(rhs.begin(), rhs.end());
+        }
+
+        unrolled_list(unrolled_list &&rhs) noexcept: size_(0) {
+            reset_head();
+            take_nodes(rhs);
+        }
+
+        unrolled_list &operator=(const unrolled_list &rhs) {
+            if (this != &rhs) {
+                unrolled_list tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        unrolled_list &operator=(unrolled_list &&rhs) noexcept {
+            unrolled_list tmp(mystl::move(rhs));
+            swap(tmp);
+            return *this;
+        }
+
+        unrolled_list &operator=(std::initializer_list<value_type> ilist) {
+            unrolled_list tmp(ilist);
+            swap(tmp);
+            return *this;
+        }
+
+        ~unrolled_list() { clear(); }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return iterator(head_.next, 0); }
+
+        const_iterator begin() const noexcept { return const_iterator(head_.next, 0); }
+
+        iterator end() noexcept { return iterator(&head_, 0); }
+
+        const_iterator end() const noexcept { return const_iterator(const_cast<base_ptr>(&head_), 0); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return size_ == 0; }
+
+        size_type size() const noexcept { return size_; }
+
+        size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+        // 访问元素相关操作
+        reference front() {
+            MYSTL_DEBUG(!empty());
+            return as_node(head_.next)->value(0);
+        }
+
+        const_reference front() const {
+            MYSTL_DEBUG(!empty());
+            return as_node(head_.next)->value(0);
+        }
+
+        reference back() {
+            MYSTL_DEBUG(!empty());
+            auto x = as_node(head_.prev);
+            return x->value(x->count - 1);
+        }
+
+        const_reference back() const {
+            MYSTL_DEBUG(!empty());
+            auto x = as_node(head_.prev);
+            return x->value(x->count - 1);
+        }
+
+        // 调整容器相关操作
+        void assign(size_type n, const value_type &value) {
+            unrolled_list tmp(n, value);
+            swap(tmp);
+        }
+
+        template<class Iter, typename std::enable_if<
+                mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last) {
+            unrolled_list tmp(first, last);
+            swap(tmp);
+        }
+
+        void assign(std::initializer_list<value_type> ilist) {
+            unrolled_list tmp(ilist);
+            swap(tmp);
+        }
+
+        // emplace_front / emplace_back / emplace
+        template<class ...Args>
+        void emplace_front(Args &&...args);
+
+        template<class ...Args>
+        void emplace_back(Args &&...args);
+
+        template<class ...Args>
+        iterator emplace(const_iterator pos, Args &&...args);
+
+        // insert
+        iterator insert(const_iterator pos, const value_type &value) { return emplace(pos, value); }
+
+        iterator insert(const_iterator pos, value_type &&value) { return emplace(pos, mystl::move(value)); }
+
+        // 插入多个元素时先在临时的 unrolled_list 中排满节点，再整块接入
+        iterator insert(const_iterator pos, size_type n, const value_type &value) {
+            unrolled_list tmp(n, value);
+            return insert_nodes(pos, tmp);
+        }
+
+        template<class Iter, typename std::enable_if<
+                mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last) {
+            unrolled_list tmp(first, last);
+            return insert_nodes(pos, tmp);
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<value_type> ilist) {
+            unrolled_list tmp(ilist);
+            return insert_nodes(pos, tmp);
+        }
+
+        // push_front / push_back
+        void push_front(const value_type &value) { emplace_front(value); }
+
+        void push_front(value_type &&value) { emplace_front(mystl::move(value)); }
+
+        void push_back(const value_type &value) { emplace_back(value); }
+
+        void push_back(value_type &&value) { emplace_back(mystl::move(value)); }
+
+        // pop_front / pop_back
+        void pop_front() {
+            MYSTL_DEBUG(!empty());
+            erase_at(as_node(head_.next), 0);
+        }
+
+        void pop_back() {
+            MYSTL_DEBUG(!empty());
+            auto x = as_node(head_.prev);
+            erase_at(x, x->count - 1);
+        }
+
+        // erase / clear
+        iterator erase(const_iterator pos) {
+            MYSTL_DEBUG(pos != cend());
+            return erase_at(as_node(pos.node), pos.pos);
+        }
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        void clear() noexcept;
+
+        // resize
+        void resize(size_type new_size) { resize(new_size, value_type()); }
+
+        void resize(size_type new_size, const value_type &value);
+
+        void swap(unrolled_list &rhs) noexcept {
+            if (this != &rhs) {
+                unrolled_list tmp;
+                tmp.take_nodes(rhs);
+                rhs.take_nodes(*this);
+                take_nodes(tmp);
+            }
+        }
+
+        // unrolled_list 相关操作
+
+        // 把 other 的所有元素接到 pos 之前，other 的节点整个转移过来
+        void splice(const_iterator pos, unrolled_list &other);
+
+        // 把 other 中 it 指向的元素接到 pos 之前
+        void splice(const_iterator pos, unrolled_list &other, const_iterator it) {
+            auto next = it;
+            splice(pos, other, it, ++next);
+        }
+
+        // 把 other 中 [first, last) 内的元素接到 pos 之前
+        void splice(const_iterator pos, unrolled_list &other, const_iterator first, const_iterator last);
+
+        void remove(const value_type &value) {
+            remove_if([&](const value_type &v) { return v == value; });
+        }
+
+        template<class UnaryPredicate>
+        void remove_if(UnaryPredicate pred);
+
+        void unique() {
+            unique([](const value_type &a, const value_type &b) { return a == b; });
+        }
+
+        template<class BinaryPredicate>
+        void unique(BinaryPredicate pred);
+
+        void reverse() noexcept;
+
+    private:
+        // helper functions
+        static node_ptr as_node(base_ptr x) noexcept { return static_cast<node_ptr>(x); }
+
+        void reset_head() noexcept {
+            head_.prev = head_.next = &head_;
+        }
+
+        // 接管 rhs 的所有节点，本 unrolled_list 需为空
+        void take_nodes(unrolled_list &rhs) noexcept;
+
+        // initialize
+        void fill_init(size_type n, const value_type &value);
+
+        template<class Iter>
+        void copy_init(Iter first, Iter last);
+
+        // create / destroy node
+        static node_ptr create_node();
+
+        static void destroy_node(node_ptr x) noexcept;
+
+        // link / unlink
+        static void link_nodes(base_ptr pos, base_ptr first, base_ptr last) noexcept;
+
+        static void unlink_node(base_ptr x) noexcept;
+
+        // 把节点 x 中下标不小于 k 的元素移到紧随其后的新节点中，返回新节点
+        static node_ptr split_node(node_ptr x, size_type k);
+
+        // 在（node，pos）处分裂节点，返回以该位置开头的节点
+        static base_ptr split_at(base_ptr node, size_type pos);
+
+        // 节点 x 在 k 处分裂出 y 之后，修正原来指向 x 中被移走元素的迭代器
+        static void follow_split(const_iterator &it, base_ptr x, size_type k, base_ptr y) noexcept;
+
+        // insert / erase
+        iterator insert_value(node_ptr x, size_type pos, value_type &&value);
+
+        iterator insert_nodes(const_iterator pos, unrolled_list &tmp);
+
+        iterator erase_at(node_ptr x, size_type pos);
+
+        iterator rebalance(node_ptr x, size_type pos);
+
+        // 析构（node，pos）及之后的所有元素
+        void truncate(base_ptr node, size_type pos) noexcept;
+
+        iterator locate(size_type n) noexcept;
+
+        // 节点内的元素操作
+        static void slot_insert(value_type *first, size_type n, size_type pos, value_type &&value);
+
+        static void slot_erase(value_type *first, size_type n, size_type pos) noexcept;
+
+        static void slot_move(value_type *dst, value_type *src, size_type n) noexcept;
+
+    public:
+        friend bool operator==(const unrolled_list &lhs, const unrolled_list &rhs) {
+            return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator<(const unrolled_list &lhs, const unrolled_list &rhs) {
+            return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+    };
+
+    template<class T, size_t NodeBytes>
+    constexpr typename unrolled_list<T, NodeBytes>::size_type unrolled_list<T, NodeBytes>::node_header;
+
+    template<class T, size_t NodeBytes>
+    constexpr typename unrolled_list<T, NodeBytes>::size_type unrolled_list<T, NodeBytes>::node_capacity;
+
+    template<class T, size_t NodeBytes>
+    constexpr typename unrolled_list<T, NodeBytes>::size_type unrolled_list<T, NodeBytes>::merge_limit;
+
+/*****************************************************************************************/
+
+// 在头部就地构造元素，第一个节点已满时在它之前新建节点
+    template<class T, size_t NodeBytes>
+    template<class ...Args>
+    void unrolled_list<T, NodeBytes>::
+    emplace_front(Args &&...args) {
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+        auto first = head_.next;
+        if (first != &head_ && as_node(first)->count < node_capacity) {
+            value_type value(mystl::forward<Args>(args)...);
+            auto x = as_node(first);
+            slot_insert(x->values(), x->count, 0, mystl::move(value));
+            ++x->count;
+        } else {
+            auto x = create_node();
+            try {
+                data_allocator::construct(x->values(), mystl::forward<Args>(args)...);
+            } catch (...) {
+                node_allocator::deallocate(x);
+                throw;
+            }
+            x->count = 1;
+            link_nodes(first, x, x);
+        }
+        ++size_;
+    }
+
+// 在尾部就地构造元素，最后一个节点已满时在它之后新建节点
+    template<class T, size_t NodeBytes>
+    template<class ...Args>
+    void unrolled_list<T, NodeBytes>::
+    emplace_back(Args &&...args) {
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+        auto last = head_.prev;
+        if (last != &head_ && as_node(last)->count < node_capacity) {
+            auto x = as_node(last);
+            data_allocator::construct(x->values() + x->count, mystl::forward<Args>(args)...);
+            ++x->count;
+        } else {
+            auto x = create_node();
+            try {
+                data_allocator::construct(x->values(), mystl::forward<Args>(args)...);
+            } catch (...) {
+                node_allocator::deallocate(x);
+                throw;
+            }
+            x->count = 1;
+            link_nodes(&head_, x, x);
+        }
+        ++size_;
+    }
+
+// 在 pos 处就地构造元素
+    template<class T, size_t NodeBytes>
+    template<class ...Args>
+    typename unrolled_list<T, NodeBytes>::iterator
+    unrolled_list<T, NodeBytes>::
+    emplace(const_iterator pos, Args &&...args) {
+        if (pos.node == &head_) {
+            emplace_back(mystl::forward<Args>(args)...);
+            auto x = as_node(head_.prev);
+            return iterator(x, x->count - 1);
+        }
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+        value_type value(mystl::forward<Args>(args)...);
+        return insert_value(as_node(pos.node), pos.pos, mystl::move(value));
+    }
+
+// 删除 [first, last) 内的元素
+// 中间的节点整个释放，first、last 所在的节点各自删去范围内的部分
+    template<class T, size_t NodeBytes>
+    typename unrolled_list<T, NodeBytes>::iterator
+    unrolled_list<T, NodeBytes>::
+    erase(const_iterator first, const_iterator last) {
+        if (first == last) {
+            return iterator(last.node, last.pos);
+        }
+        auto x = as_node(first.node);
+        if (first.node == last.node) {
+            auto vals = x->values();
+            const size_type n = last.pos - first.pos;
+            mystl::move(vals + last.pos, vals + x->count, vals + first.pos);
+            data_allocator::destroy(vals + x->count - n, vals + x->count);
+            x->count -= n;
+            size_ -= n;
+            return rebalance(x, first.pos);
+        }
+        size_ -= x->count - first.pos;
+        data_allocator::destroy(x->values() + first.pos, x->values() + x->count);
+        x->count = first.pos;
+        for (auto cur = x->next; cur != last.node;) {
+            auto next = cur->next;
+            size_ -= as_node(cur)->count;
+            unlink_node(cur);
+            destroy_node(as_node(cur));
+            cur = next;
+        }
+        if (x->count == 0) {
+            unlink_node(x);
+            node_allocator::deallocate(x);
+        }
+        if (last.node == &head_) {
+            return end();
+        }
+        auto y = as_node(last.node);
+        if (last.pos != 0) {
+            auto vals = y->values();
+            mystl::move(vals + last.pos, vals + y->count, vals);
+            data_allocator::destroy(vals + y->count - last.pos, vals + y->count);
+            y->count -= last.pos;
+            size_ -= last.pos;
+        }
+        return rebalance(y, 0);
+    }
+
+// 析构所有元素并释放所有节点
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    clear() noexcept {
+        for (auto cur = head_.next; cur != &head_;) {
+            auto next = cur->next;
+            destroy_node(as_node(cur));
+            cur = next;
+        }
+        reset_head();
+        size_ = 0;
+    }
+
+// 重置容器大小
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    resize(size_type new_size, const value_type &value) {
+        if (new_size < size_) {
+            erase(locate(new_size), end());
+            return;
+        }
+        for (size_type n = new_size - size_; n > 0; --n) {
+            emplace_back(value);
+        }
+    }
+
+// 把 other 的所有元素接到 pos 之前
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    splice(const_iterator pos, unrolled_list &other) {
+        MYSTL_DEBUG(this != &other);
+        if (other.empty()) {
+            return;
+        }
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - other.size_, "unrolled_list<T>'s size too big");
+        auto b = split_at(pos.node, pos.pos);
+        auto f = other.head_.next;
+        auto l = other.head_.prev;
+        size_ += other.size_;
+        other.reset_head();
+        other.size_ = 0;
+        link_nodes(b, f, l);
+    }
+
+// 把 other 中 [first, last) 内的元素接到 pos 之前
+// 先依次在 first、last、pos 处分裂节点，使它们都位于节点开头，再转移 [first, last) 之间的整个节点；
+// 前面的分裂可能把后面的位置移到新节点中，需要随之修正
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    splice(const_iterator pos, unrolled_list &other, const_iterator first, const_iterator last) {
+        if (first == last || (this == &other && (pos == first || pos == last))) {
+            return;
+        }
+        if (first.pos != 0) {
+            auto y = split_node(as_node(first.node), first.pos);
+            follow_split(last, first.node, first.pos, y);
+            follow_split(pos, first.node, first.pos, y);
+            first = const_iterator(y, 0);
+        }
+        if (last.pos != 0) {
+            auto y = split_node(as_node(last.node), last.pos);
+            follow_split(pos, last.node, last.pos, y);
+            last = const_iterator(y, 0);
+        }
+        auto b = split_at(pos.node, pos.pos);
+        auto f = first.node;
+        auto l = last.node->prev;
+        if (this != &other) {
+            size_type n = 0;
+            for (auto cur = f; cur != last.node; cur = cur->next) {
+                n += as_node(cur)->count;
+            }
+            THROW_LENGTH_ERROR_IF(size_ > max_size() - n, "unrolled_list<T>'s size too big");
+            size_ += n;
+            other.size_ -= n;
+        }
+        f->prev->next = last.node;
+        last.node->prev = f->prev;
+        link_nodes(b, f, l);
+    }
+
+// 将使 pred 为 true 的元素移除
+// 读、写两个位置同时前进，保留的元素移到写位置，最后析构写位置之后的元素
+    template<class T, size_t NodeBytes>
+    template<class UnaryPredicate>
+    void unrolled_list<T, NodeBytes>::
+    remove_if(UnaryPredicate pred) {
+        base_ptr wn = head_.next;
+        size_type wi = 0;
+        size_type kept = 0;
+        for (auto rn = head_.next; rn != &head_; rn = rn->next) {
+            auto r = as_node(rn);
+            for (size_type ri = 0; ri < r->count; ++ri) {
+                auto &v = r->value(ri);
+                if (pred(v)) {
+                    continue;
+                }
+                auto &dst = as_node(wn)->value(wi);
+                if (&dst != &v) {
+                    dst = mystl::move(v);
+                }
+                ++kept;
+                if (++wi == as_node(wn)->count) {
+                    wn = wn->next;
+                    wi = 0;
+                }
+            }
+        }
+        truncate(wn, wi);
+        size_ = kept;
+    }
+
+// 移除与前一个保留的元素使 pred 为 true 的元素
+    template<class T, size_t NodeBytes>
+    template<class BinaryPredicate>
+    void unrolled_list<T, NodeBytes>::
+    unique(BinaryPredicate pred) {
+        base_ptr wn = head_.next;
+        size_type wi = 0;
+        size_type kept = 0;
+        value_type *last = nullptr;
+        for (auto rn = head_.next; rn != &head_; rn = rn->next) {
+            auto r = as_node(rn);
+            for (size_type ri = 0; ri < r->count; ++ri) {
+                auto &v = r->value(ri);
+                if (last != nullptr && pred(*last, v)) {
+                    continue;
+                }
+                auto &dst = as_node(wn)->value(wi);
+                if (&dst != &v) {
+                    dst = mystl::move(v);
+                }
+                last = &dst;
+                ++kept;
+                if (++wi == as_node(wn)->count) {
+                    wn = wn->next;
+                    wi = 0;
+                }
+            }
+        }
+        truncate(wn, wi);
+        size_ = kept;
+    }
+
+// 翻转 unrolled_list：交换每个节点（包括哨兵）的 prev 与 next，并翻转节点内的元素
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    reverse() noexcept {
+        base_ptr cur = &head_;
+        do {
+            mystl::swap(cur->prev, cur->next);
+            if (cur != &head_) {
+                auto x = as_node(cur);
+                for (size_type i = 0, j = x->count - 1; i < j; ++i, --j) {
+                    mystl::swap(x->value(i), x->value(j));
+                }
+            }
+            cur = cur->prev;
+        } while (cur != &head_);
+    }
+
+/*****************************************************************************************/
+// helper function
+
+// 接管 rhs 的所有节点
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    take_nodes(unrolled_list &rhs) noexcept {
+        if (rhs.head_.next == &rhs.head_) {
+            return;
+        }
+        head_.next = rhs.head_.next;
+        head_.prev = rhs.head_.prev;
+        head_.next->prev = &head_;
+        head_.prev->next = &head_;
+        size_ = rhs.size_;
+        rhs.reset_head();
+        rhs.size_ = 0;
+    }
+
+// 用 n 个 value 初始化，失败时释放已构造的元素
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    fill_init(size_type n, const value_type &value) {
+        try {
+            for (; n > 0; --n) {
+                emplace_back(value);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+// 用 [first, last) 初始化，失败时释放已构造的元素
+    template<class T, size_t NodeBytes>
+    template<class Iter>
+    void unrolled_list<T, NodeBytes>::
+    copy_init(Iter first, Iter last) {
+        try {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+// 分配一个空节点
+    template<class T, size_t NodeBytes>
+    typename unrolled_list<T, NodeBytes>::node_ptr
+    unrolled_list<T, NodeBytes>::
+    create_node() {
+        auto x = node_allocator::allocate(1);
+        x->prev = nullptr;
+        x->next = nullptr;
+        x->count = 0;
+        return x;
+    }
+
+// 析构节点中的元素并释放节点
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    destroy_node(node_ptr x) noexcept {
+        data_allocator::destroy(x->values(), x->values() + x->count);
+        node_allocator::deallocate(x);
+    }
+
+// 把 [first, last] 内的节点接到 pos 之前
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    link_nodes(base_ptr pos, base_ptr first, base_ptr last) noexcept {
+        first->prev = pos->prev;
+        last->next = pos;
+        pos->prev->next = first;
+        pos->prev = last;
+    }
+
+// 从链表中摘下节点 x
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    unlink_node(base_ptr x) noexcept {
+        x->prev->next = x->next;
+        x->next->prev = x->prev;
+    }
+
+// 把节点 x 中下标不小于 k 的元素移到新节点中
+    template<class T, size_t NodeBytes>
+    typename unrolled_list<T, NodeBytes>::node_ptr
+    unrolled_list<T, NodeBytes>::
+    split_node(node_ptr x, size_type k) {
+        auto y = create_node();
+        slot_move(y->values(), x->values() + k, x->count - k);
+        y->count = x->count - k;
+        x->count = k;
+        link_nodes(x->next, y, y);
+        return y;
+    }
+
+// 在（node，pos）处分裂节点，返回以该位置开头的节点
+    template<class T, size_t NodeBytes>
+    typename unrolled_list<T, NodeBytes>::base_ptr
+    unrolled_list<T, NodeBytes>::
+    split_at(base_ptr node, size_type pos) {
+        return pos == 0 ? node : split_node(as_node(node), pos);
+    }
+
+// 修正分裂后的迭代器
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    follow_split(const_iterator &it, base_ptr x, size_type k, base_ptr y) noexcept {
+        if (it.node == x && it.pos >= k) {
+            it.node = y;
+            it.pos -= k;
+        }
+    }
+
+// 在节点 x 的 pos 处放入 value
+// 节点已满时，若插在节点开头且前一节点有空位就追加到前一节点末尾，否则对半分裂
+    template<class T, size_t NodeBytes>
+    typename unrolled_list<T, NodeBytes>::iterator
+    unrolled_list<T, NodeBytes>::
+    insert_value(node_ptr x, size_type pos, value_type &&value) {
+        if (x->count == node_capacity) {
+            auto prev = x->prev;
+            if (pos == 0 && prev != &head_ && as_node(prev)->count < node_capacity) {
+                auto p = as_node(prev);
+                data_allocator::construct(p->values() + p->count, mystl::move(value));
+                ++size_;
+                return iterator(p, p->count++);
+            }
+            auto y = split_node(x, node_capacity / 2);
+            if (pos > x->count) {
+                pos -= x->count;
+                x = y;
+            }
+        }
+        slot_insert(x->values(), x->count, pos, mystl::move(value));
+        ++x->count;
+        ++size_;
+        return iterator(x, pos);
+    }
+
+// 把 tmp 的所有节点接到 pos 之前，返回指向第一个接入元素的迭代器
+    template<class T, size_t NodeBytes>
+    typename unrolled_list<T, NodeBytes>::iterator
+    unrolled_list<T, NodeBytes>::
+    insert_nodes(const_iterator pos, unrolled_list &tmp) {
+        if (tmp.empty()) {
+            return iterator(pos.node, pos.pos);
+        }
+        iterator r(tmp.head_.next, 0);
+        splice(pos, tmp);
+        return r;
+    }
+
+// 删除节点 x 中下标为 pos 的元素
+    template<class T, size_t NodeBytes>
+    typename unrolled_list<T, NodeBytes>::iterator
+    unrolled_list<T, NodeBytes>::
+    erase_at(node_ptr x, size_type pos) {
+        slot_erase(x->values(), x->count, pos);
+        --x->count;
+        --size_;
+        return rebalance(x, pos);
+    }
+
+// 删除元素后整理节点 x：空节点直接释放，与相邻节点合起来不超过 merge_limit 个元素时合并
+// 返回原来位于（x，pos）的元素现在的位置，pos 等于元素个数时为下一个节点的开头
+    template<class T, size_t NodeBytes>
+    typename unrolled_list<T, NodeBytes>::iterator
+    unrolled_list<T, NodeBytes>::
+    rebalance(node_ptr x, size_type pos) {
+        if (x->count == 0) {
+            auto next = x->next;
+            unlink_node(x);
+            node_allocator::deallocate(x);
+            return iterator(next, 0);
+        }
+        auto next = x->next;
+        if (next != &head_ && x->count + as_node(next)->count <= merge_limit) {
+            auto y = as_node(next);
+            slot_move(x->values() + x->count, y->values(), y->count);
+            x->count += y->count;
+            unlink_node(y);
+            node_allocator::deallocate(y);
+        }
+        auto prev = x->prev;
+        if (prev != &head_ && as_node(prev)->count + x->count <= merge_limit) {
+            auto p = as_node(prev);
+            slot_move(p->values() + p->count, x->values(), x->count);
+            pos += p->count;
+            p->count += x->count;
+            unlink_node(x);
+            node_allocator::deallocate(x);
+            x = p;
+        }
+        return pos == x->count ? iterator(x->next, 0) : iterator(x, pos);
+    }
+
+// 析构（node，pos）及之后的所有元素，释放变空的节点
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    truncate(base_ptr node, size_type pos) noexcept {
+        if (node == &head_) {
+            return;
+        }
+        auto x = as_node(node);
+        data_allocator::destroy(x->values() + pos, x->values() + x->count);
+        x->count = pos;
+        auto cur = x->next;
+        if (pos == 0) {
+            unlink_node(x);
+            node_allocator::deallocate(x);
+        }
+        while (cur != &head_) {
+            auto next = cur->next;
+            unlink_node(cur);
+            destroy_node(as_node(cur));
+            cur = next;
+        }
+    }
+
+// 返回指向第 n 个元素的迭代器，按节点跳过，从较近的一端开始
+    template<class T, size_t NodeBytes>
+    typename unrolled_list<T, NodeBytes>::iterator
+    unrolled_list<T, NodeBytes>::
+    locate(size_type n) noexcept {
+        if (n >= size_) {
+            return end();
+        }
+        if (n < size_ / 2) {
+            auto cur = head_.next;
+            for (; n >= as_node(cur)->count; cur = cur->next) {
+                n -= as_node(cur)->count;
+            }
+            return iterator(cur, n);
+        }
+        auto cur = head_.prev;
+        size_type rest = size_ - n;  // 从后往前数的第 rest 个元素
+        for (; rest > as_node(cur)->count; cur = cur->prev) {
+            rest -= as_node(cur)->count;
+        }
+        return iterator(cur, as_node(cur)->count - rest);
+    }
+
+// 在含 n 个元素的数组的 pos 处插入 value，数组尾部有未初始化的空间
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    slot_insert(value_type *first, size_type n, size_type pos, value_type &&value) {
+        if (pos == n) {
+            data_allocator::construct(first + n, mystl::move(value));
+            return;
+        }
+        data_allocator::construct(first + n, mystl::move(first[n - 1]));
+        mystl::move_backward(first + pos, first + n - 1, first + n);
+        first[pos] = mystl::move(value);
+    }
+
+// 删除含 n 个元素的数组 pos 处的元素
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    slot_erase(value_type *first, size_type n, size_type pos) noexcept {
+        mystl::move(first + pos + 1, first + n, first + pos);
+        data_allocator::destroy(first + n - 1);
+    }
+
+// 把 src 的 n 个元素移动到未初始化的 dst，并析构 src
+    template<class T, size_t NodeBytes>
+    void unrolled_list<T, NodeBytes>::
+    slot_move(value_type *dst, value_type *src, size_type n) noexcept {
+        for (size_type i = 0; i < n; ++i) {
+            data_allocator::construct(dst + i, mystl::move(src[i]));
+            data_allocator::destroy(src + i);
+        }
+    }
+
+    // 重载比较操作符
+    template<class T, size_t NodeBytes>
+    bool operator!=(const unrolled_list<T, NodeBytes> &lhs, const unrolled_list<T, NodeBytes> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, size_t NodeBytes>
+    bool operator>(const unrolled_list<T, NodeBytes> &lhs, const unrolled_list<T, NodeBytes> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, size_t NodeBytes>
+    bool operator<=(const unrolled_list<T, NodeBytes> &lhs, const unrolled_list<T, NodeBytes> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, size_t NodeBytes>
+    bool operator>=(const unrolled_list<T, NodeBytes> &lhs, const unrolled_list<T, NodeBytes> &rhs) {
+        return !(lhs < rhs);
+    }
+
+// 重载 mystl 的 swap
+    template<class T, size_t NodeBytes>
+    void swap(unrolled_list<T, NodeBytes> &lhs, unrolled_list<T, NodeBytes> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+#endif // !MYTINYSTL_UNROLLED_LIST_H_
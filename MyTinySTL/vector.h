@@ -23,7 +23,7 @@ namespace mystl {
 
 // 模板类: vector 
 // 模板参数 T 代表类型
-    template<class T>
+    template<class T, class Alloc = mystl::allocator<T>>
     class vector {
         // 静态断言，static_assert(常量表达式，提示字符串)
         // 若常量表达式为true则跳过，若为false则产生一条编译错误，错误提示为后面的提示字符串
@@ -31,8 +31,9 @@ namespace mystl {
         static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in mystl");
     public:
         // vector 的嵌套型别定义
-        typedef mystl::allocator<T> allocator_type;
-        typedef mystl::allocator<T> data_allocator;
+        // Alloc 为空间配置器，缺省使用 mystl::allocator，大容量时可换成 mystl::huge_page_allocator
+        typedef Alloc allocator_type;
+        typedef Alloc data_allocator;
 
         typedef typename allocator_type::value_type value_type;
         typedef typename allocator_type::pointer pointer;
@@ -264,12 +265,16 @@ namespace mystl {
         void clear() { erase(begin(), end()); }
 
         // resize / reverse
-        void resize(size_type new_size) { return resize(new_size, value_type); }
+        void resize(size_type new_size) { return resize(new_size, value_type()); }
 
         void resize(size_type new_size, const value_type &value);
 
         void reverse() { mystl::reverse(begin(), end()); }
 
+        // 在尾部追加 n 个未初始化的元素并返回它们的起始位置，由调用者直接写入数据（如从文件读入）
+        // 只用于平凡可复制的类型
+        pointer append_uninitialized(size_type n);
+
         // swap
         void swap(vector &rhs) noexcept;
 
@@ -318,8 +323,8 @@ namespace mystl {
 /**********************************************************************************************/
 
 // 复制赋值操作符
-    template<class T>
-    vector<T> &vector<T>::operator=(const vector &&rhs) noexcept {
+    template<class T, class Alloc>
+    vector<T, Alloc> &vector<T, Alloc>::operator=(const vector &rhs) {
         if (this != &rhs) {
             // auto即自动类型推导，由于auto默认自动推导后不带const，因此要带上const
             const auto len = rhs.size();
@@ -348,8 +353,8 @@ namespace mystl {
     }
 
 // 移动赋值操作符
-    template<class T>
-    vector<T> &vector<T>::operator=(vector<T> &&rhs) noexcept {
+    template<class T, class Alloc>
+    vector<T, Alloc> &vector<T, Alloc>::operator=(vector<T, Alloc> &&rhs) noexcept {
         // 先销毁再恢复？
         destroy_and_recover(begin_, end_, cap_ - begin_);
         begin_ = rhs.begin_;
@@ -363,8 +368,8 @@ namespace mystl {
 
 // 预留空间大小，当原容量小于要求大小时，才会重新分配
 // reserve的作用是更改vector的容量（capacity），使vector至少可以容纳n个元素
-    template<class T>
-    void vector<T>::reserve(size_type n) {
+    template<class T, class Alloc>
+    void vector<T, Alloc>::reserve(size_type n) {
         if (capacity() < n) {
             THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than maxsize() in vector<T>::reserve(n)");
             const auto old_size = size();
@@ -378,18 +383,18 @@ namespace mystl {
     }
 
 // 放弃多余的容量
-    template<class T>
-    void vector<T>::shrink_to_fit() {
+    template<class T, class Alloc>
+    void vector<T, Alloc>::shrink_to_fit() {
         if (end_ < cap_) {
             reinsert(size()); // ？
         }
     }
 
 // 在 pos 位置就地构造元素，避免额外的复制或移动开销
-    template<class T>
+    template<class T, class Alloc>
     template<class ...Args>
-    typename vector<T>::iterator
-    vector<T>::emplace(const_iterator pos, Args &&...args) {
+    typename vector<T, Alloc>::iterator
+    vector<T, Alloc>::emplace(const_iterator pos, Args &&...args) {
         MYSTL_DEBUG(pos >= begin() && pos <= end());
         iterator xpos = const_cast<iterator>(pos);  // 获取位置 xpos
         const size_type n = xpos - begin_;  // 计算大小
@@ -414,9 +419,9 @@ namespace mystl {
     }
 
 // 在尾部就地构造元素，避免额外的复制或移动开销
-    template<class T>
+    template<class T, class Alloc>
     template<class ...Args>
-    void vector<T>::emplace_back(Args &&...args) {
+    void vector<T, Alloc>::emplace_back(Args &&...args) {
         if (end_ < cap_) {
             // 还有剩余空间
             data_allocator::construct(mystl::address_of(*end_), mystl::forward<Args>(args)...);
@@ -428,11 +433,11 @@ namespace mystl {
     }
 
 // 在尾部插入元素
-    template<class T>
-    void vector<T>::push_back(const value_type &&value) {
+    template<class T, class Alloc>
+    void vector<T, Alloc>::push_back(const value_type &value) {
         if (end_ != cap_) {
             // 有剩余空间则直接插入
-            data_allocator::construct(mystl::address_of(*end), value);
+            data_allocator::construct(mystl::address_of(*end_), value);
             ++end_;
         } else {
             // 没有剩余空间则重新开辟一片空间并插入
@@ -441,17 +446,17 @@ namespace mystl {
     }
 
 // 弹出尾部元素
-    template<class T>
-    void vector<T>::pop_back() {
+    template<class T, class Alloc>
+    void vector<T, Alloc>::pop_back() {
         MYSTL_DEBUG(!empty());
         data_allocator::destroy(end_ - 1);  // 直接销毁最后一个元素
         --end_;
     }
 
 // 在pos出插入元素
-    template<class T>
-    typename vector<T>::iterator
-    vector<T>::insert(const_iterator pos, const value_type &&value) {
+    template<class T, class Alloc>
+    typename vector<T, Alloc>::iterator
+    vector<T, Alloc>::insert(const_iterator pos, const value_type &value) {
         MYSTL_DEBUG(pos >= begin() && pos <= end());
         iterator xpos = const_cast<iterator>(pos);  // const_cast 用于消除const属性
         const size_type n = pos - begin_;
@@ -476,9 +481,9 @@ namespace mystl {
     }
 
 // 删除 pos 位置上的元素
-    template<class T>
-    typename vector<T>::iterator
-    vector<T>::erase(const_iterator pos) {
+    template<class T, class Alloc>
+    typename vector<T, Alloc>::iterator
+    vector<T, Alloc>::erase(const_iterator pos) {
         MYSTL_DEBUG(pos >= begin() && pos < end());
         iterator xpos = begin_ + (pos - begin());
         mystl::move(xpos + 1, end_, xpos);  // 将xpos移至队尾
@@ -488,9 +493,9 @@ namespace mystl {
     }
 
 // 删除[first, last)上的元素
-    template<class T>
-    typename vector<T>::iterator
-    vector<T>::erase(const_iterator first, const_iterator last) {
+    template<class T, class Alloc>
+    typename vector<T, Alloc>::iterator
+    vector<T, Alloc>::erase(const_iterator first, const_iterator last) {
         MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
         const auto n = first - begin();
         iterator r = begin_ + (first - begin());  // 要删除的起始位置
@@ -500,8 +505,8 @@ namespace mystl {
     }
 
 // 重置容器大小
-    template<class T>
-    void vector<T>::resize(size_type new_size, const value_type &value) {
+    template<class T, class Alloc>
+    void vector<T, Alloc>::resize(size_type new_size, const value_type &value) {
         if (new_size < size()) {
             // 若新尺寸小于当前尺寸，则删除多余元素
             erase(begin() + new_size, end());
@@ -511,9 +516,24 @@ namespace mystl {
         }
     }
 
+// 在尾部追加 n 个未初始化的元素，空间不足时恰好扩容到 size() + n
+    template<class T, class Alloc>
+    typename vector<T, Alloc>::pointer
+    vector<T, Alloc>::append_uninitialized(size_type n) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "vector<T>::append_uninitialized() requires trivially copyable T");
+        THROW_LENGTH_ERROR_IF(size() > max_size() - n, "vector<T>'s size too big");
+        if (static_cast<size_type>(cap_ - end_) < n) {
+            reserve(size() + n);
+        }
+        auto p = end_;
+        end_ += n;
+        return p;
+    }
+
 // 与另一个vector交换
-    template<class T>
-    void vector<T>::swap(vector<T> &rhs) noexcept {
+    template<class T, class Alloc>
+    void vector<T, Alloc>::swap(vector<T, Alloc> &rhs) noexcept {
         if (this != &rhs) {
             mystl::swap(begin_, rhs.begin_);
             mystl::swap(end_, rhs.end_);
@@ -524,8 +544,8 @@ namespace mystl {
 // helper function
 
 // try_init函数，若分配失败则忽略，不抛出异常
-    template<class T>
-    void vector<T>::try_init() noexcept {
+    template<class T, class Alloc>
+    void vector<T, Alloc>::try_init() noexcept {
         try {
             begin_ = data_allocator::allocate(16);  // 分配空间
             end_ = begin_;
@@ -540,8 +560,8 @@ namespace mystl {
     }
 
 // init_space 函数
-    template<class T>
-    void vector<T>::init_space(size_type size, size_type cap) {
+    template<class T, class Alloc>
+    void vector<T, Alloc>::init_space(size_type size, size_type cap) {
         try {
             // 初始化指定容量 cap 的空间，并设置当前队尾至 size
             begin_ = data_allocator::allocate(cap);
@@ -557,8 +577,8 @@ namespace mystl {
     }
 
 // fill_init函数
-    template<class T>
-    void vector<T>::
+    template<class T, class Alloc>
+    void vector<T, Alloc>::
     fill_init(size_type n, const value_type &value) {
         // 初始化并全部填入value
         const size_type init_size = mystl::max(static_cast<size_type>(16), n);
@@ -567,9 +587,9 @@ namespace mystl {
     }
 
 // range_init 函数
-    template<class T>
+    template<class T, class Alloc>
     template<class Iter>
-    void vector<T>::
+    void vector<T, Alloc>::
     range_init(Iter first, Iter last) {
         // 初始化一个区间
         const size_type init_size = mystl::max(static_cast<size_type>(last - first),
@@ -579,8 +599,8 @@ namespace mystl {
     }
 
 // destroy_and_recover 函数
-    template<class T>
-    void vector<T>::
+    template<class T, class Alloc>
+    void vector<T, Alloc>::
     destroy_and_recover(iterator first, iterator last, size_type n) {
         data_allocator::destroy(first, last);  // 先销毁
         data_allocator::deallocate(first, n);  // 后恢复
@@ -588,9 +608,9 @@ namespace mystl {
 
 // get_new_cap 函数
 // 在旧空间的基础上添加空间
-    template<class T>
-    typename vector<T>::size_type
-    vector<T>::
+    template<class T, class Alloc>
+    typename vector<T, Alloc>::size_type
+    vector<T, Alloc>::
     get_new_cap(size_type add_size) {
         const auto old_size = capacity(); // 获取旧的存储空间容量大小
         // 判断要增加的长度与当前存储空间大小相加是否超出最大值范围
@@ -610,8 +630,8 @@ namespace mystl {
 
 // fill_assign 函数
 // 分配新的内容到vector中，以代替现在的内容并相应的修改size
-    template<class T>
-    void vector<T>::
+    template<class T, class Alloc>
+    void vector<T, Alloc>::
     fill_assign(size_type n, const value_type &value) {
         if (n > capacity()) {
             // 若 n 大于 存储空间大小，则重新创建一个新的vector并全部填充为value值
@@ -632,9 +652,9 @@ namespace mystl {
 
 // copy_assign 函数
 // 作用？
-    template<class T>
+    template<class T, class Alloc>
     template<class IIter>
-    void vector<T>::
+    void vector<T, Alloc>::
     copy_assign(IIter first, IIter last, input_iterator_tag) {
         // input_iterator_tag是干嘛的？
         auto cur = begin_;
@@ -652,9 +672,9 @@ namespace mystl {
     }
 
 // 用 [first, last) 为容器赋值
-    template<class T>
+    template<class T, class Alloc>
     template<class FIter>
-    void vector<T>::
+    void vector<T, Alloc>::
     copy_assign(FIter first, FIter last, forward_iterator_tag) {
         // first和last是输入序列的迭代器，其中包含len个元素
         const size_type len = mystl::distance(first, last);  // 获取first - last 长度
@@ -679,10 +699,10 @@ namespace mystl {
     }
 
 // 重新分配空间并在 pos 处就地构造元素
-    template<class T>
+    template<class T, class Alloc>
     template<class ...Args>
-    void vector<T>::
-    reallocate_emplace(iterator pos, Args &&args...) {
+    void vector<T, Alloc>::
+    reallocate_emplace(iterator pos, Args &&...args) {
         const auto new_size = get_new_cap(1);  // 在旧空间的基础上添加空间  增加1
         auto new_begin = data_allocator::allocate(new_size);  // 获得新空间的起始位置
         auto new_end = new_begin;  // 将新的终止位置设为上面新的开始位置
@@ -711,8 +731,8 @@ namespace mystl {
     }
 
 // 重新分配空间并在pos处插入元素
-    template<class T>
-    void vector<T>::
+    template<class T, class Alloc>
+    void vector<T, Alloc>::
     reallocate_insert(iterator pos, const value_type &value) {
         const auto new_size = get_new_cap(1);  // 在旧空间的基础上添加空间  增加1
         auto new_begin = data_allocator::allocate(new_size);  // 获得新的起始点
@@ -742,16 +762,16 @@ namespace mystl {
 
 // fill_insert 函数
 // 在指定位置插入n个value，并返回插入的位置
-    template<class T>
-    typename vector<T>::iterator
-    vector<T>::
+    template<class T, class Alloc>
+    typename vector<T, Alloc>::iterator
+    vector<T, Alloc>::
     fill_insert(iterator pos, size_type n, const value_type &value) {
         if (n == 0) return pos;
         const size_type xpos = pos - begin_;  // 插入位置前面有几个元素
         const value_type value_copy = value;  // 避免被覆盖
         if (static_cast<size_type>(cap_ - end_) >= n) {
             // 若备用空间大于等于增加的空间
-            const size_type after_elems = end_ + pos;  // 初始化后移后的结尾位置
+            const size_type after_elems = end_ - pos;  // 初始化后移后的结尾位置
             auto old_end = end_;  // 保存旧的结尾位置
             if (after_elems > n) {
                 // 若假定的结尾位置比要插入的个数大，这样判断有什么用处？
@@ -804,9 +824,9 @@ namespace mystl {
 
 // copy_insert 函数
 // 复制迭代器中的元素到pos起始的位置
-    template<class T>
+    template<class T, class Alloc>
     template<class IIter>
-    void vector<T>::
+    void vector<T, Alloc>::
     copy_insert(iterator pos, IIter first, IIter last) {
         // first和last是输入序列的迭代器，其中包含len个元素
         if (first == last) return;
@@ -864,8 +884,8 @@ namespace mystl {
 
 // reinsert 函数
 // 创建新的大小为size的空间，并将旧的空间中的数据移动到新的存储空间中
-    template<class T>
-    void vector<T>::reinsert(size_type size) {
+    template<class T, class Alloc>
+    void vector<T, Alloc>::reinsert(size_type size) {
         auto new_begin = data_allocator::allocate(size);  // 获取大小为size的新空间的起始位置
         try {
             // 复制来自范围 [begin_, end_) 的元素到始于 new_begin 的位置
@@ -891,8 +911,8 @@ namespace mystl {
 // lhs表示左操作数a，rhs表示右操作数b
 
     // 重载 ==
-    template<class T>
-    bool operator==(const vector<T> &lhs, const vector<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator==(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
         // equal：范围 [lhs.begin(), lhs.end()) 和
         //        范围 [rhs.begin(), rhs.begin() + (lhs.end() - lhs.begin())) 进行比较
         return lhs.size() == rhs.size() &&
@@ -900,45 +920,45 @@ namespace mystl {
     }
 
     // 重载 <
-    template<class T>
-    bool operator<(const vector<T> &lhs, const vector<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator<(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
         // lexicographical_compare：
         //     检查第一个范围 [lhs.begin(), lhs.end()) 是否按字典序小于
         //        第二个范围 [rhs.begin(), rhs.begin() + (lhs.end() - lhs.begin()))
-        return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin());
+        return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
     // 重载 !=
-    template<class T>
-    bool operator!=(const vector<T> &lhs, const vector<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator!=(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
         // 利用重载了的 == 实现
         return !(lhs == rhs);
     }
 
     // 重载 >
-    template<class T>
-    bool operator>(const vector<T> &lhs, const vector<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator>(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
         // 利用重载了的 < 实现
         return rhs < lhs;
     }
 
     // 重载 <=
-    template<class T>
-    bool operator<=(const vector<T> &lhs, const vector<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator<=(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
         // 利用重载了的 < 实现
         return !(rhs < lhs);
     }
 
     // 重载 >=
-    template<class T>
-    bool operator>=(const vector<T> &lhs, const vector<T> &rhs) {
+    template<class T, class Alloc>
+    bool operator>=(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
         // 利用重载了的 < 实现
         return !(lhs < rhs);
     }
 
 // 重载 mystl 的 swap
-    template<class T>
-    void swap(vector<T> &lhs, vector<T> &rhs) {
+    template<class T, class Alloc>
+    void swap(vector<T, Alloc> &lhs, vector<T, Alloc> &rhs) {
         lhs.swap(rhs);
     }
 
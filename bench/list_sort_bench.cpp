@@ -0,0 +1,138 @@
+// list::sort 的基准：与原先自顶向下、每层用 advance 找中点的递归归并排序对照，
+// 分别对节点按内存顺序排列和已被打乱的 list 排序
+// 用法：list_sort_bench [节点数，缺省 10M]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "list.h"
+
+namespace {
+
+    typedef mystl::list<unsigned> ulist;
+    typedef ulist::iterator iter;
+
+    double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 原先的 list::list_sort，只把私有的 link_nodes / unlink_nodes 换成了 list.h 中的同名自由函数
+    template<class Compared>
+    iter top_down_sort(iter f1, iter l2, size_t n, Compared comp) {
+        if (n < 2) {
+            return f1;
+        }
+        if (n == 2) {
+            if (comp(*--l2, *f1)) {
+                auto ln = l2.node_;
+                mystl::list_unlink_nodes(ln, ln);
+                mystl::list_link_nodes(f1.node_, ln, ln);
+                return l2;
+            }
+            return f1;
+        }
+        auto n2 = n / 2;
+        auto l1 = f1;
+        mystl::advance(l1, n2);
+        auto result = f1 = top_down_sort(f1, l1, n2, comp);
+        auto f2 = l1 = top_down_sort(l1, l2, n - n2, comp);
+        if (comp(*f2, *f1)) {
+            auto m = f2;
+            ++m;
+            for (; m != l2 && comp(*m, *f1); ++m);
+            auto f = f2.node_;
+            auto l = m.node_->prev;
+            result = f2;
+            l1 = f2 = m;
+            mystl::list_unlink_nodes(f, l);
+            m = f1;
+            ++m;
+            mystl::list_link_nodes(f1.node_, f, l);
+            f1 = m;
+        } else {
+            ++f1;
+        }
+        while (f1 != l1 && f2 != l2) {
+            if (comp(*f2, *f1)) {
+                auto m = f2;
+                ++m;
+                for (; m != l2 && comp(*m, *f1); ++m);
+                auto f = f2.node_;
+                auto l = m.node_->prev;
+                if (l1 == f2) {
+                    l1 = m;
+                }
+                f2 = m;
+                mystl::list_unlink_nodes(f, l);
+                m = f1;
+                ++m;
+                mystl::list_link_nodes(f1.node_, f, l);
+                f1 = m;
+            } else {
+                ++f1;
+            }
+        }
+        return result;
+    }
+
+    bool sorted(const ulist &l) {
+        auto it = l.begin();
+        for (auto prev = it++; it != l.end(); prev = it++) {
+            if (*it < *prev) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 以同一个种子产生 n 个随机数；shuffled 时按随机键值排序一遍，使节点在内存中的顺序与 list 中的顺序无关
+    void fill(ulist &l, size_t n, bool shuffled) {
+        std::mt19937 rng(1);
+        for (size_t i = 0; i < n; ++i) {
+            l.push_back(static_cast<unsigned>(rng()));
+        }
+        if (shuffled) {
+            l.sort(mystl::greater<unsigned>());
+            std::mt19937 rng2(2);
+            for (auto &x : l) {
+                x = static_cast<unsigned>(rng2());
+            }
+        }
+    }
+
+    // 返回两种排序的耗时之比，结果不是有序序列时返回 0
+    double run(size_t n, bool shuffled) {
+        double t_old, t_new;
+        {
+            ulist l;
+            fill(l, n, shuffled);
+            auto start = std::chrono::steady_clock::now();
+            top_down_sort(l.begin(), l.end(), l.size(), mystl::less<unsigned>());
+            t_old = seconds_since(start);
+            if (!sorted(l)) {
+                return 0;
+            }
+        }
+        ulist l;
+        fill(l, n, shuffled);
+        auto start = std::chrono::steady_clock::now();
+        l.sort();
+        t_new = seconds_since(start);
+        if (!sorted(l)) {
+            return 0;
+        }
+        std::printf("  %-9s top-down %6.2f s   bottom-up %6.2f s   (%.2fx)\n",
+                    shuffled ? "shuffled" : "in-order", t_old, t_new, t_old / t_new);
+        return t_old / t_new;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : size_t(10000000);
+    std::printf("list<unsigned>::sort, %zu random keys\n", n);
+    const bool ok = run(n, false) > 0 && run(n, true) > 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+// rb_tree 查找与遍历的基准：树远大于末级 cache 时，比较逐个 find、交错查找的 find_many，
+// 以及按中序遍历的耗时；以 MYSTL_RB_TREE_PREFETCH 编译的版本另见 rb_tree_find_prefetch_bench
+// 用法：rb_tree_find_bench [节点数，缺省 16M] [查找次数，缺省 1M]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "set.h"
+#include "vector.h"
+
+namespace {
+
+    double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (size_t(1) << 24);
+    const size_t m = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : (size_t(1) << 20);
+#ifdef MYSTL_RB_TREE_PREFETCH
+    const char *variant = "prefetch";
+#else
+    const char *variant = "default";
+#endif
+
+    // 偶数为键值，有序区间以 O(n) 建树；查找的键值一半命中一半不命中
+    mystl::vector<long> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys.push_back(static_cast<long>(2 * i));
+    }
+    mystl::set<long> s(keys.begin(), keys.end());
+    std::mt19937_64 rng(1);
+    mystl::vector<long> queries;
+    queries.reserve(m);
+    for (size_t i = 0; i < m; ++i) {
+        queries.push_back(static_cast<long>(rng() % (2 * n)));
+    }
+    std::printf("%s: %zu nodes (%zu MiB), %zu lookups\n", variant, n,
+                n * sizeof(mystl::rb_tree_node<long>) >> 20, m);
+
+    size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < m; ++i) {
+        hits += s.find(queries[i]) != s.end();
+    }
+    const double t_find = seconds_since(start);
+    std::printf("  find        %7.1f ns/lookup  (%zu hits)\n", t_find * 1e9 / m, hits);
+
+    mystl::vector<mystl::set<long>::const_iterator> found(m);
+    start = std::chrono::steady_clock::now();
+    s.find_many(queries.begin(), queries.end(), found.begin());
+    const double t_many = seconds_since(start);
+    size_t many_hits = 0;
+    for (size_t i = 0; i < m; ++i) {
+        many_hits += found[i] != s.end();
+    }
+    std::printf("  find_many   %7.1f ns/lookup  (%zu hits, %.2fx)\n", t_many * 1e9 / m, many_hits, t_find / t_many);
+
+    // 随机插入、删除打乱节点在内存中的顺序后，再按中序遍历
+    for (size_t i = 0; i < n / 8; ++i) {
+        s.erase(static_cast<long>(2 * (rng() % n)));
+        s.insert(static_cast<long>(2 * (rng() % n) + 1));
+    }
+    long sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (auto it = s.begin(); it != s.end(); ++it) {
+        sum += *it;
+    }
+    const double t_iter = seconds_since(start);
+    std::printf("  iterate     %7.1f ns/node    (sum %ld)\n", t_iter * 1e9 / s.size(), sum);
+    return hits == many_hits ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+// unrolled_list 与 list 的基准：顺序遍历求和，以及每隔若干个元素插入一个元素；
+// list 分别取节点按内存顺序排列和在内存中乱序两种情况
+// 用法：unrolled_list_bench [元素个数，缺省 2M] [遍历轮数，缺省 20]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "list.h"
+#include "unrolled_list.h"
+
+namespace {
+
+    double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 依次放入 0 到 n - 1；shuffled 时先放入随机键值按其排序，使节点在内存中的顺序与 list 中的顺序无关
+    void fill(mystl::list<long> &l, size_t n, bool shuffled) {
+        std::mt19937 rng(1);
+        for (size_t i = 0; i < n; ++i) {
+            l.push_back(shuffled ? static_cast<long>(rng()) : static_cast<long>(i));
+        }
+        if (shuffled) {
+            l.sort();
+            long i = 0;
+            for (auto &x : l) {
+                x = i++;
+            }
+        }
+    }
+
+    void fill(mystl::unrolled_list<long> &l, size_t n, bool) {
+        for (size_t i = 0; i < n; ++i) {
+            l.push_back(static_cast<long>(i));
+        }
+    }
+
+    template<class List>
+    double scan(const List &l, int rounds, long &sum) {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            for (auto it = l.begin(); it != l.end(); ++it) {
+                sum += *it;
+            }
+        }
+        return seconds_since(start);
+    }
+
+    // 从头走到尾，每走 step 个元素插入一个元素
+    template<class List>
+    double insert_every(List &l, size_t step) {
+        auto start = std::chrono::steady_clock::now();
+        size_t k = 0;
+        for (auto it = l.begin(); it != l.end(); ++it) {
+            if (++k == step) {
+                k = 0;
+                it = l.insert(it, -1);
+                ++it;
+            }
+        }
+        return seconds_since(start);
+    }
+
+    // 返回遍历的耗时，size 为插入后的元素个数，用于检查各容器的结果一致
+    template<class List>
+    double run(const char *name, size_t n, int rounds, bool shuffled, double base, size_t &size) {
+        List l;
+        fill(l, n, shuffled);
+        long sum = 0;
+        const double t_scan = scan(l, rounds, sum);
+        const double t_ins = insert_every(l, 16);
+        std::printf("  %-16s scan %7.2f ns/elem (%6.2fx)   insert every 16th %7.2f ns/elem   (sum %ld)\n", name,
+                    t_scan * 1e9 / (static_cast<double>(n) * rounds), base > 0 ? base / t_scan : 1.0,
+                    t_ins * 1e9 / static_cast<double>(n), sum);
+        size = l.size();
+        return t_scan;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : size_t(2000000);
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+    std::printf("%zu longs, %d scans; scan speedups relative to list with nodes in memory order\n", n, rounds);
+    size_t a, b, c;
+    const double base = run<mystl::list<long>>("list (in-order)", n, rounds, false, 0, a);
+    run<mystl::list<long>>("list (shuffled)", n, rounds, true, base, b);
+    run<mystl::unrolled_list<long>>("unrolled_list", n, rounds, false, base, c);
+    return a == b && b == c ? 0 : 1;
+}
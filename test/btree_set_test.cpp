@@ -0,0 +1,207 @@
+// btree_set / btree_multiset 测试：随机插入、删除、查找与 std::set / std::multiset 做差分检查，并检查叶子节点链表
+
+#include <random>
+#include <set>
+#include <string>
+
+#include "btree_set.h"
+#include "test.h"
+
+namespace {
+
+    // 沿叶子节点链表检查：前后指针一致、各叶子深度相同、元素个数之和等于 size()、元素有序
+    template<class Set>
+    bool btree_valid(const Set &s) {
+        auto leaf = s.begin().node;
+        if (leaf == nullptr) {
+            return s.empty();
+        }
+        if (leaf->prev != nullptr) {
+            return false;
+        }
+        auto depth_of = [](const mystl::btree_node_base *x) {
+            int d = 0;
+            for (; x->parent != nullptr; x = x->parent) {
+                ++d;
+            }
+            return d;
+        };
+        const int depth = depth_of(leaf);
+        const bool single = leaf->next == nullptr;
+        size_t n = 0;
+        for (auto prev = leaf->prev; leaf != nullptr; prev = leaf, leaf = leaf->next) {
+            if (leaf->prev != prev || depth_of(leaf) != depth || !leaf->leaf) {
+                return false;
+            }
+            if (!single && leaf->count == 0) {
+                return false;
+            }
+            n += leaf->count;
+        }
+        if (n != s.size()) {
+            return false;
+        }
+        auto cmp = s.key_comp();
+        for (auto it = s.begin(), prev = it; it != s.end(); prev = it, ++it) {
+            if (it != prev && cmp(*it, *prev)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class Set, class Ref, class Gen>
+    void run(Gen gen, int rounds, int ops) {
+        std::mt19937 rng(7);
+        for (int round = 0; round < rounds; ++round) {
+            Set s;
+            Ref r;
+            // 三分之一的轮次只插入
+            const bool insert_only = round % 3 == 0;
+            for (int i = 0; i < ops; ++i) {
+                const int op = static_cast<int>(rng() % 10);
+                const auto k = gen(rng);
+                if (op < 5 || insert_only) {
+                    s.insert(k);
+                    r.insert(k);
+                } else if (op < 7) {
+                    EXPECT_EQ(s.erase(k), r.erase(k));
+                } else if (op < 8) {
+                    auto it = s.lower_bound(k);
+                    auto rit = r.lower_bound(k);
+                    if (rit != r.end()) {
+                        EXPECT_TRUE(it != s.end() && *it == *rit);
+                        s.erase(it);
+                        r.erase(rit);
+                    } else {
+                        EXPECT_TRUE(it == s.end());
+                    }
+                } else if (op < 9) {
+                    auto a = gen(rng), b = gen(rng);
+                    if (b < a) {
+                        mystl::swap(a, b);
+                    }
+                    s.erase(s.lower_bound(a), s.upper_bound(b));
+                    r.erase(r.lower_bound(a), r.upper_bound(b));
+                } else {
+                    EXPECT_EQ(s.count(k), r.count(k));
+                    auto er = s.equal_range(k);
+                    EXPECT_EQ(static_cast<size_t>(mystl::distance(er.first, er.second)), r.count(k));
+                }
+                if (i % 100 == 0) {
+                    EXPECT_TRUE(btree_valid(s));
+                }
+            }
+            EXPECT_TRUE(btree_valid(s));
+            EXPECT_SEQ_EQ(s, r);
+            bool reverse_ok = true;
+            auto rb = s.rbegin();
+            for (auto it = r.rbegin(); it != r.rend(); ++it, ++rb) {
+                if (!(*rb == *it)) {
+                    reverse_ok = false;
+                }
+            }
+            EXPECT_TRUE(reverse_ok);
+            for (int q = 0; q < 300; ++q) {
+                const auto k = gen(rng);
+                auto lb = s.lower_bound(k);
+                auto rlb = r.lower_bound(k);
+                EXPECT_TRUE(rlb == r.end() ? lb == s.end() : lb != s.end() && *lb == *rlb);
+                auto ub = s.upper_bound(k);
+                auto rub = r.upper_bound(k);
+                EXPECT_TRUE(rub == r.end() ? ub == s.end() : ub != s.end() && *ub == *rub);
+                EXPECT_EQ(s.find(k) != s.end(), r.find(k) != r.end());
+            }
+
+            // 复制、移动、清空后重新插入
+            Set c(s);
+            EXPECT_TRUE(btree_valid(c));
+            EXPECT_TRUE(c == s);
+            Set m(mystl::move(c));
+            EXPECT_SEQ_EQ(m, r);
+            EXPECT_TRUE(c.empty());
+            c = m;
+            EXPECT_SEQ_EQ(c, r);
+            c.clear();
+            EXPECT_TRUE(c.empty());
+            c.insert(r.begin(), r.end());
+            EXPECT_TRUE(btree_valid(c));
+            EXPECT_SEQ_EQ(c, r);
+            while (!s.empty()) {
+                s.erase(s.begin());
+                if (s.size() % 37 == 0) {
+                    EXPECT_TRUE(btree_valid(s));
+                }
+            }
+        }
+    }
+
+    void test_differential() {
+        auto gi = [](std::mt19937 &g) { return static_cast<int>(g() % 2000) - 1000; };
+        auto gu = [](std::mt19937 &g) { return static_cast<unsigned>(g() % 2000) + 0xFFFFF000u * (g() % 2); };
+        auto gl = [](std::mt19937 &g) { return static_cast<long long>(g() % 3000) - 1500; };
+        auto gs = [](std::mt19937 &g) { return std::to_string(g() % 1500) + std::string(g() % 3 ? 0 : 20, 'x'); };
+        run<mystl::btree_set<int>, std::set<int>>(gi, 20, 3000);
+        run<mystl::btree_multiset<int>, std::multiset<int>>(gi, 20, 3000);
+        run<mystl::btree_set<unsigned>, std::set<unsigned>>(gu, 10, 3000);
+        run<mystl::btree_multiset<unsigned>, std::multiset<unsigned>>(gu, 10, 3000);
+        run<mystl::btree_set<long long, mystl::less<long long>, 64>, std::set<long long>>(gl, 10, 3000);
+        run<mystl::btree_multiset<int, mystl::less<int>, 32>, std::multiset<int>>(gi, 10, 3000);
+        run<mystl::btree_set<std::string>, std::set<std::string>>(gs, 6, 3000);
+        run<mystl::btree_multiset<std::string, mystl::less<std::string>, 128>, std::multiset<std::string>>(gs, 6, 3000);
+    }
+
+    // 有序追加时叶子节点都是满的
+    void test_sorted_append() {
+        mystl::btree_set<int> a;
+        for (int i = 0; i < 100000; ++i) {
+            a.insert(i);
+        }
+        EXPECT_TRUE(btree_valid(a));
+        size_t leaves = 0;
+        size_t slots = 0;
+        for (auto leaf = a.begin().node; leaf != nullptr; leaf = leaf->next) {
+            ++leaves;
+            slots = slots < leaf->count ? leaf->count : slots;
+        }
+        EXPECT_TRUE(leaves <= 100000 / slots + 1);
+
+        mystl::btree_multiset<int> dm;
+        for (int i = 0; i < 20000; ++i) {
+            dm.insert(i / 100);
+        }
+        EXPECT_TRUE(btree_valid(dm));
+        EXPECT_EQ(dm.count(5), 100u);
+    }
+
+    // 节点内查找的计数函数与逐个比较的结果一致
+    void test_count_helpers() {
+        int arr[37];
+        for (int i = 0; i < 37; ++i) {
+            arr[i] = i * 2 - 30;
+        }
+        bool ok = true;
+        for (int k = -40; k < 50; ++k) {
+            for (size_t n = 0; n <= 37; ++n) {
+                size_t less = 0, not_greater = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    less += arr[i] < k;
+                    not_greater += arr[i] <= k;
+                }
+                if (mystl::btree_count_less(arr, n, k) != less ||
+                    mystl::btree_count_not_greater(arr, n, k) != not_greater) {
+                    ok = false;
+                }
+            }
+        }
+        EXPECT_TRUE(ok);
+    }
+
+} // namespace
+
+int main() {
+    test_differential();
+    test_sorted_append();
+    test_count_helpers();
+    return mystl::test::report("btree_set");
+}
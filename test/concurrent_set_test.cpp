@@ -0,0 +1,231 @@
+// concurrent_set 测试：单线程时与 std::set 做差分检查；多线程同时插入、删除、查找、遍历时，
+// 读者看到的总是有序的序列，从未删除的键值始终可见
+
+#include <atomic>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_set.h"
+#include "test.h"
+
+namespace {
+
+    template<class Set>
+    bool strictly_increasing(const Set &s) {
+        bool ok = true;
+        long prev = -1;
+        for (auto it = s.begin(); it != s.end(); ++it) {
+            if (*it <= prev) {
+                ok = false;
+            }
+            prev = *it;
+        }
+        return ok;
+    }
+
+    void test_sequential() {
+        mystl::concurrent_set<int> s;
+        std::set<int> r;
+        std::mt19937 rng(1);
+        for (int i = 0; i < 20000; ++i) {
+            const int k = static_cast<int>(rng() % 3000);
+            if (rng() % 3 != 0) {
+                auto p = s.insert(k);
+                EXPECT_EQ(p.second, r.insert(k).second);
+                EXPECT_EQ(*p.first, k);
+            } else {
+                EXPECT_EQ(s.erase(k), r.erase(k));
+            }
+        }
+        EXPECT_EQ(s.size(), r.size());
+        EXPECT_SEQ_EQ(s, r);
+        bool ok = true;
+        for (int k = -5; k < 3005; ++k) {
+            auto lb = s.lower_bound(k);
+            auto rl = r.lower_bound(k);
+            auto ub = s.upper_bound(k);
+            auto ru = r.upper_bound(k);
+            auto er = s.equal_range(k);
+            if ((rl == r.end() ? lb != s.end() : lb == s.end() || *lb != *rl) ||
+                (ru == r.end() ? ub != s.end() : ub == s.end() || *ub != *ru) ||
+                s.count(k) != r.count(k) || s.contains(k) != (r.count(k) == 1) ||
+                (er.first != er.second) != (r.count(k) == 1)) {
+                ok = false;
+            }
+        }
+        EXPECT_TRUE(ok);
+
+        s.clear();
+        EXPECT_TRUE(s.empty());
+        EXPECT_TRUE(s.begin() == s.end());
+        s.insert({3, 1, 2});
+        EXPECT_EQ(*s.begin(), 1);
+        EXPECT_EQ(s.size(), 3u);
+
+        mystl::concurrent_set<std::string> ss;
+        ss.emplace("b");
+        ss.emplace(3, 'a');
+        EXPECT_EQ(*ss.begin(), "aaa");
+        EXPECT_TRUE(ss.contains("b"));
+    }
+
+    // 4 的倍数从不删除，写者增删其余键值，读者同时查找和遍历
+    void test_readers_and_writers() {
+        mystl::concurrent_set<long> s;
+        for (long i = 0; i < 20000; i += 4) {
+            s.insert(i);
+        }
+        std::atomic<bool> stop(false);
+        std::atomic<int> bad(0);
+        std::vector<std::thread> writers, readers;
+        for (int w = 0; w < 2; ++w) {
+            writers.emplace_back([&s, w] {
+                std::mt19937 rng(10 + w);
+                for (int i = 0; i < 50000; ++i) {
+                    const long k = static_cast<long>(rng() % 20000);
+                    if (k % 4 == 0) {
+                        continue;
+                    }
+                    if (rng() % 2) {
+                        s.insert(k);
+                    } else {
+                        s.erase(k);
+                    }
+                }
+            });
+        }
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&s, &stop, &bad, r] {
+                std::mt19937 rng(r);
+                while (!stop.load()) {
+                    if (rng() % 50 == 0) {
+                        if (!strictly_increasing(s)) {
+                            ++bad;
+                        }
+                        continue;
+                    }
+                    const long k = static_cast<long>(rng() % 5000) * 4;
+                    if (!s.contains(k) || s.find(k) == s.end()) {
+                        ++bad;
+                    }
+                    auto lb = s.lower_bound(k + 1);
+                    if (lb != s.end() && *lb <= k) {
+                        ++bad;
+                    }
+                }
+            });
+        }
+        for (auto &t : writers) {
+            t.join();
+        }
+        stop = true;
+        for (auto &t : readers) {
+            t.join();
+        }
+        EXPECT_EQ(bad.load(), 0);
+        EXPECT_TRUE(strictly_increasing(s));
+        bool all = true;
+        for (long i = 0; i < 20000; i += 4) {
+            all = all && s.contains(i);
+        }
+        EXPECT_TRUE(all);
+        size_t n = 0;
+        for (auto it = s.begin(); it != s.end(); ++it) {
+            ++n;
+        }
+        EXPECT_EQ(n, s.size());
+    }
+
+    // 只有插入时，各线程插入成功的次数之和恰为不同键值的个数
+    void test_concurrent_inserts() {
+        mystl::concurrent_set<long> t;
+        std::atomic<long> inserted(0);
+        std::vector<std::thread> threads;
+        for (int w = 0; w < 6; ++w) {
+            threads.emplace_back([&t, &inserted, w] {
+                for (long k = w % 3; k < 30000; k += 2) {
+                    if (t.insert(k).second) {
+                        ++inserted;
+                    }
+                }
+            });
+        }
+        for (auto &th : threads) {
+            th.join();
+        }
+        EXPECT_EQ(inserted.load(), 30000);
+        EXPECT_EQ(t.size(), 30000u);
+        EXPECT_TRUE(strictly_increasing(t));
+
+        // clear 与插入同时进行
+        std::thread c1([&t] {
+            for (int i = 0; i < 3; ++i) {
+                t.clear();
+            }
+        });
+        std::thread c2([&t] {
+            for (long k = 0; k < 20000; ++k) {
+                t.insert(k * 3);
+            }
+        });
+        c1.join();
+        c2.join();
+        EXPECT_TRUE(strictly_increasing(t));
+        size_t n = 0;
+        for (auto it = t.begin(); it != t.end(); ++it) {
+            ++n;
+        }
+        EXPECT_EQ(n, t.size());
+        t.clear();
+        EXPECT_TRUE(t.empty());
+        EXPECT_TRUE(t.begin() == t.end());
+    }
+
+    // P = 2 时塔更高，无锁插入与删除在同一批键值上竞争，结束后各层仍一致
+    void test_insert_erase_race() {
+        mystl::concurrent_set<long, mystl::less<long>, 2> t;
+        std::vector<std::thread> threads;
+        for (int w = 0; w < 4; ++w) {
+            threads.emplace_back([&t, w] {
+                std::mt19937 rng(30 + w);
+                for (int i = 0; i < 40000; ++i) {
+                    const long k = static_cast<long>(rng() % 2000);
+                    if (w % 2 == 0) {
+                        t.insert(k);
+                    } else {
+                        t.erase(k);
+                    }
+                }
+            });
+        }
+        for (auto &th : threads) {
+            th.join();
+        }
+        EXPECT_TRUE(strictly_increasing(t));
+        size_t n = 0;
+        bool found = true;
+        for (auto it = t.begin(); it != t.end(); ++it) {
+            ++n;
+            found = found && t.contains(*it) && t.find(*it) == it;
+        }
+        EXPECT_EQ(n, t.size());
+        EXPECT_TRUE(found);
+        size_t hits = 0;
+        for (long k = 0; k < 2000; ++k) {
+            hits += t.count(k);
+        }
+        EXPECT_EQ(hits, n);
+    }
+
+} // namespace
+
+int main() {
+    test_sequential();
+    test_readers_and_writers();
+    test_concurrent_inserts();
+    test_insert_erase_race();
+    return mystl::test::report("concurrent_set");
+}
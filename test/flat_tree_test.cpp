@@ -0,0 +1,148 @@
+// flat_set / flat_multiset / flat_map / flat_multimap 测试，与 std 容器做差分检查
+
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include "flat_map.h"
+#include "flat_set.h"
+#include "test.h"
+
+namespace {
+
+    void test_flat_set() {
+        std::mt19937 rng(1);
+        for (int round = 0; round < 100; ++round) {
+            mystl::flat_set<int> fs;
+            std::set<int> ss;
+            for (int k = 0; k < 6; ++k) {
+                // 区间插入走追加 + 排序 + 归并的路径
+                mystl::vector<int> in;
+                const int m = static_cast<int>(rng() % 200);
+                for (int i = 0; i < m; ++i) {
+                    in.push_back(static_cast<int>(rng() % 400));
+                }
+                fs.insert(in.begin(), in.end());
+                ss.insert(in.begin(), in.end());
+                // 带 hint 的单个插入
+                const int x = static_cast<int>(rng() % 400);
+                auto hint = fs.begin() + (fs.empty() ? 0 : rng() % fs.size());
+                fs.insert(hint, x);
+                ss.insert(x);
+                const int e = static_cast<int>(rng() % 400);
+                EXPECT_EQ(fs.erase(e), ss.erase(e));
+            }
+            EXPECT_SEQ_EQ(fs, ss);
+            for (int q = 0; q < 400; q += 7) {
+                EXPECT_EQ(fs.count(q), ss.count(q));
+                EXPECT_EQ(static_cast<long>(fs.lower_bound(q) - fs.begin()),
+                          static_cast<long>(std::distance(ss.begin(), ss.lower_bound(q))));
+            }
+        }
+
+        mystl::flat_set<int> a{3, 1, 2}, b{1, 2, 3};
+        EXPECT_TRUE(a == b);
+        b.insert(4);
+        EXPECT_TRUE(a < b);
+        EXPECT_TRUE(a != b);
+    }
+
+    void test_flat_multiset() {
+        std::mt19937 rng(2);
+        mystl::flat_multiset<int> fm;
+        std::multiset<int> sm;
+        for (int k = 0; k < 50; ++k) {
+            mystl::vector<int> in;
+            const int m = static_cast<int>(rng() % 100);
+            for (int i = 0; i < m; ++i) {
+                in.push_back(static_cast<int>(rng() % 50));
+            }
+            fm.insert(in.begin(), in.end());
+            sm.insert(in.begin(), in.end());
+            const int x = static_cast<int>(rng() % 50);
+            fm.insert(x);
+            sm.insert(x);
+        }
+        EXPECT_SEQ_EQ(fm, sm);
+        for (int q = 0; q < 50; ++q) {
+            EXPECT_EQ(fm.count(q), sm.count(q));
+        }
+    }
+
+    void test_flat_map() {
+        // 区间插入时键值重复的元素保留先出现的一个
+        mystl::flat_map<int, std::string> m;
+        mystl::vector<mystl::pair<int, std::string>> in;
+        in.push_back(mystl::make_pair(2, std::string("a")));
+        in.push_back(mystl::make_pair(1, std::string("b")));
+        in.push_back(mystl::make_pair(2, std::string("c")));
+        m.insert(in.begin(), in.end());
+        EXPECT_EQ(m.size(), 2u);
+        EXPECT_EQ(m[2], "a");
+        EXPECT_EQ(m.at(1), "b");
+        m[0] = "z";
+        EXPECT_EQ(m.size(), 3u);
+        EXPECT_EQ(m.begin()->second, "z");
+        EXPECT_THROW(m.at(9), std::out_of_range);
+
+        auto it = m.emplace_hint(m.end(), 5, std::string("e"));
+        EXPECT_EQ(it->first, 5);
+        it = m.emplace_hint(m.begin(), 5, std::string("x"));
+        EXPECT_EQ(it->second, "e");
+        EXPECT_EQ(m.size(), 4u);
+
+        std::mt19937 rng(3);
+        mystl::flat_map<int, int> fm;
+        std::map<int, int> sm;
+        for (int i = 0; i < 2000; ++i) {
+            const int k = static_cast<int>(rng() % 300);
+            fm[k] += i;
+            sm[k] += i;
+            if (i % 5 == 0) {
+                const int e = static_cast<int>(rng() % 300);
+                EXPECT_EQ(fm.erase(e), sm.erase(e));
+            }
+        }
+        EXPECT_EQ(fm.size(), sm.size());
+        auto sit = sm.begin();
+        for (auto fit = fm.begin(); fit != fm.end() && sit != sm.end(); ++fit, ++sit) {
+            EXPECT_EQ(fit->first, sit->first);
+            EXPECT_EQ(fit->second, sit->second);
+        }
+    }
+
+    void test_flat_multimap() {
+        // 键值相等的元素保持插入顺序
+        mystl::flat_multimap<int, int> mm;
+        mystl::vector<mystl::pair<int, int>> in;
+        for (int i = 0; i < 1000; ++i) {
+            in.push_back(mystl::make_pair(i % 7, i));
+        }
+        mm.insert(in.begin(), in.end());
+        for (auto &p : in) {
+            p.second += 1000;
+        }
+        mm.insert(in.begin(), in.end());
+        EXPECT_EQ(mm.size(), 2000u);
+        int last_key = -1, last_value = -1;
+        for (auto &p : mm) {
+            if (p.first == last_key) {
+                EXPECT_TRUE(p.second > last_value);
+            }
+            last_key = p.first;
+            last_value = p.second;
+        }
+        EXPECT_EQ(mm.count(3), 286u);
+    }
+
+} // namespace
+
+int main() {
+    test_flat_set();
+    test_flat_multiset();
+    test_flat_map();
+    test_flat_multimap();
+    return mystl::test::report("flat_tree");
+}
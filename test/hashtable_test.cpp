@@ -0,0 +1,353 @@
+// unordered_set / unordered_multiset / unordered_map / unordered_multimap 测试：
+// 随机操作与 std 容器做差分检查，并检查每个元素都在 bucket(key) 所指的桶中、桶数为质数；
+// rehash、reserve 后元素地址不变；相等的键值按插入顺序相邻；插入时哈希函数或元素构造抛出异常不改变容器
+
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "unordered_map.h"
+#include "unordered_set.h"
+#include "test.h"
+
+namespace {
+
+    bool is_prime(size_t n) {
+        if (n < 2) {
+            return false;
+        }
+        for (size_t d = 2; d * d <= n; ++d) {
+            if (n % d == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 各桶的元素个数之和等于 size()，每个元素都在 bucket(key) 的桶中，负载因子不超过上限
+    template<class C, class KeyOf>
+    bool buckets_valid(const C &c, KeyOf key_of) {
+        size_t total = 0;
+        for (size_t b = 0; b < c.bucket_count(); ++b) {
+            size_t n = 0;
+            for (auto it = c.begin(b); it != c.end(b); ++it) {
+                if (c.bucket(key_of(*it)) != b) {
+                    return false;
+                }
+                ++n;
+            }
+            if (n != c.bucket_size(b)) {
+                return false;
+            }
+            total += n;
+        }
+        size_t walked = 0;
+        for (auto it = c.begin(); it != c.end(); ++it) {
+            ++walked;
+        }
+        return total == c.size() && walked == c.size() && c.load_factor() <= c.max_load_factor() &&
+               (c.bucket_count() == 0 || is_prime(c.bucket_count()));
+    }
+
+    struct identity {
+        int operator()(int k) const { return k; }
+    };
+
+    struct first_of {
+        template<class P>
+        int operator()(const P &p) const { return p.first; }
+    };
+
+    void test_set() {
+        mystl::unordered_set<int> s;
+        std::unordered_set<int> r;
+        std::mt19937 rng(71);
+        bool ok = true;
+        for (int i = 0; i < 60000; ++i) {
+            const int k = static_cast<int>(rng() % 10000);
+            switch (rng() % 5) {
+                case 0:
+                case 1: {
+                    auto p = s.insert(k);
+                    ok = ok && p.second == r.insert(k).second && *p.first == k;
+                    break;
+                }
+                case 2:
+                    ok = ok && s.erase(k) == r.erase(k);
+                    break;
+                case 3: {
+                    auto it = s.find(k);
+                    ok = ok && (it == s.end()) == (r.count(k) == 0);
+                    if (it != s.end()) {
+                        s.erase(it);
+                        r.erase(k);
+                    }
+                    break;
+                }
+                default:
+                    ok = ok && s.count(k) == r.count(k) && s.contains(k) == (r.count(k) == 1);
+                    break;
+            }
+            if (i % 5000 == 0) {
+                ok = ok && s.size() == r.size() && buckets_valid(s, identity());
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(s.size(), r.size());
+        EXPECT_TRUE(buckets_valid(s, identity()));
+
+        // 元素的地址在 rehash、reserve 后不变
+        std::vector<const int *> addr;
+        std::vector<int> keys;
+        for (auto it = s.begin(); it != s.end() && addr.size() < 200; ++it) {
+            addr.push_back(&*it);
+            keys.push_back(*it);
+        }
+        s.rehash(s.bucket_count() * 4);
+        EXPECT_TRUE(buckets_valid(s, identity()));
+        s.reserve(100000);
+        EXPECT_TRUE(s.bucket_count() * s.max_load_factor() >= 100000);
+        const size_t reserved = s.bucket_count();
+        for (int k = 10000; s.size() < 100000; ++k) {
+            s.insert(k);
+        }
+        EXPECT_EQ(s.bucket_count(), reserved);
+        bool stable = true;
+        for (size_t i = 0; i < addr.size(); ++i) {
+            stable = stable && &*s.find(keys[i]) == addr[i];
+        }
+        EXPECT_TRUE(stable);
+
+        // 调整最大负载因子后，rehash(0) 按新的上限重建
+        s.max_load_factor(0.5f);
+        s.rehash(0);
+        EXPECT_TRUE(buckets_valid(s, identity()));
+        EXPECT_THROW(s.max_load_factor(0.0f), std::out_of_range);
+        s.max_load_factor(4.0f);
+        s.rehash(0);
+        EXPECT_TRUE(buckets_valid(s, identity()));
+        EXPECT_TRUE(s.load_factor() > 1.0f);
+
+        auto c = s;
+        EXPECT_TRUE(c == s);
+        c.erase(c.begin());
+        EXPECT_TRUE(c != s);
+        auto m = mystl::move(c);
+        EXPECT_TRUE(c.empty());
+        m.clear();
+        EXPECT_TRUE(m.empty());
+        EXPECT_TRUE(m.begin() == m.end());
+        m.insert({5, 6, 5});
+        EXPECT_EQ(m.size(), 2u);
+        EXPECT_TRUE(buckets_valid(m, identity()));
+    }
+
+    void test_multi() {
+        mystl::unordered_multiset<int> s;
+        std::multiset<int> r;
+        std::mt19937 rng(73);
+        bool ok = true;
+        for (int i = 0; i < 30000; ++i) {
+            const int k = static_cast<int>(rng() % 500);
+            if (rng() % 3 != 0) {
+                s.insert(k);
+                r.insert(k);
+            } else if (rng() % 2) {
+                ok = ok && s.erase(k) == r.erase(k);
+            } else {
+                auto it = s.find(k);
+                if (it != s.end()) {
+                    s.erase(it);
+                    r.erase(r.find(k));
+                }
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(s.size(), r.size());
+        EXPECT_TRUE(buckets_valid(s, identity()));
+        bool counts = true;
+        for (int k = 0; k < 500; ++k) {
+            auto er = s.equal_range(k);
+            size_t n = 0;
+            for (auto it = er.first; it != er.second; ++it) {
+                counts = counts && *it == k;
+                ++n;
+            }
+            counts = counts && n == r.count(k) && s.count(k) == n;
+        }
+        EXPECT_TRUE(counts);
+
+        // 相等的键值按插入顺序相邻，经过多次 rehash 仍然如此
+        mystl::unordered_multimap<int, int> mm;
+        for (int i = 0; i < 20000; ++i) {
+            mm.emplace(i % 97, i);
+        }
+        mm.rehash(mm.bucket_count() * 3);
+        bool order = true;
+        for (int k = 0; k < 97; ++k) {
+            auto er = mm.equal_range(k);
+            int prev = -1;
+            size_t n = 0;
+            for (auto it = er.first; it != er.second; ++it, ++n) {
+                order = order && it->first == k && it->second > prev;
+                prev = it->second;
+            }
+            order = order && n == mm.count(k);
+        }
+        EXPECT_TRUE(order);
+        EXPECT_TRUE(buckets_valid(mm, first_of()));
+        EXPECT_EQ(mm.erase(3), 207u);
+        EXPECT_EQ(mm.count(3), 0u);
+    }
+
+    void test_map() {
+        mystl::unordered_map<int, std::string> m;
+        std::map<int, std::string> r;
+        std::mt19937 rng(75);
+        bool ok = true;
+        for (int i = 0; i < 40000; ++i) {
+            const int k = static_cast<int>(rng() % 3000);
+            const std::string v = std::to_string(i);
+            switch (rng() % 5) {
+                case 0:
+                    m[k] = v;
+                    r[k] = v;
+                    break;
+                case 1: {
+                    auto p = m.try_emplace(k, v);
+                    ok = ok && p.second == r.emplace(k, v).second;
+                    break;
+                }
+                case 2: {
+                    auto p = m.insert_or_assign(k, v);
+                    ok = ok && p.second == (r.count(k) == 0);
+                    r[k] = v;
+                    break;
+                }
+                case 3:
+                    ok = ok && m.erase(k) == r.erase(k);
+                    break;
+                default: {
+                    auto it = m.find(k);
+                    auto rit = r.find(k);
+                    ok = ok && (rit == r.end() ? it == m.end() : it != m.end() && it->second == rit->second);
+                    break;
+                }
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(m.size(), r.size());
+        EXPECT_TRUE(buckets_valid(m, first_of()));
+        bool same = true;
+        for (auto &e : r) {
+            same = same && m.at(e.first) == e.second;
+        }
+        EXPECT_TRUE(same);
+        EXPECT_THROW(m.at(-1), std::out_of_range);
+
+        // 区间删除
+        auto first = m.begin();
+        auto last = first;
+        for (int i = 0; i < 100 && last != m.end(); ++i) {
+            ++last;
+        }
+        size_t erased = 0;
+        for (auto it = first; it != last; ++it) {
+            r.erase(it->first);
+            ++erased;
+        }
+        m.erase(first, last);
+        EXPECT_EQ(m.size(), r.size());
+        EXPECT_EQ(erased, 100u);
+        EXPECT_TRUE(buckets_valid(m, first_of()));
+    }
+
+    // 哈希函数按预算抛出异常
+    struct throwing_hash {
+        static int budget;
+
+        size_t operator()(int k) const {
+            if (budget >= 0 && budget-- == 0) {
+                throw std::runtime_error("throwing_hash");
+            }
+            return static_cast<size_t>(k);
+        }
+    };
+
+    int throwing_hash::budget = -1;
+
+    // 复制时按预算抛出异常的元素
+    struct thrower {
+        static int budget;
+        int value;
+
+        thrower(int v) : value(v) {}
+
+        thrower(const thrower &rhs) : value(rhs.value) {
+            if (budget >= 0 && budget-- == 0) {
+                throw std::runtime_error("thrower");
+            }
+        }
+
+        bool operator==(const thrower &rhs) const { return value == rhs.value; }
+    };
+
+    int thrower::budget = -1;
+
+    struct thrower_hash {
+        size_t operator()(const thrower &t) const { return static_cast<size_t>(t.value); }
+    };
+
+    // rehash 使用节点缓存的哈希值，不调用哈希函数，因此插入时哈希函数或复制抛出异常都不改变容器
+    void test_exception_safety() {
+        mystl::unordered_set<int, throwing_hash> s;
+        bool ok = true;
+        for (int i = 0; i < 3000; ++i) {
+            if (i % 7 == 0) {
+                throwing_hash::budget = 0;
+                EXPECT_THROW(s.insert(i), std::runtime_error);
+                throwing_hash::budget = -1;
+                ok = ok && s.size() == static_cast<size_t>(i);
+            }
+            s.insert(i);
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(s.size(), 3000u);
+        // 以后的 rehash 不再调用哈希函数
+        throwing_hash::budget = 0;
+        s.rehash(s.bucket_count() * 2);
+        throwing_hash::budget = -1;
+        EXPECT_TRUE(buckets_valid(s, identity()));
+
+        mystl::unordered_multiset<thrower, thrower_hash> t;
+        for (int i = 0; i < 2000; ++i) {
+            const thrower x(i % 300);
+            if (i % 5 == 0) {
+                thrower::budget = 0;
+                EXPECT_THROW(t.insert(x), std::runtime_error);
+                thrower::budget = -1;
+            }
+            t.insert(x);
+        }
+        EXPECT_EQ(t.size(), 2000u);
+        size_t n = 0;
+        for (auto it = t.begin(); it != t.end(); ++it) {
+            ++n;
+        }
+        EXPECT_EQ(n, 2000u);
+        EXPECT_EQ(t.count(thrower(5)), 7u);
+    }
+
+} // namespace
+
+int main() {
+    test_set();
+    test_multi();
+    test_map();
+    test_exception_safety();
+    return mystl::test::report("hashtable");
+}
@@ -0,0 +1,106 @@
+// huge_page_allocator 测试：vector、deque、set 以大页配置器工作，deque 缓冲区与节点池的块增长到一个大页
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <set>
+
+#include "deque.h"
+#include "huge_page_allocator.h"
+#include "node_pool.h"
+#include "set.h"
+#include "vector.h"
+#include "test.h"
+
+namespace {
+
+    struct node {
+        node *next;
+        long value;
+    };
+
+    void test_chunk_bytes() {
+        // 缺省配置器保持原来的块大小，大页配置器下一块恰好一个大页
+        EXPECT_EQ(mystl::allocator_chunk_bytes<mystl::allocator<int>>::value, 0u);
+        EXPECT_EQ(mystl::allocator_chunk_bytes<mystl::huge_page_allocator<int>>::value,
+                  static_cast<size_t>(MYSTL_HUGE_PAGE_SIZE));
+
+        EXPECT_EQ((mystl::deque<int>::buffer_size), 4096 / sizeof(int));
+        EXPECT_EQ((mystl::deque<int, mystl::huge_page_allocator<int>>::buffer_size),
+                  MYSTL_HUGE_PAGE_SIZE / sizeof(int));
+
+        EXPECT_EQ((mystl::node_pool<node>::max_slab_bytes), 64u * 1024);
+        EXPECT_EQ((mystl::node_pool<node, mystl::huge_page_allocator<node>>::max_slab_bytes),
+                  static_cast<size_t>(MYSTL_HUGE_PAGE_SIZE));
+    }
+
+    void test_vector() {
+        mystl::vector<long, mystl::huge_page_allocator<long>> v;
+        for (long i = 0; i < 1000000; ++i) {
+            v.push_back(i);
+        }
+        // 超过阈值的空间走 mmap，起始地址按大页对齐
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(v.data()) % MYSTL_HUGE_PAGE_SIZE, 0u);
+        mystl::vector<long, mystl::huge_page_allocator<long>> w(v);
+        long sum = 0;
+        for (auto x : w) {
+            sum += x;
+        }
+        EXPECT_EQ(sum, 1000000L * 999999 / 2);
+    }
+
+    void test_deque() {
+        std::mt19937 rng(7);
+        mystl::deque<int, mystl::huge_page_allocator<int>> d;
+        std::deque<int> sd;
+        for (int i = 0; i < 2000000; ++i) {
+            switch (rng() % 4) {
+                case 0:
+                    d.push_front(i);
+                    sd.push_front(i);
+                    break;
+                case 3:
+                    if (!sd.empty()) {
+                        d.pop_back();
+                        sd.pop_back();
+                    }
+                    break;
+                default:
+                    d.push_back(i);
+                    sd.push_back(i);
+                    break;
+            }
+        }
+        EXPECT_EQ(d.size(), sd.size());
+        EXPECT_SEQ_EQ(d, sd);
+        d.clear();
+        EXPECT_TRUE(d.empty());
+        d.push_back(1);
+        EXPECT_EQ(d.front(), 1);
+    }
+
+    void test_set() {
+        std::mt19937 rng(11);
+        mystl::set<int, mystl::less<int>, mystl::huge_page_allocator<int>> s;
+        std::set<int> ss;
+        for (int i = 0; i < 300000; ++i) {
+            const int x = static_cast<int>(rng() % 500000);
+            EXPECT_EQ(s.insert(x).second, ss.insert(x).second);
+            if (i % 3 == 0) {
+                const int e = static_cast<int>(rng() % 500000);
+                EXPECT_EQ(s.erase(e), ss.erase(e));
+            }
+        }
+        EXPECT_EQ(s.size(), ss.size());
+        EXPECT_SEQ_EQ(s, ss);
+    }
+
+} // namespace
+
+int main() {
+    test_chunk_bytes();
+    test_vector();
+    test_deque();
+    test_set();
+    return mystl::test::report("huge_page_allocator");
+}
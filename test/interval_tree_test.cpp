@@ -0,0 +1,183 @@
+// interval_set / interval_map 测试：随机插入、删除后检查红黑树结构与每个节点的 max_high，
+// 相交、包含查询与暴力扫描的结果对照
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "interval_tree.h"
+#include "vector.h"
+#include "rb_tree_check.h"
+#include "test.h"
+
+namespace {
+
+    // 返回以 x 为根的子树中最大的右端点，节点保存的 max_high 与之不符时把 ok 置为 false
+    template<class BasePtr, class Key>
+    Key check_max_high(BasePtr x, Key lowest, bool &ok) {
+        if (x == nullptr) {
+            return lowest;
+        }
+        auto node = x->get_node_ptr();
+        typedef typename std::remove_reference<decltype(node->value)>::type value_type;
+        Key m = mystl::rb_tree_value_traits<value_type>::get_key(node->value).high;
+        const Key l = check_max_high(x->left, lowest, ok);
+        const Key r = check_max_high(x->right, lowest, ok);
+        m = m < l ? l : m;
+        m = m < r ? r : m;
+        if (node->max_high != m) {
+            ok = false;
+        }
+        return m;
+    }
+
+    template<class Tree, class Key>
+    bool interval_tree_valid(const Tree &t, Key lowest) {
+        if (!mystl::test::rb_tree_valid(t)) {
+            return false;
+        }
+        bool ok = true;
+        check_max_high(t.end().node->parent, lowest, ok);
+        return ok;
+    }
+
+    typedef mystl::interval<int> ival;
+    typedef std::pair<int, int> span;
+
+    void test_interval_set() {
+        std::mt19937 rng(5);
+        mystl::interval_set<int> s;
+        std::vector<ival> ref;
+        for (int i = 0; i < 20000; ++i) {
+            const int op = static_cast<int>(rng() % 10);
+            if (op < 6 || ref.empty()) {
+                const int a = static_cast<int>(rng() % 10000);
+                const int b = a + static_cast<int>(rng() % 300);
+                s.insert(a, b);
+                ref.push_back(ival(a, b));
+            } else if (op < 8) {
+                const ival v = ref[rng() % ref.size()];
+                EXPECT_EQ(s.erase(v), static_cast<size_t>(std::count(ref.begin(), ref.end(), v)));
+                ref.erase(std::remove(ref.begin(), ref.end(), v), ref.end());
+            } else {
+                const ival v = ref[rng() % ref.size()];
+                auto p = s.find(v);
+                EXPECT_TRUE(p != s.end());
+                s.erase(p);
+                ref.erase(std::find(ref.begin(), ref.end(), v));
+            }
+            if (i % 1000 == 0) {
+                EXPECT_TRUE(interval_tree_valid(s, -1));
+            }
+            if (i % 97 == 0) {
+                const int lo = static_cast<int>(rng() % 10300);
+                const int hi = lo + static_cast<int>(rng() % 200);
+                std::vector<mystl::interval_set<int>::const_iterator> its;
+                s.find_overlapping(lo, hi, std::back_inserter(its));
+                std::vector<span> got, expect;
+                for (auto it : its) {
+                    got.push_back(span(it->low, it->high));
+                }
+                for (auto &v : ref) {
+                    if (v.overlaps(lo, hi)) {
+                        expect.push_back(span(v.low, v.high));
+                    }
+                }
+                std::sort(expect.begin(), expect.end());
+                EXPECT_TRUE(got == expect);
+                auto f = s.first_overlap(lo, hi);
+                EXPECT_EQ(f == s.end(), expect.empty());
+                if (!expect.empty()) {
+                    EXPECT_TRUE(span(f->low, f->high) == expect[0]);
+                }
+                EXPECT_EQ(s.overlaps(lo, hi), !expect.empty());
+                its.clear();
+                s.find_containing(lo, std::back_inserter(its));
+                EXPECT_EQ(its.size(), static_cast<size_t>(std::count_if(ref.begin(), ref.end(),
+                                                                        [lo](const ival &v) { return v.contains(lo); })));
+            }
+        }
+        EXPECT_EQ(s.size(), ref.size());
+        EXPECT_TRUE(interval_tree_valid(s, -1));
+
+        // 复制与从有序区间建树后 max_high 仍然正确
+        mystl::interval_set<int> c(s);
+        EXPECT_TRUE(interval_tree_valid(c, -1));
+        EXPECT_TRUE(c == s);
+        mystl::vector<ival> sorted;
+        for (auto it = s.begin(); it != s.end(); ++it) {
+            sorted.push_back(*it);
+        }
+        mystl::interval_set<int> b(sorted.begin(), sorted.end());
+        EXPECT_TRUE(interval_tree_valid(b, -1));
+        EXPECT_TRUE(b == s);
+    }
+
+    void test_interval_map() {
+        std::mt19937 rng(7);
+        mystl::interval_map<unsigned, int> m;
+        std::vector<std::pair<ival, int>> ref;
+        for (int i = 0; i < 5000; ++i) {
+            if (rng() % 4 != 0 || ref.empty()) {
+                const unsigned a = static_cast<unsigned>(rng() % 10000);
+                const unsigned b = a + static_cast<unsigned>(rng() % 100);
+                m.insert(a, b, i);
+                ref.push_back(std::make_pair(ival(static_cast<int>(a), static_cast<int>(b)), i));
+            } else {
+                const size_t k = rng() % ref.size();
+                const ival v = ref[k].first;
+                auto it = m.find(mystl::interval<unsigned>(static_cast<unsigned>(v.low), static_cast<unsigned>(v.high)));
+                EXPECT_TRUE(it != m.end());
+                // 区间可能重复，删除找到的那一个
+                auto r = std::find_if(ref.begin(), ref.end(), [&it](const std::pair<ival, int> &e) {
+                    return e.second == it->second;
+                });
+                EXPECT_TRUE(r != ref.end());
+                ref.erase(r);
+                m.erase(it);
+            }
+        }
+        EXPECT_EQ(m.size(), ref.size());
+        EXPECT_TRUE(interval_tree_valid(m, 0u));
+        bool ok = true;
+        for (unsigned p = 0; p < 10100; p += 13) {
+            std::vector<mystl::interval_map<unsigned, int>::iterator> hits;
+            m.find_containing(p, std::back_inserter(hits));
+            std::vector<int> got, expect;
+            for (auto it : hits) {
+                got.push_back(it->second);
+            }
+            for (auto &e : ref) {
+                if (e.first.contains(static_cast<int>(p))) {
+                    expect.push_back(e.second);
+                }
+            }
+            std::sort(got.begin(), got.end());
+            std::sort(expect.begin(), expect.end());
+            ok = ok && got == expect;
+        }
+        EXPECT_TRUE(ok);
+
+        // 通过查询得到的迭代器修改值
+        mystl::interval_map<unsigned, int> small;
+        for (unsigned i = 0; i < 1000; ++i) {
+            small.insert(i * 10, i * 10 + 15, static_cast<int>(i));
+        }
+        std::vector<mystl::interval_map<unsigned, int>::iterator> hits;
+        small.find_containing(105u, std::back_inserter(hits));
+        EXPECT_EQ(hits.size(), 2u);
+        EXPECT_EQ(hits[0]->second, 9);
+        EXPECT_EQ(hits[1]->second, 10);
+        hits[0]->second = 42;
+        EXPECT_EQ(small.first_containing(105u)->second, 42);
+        EXPECT_TRUE(small.first_containing(20000u) == small.end());
+    }
+
+} // namespace
+
+int main() {
+    test_interval_set();
+    test_interval_map();
+    return mystl::test::report("interval_tree");
+}
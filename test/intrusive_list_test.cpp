@@ -0,0 +1,254 @@
+// intrusive_list 测试：同一组对象通过两个钩子同时位于两个链表中，随机操作与 std::list 做差分检查；
+// 插入、删除、splice 都不分配内存，对象的复制不复制链接
+
+#include <cstdlib>
+#include <list>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "intrusive_list.h"
+#include "test.h"
+
+// 记录 operator new 的调用次数
+static long allocations = 0;
+
+void *operator new(std::size_t n) {
+    ++allocations;
+    void *p = std::malloc(n == 0 ? 1 : n);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+    struct tag_a {};
+    struct tag_b {};
+
+    struct conn : public mystl::intrusive_list_hook<tag_a>, public mystl::intrusive_list_hook<tag_b> {
+        int id;
+
+        explicit conn(int i = 0) : id(i) {}
+
+        bool operator==(const conn &rhs) const { return id == rhs.id; }
+    };
+
+    typedef mystl::intrusive_list<conn, tag_a> list_a;
+    typedef mystl::intrusive_list<conn, tag_b> list_b;
+
+    // 正反两个方向都与 ids 一致
+    template<class List>
+    bool same(const List &l, const std::list<int> &ids) {
+        if (l.size() != ids.size()) {
+            return false;
+        }
+        auto it = l.begin();
+        for (int id : ids) {
+            if (it == l.end() || it->id != id) {
+                return false;
+            }
+            ++it;
+        }
+        auto rit = l.rbegin();
+        for (auto ri = ids.rbegin(); ri != ids.rend(); ++ri, ++rit) {
+            if (rit->id != *ri) {
+                return false;
+            }
+        }
+        return it == l.end();
+    }
+
+    template<class C>
+    typename C::iterator at(C &c, size_t pos) {
+        auto it = c.begin();
+        for (size_t i = 0; i < pos; ++i) {
+            ++it;
+        }
+        return it;
+    }
+
+    // a1、a2 用钩子 tag_a，b 用钩子 tag_b，一个对象可以同时在 a1 或 a2 之一以及 b 中
+    void test_differential() {
+        const int n = 500;
+        std::vector<conn> objs;
+        objs.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            objs.emplace_back(i);
+        }
+        list_a a1, a2;
+        list_b b;
+        std::list<int> r1, r2, rb;
+        std::mt19937 rng(21);
+        bool ok = true;
+        for (int step = 0; step < 20000; ++step) {
+            const int op = static_cast<int>(rng() % 10);
+            conn &c = objs[rng() % n];
+            if (op < 3) {
+                // 插入 tag_a 的某个链表
+                if (!static_cast<mystl::intrusive_list_hook<tag_a> &>(c).is_linked()) {
+                    const bool first = rng() % 2 == 0;
+                    list_a &l = first ? a1 : a2;
+                    std::list<int> &r = first ? r1 : r2;
+                    const size_t pos = rng() % (r.size() + 1);
+                    auto it = l.insert(at(l, pos), c);
+                    r.insert(at(r, pos), c.id);
+                    ok = ok && &*it == &c;
+                }
+            } else if (op < 5) {
+                if (!static_cast<mystl::intrusive_list_hook<tag_b> &>(c).is_linked()) {
+                    if (rng() % 2) {
+                        b.push_back(c);
+                        rb.push_back(c.id);
+                    } else {
+                        b.push_front(c);
+                        rb.push_front(c.id);
+                    }
+                }
+            } else if (op < 7) {
+                // 通过对象找到迭代器并删除
+                if (static_cast<mystl::intrusive_list_hook<tag_a> &>(c).is_linked()) {
+                    auto it = list_a::iterator_to(c);
+                    bool in1 = false;
+                    for (int id : r1) {
+                        in1 = in1 || id == c.id;
+                    }
+                    (in1 ? a1 : a2).erase(it);
+                    (in1 ? r1 : r2).remove(c.id);
+                    ok = ok && !static_cast<mystl::intrusive_list_hook<tag_a> &>(c).is_linked();
+                }
+            } else if (op < 8) {
+                if (!rb.empty()) {
+                    b.pop_front();
+                    rb.pop_front();
+                }
+                if (!rb.empty()) {
+                    b.pop_back();
+                    rb.pop_back();
+                }
+            } else if (op < 9) {
+                // 把 a2 的一段移到 a1
+                const size_t first = rng() % (r2.size() + 1);
+                const size_t last = first + rng() % (r2.size() - first + 1);
+                const size_t pos = rng() % (r1.size() + 1);
+                a1.splice(at(a1, pos), a2, at(a2, first), at(a2, last));
+                r1.splice(at(r1, pos), r2, at(r2, first), at(r2, last));
+            } else if (!r1.empty()) {
+                const size_t first = rng() % r1.size();
+                a2.splice(a2.end(), a1, at(a1, first));
+                r2.splice(r2.end(), r1, at(r1, first));
+            }
+            if (step % 500 == 0) {
+                ok = ok && same(a1, r1) && same(a2, r2) && same(b, rb);
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_TRUE(same(a1, r1));
+        EXPECT_TRUE(same(a2, r2));
+        EXPECT_TRUE(same(b, rb));
+
+        a1.reverse();
+        r1.reverse();
+        EXPECT_TRUE(same(a1, r1));
+        a1.remove_if([](const conn &x) { return x.id % 3 == 0; });
+        r1.remove_if([](int id) { return id % 3 == 0; });
+        EXPECT_TRUE(same(a1, r1));
+        a1.splice(a1.begin(), a2);
+        r1.splice(r1.begin(), r2);
+        EXPECT_TRUE(same(a1, r1));
+        EXPECT_TRUE(a2.empty());
+
+        // 移动与交换只转移链接
+        list_a m(mystl::move(a1));
+        EXPECT_TRUE(a1.empty());
+        EXPECT_TRUE(same(m, r1));
+        m.swap(a2);
+        EXPECT_TRUE(m.empty());
+        EXPECT_TRUE(same(a2, r1));
+
+        EXPECT_TRUE(same(b, rb));
+
+        // 逐个处理摘下的对象，b 中的对象不受影响
+        size_t disposed = 0;
+        a2.clear_and_dispose([&disposed](conn *x) {
+            ++disposed;
+            x->id = -1;
+        });
+        EXPECT_EQ(disposed, r1.size());
+        bool unlinked = true;
+        for (auto &o : objs) {
+            unlinked = unlinked && !static_cast<mystl::intrusive_list_hook<tag_a> &>(o).is_linked();
+        }
+        EXPECT_TRUE(unlinked);
+        EXPECT_EQ(b.size(), rb.size());
+        b.clear();
+        EXPECT_TRUE(b.empty());
+    }
+
+    // 只做链表操作，检查没有分配内存
+    void test_no_allocation() {
+        std::vector<conn> objs(1000);
+        list_a a1, a2;
+        list_b b;
+        const long before = allocations;
+        for (int round = 0; round < 100; ++round) {
+            for (auto &o : objs) {
+                a1.push_back(o);
+                b.push_front(o);
+            }
+            auto mid = a1.begin();
+            mystl::advance(mid, 500);
+            a2.splice(a2.end(), a1, a1.begin(), mid);
+            a1.splice(a1.begin(), a2);
+            a1.reverse();
+            for (size_t i = 0; i < objs.size(); i += 2) {
+                a1.erase(list_a::iterator_to(objs[i]));
+            }
+            a1.insert(a1.begin(), objs[0]);
+            a1.remove_if([](const conn &x) { return x.id != 0; });
+            a1.clear();
+            while (!b.empty()) {
+                b.pop_back();
+            }
+        }
+        EXPECT_EQ(allocations - before, 0);
+        EXPECT_TRUE(a1.empty());
+        EXPECT_TRUE(a2.empty());
+    }
+
+    // 对象的复制不复制链接
+    void test_hook_copy() {
+        conn x(1), y(2);
+        list_a l;
+        l.push_back(x);
+        conn z(x);
+        EXPECT_FALSE(static_cast<mystl::intrusive_list_hook<tag_a> &>(z).is_linked());
+        y = x;
+        EXPECT_FALSE(static_cast<mystl::intrusive_list_hook<tag_a> &>(y).is_linked());
+        l.push_back(z);
+        l.push_back(y);
+        EXPECT_EQ(l.size(), 3u);
+        EXPECT_EQ(l.back().id, 1);
+        auto it = l.erase_and_dispose(l.begin(), [](conn *p) { p->id = 0; });
+        EXPECT_EQ(x.id, 0);
+        EXPECT_TRUE(&*it == &z);
+        l.clear();
+    }
+
+} // namespace
+
+int main() {
+    test_differential();
+    test_no_allocation();
+    test_hook_copy();
+    return mystl::test::report("intrusive_list");
+}
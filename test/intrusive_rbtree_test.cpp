@@ -0,0 +1,240 @@
+// intrusive_rbtree 测试：随机插入、删除后检查红黑树结构，并与 std::multimap / std::set 做差分检查；
+// 对象同时位于一棵树和一个 intrusive_list 中，插入、删除都不分配内存
+
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "intrusive_list.h"
+#include "intrusive_rbtree.h"
+#include "rb_tree_check.h"
+#include "test.h"
+
+// 记录 operator new 的调用次数
+static long allocations = 0;
+
+void *operator new(std::size_t n) {
+    ++allocations;
+    void *p = std::malloc(n == 0 ? 1 : n);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+    struct item : public mystl::intrusive_rbtree_hook<>, public mystl::intrusive_list_hook<> {
+        int key;
+        int id;
+
+        item() : key(0), id(0) {}
+    };
+
+    // 以 key 比较，也可以直接与 int 比较
+    struct key_less {
+        bool operator()(const item &a, const item &b) const { return a.key < b.key; }
+
+        bool operator()(const item &a, int k) const { return a.key < k; }
+
+        bool operator()(int k, const item &b) const { return k < b.key; }
+    };
+
+    typedef mystl::intrusive_rbtree<item, key_less> tree;
+
+    bool is_linked(const item &x) {
+        return static_cast<const mystl::intrusive_rbtree_hook<> &>(x).is_linked();
+    }
+
+    // 按中序与 multimap 的 (key, id) 序列一致
+    bool same(const tree &t, const std::multimap<int, int> &r) {
+        if (t.size() != r.size() || !mystl::test::rb_tree_valid(t)) {
+            return false;
+        }
+        auto it = t.begin();
+        for (auto &e : r) {
+            if (it->key != e.first || it->id != e.second) {
+                return false;
+            }
+            ++it;
+        }
+        return it == t.end();
+    }
+
+    void test_multi() {
+        const int n = 3000;
+        std::vector<item> items(n);
+        for (int i = 0; i < n; ++i) {
+            items[i].id = i;
+        }
+        tree t;
+        std::multimap<int, int> r;
+        std::mt19937 rng(31);
+        bool ok = true;
+        for (int step = 0; step < 40000; ++step) {
+            item &x = items[rng() % n];
+            const int op = static_cast<int>(rng() % 4);
+            if (!is_linked(x)) {
+                x.key = static_cast<int>(rng() % 500);
+                auto it = t.insert_multi(x);
+                r.insert(std::make_pair(x.key, x.id));
+                ok = ok && &*it == &x;
+            } else if (op == 0) {
+                // 按键值删除全部相等的对象
+                const int k = x.key;
+                ok = ok && t.erase(k) == r.erase(k);
+            } else {
+                auto er = r.equal_range(x.key);
+                for (; er.first->second != x.id; ++er.first);
+                r.erase(er.first);
+                t.erase(tree::iterator_to(x));
+                ok = ok && !is_linked(x);
+            }
+            if (step % 1000 == 0) {
+                ok = ok && same(t, r);
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_TRUE(same(t, r));
+
+        // 以 int 查找
+        bool found = true;
+        for (int k = -1; k < 502; ++k) {
+            auto lb = t.lower_bound(k);
+            auto ub = t.upper_bound(k);
+            auto rl = r.lower_bound(k);
+            auto ru = r.upper_bound(k);
+            found = found && (rl == r.end() ? lb == t.end() : lb != t.end() && lb->id == rl->second);
+            found = found && (ru == r.end() ? ub == t.end() : ub != t.end() && ub->id == ru->second);
+            found = found && t.count(k) == r.count(k);
+            found = found && (t.find(k) == t.end()) == (r.count(k) == 0);
+            auto er = t.equal_range(k);
+            found = found && er.first == lb && er.second == ub;
+        }
+        EXPECT_TRUE(found);
+
+        // 反向遍历
+        auto rit = t.rbegin();
+        bool back = true;
+        for (auto ri = r.rbegin(); ri != r.rend(); ++ri, ++rit) {
+            back = back && rit->id == ri->second;
+        }
+        EXPECT_TRUE(back);
+
+        // 区间删除与移动
+        auto first = t.lower_bound(100);
+        auto last = t.lower_bound(200);
+        t.erase(first, last);
+        r.erase(r.lower_bound(100), r.lower_bound(200));
+        EXPECT_TRUE(same(t, r));
+        tree m(mystl::move(t));
+        EXPECT_TRUE(t.empty());
+        EXPECT_TRUE(mystl::test::rb_tree_valid(t));
+        EXPECT_TRUE(same(m, r));
+        size_t disposed = 0;
+        m.clear_and_dispose([&disposed](item *p) {
+            ++disposed;
+            p->key = -1;
+        });
+        EXPECT_EQ(disposed, r.size());
+        bool unlinked = true;
+        for (auto &x : items) {
+            unlinked = unlinked && !is_linked(x);
+        }
+        EXPECT_TRUE(unlinked);
+        EXPECT_TRUE(m.empty());
+    }
+
+    void test_unique() {
+        std::vector<item> items(2000);
+        tree t;
+        std::set<int> r;
+        std::mt19937 rng(33);
+        bool ok = true;
+        for (size_t i = 0; i < items.size(); ++i) {
+            items[i].key = static_cast<int>(rng() % 1000);
+            items[i].id = static_cast<int>(i);
+            auto p = t.insert_unique(items[i]);
+            const bool inserted = r.insert(items[i].key).second;
+            ok = ok && p.second == inserted && p.first->key == items[i].key;
+            ok = ok && is_linked(items[i]) == inserted;
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_TRUE(mystl::test::rb_tree_valid(t));
+        EXPECT_EQ(t.size(), r.size());
+        bool order = true;
+        auto it = t.begin();
+        for (int k : r) {
+            order = order && it->key == k;
+            ++it;
+        }
+        EXPECT_TRUE(order);
+        t.clear();
+        EXPECT_TRUE(t.empty());
+    }
+
+    // 对象同时在树和链表中；只做侵入式容器的操作，检查没有分配内存
+    void test_tree_and_list() {
+        std::vector<item> items(5000);
+        for (size_t i = 0; i < items.size(); ++i) {
+            items[i].key = static_cast<int>((i * 7919) % items.size());
+            items[i].id = static_cast<int>(i);
+        }
+        const long before = allocations;
+        tree t;
+        mystl::intrusive_list<item> lru;
+        for (auto &x : items) {
+            t.insert_unique(x);
+            lru.push_front(x);
+        }
+        // 从链表尾部淘汰一半对象，同时从树中摘下
+        for (size_t i = 0; i < items.size() / 2; ++i) {
+            item &x = lru.back();
+            lru.pop_back();
+            t.erase(tree::iterator_to(x));
+        }
+        // 查找到的对象移到链表头部
+        for (int k = 0; k < 5000; k += 3) {
+            auto it = t.find(k);
+            if (it != t.end()) {
+                lru.erase(mystl::intrusive_list<item>::iterator_to(*it));
+                lru.push_front(*it);
+            }
+        }
+        const long used = allocations - before;
+        EXPECT_EQ(used, 0);
+        EXPECT_EQ(t.size(), 2500u);
+        EXPECT_EQ(lru.size(), 2500u);
+        EXPECT_TRUE(mystl::test::rb_tree_valid(t));
+        bool both = true;
+        for (auto &x : lru) {
+            both = both && is_linked(x) && t.find(x.key) == tree::iterator_to(x);
+        }
+        EXPECT_TRUE(both);
+        // 先摘下链表，树中的对象不受影响
+        lru.clear();
+        EXPECT_TRUE(mystl::test::rb_tree_valid(t));
+        EXPECT_EQ(t.size(), 2500u);
+        t.clear();
+    }
+
+} // namespace
+
+int main() {
+    test_multi();
+    test_unique();
+    test_tree_and_list();
+    return mystl::test::report("intrusive_rbtree");
+}
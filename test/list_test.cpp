@@ -0,0 +1,317 @@
+// list 测试：随机操作与 std::list 做差分检查；splice / merge 只重新链接节点，不复制元素；
+// sort 对各种长度都与 std::list::sort 的结果相同（稳定），比较函数抛出异常时节点不丢失；
+// 被移动赋值移走的 list 仍可继续使用
+
+#include <algorithm>
+#include <list>
+#include <stdexcept>
+#include <random>
+#include <set>
+#include <string>
+
+#include "list.h"
+#include "test.h"
+
+namespace {
+
+    // 记录复制与移动次数的元素
+    struct tracked {
+        static int copies;
+        static int moves;
+        int k;
+
+        explicit tracked(int x = 0) : k(x) {}
+
+        tracked(const tracked &rhs) : k(rhs.k) { ++copies; }
+
+        tracked(tracked &&rhs) noexcept: k(rhs.k) { ++moves; }
+
+        tracked &operator=(const tracked &rhs) {
+            k = rhs.k;
+            ++copies;
+            return *this;
+        }
+
+        bool operator<(const tracked &rhs) const { return k < rhs.k; }
+    };
+
+    int tracked::copies = 0;
+    int tracked::moves = 0;
+
+    void reset_counts() {
+        tracked::copies = 0;
+        tracked::moves = 0;
+    }
+
+    // 随机操作，每一步后与 std::list 对照
+    void test_differential() {
+        std::mt19937 rng(3);
+        mystl::list<int> l;
+        std::list<int> r;
+        for (int i = 0; i < 20000; ++i) {
+            const int op = static_cast<int>(rng() % 8);
+            const int x = static_cast<int>(rng() % 100);
+            if (op < 2) {
+                l.push_back(x);
+                r.push_back(x);
+            } else if (op < 3) {
+                l.push_front(x);
+                r.push_front(x);
+            } else if (op < 4 && !r.empty()) {
+                l.pop_front();
+                r.pop_front();
+            } else if (op < 5 && !r.empty()) {
+                l.pop_back();
+                r.pop_back();
+            } else if (op < 6) {
+                // 在第 x % (size + 1) 个位置插入
+                const size_t pos = static_cast<size_t>(x) % (r.size() + 1);
+                auto it = l.begin();
+                auto rit = r.begin();
+                for (size_t j = 0; j < pos; ++j, ++it, ++rit) {
+                }
+                l.insert(it, x);
+                r.insert(rit, x);
+            } else if (op < 7 && !r.empty()) {
+                const size_t pos = static_cast<size_t>(x) % r.size();
+                auto it = l.begin();
+                auto rit = r.begin();
+                for (size_t j = 0; j < pos; ++j, ++it, ++rit) {
+                }
+                l.erase(it);
+                r.erase(rit);
+            } else if (i % 97 == 0) {
+                l.remove(x);
+                r.remove(x);
+            }
+            if (i % 1000 == 0) {
+                EXPECT_SEQ_EQ(l, r);
+            }
+        }
+        EXPECT_EQ(l.size(), r.size());
+        EXPECT_SEQ_EQ(l, r);
+        l.reverse();
+        r.reverse();
+        EXPECT_SEQ_EQ(l, r);
+        l.sort();
+        r.sort();
+        EXPECT_SEQ_EQ(l, r);
+        l.unique();
+        r.unique();
+        EXPECT_SEQ_EQ(l, r);
+        mystl::list<int> c(l);
+        EXPECT_SEQ_EQ(c, r);
+        c.clear();
+        EXPECT_TRUE(c.empty());
+        c.push_back(1);
+        EXPECT_EQ(c.front(), 1);
+    }
+
+    // splice / merge 的两方各自与第三个 list 共用节点池时，仍然只重新链接节点
+    void test_splice_merge() {
+        mystl::list<tracked> a, b, c, d;
+        for (int i = 0; i < 100; ++i) {
+            a.emplace_back(2 * i);
+            b.emplace_back(2 * i + 1);
+            c.emplace_back(-1);
+            d.emplace_back(-2);
+        }
+        // a 与 c、b 与 d 分别共用节点池
+        a.splice(a.end(), c, c.begin());
+        b.splice(b.end(), d, d.begin());
+        a.pop_back();
+        b.pop_back();
+        reset_counts();
+        const tracked *first_b = &b.front();
+        a.splice(a.begin(), b, b.begin());
+        EXPECT_TRUE(&a.front() == first_b);
+        EXPECT_EQ(a.size(), 101u);
+        EXPECT_EQ(b.size(), 99u);
+        auto mid = b.begin();
+        mystl::advance(mid, 50);
+        c.splice(c.end(), b, b.begin(), mid);
+        EXPECT_EQ(c.size(), 149u);
+        EXPECT_EQ(b.size(), 49u);
+        d.splice(d.begin(), b);
+        EXPECT_TRUE(b.empty());
+        EXPECT_EQ(d.size(), 148u);
+        EXPECT_EQ(tracked::copies, 0);
+        EXPECT_EQ(tracked::moves, 0);
+
+        // 把 c、d 中的奇数取回 b，再与 a 合并
+        reset_counts();
+        c.remove_if([](const tracked &t) { return t.k < 0; });
+        d.remove_if([](const tracked &t) { return t.k < 0; });
+        b.splice(b.end(), c);
+        b.splice(b.end(), d);
+        a.sort();
+        b.sort();
+        a.merge(b);
+        EXPECT_TRUE(b.empty());
+        EXPECT_EQ(a.size(), 200u);
+        bool ok = true;
+        int expect = 0;
+        for (auto &t : a) {
+            ok = ok && t.k == expect++;
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(tracked::copies, 0);
+        EXPECT_EQ(tracked::moves, 0);
+
+        // 节点在各个 list 之间转移后，任一 list 都可以先析构
+        {
+            mystl::list<tracked> e;
+            e.emplace_back(7);
+            a.splice(a.end(), e);
+        }
+        EXPECT_EQ(a.back().k, 7);
+        a.clear();
+        for (int i = 0; i < 10; ++i) {
+            a.emplace_back(i);
+        }
+        EXPECT_EQ(a.size(), 10u);
+    }
+
+    // 只按 key 比较，value 记录原先的位置，用来检查稳定性
+    struct keyed {
+        int key;
+        int value;
+
+        bool operator==(const keyed &rhs) const { return key == rhs.key && value == rhs.value; }
+    };
+
+    struct keyed_less {
+        bool operator()(const keyed &a, const keyed &b) const { return a.key < b.key; }
+    };
+
+    // 比较到第 budget 次时抛出异常
+    struct throwing_less {
+        int *budget;
+
+        bool operator()(int a, int b) const {
+            if ((*budget)-- == 0) {
+                throw std::runtime_error("throwing_less");
+            }
+            return a < b;
+        }
+    };
+
+    void test_sort() {
+        std::mt19937 rng(9);
+        bool ok = true;
+        const size_t big[] = {1000, 1023, 1024, 1025, 3 * 1024 + 1, 100000};
+        for (size_t n = 0; n < 80 + sizeof(big) / sizeof(big[0]); ++n) {
+            const size_t len = n < 80 ? n : big[n - 80];
+            mystl::list<keyed> l;
+            std::list<keyed> r;
+            for (size_t i = 0; i < len; ++i) {
+                const keyed k = {static_cast<int>(rng() % (len / 4 + 1)), static_cast<int>(i)};
+                l.push_back(k);
+                r.push_back(k);
+            }
+            l.sort(keyed_less());
+            r.sort(keyed_less());
+            ok = ok && l.size() == r.size() && std::equal(r.begin(), r.end(), l.begin());
+            // 反向遍历检查 prev 指针
+            ok = ok && std::equal(r.rbegin(), r.rend(), l.rbegin());
+        }
+        EXPECT_TRUE(ok);
+
+        // 已有序与逆序的输入
+        mystl::list<int> a;
+        for (int i = 0; i < 5000; ++i) {
+            a.push_back(i);
+        }
+        a.sort();
+        EXPECT_EQ(a.front(), 0);
+        EXPECT_EQ(a.back(), 4999);
+        a.sort(mystl::greater<int>());
+        EXPECT_EQ(a.front(), 4999);
+        EXPECT_EQ(a.back(), 0);
+        EXPECT_EQ(a.size(), 5000u);
+
+        // 比较函数在排序的各个阶段抛出异常，所有节点仍在 list 中且链接完整
+        bool kept = true;
+        for (int when = 0; when < 1800; when += 37) {
+            mystl::list<int> t;
+            std::multiset<int> ref;
+            for (int i = 0; i < 300; ++i) {
+                const int x = static_cast<int>(rng() % 1000);
+                t.push_back(x);
+                ref.insert(x);
+            }
+            int budget = when;
+            EXPECT_THROW(t.sort(throwing_less{&budget}), std::runtime_error);
+            std::multiset<int> got, back;
+            for (auto it = t.begin(); it != t.end(); ++it) {
+                got.insert(*it);
+            }
+            for (auto it = t.rbegin(); it != t.rend(); ++it) {
+                back.insert(*it);
+            }
+            kept = kept && t.size() == 300 && got == ref && back == ref;
+        }
+        EXPECT_TRUE(kept);
+    }
+
+    // 移动赋值后，被移走的 list 仍是合法的空 list，可以继续使用
+    void test_move_assign() {
+        mystl::list<int> a{1, 2}, b{3};
+        a = mystl::move(b);
+        EXPECT_EQ(a.size(), 1u);
+        EXPECT_EQ(a.front(), 3);
+        EXPECT_TRUE(b.empty());
+        for (int i = 0; i < 100; ++i) {
+            b.push_back(i);
+        }
+        b.push_front(-1);
+        EXPECT_EQ(b.size(), 101u);
+        int expect = -1;
+        bool ordered = true;
+        for (auto it = b.begin(); it != b.end(); ++it) {
+            ordered = ordered && *it == expect;
+            expect = expect < 0 ? 0 : expect + 1;
+        }
+        EXPECT_TRUE(ordered);
+        EXPECT_EQ(expect, 100);
+
+        // 再从 a 移回 b，两边都可继续使用
+        b = mystl::move(a);
+        EXPECT_EQ(b.size(), 1u);
+        EXPECT_EQ(b.back(), 3);
+        a.push_back(7);
+        EXPECT_EQ(a.size(), 1u);
+        EXPECT_EQ(a.front(), 7);
+    }
+
+    void test_strings() {
+        mystl::list<std::string> a, b;
+        for (int i = 0; i < 100; ++i) {
+            a.push_back(std::to_string(i));
+            b.push_back("b" + std::to_string(i));
+        }
+        a.splice(a.end(), b);
+        EXPECT_EQ(a.size(), 200u);
+        EXPECT_TRUE(b.empty());
+        b.push_back("x");
+        b.splice(b.begin(), a, a.begin());
+        EXPECT_EQ(b.size(), 2u);
+        EXPECT_EQ(b.front(), "0");
+        mystl::list<std::string> h(mystl::move(a));
+        EXPECT_EQ(h.size(), 199u);
+        mystl::list<std::string> k;
+        k = mystl::move(h);
+        EXPECT_EQ(k.size(), 199u);
+        EXPECT_EQ(k.back(), "b99");
+    }
+
+} // namespace
+
+int main() {
+    test_differential();
+    test_splice_merge();
+    test_sort();
+    test_move_assign();
+    test_strings();
+    return mystl::test::report("list");
+}
@@ -0,0 +1,142 @@
+// mmap_vector 测试：与 std::vector 做差分检查，重新打开文件后数据保持不变，输入迭代器只遍历一次
+
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+#include "mmap_vector.h"
+#include "test.h"
+
+namespace {
+
+    struct point {
+        int a;
+        double b;
+    };
+
+    // 单遍的输入迭代器：每次解引用都从共享的计数器取下一个值，
+    // 同一区间若被遍历两次，第二次得到的值会不同
+    class counting_input_iterator : public mystl::iterator<mystl::input_iterator_tag, int> {
+    public:
+        counting_input_iterator(int *next, int remain) : next_(next), remain_(remain) {}
+
+        int operator*() const { return (*next_)++; }
+
+        counting_input_iterator &operator++() {
+            --remain_;
+            return *this;
+        }
+
+        bool operator==(const counting_input_iterator &rhs) const { return remain_ == rhs.remain_; }
+
+        bool operator!=(const counting_input_iterator &rhs) const { return remain_ != rhs.remain_; }
+
+    private:
+        int *next_;
+        int remain_;
+    };
+
+    void test_reopen(const char *path) {
+        ::unlink(path);
+        {
+            mystl::mmap_vector<point> v(path);
+            for (int i = 0; i < 100000; ++i) {
+                v.push_back(point{i, i * 0.5});
+            }
+            v.insert(v.begin() + 1, 3, point{-1, 0});
+            v.erase(v.begin() + 1, v.begin() + 4);
+            v.emplace_back(point{7, 7});
+            v.flush();
+        }
+        mystl::mmap_vector<point> w(path);
+        EXPECT_EQ(w.size(), 100001u);
+        bool same = true;
+        for (int i = 0; i < 100000; ++i) {
+            same = same && w[i].a == i;
+        }
+        EXPECT_TRUE(same);
+        EXPECT_EQ(w.back().a, 7);
+        w.resize(10);
+        w.shrink_to_fit();
+        w.close();
+
+        mystl::mmap_vector<point> x(path);
+        EXPECT_EQ(x.size(), 10u);
+        EXPECT_EQ(x.capacity(), 10u);
+        x.close();
+        // 元素大小不同的类型打开同一文件会失败
+        EXPECT_THROW(mystl::mmap_vector<double> bad(path), std::runtime_error);
+        ::unlink(path);
+    }
+
+    void test_differential(const char *path) {
+        ::unlink(path);
+        std::mt19937 rng(3);
+        mystl::mmap_vector<int> v(path);
+        std::vector<int> sv;
+        for (int i = 0; i < 2000; ++i) {
+            const size_t pos = sv.empty() ? 0 : rng() % (sv.size() + 1);
+            switch (rng() % 4) {
+                case 0: {
+                    int src[] = {i, i + 1, i + 2};
+                    v.insert(v.begin() + pos, src, src + 3);
+                    sv.insert(sv.begin() + pos, src, src + 3);
+                    break;
+                }
+                case 1:
+                    v.insert(v.begin() + pos, 2, i);
+                    sv.insert(sv.begin() + pos, 2, i);
+                    break;
+                case 2:
+                    if (pos < sv.size()) {
+                        v.erase(v.begin() + pos);
+                        sv.erase(sv.begin() + pos);
+                    }
+                    break;
+                default:
+                    v.push_back(i);
+                    sv.push_back(i);
+                    break;
+            }
+        }
+        EXPECT_SEQ_EQ(v, sv);
+        v.close();
+        ::unlink(path);
+    }
+
+    void test_input_iterator(const char *path) {
+        ::unlink(path);
+        mystl::mmap_vector<int> v(path);
+        for (int i = 0; i < 5; ++i) {
+            v.push_back(-i);
+        }
+        // 在中间插入：追加后旋转到插入位置
+        int next = 100;
+        v.insert(v.begin() + 2, counting_input_iterator(&next, 4), counting_input_iterator(&next, 0));
+        const int expect1[] = {0, -1, 100, 101, 102, 103, -2, -3, -4};
+        EXPECT_TRUE(mystl::test::seq_equal(v.begin(), v.end(), expect1, expect1 + 9));
+        EXPECT_EQ(next, 104);
+
+        // assign 同样只遍历一次
+        next = 0;
+        v.assign(counting_input_iterator(&next, 3), counting_input_iterator(&next, 0));
+        const int expect2[] = {0, 1, 2};
+        EXPECT_TRUE(mystl::test::seq_equal(v.begin(), v.end(), expect2, expect2 + 3));
+        EXPECT_EQ(next, 3);
+        v.close();
+        ::unlink(path);
+    }
+
+} // namespace
+
+int main() {
+    char path[64];
+    std::snprintf(path, sizeof(path), "mmap_vector_test_%ld.bin", static_cast<long>(::getpid()));
+    test_reopen(path);
+    test_differential(path);
+    test_input_iterator(path);
+    return mystl::test::report("mmap_vector");
+}
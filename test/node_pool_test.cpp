@@ -0,0 +1,164 @@
+// node_pool / shared_node_pool 测试：节点复用、空闲块归还、节点池合并，以及共用节点池的容器在不同线程中修改
+
+#include <random>
+#include <set>
+#include <thread>
+
+#include "node_pool.h"
+#include "set.h"
+#include "test.h"
+
+namespace {
+
+    struct node {
+        node *next;
+        long value;
+    };
+
+    typedef mystl::node_pool<node> pool_type;
+    typedef mystl::shared_node_pool<node> shared_pool_type;
+
+    void test_reuse() {
+        pool_type pool;
+        node *a = pool.allocate();
+        node *b = pool.allocate();
+        EXPECT_TRUE(a != b);
+        pool.deallocate(a);
+        // 刚归还的节点最先被复用
+        EXPECT_TRUE(pool.allocate() == a);
+
+        node *block = pool.allocate_n(100);
+        for (int i = 0; i < 100; ++i) {
+            block[i].value = i;
+        }
+        for (int i = 0; i < 100; ++i) {
+            pool.deallocate(block + i);
+        }
+        pool.release();
+        EXPECT_EQ(pool.slab_count(), 0u);
+    }
+
+    void test_trim() {
+        pool_type pool;
+        mystl::vector<node *> nodes;
+        for (int i = 0; i < 200000; ++i) {
+            nodes.push_back(pool.allocate());
+        }
+        const size_t full = pool.slab_count();
+        EXPECT_TRUE(full > 4);
+        // 归还前一半以外的节点：后面的块整块空闲，应被归还
+        for (size_t i = nodes.size() / 2; i < nodes.size(); ++i) {
+            pool.deallocate(nodes[i]);
+        }
+        // 再归还一些零散的节点，触发之后的整理
+        for (size_t i = 0; i < nodes.size() / 2; i += 2) {
+            pool.deallocate(nodes[i]);
+        }
+        EXPECT_TRUE(pool.slab_count() < full);
+        // 剩余的节点仍然可用，全部归还后只保留当前块
+        for (size_t i = 1; i < nodes.size() / 2; i += 2) {
+            nodes[i]->value = static_cast<long>(i);
+        }
+        for (size_t i = 1; i < nodes.size() / 2; i += 2) {
+            EXPECT_EQ(nodes[i]->value, static_cast<long>(i));
+            pool.deallocate(nodes[i]);
+        }
+        EXPECT_EQ(pool.slab_count(), 1u);
+
+        // 以随机顺序全部归还
+        std::mt19937 rng(5);
+        nodes.clear();
+        for (int i = 0; i < 200000; ++i) {
+            nodes.push_back(pool.allocate());
+        }
+        for (size_t i = nodes.size(); i > 1; --i) {
+            mystl::swap(nodes[i - 1], nodes[rng() % i]);
+        }
+        for (auto p : nodes) {
+            pool.deallocate(p);
+        }
+        EXPECT_EQ(pool.slab_count(), 1u);
+    }
+
+    void test_share_with() {
+        // a、c 共用一个节点池，b、d 共用另一个，两边都不是独占时也能合并
+        shared_pool_type a, b;
+        node *na = a.allocate();
+        node *nb = b.allocate();
+        shared_pool_type c(a), d(b);
+        EXPECT_FALSE(a.unique());
+        EXPECT_FALSE(a.shares_with(b));
+        a.share_with(b);
+        EXPECT_TRUE(a.shares_with(b));
+        EXPECT_TRUE(c.shares_with(d));
+        EXPECT_TRUE(c.shares_with(b));
+        // 节点可以经由任何一个句柄归还
+        d.deallocate(na);
+        c.deallocate(nb);
+        node *x = d.allocate();
+        c.deallocate(x);
+        a.reset();
+        b.reset();
+        c.reset();
+        EXPECT_TRUE(d.unique());
+        d.allocate();
+        d.release();
+    }
+
+    // 从一棵树分裂出的两个 set 共用节点池，分别交给两个线程修改
+    void test_threads() {
+        mystl::set<int> s;
+        for (int i = 0; i < 200000; ++i) {
+            s.insert(i);
+        }
+        auto parts = s.split(100000);
+        mystl::set<int> &lo = parts.first;
+        mystl::set<int> &hi = parts.second;
+        auto work = [](mystl::set<int> &t, int base, unsigned seed) {
+            std::mt19937 rng(seed);
+            for (int i = 0; i < 200000; ++i) {
+                const int k = base + static_cast<int>(rng() % 100000);
+                if (rng() % 2) {
+                    t.insert(k);
+                } else {
+                    t.erase(k);
+                }
+            }
+        };
+        std::thread t1(work, std::ref(lo), 0, 1u);
+        std::thread t2(work, std::ref(hi), 100000, 2u);
+        t1.join();
+        t2.join();
+
+        // 单线程重放同样的操作作为对照
+        std::set<int> rlo, rhi;
+        for (int i = 0; i < 100000; ++i) {
+            rlo.insert(i);
+            rhi.insert(100000 + i);
+        }
+        auto replay = [](std::set<int> &t, int base, unsigned seed) {
+            std::mt19937 rng(seed);
+            for (int i = 0; i < 200000; ++i) {
+                const int k = base + static_cast<int>(rng() % 100000);
+                if (rng() % 2) {
+                    t.insert(k);
+                } else {
+                    t.erase(k);
+                }
+            }
+        };
+        replay(rlo, 0, 1u);
+        replay(rhi, 100000, 2u);
+        EXPECT_SEQ_EQ(lo, rlo);
+        EXPECT_SEQ_EQ(hi, rhi);
+    }
+
+} // namespace
+
+int main() {
+    test_reuse();
+    test_trim();
+    test_share_with();
+    test_threads();
+    return mystl::test::report("node_pool");
+}
@@ -0,0 +1,222 @@
+// persistent_set 测试：保存的每个历史版本都与当时的 std::set 一致且是合法的红黑树，
+// 修改不影响旧版本；不同线程可以同时读取、复制、析构共用节点的版本
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "persistent_set.h"
+#include "test.h"
+
+namespace {
+
+    // 返回以 x 为根的子树的黑高，不合法时把 ok 置为 false
+    template<class NodePtr>
+    int black_height(NodePtr x, bool &ok) {
+        if (x == nullptr) {
+            return 1;
+        }
+        if (x->red && ((x->left != nullptr && x->left->red) || (x->right != nullptr && x->right->red))) {
+            ok = false;
+        }
+        const int lh = black_height(x->left, ok);
+        const int rh = black_height(x->right, ok);
+        if (lh != rh) {
+            ok = false;
+        }
+        return lh + (x->red ? 0 : 1);
+    }
+
+    // end() 迭代器保存着版本的根节点
+    template<class Set>
+    bool persistent_valid(const Set &s) {
+        auto root = s.end().root;
+        if (root == nullptr) {
+            return s.empty();
+        }
+        bool ok = !root->red;
+        black_height(root, ok);
+        return ok;
+    }
+
+    // 复制时按预算抛出异常的键值
+    struct thrower {
+        static int budget;
+        int value;
+
+        thrower(int v) : value(v) {}
+
+        thrower(const thrower &rhs) : value(rhs.value) {
+            if (budget >= 0 && budget-- == 0) {
+                throw std::runtime_error("thrower");
+            }
+        }
+
+        bool operator<(const thrower &rhs) const { return value < rhs.value; }
+    };
+
+    int thrower::budget = -1;
+
+    void test_versions() {
+        typedef mystl::persistent_set<int> pset;
+        std::mt19937 rng(1);
+        std::vector<pset> versions;
+        std::vector<std::set<int>> refs;
+        pset cur;
+        std::set<int> ref;
+        for (int i = 0; i < 20000; ++i) {
+            const int k = static_cast<int>(rng() % 3000);
+            if (rng() % 3 == 0) {
+                cur = cur.erase(k);
+                ref.erase(k);
+            } else {
+                cur = cur.insert(k);
+                ref.insert(k);
+            }
+            if (i % 500 == 0) {
+                versions.push_back(cur);
+                refs.push_back(ref);
+            }
+        }
+        versions.push_back(cur);
+        refs.push_back(ref);
+
+        for (size_t v = 0; v < versions.size(); ++v) {
+            const pset &s = versions[v];
+            const std::set<int> &r = refs[v];
+            EXPECT_TRUE(persistent_valid(s));
+            EXPECT_EQ(s.size(), r.size());
+            EXPECT_SEQ_EQ(s, r);
+            EXPECT_TRUE(std::equal(r.rbegin(), r.rend(), s.rbegin()));
+            bool ok = true;
+            for (int k = -2; k < 3002; k += 7) {
+                auto lb = s.lower_bound(k);
+                auto rl = r.lower_bound(k);
+                auto ub = s.upper_bound(k);
+                auto ru = r.upper_bound(k);
+                if ((lb == s.end()) != (rl == r.end()) || (rl != r.end() && *lb != *rl) ||
+                    (ub == s.end()) != (ru == r.end()) || (ru != r.end() && *ub != *ru) ||
+                    s.count(k) != r.count(k) || (s.find(k) != s.end()) != (r.count(k) == 1)) {
+                    ok = false;
+                }
+                // 从查找得到的迭代器出发前进、后退
+                if (lb != s.end() && lb != s.begin()) {
+                    auto p = lb;
+                    auto rp = rl;
+                    if (*--p != *--rp) {
+                        ok = false;
+                    }
+                }
+            }
+            EXPECT_TRUE(ok);
+        }
+
+        // 插入已有键值、删除不存在的键值时返回共用同一棵树的版本
+        pset a{1, 2, 3};
+        EXPECT_TRUE(a.insert(2).shares_with(a));
+        EXPECT_TRUE(a.erase(9).shares_with(a));
+        pset d = a.insert(4);
+        EXPECT_FALSE(d.shares_with(a));
+        EXPECT_EQ(a.size(), 3u);
+        EXPECT_EQ(d.size(), 4u);
+        EXPECT_TRUE(a != d);
+        EXPECT_TRUE(a < d);
+
+        pset e = cur;
+        for (int k : ref) {
+            e = e.erase(k);
+        }
+        EXPECT_TRUE(e.empty());
+        EXPECT_TRUE(e.begin() == e.end());
+        EXPECT_EQ(cur.size(), ref.size());
+
+        // 原地修改独占的版本
+        pset seq;
+        for (int i = 0; i < 100000; ++i) {
+            seq.insert_in_place(i);
+        }
+        EXPECT_TRUE(persistent_valid(seq));
+        for (int i = 0; i < 100000; i += 2) {
+            seq.erase_in_place(i);
+        }
+        EXPECT_EQ(seq.size(), 50000u);
+        EXPECT_TRUE(persistent_valid(seq));
+        EXPECT_EQ(*seq.begin(), 1);
+
+        mystl::persistent_set<std::string> ss;
+        for (int i = 0; i < 1000; ++i) {
+            ss = ss.insert(std::to_string(i));
+        }
+        EXPECT_EQ(ss.size(), 1000u);
+        EXPECT_TRUE(persistent_valid(ss));
+    }
+
+    // 复制路径上的节点时抛出异常，原版本不受影响
+    void test_exception_safety() {
+        mystl::persistent_set<thrower> s;
+        for (int i = 0; i < 200; ++i) {
+            s = s.insert(thrower(i));
+        }
+        thrower::budget = 0;
+        EXPECT_THROW(s.insert(thrower(1000)), std::runtime_error);
+        thrower::budget = -1;
+        EXPECT_EQ(s.size(), 200u);
+        EXPECT_TRUE(persistent_valid(s));
+        int expect = 0;
+        bool ok = true;
+        for (auto it = s.begin(); it != s.end(); ++it, ++expect) {
+            ok = ok && it->value == expect;
+        }
+        EXPECT_TRUE(ok);
+    }
+
+    // 发布者不断产生新版本，读者各自复制、遍历、丢弃旧版本
+    void test_threads() {
+        typedef mystl::persistent_set<long> pset;
+        pset base;
+        for (long i = 0; i < 5000; ++i) {
+            base = base.insert(i * 2);
+        }
+        std::atomic<int> bad(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 3; ++t) {
+            threads.emplace_back([base, t, &bad] {
+                std::mt19937 rng(t);
+                pset mine = base;
+                for (int i = 0; i < 3000; ++i) {
+                    const long k = static_cast<long>(rng() % 20000);
+                    pset next = rng() % 2 ? mine.insert(k) : mine.erase(k);
+                    if (i % 300 == 0) {
+                        long prev = -1;
+                        for (long x : next) {
+                            if (x <= prev) {
+                                ++bad;
+                            }
+                            prev = x;
+                        }
+                    }
+                    mine = next;
+                }
+            });
+        }
+        for (auto &th : threads) {
+            th.join();
+        }
+        EXPECT_EQ(bad.load(), 0);
+        EXPECT_EQ(base.size(), 5000u);
+        EXPECT_TRUE(persistent_valid(base));
+    }
+
+} // namespace
+
+int main() {
+    test_versions();
+    test_exception_safety();
+    test_threads();
+    return mystl::test::report("persistent_set");
+}
@@ -0,0 +1,27 @@
+// 以不同的 MYSTL_RB_TREE_* 设置编译的翻译单元链接进同一程序：两边的 set<int> 位于不同的内联命名空间，
+// 是不同的类型，各自按自己的节点布局工作
+
+#include <cstring>
+#include <typeinfo>
+
+#include "set.h"
+#include "rb_tree_check.h"
+#include "test.h"
+
+namespace mystl {
+    namespace test {
+
+        bool rb_tree_abi_variant_run();
+
+        const char *rb_tree_abi_variant_name();
+
+    } // namespace test
+} // namespace mystl
+
+int main() {
+    EXPECT_TRUE(mystl::test::rb_tree_churn<mystl::set<int>>(1, 20000));
+    EXPECT_TRUE(mystl::test::rb_tree_abi_variant_run());
+    EXPECT_TRUE(std::strcmp(typeid(mystl::set<int>).name(), mystl::test::rb_tree_abi_variant_name()) != 0);
+    EXPECT_TRUE(mystl::test::rb_tree_churn<mystl::set<int>>(3, 20000));
+    return mystl::test::report("rb_tree_abi");
+}
@@ -0,0 +1,20 @@
+// 与 rb_tree_abi_test.cpp 链接在一起的翻译单元，编译时打开全部 MYSTL_RB_TREE_* 宏
+
+#include <typeinfo>
+
+#include "set.h"
+#include "rb_tree_check.h"
+
+namespace mystl {
+    namespace test {
+
+        bool rb_tree_abi_variant_run() {
+            return rb_tree_churn<mystl::set<int>>(2, 20000);
+        }
+
+        const char *rb_tree_abi_variant_name() {
+            return typeid(mystl::set<int>).name();
+        }
+
+    } // namespace test
+} // namespace mystl
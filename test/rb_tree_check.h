@@ -0,0 +1,96 @@
+#ifndef MYTINYSTL_RB_TREE_CHECK_H_
+#define MYTINYSTL_RB_TREE_CHECK_H_
+
+// 这个头文件包含了检查红黑树结构是否合法的辅助函数，供以 rb_tree 为底层的容器的测试使用
+// 检查内容：根为黑色、没有相邻的红色节点、各路径黑高相同、父指针一致、
+// header 的左右指针为最小和最大节点、节点数与 size() 一致，开启顺序统计时还检查子树大小
+
+#include <random>
+#include <set>
+
+#include "rb_tree.h"
+
+namespace mystl {
+    namespace test {
+
+        // 返回以 x 为根的子树的黑高，不合法时把 ok 置为 false
+        template<class BasePtr>
+        int rb_tree_check_node(BasePtr x, BasePtr parent, size_t &count, bool &ok) {
+            if (x == nullptr) {
+                count = 0;
+                return 1;
+            }
+            BasePtr xp = x->parent;
+            if (xp != parent) {
+                ok = false;
+            }
+            if (mystl::rb_tree_is_red(x) &&
+                ((x->left != nullptr && mystl::rb_tree_is_red(x->left)) ||
+                 (x->right != nullptr && mystl::rb_tree_is_red(x->right)))) {
+                ok = false;
+            }
+            size_t lc = 0, rc = 0;
+            const int lh = rb_tree_check_node(x->left, x, lc, ok);
+            const int rh = rb_tree_check_node(x->right, x, rc, ok);
+            if (lh != rh) {
+                ok = false;
+            }
+            count = lc + rc + 1;
+#ifdef MYSTL_RB_TREE_ORDER_STATISTICS
+            if (x->size != count) {
+                ok = false;
+            }
+#endif
+            return lh + (mystl::rb_tree_is_red(x) ? 0 : 1);
+        }
+
+        // 检查容器 c 的底层红黑树，c.end() 指向 header
+        template<class Container>
+        bool rb_tree_valid(const Container &c) {
+            auto header = c.end().node;
+            decltype(header) root = header->parent;
+            if (root == nullptr) {
+                return c.size() == 0 && header->left == header && header->right == header;
+            }
+            bool ok = !mystl::rb_tree_is_red(root);
+            size_t count = 0;
+            rb_tree_check_node(root, header, count, ok);
+            return ok && count == c.size() &&
+                   header->left == mystl::rb_tree_min(root) &&
+                   header->right == mystl::rb_tree_max(root);
+        }
+
+        // 对 Set 随机插入、删除，每隔一段检查结构并与 std::set 对照
+        template<class Set>
+        bool rb_tree_churn(unsigned seed, int rounds) {
+            std::mt19937 rng(seed);
+            Set s;
+            std::set<int> ref;
+            for (int i = 0; i < rounds; ++i) {
+                const int x = static_cast<int>(rng() % 1000);
+                if (rng() % 3 != 0) {
+                    s.insert(x);
+                    ref.insert(x);
+                } else if (s.erase(x) != ref.erase(x)) {
+                    return false;
+                }
+                if (i % 500 == 0 && !rb_tree_valid(s)) {
+                    return false;
+                }
+            }
+            if (!rb_tree_valid(s) || s.size() != ref.size()) {
+                return false;
+            }
+            size_t k = 0;
+            for (auto it = ref.begin(); it != ref.end(); ++it, ++k) {
+                if (*s.nth(k) != *it || s.rank(*it) != k) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    } // namespace test
+} // namespace mystl
+
+#endif // !MYTINYSTL_RB_TREE_CHECK_H_
@@ -0,0 +1,144 @@
+// serialize / deserialize 测试：各容器写出后读回，内容一致；头部不匹配、数据截断时抛出异常
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "serialize.h"
+#include "test.h"
+
+namespace {
+
+    struct point {
+        int a;
+        double b;
+
+        bool operator==(const point &rhs) const { return a == rhs.a && b == rhs.b; }
+    };
+
+    void test_round_trip() {
+        std::FILE *fp = std::tmpfile();
+        EXPECT_TRUE(fp != nullptr);
+        if (fp == nullptr) {
+            return;
+        }
+        mystl::binary_writer out(fp);
+        mystl::vector<int> v;
+        for (int i = 0; i < 100000; ++i) {
+            v.push_back(i);
+        }
+        mystl::deque<point> d;
+        for (int i = 0; i < 5000; ++i) {
+            d.push_front(point{i, i * 0.5});
+        }
+        // 恰好占满整数个缓冲区，以及空 deque
+        mystl::deque<int> full;
+        for (size_t i = 0; i < 3 * mystl::deque<int>::buffer_size; ++i) {
+            full.push_back(static_cast<int>(i));
+        }
+        mystl::deque<int> empty;
+        mystl::list<long> l;
+        for (int i = 0; i < 70000; ++i) {
+            l.push_back(i * 3);
+        }
+        mystl::set<int> s;
+        for (int i = 0; i < 3000; ++i) {
+            s.insert((i * 7919) % 10007);
+        }
+        mystl::multiset<int> ms;
+        for (int i = 0; i < 300; ++i) {
+            ms.insert(i % 10);
+        }
+        // 元素不是平凡类型时逐个序列化，容器可以嵌套
+        mystl::vector<mystl::vector<int>> vv;
+        for (int i = 0; i < 10; ++i) {
+            mystl::vector<int> x;
+            for (int j = 0; j < i; ++j) {
+                x.push_back(j);
+            }
+            vv.push_back(x);
+        }
+        serialize(out, v);
+        serialize(out, d);
+        serialize(out, full);
+        serialize(out, empty);
+        serialize(out, l);
+        serialize(out, s);
+        serialize(out, ms);
+        serialize(out, vv);
+        out.flush();
+
+        std::rewind(fp);
+        mystl::binary_reader in(fp);
+        mystl::vector<int> v2;
+        v2.push_back(42);
+        mystl::deque<point> d2;
+        d2.push_back(point{-1, -1});
+        mystl::deque<int> full2, empty2;
+        mystl::list<long> l2;
+        mystl::set<int> s2;
+        mystl::multiset<int> ms2;
+        mystl::vector<mystl::vector<int>> vv2;
+        deserialize(in, v2);
+        deserialize(in, d2);
+        deserialize(in, full2);
+        deserialize(in, empty2);
+        deserialize(in, l2);
+        deserialize(in, s2);
+        deserialize(in, ms2);
+        deserialize(in, vv2);
+        EXPECT_SEQ_EQ(v2, v);
+        EXPECT_SEQ_EQ(d2, d);
+        EXPECT_SEQ_EQ(full2, full);
+        EXPECT_TRUE(empty2.empty());
+        EXPECT_SEQ_EQ(l2, l);
+        EXPECT_SEQ_EQ(s2, s);
+        EXPECT_EQ(ms2.size(), 300u);
+        EXPECT_EQ(ms2.count(3), 30u);
+        EXPECT_EQ(vv2.size(), 10u);
+        EXPECT_SEQ_EQ(vv2[7], vv[7]);
+
+        // 元素类型不符
+        std::rewind(fp);
+        mystl::binary_reader in2(fp);
+        mystl::vector<long> bad;
+        EXPECT_THROW(deserialize(in2, bad), std::runtime_error);
+        std::fclose(fp);
+    }
+
+    void test_truncated() {
+        std::FILE *fp = std::tmpfile();
+        EXPECT_TRUE(fp != nullptr);
+        if (fp == nullptr) {
+            return;
+        }
+        mystl::binary_writer out(fp);
+        mystl::deque<int> d;
+        for (int i = 0; i < 100000; ++i) {
+            d.push_back(i);
+        }
+        serialize(out, d);
+        out.flush();
+        // 只留下头部和一部分数据
+        std::FILE *cut = std::tmpfile();
+        std::rewind(fp);
+        char buf[1000];
+        const size_t n = std::fread(buf, 1, sizeof(buf), fp);
+        std::fwrite(buf, 1, n, cut);
+        std::fflush(cut);
+        std::rewind(cut);
+        mystl::binary_reader in(cut);
+        mystl::deque<int> d2;
+        EXPECT_THROW(deserialize(in, d2), std::runtime_error);
+        EXPECT_TRUE(d2.empty());
+        std::fclose(cut);
+        std::fclose(fp);
+    }
+
+} // namespace
+
+int main() {
+    test_round_trip();
+    test_truncated();
+    return mystl::test::report("serialize");
+}
@@ -0,0 +1,693 @@
+// set / multiset 及其底层 rb_tree 的测试，每项操作后检查红黑树结构，并与 std::set / std::multiset 做差分检查
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include "set.h"
+#include "vector.h"
+#include "rb_tree_check.h"
+#include "test.h"
+
+namespace {
+
+    // 复制元素时按预算抛出异常
+    struct thrower {
+        static int budget;
+        int value;
+
+        explicit thrower(int v) : value(v) {}
+
+        thrower(const thrower &rhs) : value(rhs.value) {
+            if (budget >= 0 && budget-- == 0) {
+                throw std::runtime_error("thrower");
+            }
+        }
+
+        bool operator<(const thrower &rhs) const { return value < rhs.value; }
+
+        bool operator==(const thrower &rhs) const { return value == rhs.value; }
+
+        bool operator!=(const thrower &rhs) const { return value != rhs.value; }
+    };
+
+    int thrower::budget = -1;
+
+    // 记录构造次数的键值，用于检查异构查找不构造临时的键值
+    struct counted_key {
+        static int constructed;
+        std::string s;
+
+        counted_key(const char *p) : s(p) { ++constructed; }
+
+        counted_key(const counted_key &rhs) : s(rhs.s) { ++constructed; }
+    };
+
+    int counted_key::constructed = 0;
+
+    // 可以直接与 const char* 比较的透明比较函数
+    struct counted_key_less {
+        typedef void is_transparent;
+
+        bool operator()(const counted_key &a, const counted_key &b) const { return a.s < b.s; }
+
+        bool operator()(const counted_key &a, const char *b) const { return std::strcmp(a.s.c_str(), b) < 0; }
+
+        bool operator()(const char *a, const counted_key &b) const { return std::strcmp(a, b.s.c_str()) < 0; }
+    };
+
+    // 记录复制与移动次数的元素，用于检查节点转移时元素不被复制或移动
+    struct tracked {
+        static int copies;
+        static int moves;
+        int k;
+
+        explicit tracked(int x) : k(x) {}
+
+        tracked(const tracked &rhs) : k(rhs.k) { ++copies; }
+
+        tracked(tracked &&rhs) noexcept: k(rhs.k) { ++moves; }
+
+        bool operator<(const tracked &rhs) const { return k < rhs.k; }
+    };
+
+    int tracked::copies = 0;
+    int tracked::moves = 0;
+
+    template<class Set>
+    mystl::vector<int> keys_of(const Set &s) {
+        mystl::vector<int> v;
+        for (auto it = s.begin(); it != s.end(); ++it) {
+            v.push_back(it->k);
+        }
+        return v;
+    }
+
+    // 记录比较次数的比较函数
+    struct counting_less {
+        static long calls;
+
+        bool operator()(int a, int b) const {
+            ++calls;
+            return a < b;
+        }
+    };
+
+    long counting_less::calls = 0;
+
+    struct counted_key_plain_less {
+        bool operator()(const counted_key &a, const counted_key &b) const { return a.s < b.s; }
+    };
+
+    // 从有序区间以 O(n) 建树，重复键值、无序输入退回逐个插入
+    void test_build_from_sorted() {
+        std::mt19937 rng(9);
+        for (int n = 0; n < 600; ++n) {
+            mystl::vector<int> v;
+            for (int i = 0; i < n; ++i) {
+                v.push_back(i / (1 + n % 3));
+            }
+            mystl::set<int> s(v.begin(), v.end());
+            std::set<int> rs(v.begin(), v.end());
+            mystl::multiset<int> m(v.begin(), v.end());
+            std::multiset<int> rm(v.begin(), v.end());
+            EXPECT_TRUE(mystl::test::rb_tree_valid(s));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(m));
+            EXPECT_SEQ_EQ(s, rs);
+            EXPECT_SEQ_EQ(m, rm);
+            // 建好的树之后仍可正常插入、删除
+            for (int i = 0; i < 50; ++i) {
+                const int x = static_cast<int>(rng() % (n + 5));
+                s.insert(x);
+                rs.insert(x);
+                m.insert(x);
+                rm.insert(x);
+                const int y = static_cast<int>(rng() % (n + 5));
+                EXPECT_EQ(s.erase(y), rs.erase(y));
+                EXPECT_EQ(m.erase(y), rm.erase(y));
+            }
+            EXPECT_TRUE(mystl::test::rb_tree_valid(s));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(m));
+            EXPECT_SEQ_EQ(s, rs);
+            EXPECT_SEQ_EQ(m, rm);
+        }
+
+        mystl::vector<int> u;
+        for (int i = 0; i < 1000; ++i) {
+            u.push_back(static_cast<int>(rng() % 300));
+        }
+        mystl::set<int> su(u.begin(), u.end());
+        std::set<int> ru(u.begin(), u.end());
+        EXPECT_TRUE(mystl::test::rb_tree_valid(su));
+        EXPECT_SEQ_EQ(su, ru);
+
+        mystl::vector<std::string> sv;
+        for (int i = 0; i < 1000; ++i) {
+            char buf[16];
+            std::snprintf(buf, sizeof(buf), "%06d", i);
+            sv.push_back(buf);
+        }
+        mystl::set<std::string> ss(sv.begin(), sv.end());
+        EXPECT_TRUE(mystl::test::rb_tree_valid(ss));
+        EXPECT_EQ(ss.size(), 1000u);
+        EXPECT_EQ(*ss.begin(), "000000");
+    }
+
+    // 复制整棵树：节点一次连续分配并按中序排布
+    void test_copy() {
+        std::mt19937 rng(11);
+        const int sizes[] = {0, 1, 2, 3, 10, 100, 1000, 50000};
+        for (int n : sizes) {
+            mystl::multiset<std::string> s;
+            std::multiset<std::string> rs;
+            for (int i = 0; i < n; ++i) {
+                const std::string x = std::to_string(rng() % 1000);
+                s.insert(x);
+                rs.insert(x);
+            }
+            mystl::multiset<std::string> c(s);
+            EXPECT_TRUE(mystl::test::rb_tree_valid(c));
+            EXPECT_SEQ_EQ(c, rs);
+            bool contiguous = true;
+            const char *prev = nullptr;
+            for (auto it = c.begin(); it != c.end(); ++it) {
+                const char *cur = reinterpret_cast<const char *>(it.node);
+                if (prev != nullptr && cur - prev != static_cast<long>(sizeof(mystl::rb_tree_node<std::string>))) {
+                    contiguous = false;
+                }
+                prev = cur;
+            }
+            EXPECT_TRUE(contiguous);
+
+            mystl::multiset<std::string> d;
+            d.insert("zz");
+            d = s;
+            EXPECT_TRUE(mystl::test::rb_tree_valid(d));
+            EXPECT_SEQ_EQ(d, rs);
+            // 复制出的树可以继续修改，且不影响原树
+            c.insert("q");
+            if (!c.empty()) {
+                c.erase(c.begin());
+            }
+            EXPECT_TRUE(mystl::test::rb_tree_valid(c));
+            EXPECT_SEQ_EQ(s, rs);
+        }
+
+        // 复制到一半抛出异常：已复制的节点被销毁，原树不变
+        mystl::set<thrower> t;
+        for (int i = 0; i < 100; ++i) {
+            t.insert(thrower(i));
+        }
+        thrower::budget = 50;
+        EXPECT_THROW(mystl::set<thrower> u(t), std::runtime_error);
+        thrower::budget = -1;
+        mystl::set<thrower> u(t);
+        EXPECT_EQ(u.size(), 100u);
+        EXPECT_TRUE(mystl::test::rb_tree_valid(u));
+        EXPECT_TRUE(u == t);
+    }
+
+    // nth / rank，开启 MYSTL_RB_TREE_ORDER_STATISTICS 时走子树大小，否则线性查找，结果相同
+    void test_order_statistics() {
+        std::mt19937 rng(13);
+        mystl::multiset<int> m;
+        std::multiset<int> rm;
+        for (int round = 0; round < 3000; ++round) {
+            const int x = static_cast<int>(rng() % 500);
+            if (rng() % 3 != 0) {
+                m.insert(x);
+                rm.insert(x);
+            } else {
+                EXPECT_EQ(m.erase(x), rm.erase(x));
+            }
+            if (round % 100 == 0) {
+                EXPECT_TRUE(mystl::test::rb_tree_valid(m));
+                size_t k = 0;
+                bool ok = true;
+                for (auto it = rm.begin(); it != rm.end(); ++it, ++k) {
+                    if (*m.nth(k) != *it) {
+                        ok = false;
+                    }
+                }
+                EXPECT_TRUE(ok);
+                EXPECT_TRUE(m.nth(m.size()) == m.end());
+                for (int y = -1; y <= 501; y += 7) {
+                    const size_t r = static_cast<size_t>(std::distance(rm.begin(), rm.lower_bound(y)));
+                    EXPECT_EQ(m.rank(y), r);
+                }
+            }
+        }
+
+        mystl::set<int> s;
+        for (int i = 0; i < 1000; ++i) {
+            s.insert(i * 2);
+        }
+        EXPECT_EQ(*s.nth(0), 0);
+        EXPECT_EQ(*s.nth(999), 1998);
+        EXPECT_EQ(s.rank(1001), 501u);
+        // 分裂、合并后子树大小仍然正确
+        auto parts = s.split(600);
+        EXPECT_TRUE(mystl::test::rb_tree_valid(parts.first));
+        EXPECT_TRUE(mystl::test::rb_tree_valid(parts.second));
+        EXPECT_EQ(*parts.second.nth(0), 600);
+        EXPECT_EQ(parts.first.rank(600), 300u);
+        parts.first.join(parts.second);
+        EXPECT_TRUE(mystl::test::rb_tree_valid(parts.first));
+        EXPECT_EQ(*parts.first.nth(700), 1400);
+    }
+
+    // 分裂、合并与集合运算，结果与 std::set 上的对应运算对照
+    void test_split_join() {
+        std::mt19937 rng(17);
+        for (int round = 0; round < 200; ++round) {
+            const int n = static_cast<int>(rng() % 500);
+            const int m = static_cast<int>(rng() % 500);
+            const int range = 1 + static_cast<int>(rng() % 1500);
+            mystl::set<int> a, b;
+            std::set<int> ra, rb;
+            for (int i = 0; i < n; ++i) {
+                const int x = static_cast<int>(rng() % range);
+                a.insert(x);
+                ra.insert(x);
+            }
+            for (int i = 0; i < m; ++i) {
+                const int x = static_cast<int>(rng() % range);
+                b.insert(x);
+                rb.insert(x);
+            }
+            const int key = static_cast<int>(rng() % (range + 2)) - 1;
+
+            mystl::set<int> c(a);
+            auto parts = c.split(key);
+            std::set<int> lo(ra.begin(), ra.lower_bound(key)), hi(ra.lower_bound(key), ra.end());
+            EXPECT_TRUE(mystl::test::rb_tree_valid(parts.first));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(parts.second));
+            EXPECT_SEQ_EQ(parts.first, lo);
+            EXPECT_SEQ_EQ(parts.second, hi);
+            EXPECT_TRUE(c.empty());
+            // 分裂出的两个 set 仍可各自修改
+            parts.first.insert(-5);
+            lo.insert(-5);
+            parts.second.erase(parts.second.begin(), parts.second.end());
+            EXPECT_TRUE(mystl::test::rb_tree_valid(parts.first));
+            EXPECT_SEQ_EQ(parts.first, lo);
+            EXPECT_TRUE(parts.second.empty());
+
+            // 键值区间不相交的合并，rhs 在左侧
+            auto p2 = mystl::set<int>(a).split(key);
+            p2.second.join(p2.first);
+            EXPECT_TRUE(mystl::test::rb_tree_valid(p2.second));
+            EXPECT_SEQ_EQ(p2.second, ra);
+            EXPECT_TRUE(p2.first.empty());
+
+            std::set<int> ru, ri, rd;
+            std::set_union(ra.begin(), ra.end(), rb.begin(), rb.end(), std::inserter(ru, ru.end()));
+            std::set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(), std::inserter(ri, ri.end()));
+            std::set_difference(ra.begin(), ra.end(), rb.begin(), rb.end(), std::inserter(rd, rd.end()));
+            auto j = mystl::join(a, b);
+            auto u = mystl::set_union(a, b);
+            auto in = mystl::set_intersection(a, b);
+            auto d = mystl::set_difference(a, b);
+            EXPECT_TRUE(mystl::test::rb_tree_valid(j));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(u));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(in));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(d));
+            EXPECT_SEQ_EQ(j, ru);
+            EXPECT_SEQ_EQ(u, ru);
+            EXPECT_SEQ_EQ(in, ri);
+            EXPECT_SEQ_EQ(d, rd);
+            // 参数按值传入，原 set 不变
+            EXPECT_SEQ_EQ(a, ra);
+            EXPECT_SEQ_EQ(b, rb);
+
+            // 运算结果之间继续运算：(a ∩ b) ∪ (a - b) == a
+            auto x = mystl::set_union(mystl::move(in), mystl::move(d));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(x));
+            EXPECT_SEQ_EQ(x, ra);
+            EXPECT_TRUE(mystl::set_difference(x, u).empty());
+
+            // 两边的节点池都已被共用时合并
+            auto s1 = mystl::set<int>(a).split(key);
+            auto s2 = mystl::set<int>(b).split(key);
+            s1.first.join(s2.second);
+            std::set<int> e(ra.begin(), ra.lower_bound(key));
+            e.insert(rb.lower_bound(key), rb.end());
+            EXPECT_TRUE(mystl::test::rb_tree_valid(s1.first));
+            EXPECT_SEQ_EQ(s1.first, e);
+            EXPECT_TRUE(s2.second.empty());
+
+            mystl::multiset<int> ma, mb;
+            std::multiset<int> rma, rmb;
+            for (int i = 0; i < n; ++i) {
+                const int x = static_cast<int>(rng() % range);
+                ma.insert(x);
+                rma.insert(x);
+            }
+            for (int i = 0; i < m; ++i) {
+                const int x = static_cast<int>(rng() % range);
+                mb.insert(x);
+                rmb.insert(x);
+            }
+            auto mp = mystl::multiset<int>(ma).split(key);
+            EXPECT_TRUE(mystl::test::rb_tree_valid(mp.first));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(mp.second));
+            const std::multiset<int> mlo(rma.begin(), rma.lower_bound(key)), mhi(rma.lower_bound(key), rma.end());
+            EXPECT_SEQ_EQ(mp.first, mlo);
+            EXPECT_SEQ_EQ(mp.second, mhi);
+            mp.first.join(mp.second);
+            EXPECT_TRUE(mystl::test::rb_tree_valid(mp.first));
+            EXPECT_SEQ_EQ(mp.first, rma);
+            auto mj = mystl::join(ma, mb);
+            std::multiset<int> rmj(rma);
+            rmj.insert(rmb.begin(), rmb.end());
+            EXPECT_TRUE(mystl::test::rb_tree_valid(mj));
+            EXPECT_SEQ_EQ(mj, rmj);
+        }
+
+        // 大树在中间分裂再合并
+        mystl::set<int> big;
+        for (int i = 0; i < 200000; ++i) {
+            big.insert(i);
+        }
+        auto bp = big.split(123456);
+        EXPECT_EQ(bp.first.size(), 123456u);
+        EXPECT_EQ(*bp.second.begin(), 123456);
+        bp.first.join(bp.second);
+        EXPECT_TRUE(mystl::test::rb_tree_valid(bp.first));
+        EXPECT_EQ(bp.first.size(), 200000u);
+    }
+
+    // 比较函数定义了 is_transparent 时，查找与删除直接使用 const char*，不构造 counted_key
+    void test_heterogeneous_lookup() {
+        static_assert(mystl::is_transparent<counted_key_less>::value, "");
+        static_assert(!mystl::is_transparent<counted_key_plain_less>::value, "");
+        const char *words[] = {"pear", "apple", "fig", "kiwi", "plum"};
+        mystl::set<counted_key, counted_key_less> s;
+        mystl::multiset<counted_key, counted_key_less> ms;
+        for (auto w : words) {
+            s.insert(counted_key(w));
+            ms.insert(counted_key(w));
+            ms.insert(counted_key(w));
+        }
+        const int before = counted_key::constructed;
+        EXPECT_TRUE(s.find("fig") != s.end());
+        EXPECT_EQ(s.find("fig")->s, "fig");
+        EXPECT_TRUE(s.find("zzz") == s.end());
+        EXPECT_EQ(s.count("kiwi"), 1u);
+        EXPECT_EQ(s.count("nope"), 0u);
+        EXPECT_EQ(s.lower_bound("g")->s, "kiwi");
+        EXPECT_EQ(s.upper_bound("kiwi")->s, "pear");
+        auto er = s.equal_range("apple");
+        EXPECT_EQ(er.first->s, "apple");
+        EXPECT_EQ(er.second->s, "fig");
+        const auto &cs = s;
+        EXPECT_TRUE(cs.find("pear") != cs.end());
+        EXPECT_EQ(cs.lower_bound("a")->s, "apple");
+        EXPECT_EQ(ms.count("plum"), 2u);
+        auto mr = ms.equal_range("pear");
+        EXPECT_EQ(mystl::distance(mr.first, mr.second), 2);
+        EXPECT_EQ(s.erase("fig"), 1u);
+        EXPECT_EQ(s.erase("fig"), 0u);
+        EXPECT_EQ(s.size(), 4u);
+        EXPECT_EQ(ms.erase("kiwi"), 2u);
+        EXPECT_EQ(ms.size(), 8u);
+        EXPECT_EQ(counted_key::constructed, before);
+        EXPECT_TRUE(mystl::test::rb_tree_valid(s));
+        EXPECT_TRUE(mystl::test::rb_tree_valid(ms));
+
+        // 比较函数不透明时，参数先转换为键值
+        mystl::set<counted_key, counted_key_plain_less> p;
+        p.insert(counted_key("a"));
+        EXPECT_TRUE(p.find("a") != p.end());
+        EXPECT_EQ(p.count(counted_key("b")), 0u);
+    }
+
+    // extract / insert(node_handle) / merge 只重新链接节点，不分配空间，也不复制或移动元素
+    void test_node_handle() {
+        std::mt19937 rng(19);
+        for (int round = 0; round < 100; ++round) {
+            const int n = static_cast<int>(rng() % 300);
+            const int range = 1 + static_cast<int>(rng() % 600);
+            mystl::set<tracked> a, b;
+            std::set<int> ra, rb;
+            for (int i = 0; i < n; ++i) {
+                int x = static_cast<int>(rng() % range);
+                a.emplace(x);
+                ra.insert(x);
+                x = static_cast<int>(rng() % range);
+                b.emplace(x);
+                rb.insert(x);
+            }
+            tracked::copies = 0;
+            tracked::moves = 0;
+            for (int i = 0; i < 100; ++i) {
+                const int k = static_cast<int>(rng() % range);
+                auto nh = a.extract(tracked(k));
+                if (nh.empty()) {
+                    EXPECT_EQ(ra.count(k), 0u);
+                    continue;
+                }
+                const tracked *addr = &nh.value();
+                ra.erase(k);
+                auto res = b.insert(mystl::move(nh));
+                EXPECT_EQ(res.first->k, k);
+                if (res.second) {
+                    rb.insert(k);
+                    EXPECT_TRUE(nh.empty());
+                    EXPECT_TRUE(&*res.first == addr);
+                } else {
+                    // 键值已存在，节点仍留在 nh 中，可以放回原处
+                    EXPECT_FALSE(nh.empty());
+                    EXPECT_TRUE(a.insert(mystl::move(nh)).second);
+                    ra.insert(k);
+                }
+            }
+            EXPECT_EQ(tracked::copies, 0);
+            EXPECT_EQ(tracked::moves, 0);
+            EXPECT_TRUE(mystl::test::rb_tree_valid(a));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(b));
+            EXPECT_SEQ_EQ(keys_of(a), ra);
+            EXPECT_SEQ_EQ(keys_of(b), rb);
+
+            // merge 只转移键值不在本 set 中的节点
+            mystl::set<tracked> c;
+            for (int x : ra) {
+                c.emplace(x);
+            }
+            tracked::copies = 0;
+            tracked::moves = 0;
+            c.merge(b);
+            std::set<int> rc(ra), rleft;
+            for (int x : rb) {
+                if (!rc.insert(x).second) {
+                    rleft.insert(x);
+                }
+            }
+            EXPECT_TRUE(mystl::test::rb_tree_valid(c));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(b));
+            EXPECT_SEQ_EQ(keys_of(c), rc);
+            EXPECT_SEQ_EQ(keys_of(b), rleft);
+            mystl::multiset<tracked> m;
+            for (int x : ra) {
+                m.emplace(x);
+            }
+            m.merge(c);
+            std::multiset<int> rm(ra.begin(), ra.end());
+            rm.insert(rc.begin(), rc.end());
+            EXPECT_TRUE(c.empty());
+            EXPECT_TRUE(mystl::test::rb_tree_valid(m));
+            EXPECT_SEQ_EQ(keys_of(m), rm);
+            EXPECT_EQ(tracked::copies, 0);
+            EXPECT_EQ(tracked::moves, 0);
+        }
+
+        // 两边的节点池都已被其他 set 共用时，插入节点仍不复制也不移动元素
+        mystl::set<tracked> x, y;
+        for (int i = 0; i < 1000; ++i) {
+            x.emplace(i);
+            y.emplace(1000 + i);
+        }
+        auto xs = x.split(tracked(500));
+        auto ys = y.split(tracked(1500));
+        tracked::copies = 0;
+        tracked::moves = 0;
+        for (int i = 0; i < 500; ++i) {
+            const tracked *addr = &*xs.first.begin();
+            auto res = ys.second.insert(xs.first.extract(xs.first.begin()));
+            EXPECT_TRUE(res.second);
+            EXPECT_TRUE(&*res.first == addr);
+        }
+        EXPECT_EQ(tracked::copies, 0);
+        EXPECT_EQ(tracked::moves, 0);
+        EXPECT_TRUE(xs.first.empty());
+        EXPECT_EQ(ys.second.size(), 1000u);
+        EXPECT_TRUE(mystl::test::rb_tree_valid(ys.second));
+        // 节点在各个 set 之间转移后，各自销毁
+        xs.second.clear();
+        ys.first.insert(ys.second.extract(ys.second.begin()));
+        EXPECT_EQ(ys.first.size(), 501u);
+
+        // 句柄比原来的 set 活得久
+        mystl::set<tracked>::node_handle keep;
+        {
+            mystl::set<tracked> t;
+            t.emplace(7);
+            keep = t.extract(t.begin());
+        }
+        EXPECT_EQ(keep.value().k, 7);
+        ys.first.insert(mystl::move(keep));
+        EXPECT_EQ(ys.first.count(tracked(7)), 1u);
+    }
+
+    // 节点布局：定义 MYSTL_RB_TREE_COMPACT_NODES 时颜色存放在 parent 指针的最低位，不占额外空间
+    void test_node_layout() {
+#if defined(MYSTL_RB_TREE_COMPACT_NODES) && !defined(MYSTL_RB_TREE_ORDER_STATISTICS)
+        static_assert(sizeof(mystl::rb_tree_node_base<int>) == 3 * sizeof(void *), "");
+        static_assert(sizeof(mystl::rb_tree_node<long>) == 4 * sizeof(void *), "");
+#else
+        static_assert(sizeof(mystl::rb_tree_node_base<int>) > 3 * sizeof(void *), "");
+#endif
+        // 旋转、删除后修改 parent 指针不改变颜色，颜色修改也不改变 parent 指针
+        std::mt19937 rng(23);
+        mystl::set<long> s;
+        std::set<long> rs;
+        for (int i = 0; i < 20000; ++i) {
+            const long x = static_cast<long>(rng() % 5000);
+            if (rng() % 4 != 0) {
+                s.insert(x);
+                rs.insert(x);
+            } else {
+                EXPECT_EQ(s.erase(x), rs.erase(x));
+            }
+            if (i % 1000 == 0) {
+                EXPECT_TRUE(mystl::test::rb_tree_valid(s));
+            }
+        }
+        EXPECT_TRUE(mystl::test::rb_tree_valid(s));
+        EXPECT_SEQ_EQ(s, rs);
+        bool backward = true;
+        auto rit = rs.rbegin();
+        for (auto it = s.end(); it != s.begin(); ++rit) {
+            --it;
+            if (*it != *rit) {
+                backward = false;
+            }
+        }
+        EXPECT_TRUE(backward);
+    }
+
+    // find_many 交错进行多个查找，结果与逐个 find 相同
+    void test_find_many() {
+        std::mt19937 rng(29);
+        mystl::set<int> s;
+        mystl::multiset<int> m;
+        for (int i = 0; i < 5000; ++i) {
+            const int x = static_cast<int>(rng() % 20000);
+            s.insert(x);
+            m.insert(x);
+            m.insert(x);
+        }
+        for (int len : {0, 1, 7, 8, 9, 1000}) {
+            mystl::vector<int> keys;
+            for (int i = 0; i < len; ++i) {
+                keys.push_back(static_cast<int>(rng() % 20000));
+            }
+            mystl::vector<mystl::set<int>::const_iterator> found(keys.size());
+            EXPECT_TRUE(s.find_many(keys.begin(), keys.end(), found.begin()) == found.end());
+            mystl::vector<mystl::multiset<int>::const_iterator> mfound(keys.size());
+            m.find_many(keys.begin(), keys.end(), mfound.begin());
+            bool ok = true;
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if (found[i] != s.find(keys[i]) || mfound[i] != m.find(keys[i])) {
+                    ok = false;
+                }
+            }
+            EXPECT_TRUE(ok);
+        }
+    }
+
+    // 有序批量插入从上一个插入位置做指状查找，结果与逐个插入相同，比较次数为 O(klog(n/k))
+    void test_insert_sorted_batch() {
+        std::mt19937 rng(31);
+        for (int round = 0; round < 200; ++round) {
+            mystl::multiset<int> m;
+            mystl::set<int> s;
+            std::multiset<int> rm;
+            std::set<int> rs;
+            for (int b = 0; b < 8; ++b) {
+                const int k = static_cast<int>(rng() % 200);
+                mystl::vector<int> v;
+                for (int i = 0; i < k; ++i) {
+                    v.push_back(static_cast<int>(rng() % 1000));
+                }
+                std::sort(v.begin(), v.end());
+                // 偶尔传入无序的批次，退回逐个插入
+                if (round % 5 == 0 && k > 2) {
+                    mystl::swap(v[0], v[k - 1]);
+                }
+                m.insert_sorted_batch(v.begin(), v.end());
+                s.insert_sorted_batch(v.begin(), v.end());
+                rm.insert(v.begin(), v.end());
+                rs.insert(v.begin(), v.end());
+            }
+            EXPECT_TRUE(mystl::test::rb_tree_valid(m));
+            EXPECT_TRUE(mystl::test::rb_tree_valid(s));
+            EXPECT_SEQ_EQ(m, rm);
+            EXPECT_SEQ_EQ(s, rs);
+        }
+
+        // 在 1M 个元素的树中插入分散的 k 个有序键值，每个键值的比较次数随 k 增大而减少
+        mystl::vector<int> base;
+        for (int i = 0; i < (1 << 20); ++i) {
+            base.push_back(i * 4);
+        }
+        mystl::multiset<int, counting_less> big(base.begin(), base.end());
+        double per_key_sparse = 0, per_key_dense = 0;
+        for (int k : {16, 65536}) {
+            mystl::vector<int> v;
+            for (int i = 0; i < k; ++i) {
+                v.push_back(static_cast<int>(static_cast<long>(i) * (1 << 22) / k) + 1);
+            }
+            counting_less::calls = 0;
+            big.insert_sorted_batch(v.begin(), v.end());
+            (k == 16 ? per_key_sparse : per_key_dense) = static_cast<double>(counting_less::calls) / k;
+        }
+        EXPECT_TRUE(mystl::test::rb_tree_valid(big));
+        EXPECT_EQ(big.size(), (1u << 20) + 16 + 65536);
+        EXPECT_TRUE(per_key_dense < per_key_sparse / 2);
+        EXPECT_TRUE(per_key_dense < 20);
+
+        // 时间序列式的追加：每批都在最右端，每个键值只需常数次比较
+        mystl::multiset<int, counting_less> ts;
+        counting_less::calls = 0;
+        for (int b = 0; b < 100; ++b) {
+            mystl::vector<int> v;
+            for (int i = 0; i < 1000; ++i) {
+                v.push_back((b * 1000 + i) / 3);
+            }
+            ts.insert_sorted_batch(v.begin(), v.end());
+        }
+        EXPECT_EQ(ts.size(), 100000u);
+        EXPECT_TRUE(mystl::test::rb_tree_valid(ts));
+        EXPECT_TRUE(counting_less::calls < 100000 * 4);
+    }
+
+} // namespace
+
+int main() {
+    test_build_from_sorted();
+    test_copy();
+    test_order_statistics();
+    test_split_join();
+    test_heterogeneous_lookup();
+    test_node_handle();
+    test_node_layout();
+    test_find_many();
+    test_insert_sorted_batch();
+    return mystl::test::report("set");
+}
@@ -0,0 +1,250 @@
+// skiplist_set 测试：随机插入、删除后检查各层的环与塔高，并与 std::set 做差分检查；
+// 不同的 P 下平均塔高接近 P/(P-1)；复制键值抛出异常时集合不变；异构查找
+
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include "skiplist.h"
+#include "vector.h"
+#include "test.h"
+
+namespace {
+
+    // 第 0 层的前驱、后继一致且严格递增；第 i 层恰好串起塔高大于 i 的节点，并按第 0 层的顺序排列
+    template<class Set>
+    bool skiplist_valid(const Set &s) {
+        auto head = s.end().node;
+        auto comp = s.key_comp();
+        size_t count = 0;
+        auto prev = head;
+        for (auto x = head->next()[0]; x != head; prev = x, x = x->next()[0]) {
+            if (x->prev != prev || x->height == 0 || x->height > Set::max_height) {
+                return false;
+            }
+            if (prev != head && !comp(*typename Set::iterator(prev), *typename Set::iterator(x))) {
+                return false;
+            }
+            ++count;
+        }
+        if (head->prev != prev || count != s.size()) {
+            return false;
+        }
+        for (unsigned int i = 1; i < Set::max_height; ++i) {
+            auto y = head->next()[i];
+            for (auto x = head->next()[0]; x != head; x = x->next()[0]) {
+                if (x->height > i) {
+                    if (y != x) {
+                        return false;
+                    }
+                    y = y->next()[i];
+                }
+            }
+            if (y != head) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class Set>
+    bool same(const Set &s, const std::set<int> &r) {
+        if (!skiplist_valid(s) || s.size() != r.size()) {
+            return false;
+        }
+        auto it = s.begin();
+        for (int k : r) {
+            if (*it != k) {
+                return false;
+            }
+            ++it;
+        }
+        auto rit = s.rbegin();
+        for (auto ri = r.rbegin(); ri != r.rend(); ++ri, ++rit) {
+            if (*rit != *ri) {
+                return false;
+            }
+        }
+        return it == s.end();
+    }
+
+    template<unsigned int P>
+    void test_differential(unsigned seed) {
+        typedef mystl::skiplist_set<int, mystl::less<int>, P> sset;
+        std::mt19937 rng(seed);
+        sset s;
+        std::set<int> r;
+        bool ok = true;
+        for (int i = 0; i < 30000; ++i) {
+            const int k = static_cast<int>(rng() % 5000);
+            const int op = static_cast<int>(rng() % 10);
+            if (op < 5) {
+                auto p = s.insert(k);
+                ok = ok && p.second == r.insert(k).second && *p.first == k;
+            } else if (op < 6) {
+                auto it = s.insert(s.lower_bound(k), k);
+                r.insert(k);
+                ok = ok && *it == k;
+            } else if (op < 8) {
+                ok = ok && s.erase(k) == r.erase(k);
+            } else if (op < 9) {
+                auto it = s.find(k);
+                ok = ok && (it == s.end()) == (r.count(k) == 0);
+                if (it != s.end()) {
+                    s.erase(it);
+                    r.erase(k);
+                }
+            } else if (i % 50 == 0) {
+                // 区间删除
+                const int hi = k + static_cast<int>(rng() % 200);
+                s.erase(s.lower_bound(k), s.lower_bound(hi));
+                r.erase(r.lower_bound(k), r.lower_bound(hi));
+            }
+            if (i % 1000 == 0) {
+                ok = ok && same(s, r);
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_TRUE(same(s, r));
+
+        bool found = true;
+        for (int k = -3; k < 5003; ++k) {
+            auto lb = s.lower_bound(k);
+            auto ub = s.upper_bound(k);
+            auto rl = r.lower_bound(k);
+            auto ru = r.upper_bound(k);
+            auto er = s.equal_range(k);
+            found = found && (rl == r.end() ? lb == s.end() : lb != s.end() && *lb == *rl);
+            found = found && (ru == r.end() ? ub == s.end() : ub != s.end() && *ub == *ru);
+            found = found && s.count(k) == r.count(k) && s.contains(k) == (r.count(k) == 1);
+            found = found && er.first == lb && er.second == ub;
+        }
+        EXPECT_TRUE(found);
+
+        // 复制、移动、交换后各层的环仍指向各自的头节点
+        sset c(s);
+        EXPECT_TRUE(same(c, r));
+        EXPECT_TRUE(c == s);
+        sset m(mystl::move(c));
+        EXPECT_TRUE(c.empty());
+        EXPECT_TRUE(skiplist_valid(c));
+        EXPECT_TRUE(same(m, r));
+        sset small{3, 1, 2};
+        m.swap(small);
+        EXPECT_TRUE(skiplist_valid(m));
+        EXPECT_TRUE(same(small, r));
+        EXPECT_EQ(m.size(), 3u);
+        EXPECT_TRUE(m < small || small < m);
+        c = small;
+        EXPECT_TRUE(same(c, r));
+        c.insert(-1);
+        EXPECT_TRUE(c != small);
+        c.clear();
+        EXPECT_TRUE(c.empty());
+        EXPECT_TRUE(skiplist_valid(c));
+        c.insert(7);
+        EXPECT_EQ(*c.begin(), 7);
+    }
+
+    // 平均塔高接近 P/(P-1)
+    template<unsigned int P>
+    double average_height() {
+        mystl::skiplist_set<int, mystl::less<int>, P> s;
+        for (int i = 0; i < 100000; ++i) {
+            s.insert(i);
+        }
+        auto head = s.end().node;
+        size_t total = 0;
+        for (auto x = head->next()[0]; x != head; x = x->next()[0]) {
+            total += x->height;
+        }
+        return static_cast<double>(total) / s.size();
+    }
+
+    void test_level_probability() {
+        const double h2 = average_height<2>();
+        const double h4 = average_height<4>();
+        const double h16 = average_height<16>();
+        EXPECT_TRUE(h2 > 1.9 && h2 < 2.1);
+        EXPECT_TRUE(h4 > 1.28 && h4 < 1.39);
+        EXPECT_TRUE(h16 > 1.03 && h16 < 1.1);
+    }
+
+    // 复制时按预算抛出异常的键值
+    struct thrower {
+        static int budget;
+        int value;
+
+        thrower(int v) : value(v) {}
+
+        thrower(const thrower &rhs) : value(rhs.value) {
+            if (budget >= 0 && budget-- == 0) {
+                throw std::runtime_error("thrower");
+            }
+        }
+
+        bool operator<(const thrower &rhs) const { return value < rhs.value; }
+    };
+
+    int thrower::budget = -1;
+
+    // 以 int 直接与字符串键值的长度比较
+    struct length_less {
+        typedef void is_transparent;
+
+        bool operator()(const std::string &a, const std::string &b) const { return a.size() < b.size(); }
+
+        bool operator()(const std::string &a, size_t n) const { return a.size() < n; }
+
+        bool operator()(size_t n, const std::string &b) const { return n < b.size(); }
+    };
+
+    void test_exceptions_and_lookup() {
+        mystl::skiplist_set<thrower> s;
+        for (int i = 0; i < 500; ++i) {
+            s.insert(thrower(i * 2));
+        }
+        const thrower t(101);
+        thrower::budget = 0;
+        EXPECT_THROW(s.insert(t), std::runtime_error);
+        thrower::budget = -1;
+        EXPECT_EQ(s.size(), 500u);
+        EXPECT_TRUE(skiplist_valid(s));
+        EXPECT_TRUE(s.find(t) == s.end());
+
+        mystl::skiplist_set<std::string, length_less> w;
+        for (size_t n = 1; n <= 50; ++n) {
+            w.insert(std::string(n, 'a'));
+        }
+        EXPECT_EQ(w.size(), 50u);
+        EXPECT_TRUE(w.find(size_t(7)) != w.end());
+        EXPECT_EQ(w.find(size_t(7))->size(), 7u);
+        EXPECT_EQ(w.count(size_t(51)), 0u);
+        EXPECT_EQ(w.lower_bound(size_t(10))->size(), 10u);
+        EXPECT_EQ(w.upper_bound(size_t(10))->size(), 11u);
+        EXPECT_EQ(w.erase(size_t(3)), 1u);
+        EXPECT_EQ(w.size(), 49u);
+        EXPECT_TRUE(skiplist_valid(w));
+
+        // 从迭代器区间构造
+        mystl::vector<int> v;
+        for (int i = 100; i > 0; --i) {
+            v.push_back(i % 37);
+        }
+        mystl::skiplist_set<int> f(v.begin(), v.end());
+        EXPECT_EQ(f.size(), 37u);
+        EXPECT_EQ(*f.begin(), 0);
+        EXPECT_EQ(*f.rbegin(), 36);
+    }
+
+} // namespace
+
+int main() {
+    test_differential<4>(41);
+    test_differential<2>(42);
+    test_differential<8>(43);
+    test_level_probability();
+    test_exceptions_and_lookup();
+    return mystl::test::report("skiplist");
+}
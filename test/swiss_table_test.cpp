@@ -0,0 +1,335 @@
+// swiss_set / swiss_map 测试：flat 与 node 两种存储下随机插入、删除与 std::unordered_set / std::map 做差分检查；
+// 反复删除、插入时墓碑不会使容量无限增长；node 存储下 rehash 后元素地址不变；
+// 哈希值只有少数几种时仍然正确；异构查找；插入时元素构造抛出异常不改变容器
+
+#include <cstring>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+#include "swiss_map.h"
+#include "swiss_set.h"
+#include "vector.h"
+#include "test.h"
+
+namespace {
+
+    // 遍历得到的元素个数等于 size()，且每个元素都能找到
+    template<class Set>
+    bool consistent(const Set &s) {
+        size_t n = 0;
+        bool ok = true;
+        for (auto it = s.begin(); it != s.end(); ++it) {
+            ++n;
+            ok = ok && s.find(*it) == it;
+        }
+        return ok && n == s.size() && s.load_factor() <= s.max_load_factor();
+    }
+
+    template<bool NodeStorage>
+    void test_set_differential(unsigned seed) {
+        mystl::swiss_set<int, mystl::hash<int>, mystl::equal_to<int>, NodeStorage> s;
+        std::unordered_set<int> r;
+        std::mt19937 rng(seed);
+        bool ok = true;
+        for (int i = 0; i < 100000; ++i) {
+            const int k = static_cast<int>(rng() % 20000) - 10000;
+            const int op = static_cast<int>(rng() % 10);
+            if (op < 5) {
+                auto p = s.insert(k);
+                ok = ok && p.second == r.insert(k).second && *p.first == k;
+            } else if (op < 8) {
+                ok = ok && s.erase(k) == r.erase(k);
+            } else if (op < 9) {
+                auto it = s.find(k);
+                ok = ok && (it == s.end()) == (r.count(k) == 0);
+                if (it != s.end()) {
+                    s.erase(it);
+                    r.erase(k);
+                }
+            } else {
+                ok = ok && s.count(k) == r.count(k) && s.contains(k) == (r.count(k) == 1);
+            }
+            if (i % 5000 == 0) {
+                ok = ok && s.size() == r.size() && consistent(s);
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(s.size(), r.size());
+        EXPECT_TRUE(consistent(s));
+        bool all = true;
+        for (int k : r) {
+            all = all && s.contains(k);
+        }
+        EXPECT_TRUE(all);
+
+        // 遍历时删除，erase 返回下一个元素
+        size_t erased = 0;
+        for (auto it = s.begin(); it != s.end();) {
+            if (*it % 2 == 0) {
+                it = s.erase(it);
+                ++erased;
+            } else {
+                ++it;
+            }
+        }
+        size_t even = 0;
+        for (int k : r) {
+            even += k % 2 == 0;
+        }
+        EXPECT_EQ(erased, even);
+        EXPECT_TRUE(consistent(s));
+
+        // 复制、移动、交换与比较
+        auto c = s;
+        EXPECT_TRUE(c == s);
+        c.insert(100001);
+        EXPECT_TRUE(c != s);
+        auto m = mystl::move(c);
+        EXPECT_TRUE(c.empty());
+        EXPECT_EQ(m.size(), s.size() + 1);
+        m.swap(c);
+        EXPECT_TRUE(m.empty());
+        EXPECT_TRUE(c.contains(100001));
+        c.clear();
+        EXPECT_TRUE(c.empty());
+        EXPECT_TRUE(c.begin() == c.end());
+        c.insert({1, 2, 3, 2});
+        EXPECT_EQ(c.size(), 3u);
+    }
+
+    // 元素个数保持不变地反复删除、插入新键值，墓碑应当在原容量下被清理
+    void test_tombstones() {
+        mystl::swiss_set<long> s;
+        for (long i = 0; i < 1000; ++i) {
+            s.insert(i);
+        }
+        const size_t cap = s.bucket_count();
+        bool ok = true;
+        for (long i = 1000; i < 200000; ++i) {
+            s.erase(i - 1000);
+            s.insert(i);
+            ok = ok && s.size() == 1000;
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(s.bucket_count(), cap);
+        EXPECT_TRUE(consistent(s));
+        EXPECT_TRUE(s.contains(199999));
+        EXPECT_FALSE(s.contains(198999));
+
+        s.reserve(100000);
+        EXPECT_TRUE(s.bucket_count() * s.max_load_factor() >= 100000);
+        EXPECT_TRUE(consistent(s));
+        s.rehash(0);
+        EXPECT_TRUE(consistent(s));
+        EXPECT_EQ(s.size(), 1000u);
+    }
+
+    // 所有键值只有 4 种哈希值，H2 相同，必须逐个比较键值
+    struct bad_hash {
+        size_t operator()(int k) const { return static_cast<size_t>(k & 3); }
+    };
+
+    void test_bad_hash() {
+        mystl::swiss_set<int, bad_hash> s;
+        for (int i = 0; i < 3000; ++i) {
+            s.insert(i);
+        }
+        for (int i = 0; i < 3000; i += 3) {
+            s.erase(i);
+        }
+        bool ok = true;
+        for (int i = 0; i < 3000; ++i) {
+            ok = ok && s.contains(i) == (i % 3 != 0);
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(s.size(), 2000u);
+        EXPECT_TRUE(consistent(s));
+    }
+
+    template<bool NodeStorage>
+    void test_map_differential() {
+        mystl::swiss_map<int, std::string, mystl::hash<int>, mystl::equal_to<int>, NodeStorage> m;
+        std::map<int, std::string> r;
+        std::mt19937 rng(51);
+        bool ok = true;
+        for (int i = 0; i < 50000; ++i) {
+            const int k = static_cast<int>(rng() % 5000);
+            const std::string v = std::to_string(i);
+            switch (rng() % 6) {
+                case 0:
+                    m[k] = v;
+                    r[k] = v;
+                    break;
+                case 1: {
+                    auto p = m.try_emplace(k, v);
+                    auto q = r.emplace(k, v);
+                    ok = ok && p.second == q.second && p.first->second == q.first->second;
+                    break;
+                }
+                case 2: {
+                    auto p = m.insert_or_assign(k, v);
+                    ok = ok && p.second == (r.count(k) == 0);
+                    r[k] = v;
+                    break;
+                }
+                case 3:
+                    ok = ok && m.erase(k) == r.erase(k);
+                    break;
+                case 4: {
+                    auto p = m.insert(mystl::make_pair(k, v));
+                    ok = ok && p.second == r.insert(std::make_pair(k, v)).second;
+                    break;
+                }
+                default: {
+                    auto it = m.find(k);
+                    auto rit = r.find(k);
+                    ok = ok && (rit == r.end() ? it == m.end() : it != m.end() && it->second == rit->second);
+                    break;
+                }
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(m.size(), r.size());
+        bool same = true;
+        for (auto &e : r) {
+            same = same && m.at(e.first) == e.second;
+        }
+        size_t n = 0;
+        for (auto it = m.begin(); it != m.end(); ++it) {
+            ++n;
+            auto rit = r.find(it->first);
+            same = same && rit != r.end() && rit->second == it->second;
+        }
+        EXPECT_TRUE(same);
+        EXPECT_EQ(n, r.size());
+        EXPECT_THROW(m.at(-1), std::out_of_range);
+        auto c = m;
+        EXPECT_TRUE(c == m);
+        c[-1] = "x";
+        EXPECT_TRUE(c != m);
+    }
+
+    // node 存储下 rehash 只移动指针，元素地址不变
+    void test_node_storage_stability() {
+        mystl::swiss_map<int, int, mystl::hash<int>, mystl::equal_to<int>, true> m;
+        mystl::vector<const int *> addr;
+        for (int i = 0; i < 100; ++i) {
+            addr.push_back(&m[i]);
+            m[i] = i * i;
+        }
+        const size_t cap = m.bucket_count();
+        for (int i = 100; i < 50000; ++i) {
+            m[i] = i;
+        }
+        EXPECT_TRUE(m.bucket_count() > cap);
+        bool ok = true;
+        for (int i = 0; i < 100; ++i) {
+            ok = ok && &m.find(i)->second == addr[i] && *addr[i] == i * i;
+        }
+        EXPECT_TRUE(ok);
+    }
+
+    // 对 std::string 与 const char* 给出相同哈希值的 FNV-1a
+    struct string_hash {
+        typedef void is_transparent;
+
+        static size_t fnv(const char *p, size_t n) {
+            size_t h = 14695981039346656037ULL;
+            for (size_t i = 0; i < n; ++i) {
+                h = (h ^ static_cast<unsigned char>(p[i])) * 1099511628211ULL;
+            }
+            return h;
+        }
+
+        size_t operator()(const std::string &s) const { return fnv(s.data(), s.size()); }
+
+        size_t operator()(const char *s) const { return fnv(s, std::strlen(s)); }
+    };
+
+    struct string_equal {
+        typedef void is_transparent;
+
+        bool operator()(const std::string &a, const std::string &b) const { return a == b; }
+
+        bool operator()(const std::string &a, const char *b) const { return a == b; }
+
+        bool operator()(const char *a, const std::string &b) const { return b == a; }
+    };
+
+    void test_heterogeneous() {
+        mystl::swiss_map<std::string, int, string_hash, string_equal> m;
+        for (int i = 0; i < 1000; ++i) {
+            m[std::to_string(i)] = i;
+        }
+        EXPECT_TRUE(m.contains("512"));
+        EXPECT_EQ(m.find("512")->second, 512);
+        EXPECT_EQ(m.count("1000"), 0u);
+        EXPECT_EQ(m.erase("7"), 1u);
+        EXPECT_FALSE(m.contains("7"));
+        auto er = m.equal_range("8");
+        EXPECT_TRUE(er.first != er.second);
+        EXPECT_EQ(m.size(), 999u);
+    }
+
+    // 复制时按预算抛出异常的键值
+    struct thrower {
+        static int budget;
+        int value;
+
+        thrower(int v) : value(v) {}
+
+        thrower(const thrower &rhs) : value(rhs.value) {
+            if (budget >= 0 && budget-- == 0) {
+                throw std::runtime_error("thrower");
+            }
+        }
+
+        thrower(thrower &&rhs) noexcept: value(rhs.value) {}
+
+        bool operator==(const thrower &rhs) const { return value == rhs.value; }
+    };
+
+    int thrower::budget = -1;
+
+    struct thrower_hash {
+        size_t operator()(const thrower &t) const { return mystl::hash<int>()(t.value); }
+    };
+
+    template<bool NodeStorage>
+    void test_exception_safety() {
+        mystl::swiss_set<thrower, thrower_hash, mystl::equal_to<thrower>, NodeStorage> s;
+        bool ok = true;
+        for (int i = 0; i < 2000; ++i) {
+            const thrower t(i);
+            // 每隔几次让复制抛出异常，包括需要扩容的那几次
+            thrower::budget = i % 3 == 0 ? 0 : -1;
+            if (i % 3 == 0) {
+                EXPECT_THROW(s.insert(t), std::runtime_error);
+                ok = ok && !s.contains(t);
+            }
+            thrower::budget = -1;
+            s.insert(t);
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(s.size(), 2000u);
+        EXPECT_TRUE(consistent(s));
+    }
+
+} // namespace
+
+int main() {
+    test_set_differential<false>(61);
+    test_set_differential<true>(62);
+    test_tombstones();
+    test_bad_hash();
+    test_map_differential<false>();
+    test_map_differential<true>();
+    test_node_storage_stability();
+    test_heterogeneous();
+    test_exception_safety<false>();
+    test_exception_safety<true>();
+    return mystl::test::report("swiss_table");
+}
@@ -0,0 +1,77 @@
+#ifndef MYTINYSTL_TEST_H_
+#define MYTINYSTL_TEST_H_
+
+// 这个头文件包含了测试用的断言宏和辅助函数
+// notes:
+//
+// 1. 断言失败时不会中止程序，只打印位置并累计失败次数，
+//    测试程序在 main 的末尾返回 mystl::test::report()，失败次数不为零时 ctest 判定为失败
+// 2. EXPECT_SEQ_EQ 逐个比较两个区间，用于与 std 容器做差分检查
+
+#include <cstdio>
+
+namespace mystl {
+    namespace test {
+
+        // 累计的失败次数
+        inline int &failures() {
+            static int count = 0;
+            return count;
+        }
+
+        inline void fail(const char *file, int line, const char *expr) {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+            ++failures();
+        }
+
+        // 比较两个区间的长度和元素是否一致
+        template<class Iter1, class Iter2>
+        bool seq_equal(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+            for (; first1 != last1 && first2 != last2; ++first1, ++first2) {
+                if (!(*first1 == *first2)) {
+                    return false;
+                }
+            }
+            return first1 == last1 && first2 == last2;
+        }
+
+        // 打印结果，返回值作为 main 的返回值
+        inline int report(const char *name) {
+            if (failures() == 0) {
+                std::printf("[ PASSED ] %s\n", name);
+                return 0;
+            }
+            std::printf("[ FAILED ] %s: %d check(s) failed\n", name, failures());
+            return 1;
+        }
+
+    } // namespace test
+} // namespace mystl
+
+#define EXPECT_TRUE(cond) do {                                     \
+    if (!(cond)) mystl::test::fail(__FILE__, __LINE__, #cond);     \
+} while (0)
+
+#define EXPECT_FALSE(cond) EXPECT_TRUE(!(cond))
+
+#define EXPECT_EQ(lhs, rhs) do {                                   \
+    if (!((lhs) == (rhs)))                                         \
+        mystl::test::fail(__FILE__, __LINE__, #lhs " == " #rhs);   \
+} while (0)
+
+#define EXPECT_SEQ_EQ(c1, c2) do {                                 \
+    const auto &seq1_ = (c1);                                      \
+    const auto &seq2_ = (c2);                                      \
+    if (!mystl::test::seq_equal(seq1_.begin(), seq1_.end(),        \
+                                seq2_.begin(), seq2_.end()))       \
+        mystl::test::fail(__FILE__, __LINE__, #c1 " ~ " #c2);      \
+} while (0)
+
+#define EXPECT_THROW(expr, except) do {                            \
+    bool caught_ = false;                                          \
+    try { expr; } catch (const except &) { caught_ = true; }       \
+    if (!caught_)                                                  \
+        mystl::test::fail(__FILE__, __LINE__, #expr " throws " #except); \
+} while (0)
+
+#endif // !MYTINYSTL_TEST_H_
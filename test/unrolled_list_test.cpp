@@ -0,0 +1,286 @@
+// unrolled_list 测试：随机操作与 std::list 做差分检查，并检查节点链与每个节点的元素个数；
+// splice 后未被分裂的节点中的元素地址不变；插入时元素构造抛出异常不影响原有元素
+
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "unrolled_list.h"
+#include "vector.h"
+#include "test.h"
+
+namespace {
+
+    // 节点链的 prev / next 一致，每个节点有 1 到 node_capacity 个元素，总数等于 size()
+    template<class List>
+    bool nodes_valid(const List &l) {
+        auto head = l.end().node;
+        size_t total = 0;
+        auto prev = head;
+        for (auto x = head->next; x != head; prev = x, x = x->next) {
+            if (x->prev != prev) {
+                return false;
+            }
+            const size_t count = static_cast<typename List::node_ptr>(x)->count;
+            if (count == 0 || count > List::node_capacity) {
+                return false;
+            }
+            total += count;
+        }
+        return head->prev == prev && total == l.size();
+    }
+
+    template<class List, class Ref>
+    bool same(const List &l, const Ref &r) {
+        if (l.size() != r.size() || !nodes_valid(l)) {
+            return false;
+        }
+        auto it = l.begin();
+        for (auto &v : r) {
+            if (!(*it == v)) {
+                return false;
+            }
+            ++it;
+        }
+        if (it != l.end()) {
+            return false;
+        }
+        auto rit = l.rbegin();
+        for (auto ri = r.rbegin(); ri != r.rend(); ++ri, ++rit) {
+            if (!(*rit == *ri)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 第 pos 个位置的迭代器
+    template<class C>
+    typename C::iterator at(C &c, size_t pos) {
+        auto it = c.begin();
+        for (size_t i = 0; i < pos; ++i) {
+            ++it;
+        }
+        return it;
+    }
+
+    // 复制时按预算抛出异常的元素
+    struct thrower {
+        static int budget;
+        int value;
+
+        thrower(int v) : value(v) {}
+
+        thrower(const thrower &rhs) : value(rhs.value) {
+            if (budget >= 0 && budget-- == 0) {
+                throw std::runtime_error("thrower");
+            }
+        }
+
+        thrower &operator=(const thrower &rhs) = default;
+
+        bool operator==(const thrower &rhs) const { return value == rhs.value; }
+    };
+
+    int thrower::budget = -1;
+
+    // 小节点使随机操作频繁触发分裂与合并
+    typedef mystl::unrolled_list<int, 64> small_list;
+
+    void test_differential() {
+        std::mt19937 rng(11);
+        small_list l;
+        std::list<int> r;
+        bool ok = true;
+        for (int i = 0; i < 30000; ++i) {
+            const int op = static_cast<int>(rng() % 12);
+            const int x = static_cast<int>(rng() % 50);
+            if (op < 3) {
+                l.push_back(x);
+                r.push_back(x);
+            } else if (op < 4) {
+                l.push_front(x);
+                r.push_front(x);
+            } else if (op < 7) {
+                const size_t pos = rng() % (r.size() + 1);
+                auto it = l.insert(at(l, pos), x);
+                r.insert(at(r, pos), x);
+                ok = ok && *it == x;
+            } else if (op < 9 && !r.empty()) {
+                const size_t pos = rng() % r.size();
+                auto it = l.erase(at(l, pos));
+                auto rit = r.erase(at(r, pos));
+                ok = ok && (rit == r.end() ? it == l.end() : *it == *rit);
+            } else if (op < 10 && !r.empty()) {
+                const size_t pos = rng() % r.size();
+                const size_t len = rng() % (r.size() - pos + 1);
+                l.erase(at(l, pos), at(l, pos + len));
+                r.erase(at(r, pos), at(r, pos + len));
+            } else if (op < 11 && !r.empty()) {
+                l.pop_front();
+                r.pop_front();
+                if (!r.empty()) {
+                    l.pop_back();
+                    r.pop_back();
+                }
+            } else {
+                const size_t pos = rng() % (r.size() + 1);
+                const size_t n = rng() % 40;
+                l.insert(at(l, pos), n, x);
+                r.insert(at(r, pos), n, x);
+            }
+            if (i % 500 == 0) {
+                ok = ok && same(l, r);
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_TRUE(same(l, r));
+
+        l.remove(7);
+        r.remove(7);
+        EXPECT_TRUE(same(l, r));
+        l.remove_if([](int v) { return v % 3 == 0; });
+        r.remove_if([](int v) { return v % 3 == 0; });
+        EXPECT_TRUE(same(l, r));
+        l.unique();
+        r.unique();
+        EXPECT_TRUE(same(l, r));
+        l.reverse();
+        r.reverse();
+        EXPECT_TRUE(same(l, r));
+        l.resize(r.size() + 100, 5);
+        r.resize(r.size() + 100, 5);
+        EXPECT_TRUE(same(l, r));
+        l.resize(10);
+        r.resize(10);
+        EXPECT_TRUE(same(l, r));
+
+        small_list c(l);
+        EXPECT_TRUE(c == l);
+        EXPECT_TRUE(same(c, r));
+        c.push_back(100);
+        EXPECT_TRUE(l < c);
+        small_list m(mystl::move(c));
+        EXPECT_TRUE(c.empty());
+        EXPECT_EQ(m.size(), 11u);
+        c = {1, 2, 3};
+        EXPECT_EQ(c.size(), 3u);
+        c.clear();
+        EXPECT_TRUE(c.empty());
+        EXPECT_TRUE(nodes_valid(c));
+    }
+
+    // splice 后除 pos、first、last 所在节点外，被转移元素的地址不变
+    void test_splice() {
+        std::mt19937 rng(13);
+        bool ok = true;
+        for (int round = 0; round < 300; ++round) {
+            small_list a, b;
+            std::list<int> ra, rb;
+            const size_t na = rng() % 200;
+            const size_t nb = rng() % 200;
+            for (size_t i = 0; i < na; ++i) {
+                a.push_back(static_cast<int>(i));
+                ra.push_back(static_cast<int>(i));
+            }
+            for (size_t i = 0; i < nb; ++i) {
+                b.push_back(static_cast<int>(1000 + i));
+                rb.push_back(static_cast<int>(1000 + i));
+            }
+            const size_t pos = rng() % (na + 1);
+            const size_t first = rng() % (nb + 1);
+            const size_t last = first + rng() % (nb - first + 1);
+            auto f = at(b, first);
+            auto l = at(b, last);
+            // 记下与 first、last 不在同一节点的元素的地址
+            std::vector<std::pair<int, const int *>> fixed;
+            for (auto it = f; it != l; ++it) {
+                if (it.node != f.node && it.node != l.node) {
+                    fixed.push_back(std::make_pair(*it, &*it));
+                }
+            }
+            switch (round % 3) {
+                case 0:
+                    a.splice(at(a, pos), b, f, l);
+                    ra.splice(at(ra, pos), rb, at(rb, first), at(rb, last));
+                    break;
+                case 1:
+                    a.splice(at(a, pos), b);
+                    ra.splice(at(ra, pos), rb);
+                    break;
+                default:
+                    if (first < nb) {
+                        a.splice(at(a, pos), b, f);
+                        ra.splice(at(ra, pos), rb, at(rb, first));
+                    }
+                    break;
+            }
+            ok = ok && same(a, ra) && same(b, rb);
+            if (round % 3 == 0) {
+                for (auto &p : fixed) {
+                    ok = ok && *p.second == p.first;
+                }
+                // 转移后的元素仍在 a 中且地址不变
+                size_t found = 0;
+                for (auto it = a.begin(); it != a.end(); ++it) {
+                    for (auto &p : fixed) {
+                        found += &*it == p.second;
+                    }
+                }
+                ok = ok && found == fixed.size();
+            }
+        }
+        EXPECT_TRUE(ok);
+    }
+
+    void test_strings_and_exceptions() {
+        mystl::unrolled_list<std::string> s;
+        std::list<std::string> r;
+        for (int i = 0; i < 2000; ++i) {
+            s.push_back(std::to_string(i));
+            r.push_back(std::to_string(i));
+        }
+        for (int i = 0; i < 2000; i += 3) {
+            s.insert(at(s, static_cast<size_t>(i)), "x" + std::to_string(i));
+            r.insert(at(r, static_cast<size_t>(i)), "x" + std::to_string(i));
+        }
+        EXPECT_TRUE(same(s, r));
+        s.remove_if([](const std::string &v) { return v[0] == 'x'; });
+        EXPECT_EQ(s.size(), 2000u);
+        EXPECT_EQ(s.back(), "1999");
+
+        // 插入多个元素时抛出异常，原有元素不变
+        mystl::unrolled_list<thrower, 64> t;
+        std::list<int> rt;
+        for (int i = 0; i < 100; ++i) {
+            t.push_back(thrower(i));
+            rt.push_back(i);
+        }
+        mystl::vector<thrower> more;
+        for (int i = 0; i < 50; ++i) {
+            more.push_back(thrower(-i));
+        }
+        thrower::budget = 20;
+        EXPECT_THROW(t.insert(at(t, 37), more.begin(), more.end()), std::runtime_error);
+        thrower::budget = 0;
+        EXPECT_THROW(t.push_back(thrower(7)), std::runtime_error);
+        thrower::budget = -1;
+        bool ok = t.size() == 100 && nodes_valid(t);
+        auto it = t.begin();
+        for (int v : rt) {
+            ok = ok && it->value == v;
+            ++it;
+        }
+        EXPECT_TRUE(ok);
+    }
+
+} // namespace
+
+int main() {
+    test_differential();
+    test_splice();
+    test_strings_and_exceptions();
+    return mystl::test::report("unrolled_list");
+}